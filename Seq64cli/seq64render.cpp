@@ -0,0 +1,298 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          seq64render.cpp
+ *
+ *  This module defines the main module of a headless tool that renders a
+ *  performance offline, faster than real time.
+ *
+ * \library       seq64render application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  This application loads a Sequencer64 MIDI file, plays it with
+ *  seq64::offline_render, optionally following a script of actions, and
+ *  writes what the patterns sent, either as a MIDI file or as a binary log.
+ *  It is meant for checking sets in continuous integration, where it is
+ *  best built with the loop-back MIDI backend (--enable-loopmidi), which
+ *  needs no ALSA sequencer or JACK server.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>                     /* exit(3), EXIT_SUCCESS            */
+#include <getopt.h>
+#include <time.h>                       /* clock_gettime()                  */
+
+#include "gui_assistant.hpp"            /* seq64::gui_assistant base class  */
+#include "keys_perform.hpp"             /* seq64::keys_perform              */
+#include "midifile.hpp"                 /* seq64::midifile to open the file */
+#include "offline_render.hpp"           /* seq64::offline_render            */
+#include "perform.hpp"                  /* seq64::perform, the main object  */
+#include "settings.hpp"                 /* seq64::usr() and seq64::rc()     */
+
+/**
+ *  Lists the options (long and short) for the seq64render application.
+ */
+
+static struct option const long_options [] =
+{
+    { "live",           no_argument,        0, 'l'  },
+    { "bars",           required_argument,  0, 'b'  },
+    { "script",         required_argument,  0, 's'  },
+    { "action",         required_argument,  0, 'a'  },
+    { "step",           required_argument,  0, 't'  },
+    { "output",         required_argument,  0, 'o'  },
+    { "log",            no_argument,        0, 'L'  },
+    { "quiet",          no_argument,        0, 'q'  },
+    { "help",           no_argument,        0, 'h'  },
+    { NULL,             0,                  NULL, 0 }
+};
+
+/**
+ *  Help strings.
+ */
+
+static const std::string s_help_intro =
+"A headless tool to play a Sequencer64 MIDI file offline, as fast as the\n"
+"CPU allows, and write out what it plays.\n\n"
+"Usage: seq64render [ options ] file.mid\n\n"
+;
+
+static const std::string s_help_options =
+"Options:\n"
+"\n"
+"  -l, --live             Play the armed patterns, as in live mode, rather\n"
+"                         than the song.\n"
+"  -b bars, --bars bars   Play this many bars.  Default: to the end of the\n"
+"                         song, or, in live mode, to a 'stop' action.\n"
+"  -s file, --script file Read actions from a file, one per line.\n"
+"  -a spec, --action spec Add one action, such as '9 queue 3'.  Repeatable.\n"
+"  -t ticks, --step ticks Ticks per step.  Default 1, the exact timing.\n"
+"  -o file, --output file Write the output to this file.\n"
+"  -L, --log              Write a binary log with the times in microseconds,\n"
+"                         rather than a MIDI file.\n"
+"  -q, --quiet            Print only errors.\n"
+"  -h, --help             Display this help and exit.\n"
+"\n"
+"An action is 'bar verb [value]', bars counting from 1.  The verbs are on,\n"
+"off, toggle, queue, and oneshot, taking a pattern number; group, taking a\n"
+"mute-group; mute-all; unmute-all; transpose; bpm; and stop.  MIDI clock\n"
+"and SysEx are not rendered.  The MIDI backend is set up but its ports get\n"
+"nothing.\n"
+"\n"
+;
+
+/**
+ *  The settings made on the command line.
+ */
+
+static bool s_live = false;
+static int s_bars = 0;
+static std::string s_script;
+static std::vector<std::string> s_actions;
+static long s_step = 1;
+static std::string s_output;
+static bool s_log = false;
+static bool s_quiet = false;
+
+/**
+ *  Prints the help text for this application.
+ */
+
+static void
+usage (int status)
+{
+    printf("%s%s", s_help_intro.c_str(), s_help_options.c_str());
+    exit(status);
+}
+
+/**
+ *  Decodes the options, saving them in the static settings above.
+ *
+ * \return
+ *      Returns the index of the first non-option argument.
+ */
+
+static int
+decode_switches (int argc, char ** argv)
+{
+    int c;
+    while
+    (
+        (
+            c = getopt_long
+            (
+                argc, argv,
+                "l"                             /* live             */
+                "b:"                            /* bars             */
+                "s:"                            /* script           */
+                "a:"                            /* action           */
+                "t:"                            /* step             */
+                "o:"                            /* output           */
+                "L"                             /* log              */
+                "q"                             /* quiet            */
+                "h"                             /* help             */
+                , long_options, (int *) 0
+            )
+        ) != EOF
+    )
+    {
+        switch (c)
+        {
+        case 'l':
+            s_live = true;
+            break;
+
+        case 'b':
+            s_bars = atoi(optarg);
+            break;
+
+        case 's':
+            s_script = optarg;
+            break;
+
+        case 'a':
+            s_actions.push_back(optarg);
+            break;
+
+        case 't':
+            s_step = atol(optarg);
+            break;
+
+        case 'o':
+            s_output = optarg;
+            break;
+
+        case 'L':
+            s_log = true;
+            break;
+
+        case 'q':
+            s_quiet = true;
+            break;
+
+        case 'h':
+            usage(EXIT_SUCCESS);
+            break;
+
+        default:
+            usage(EXIT_FAILURE);
+            break;
+        }
+    }
+    return optind;
+}
+
+/**
+ * \return
+ *      Returns the monotonic time, in seconds.
+ */
+
+static double
+seconds_now ()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1.0e9;
+}
+
+/**
+ *  The standard C/C++ entry point to this application.  The configuration
+ *  files are not read, so that the render does not depend on the machine.
+ *
+ * \param argc
+ *      The number of command-line parameters, including the name of the
+ *      application as parameter 0.
+ *
+ * \param argv
+ *      The array of pointers to the command-line parameters.
+ *
+ * \return
+ *      Returns EXIT_SUCCESS (0) or EXIT_FAILURE, depending on the status of
+ *      the run.
+ */
+
+int
+main (int argc, char * argv [])
+{
+    seq64::rc().set_defaults();             /* start out with normal values */
+    seq64::usr().set_defaults();            /* start out with normal values */
+    int index = decode_switches(argc, argv);
+    if (index != argc - 1)
+        usage(EXIT_FAILURE);
+
+    seq64::keys_perform keys;               /* keystroke support            */
+    seq64::gui_assistant cli(keys);         /* keystroke support only       */
+    seq64::perform p(cli);                  /* the performance to render    */
+    p.launch(seq64::usr().midi_ppqn());     /* sets up the master buss      */
+
+    std::string fn = argv[index];
+    seq64::midifile f(fn);
+    bool ok = f.parse(p);
+    if (! ok)
+    {
+        printf("? MIDI file not parsed: %s\n", fn.c_str());
+        return EXIT_FAILURE;
+    }
+
+    seq64::offline_render r(p, ! s_live);
+    r.step(seq64::midipulse(s_step));
+    if (! s_script.empty())
+        ok = r.load_script(s_script);
+
+    std::vector<std::string>::const_iterator ai;
+    for (ai = s_actions.begin(); ok && ai != s_actions.end(); ++ai)
+        ok = r.add_action(*ai);
+
+    double start = seconds_now();
+    if (ok)
+        ok = r.run(s_bars);
+
+    if (! ok)
+    {
+        printf("? Not rendered: %s\n", r.error_message().c_str());
+        return EXIT_FAILURE;
+    }
+
+    double elapsed = seconds_now() - start;
+    double played = r.end_time_us() / 1.0e6;
+    if (! s_quiet)
+    {
+        printf
+        (
+            "%ld events, %ld ticks, %.3f s of music rendered in %.3f s\n",
+            long(r.messages().size()), long(r.end_tick()), played, elapsed
+        );
+    }
+    if (! s_output.empty())
+    {
+        ok = s_log ? r.write_log(s_output) : r.write_midi(s_output) ;
+        if (! ok)
+            printf("? Output not written: %s\n", s_output.c_str());
+    }
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE ;
+}
+
+/*
+ * seq64render.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
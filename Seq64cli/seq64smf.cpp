@@ -0,0 +1,286 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          seq64smf.cpp
+ *
+ *  This module defines the main module of a headless tool that inspects or
+ *  imports large MIDI files.
+ *
+ * \library       seq64smf application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  This application reads a MIDI file with seq64::midifile_stream, which
+ *  holds only a small part of the file in memory, and can thin out the
+ *  controller data on the way.  It prints what each track holds, and,
+ *  given an output file, imports the tracks and writes them out again as a
+ *  Sequencer64 MIDI file.  No MIDI ports are opened.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>                     /* exit(3), EXIT_SUCCESS            */
+#include <getopt.h>
+
+#include "gui_assistant.hpp"            /* seq64::gui_assistant base class  */
+#include "keys_perform.hpp"             /* seq64::keys_perform              */
+#include "midifile.hpp"                 /* seq64::midifile to write a file  */
+#include "midifile_stream.hpp"          /* seq64::midifile_stream           */
+#include "perform.hpp"                  /* seq64::perform, the main object  */
+#include "settings.hpp"                 /* seq64::usr() and seq64::rc()     */
+
+/**
+ *  Lists the options (long and short) for the seq64smf application.
+ */
+
+static struct option const long_options [] =
+{
+    { "drop-redundant", no_argument,        0, 'r'  },
+    { "thin",           required_argument,  0, 't'  },
+    { "ppqn",           required_argument,  0, 'p'  },
+    { "output",         required_argument,  0, 'o'  },
+    { "quiet",          no_argument,        0, 'q'  },
+    { "help",           no_argument,        0, 'h'  },
+    { NULL,             0,                  NULL, 0 }
+};
+
+/**
+ *  Help strings.
+ */
+
+static const std::string s_help_intro =
+"A headless tool to inspect or import large MIDI files, reading them in\n"
+"small chunks, and optionally thinning out controller data.\n\n"
+"Usage: seq64smf [ options ] file.mid\n\n"
+;
+
+static const std::string s_help_options =
+"Options:\n"
+"\n"
+"  -r, --drop-redundant   Drop control change, pitch wheel, and channel\n"
+"                         pressure events that repeat the last value kept.\n"
+"  -t ticks, --thin ticks Keep at most one such value per channel and\n"
+"                         controller in each interval of the given ticks.\n"
+"  -p ppqn, --ppqn ppqn   Import at this PPQN, without scaling timestamps.\n"
+"                         Default: scale the file to the configured PPQN.\n"
+"  -o file, --output file Import the tracks and write them to this file.\n"
+"  -q, --quiet            Do not list the tracks.\n"
+"  -h, --help             Display this help and exit.\n"
+"\n"
+"Without -o, the file is only inspected, in constant memory.  The filter is\n"
+"applied either way, so the listing shows what it would drop.  Sequencer64\n"
+"SeqSpec data (triggers, busses) is not read.\n"
+"\n"
+;
+
+/**
+ *  The settings made on the command line.
+ */
+
+static bool s_drop_redundant = false;
+static long s_thin_ticks = 0;
+static int s_ppqn = SEQ64_USE_DEFAULT_PPQN;
+static std::string s_output;
+static bool s_quiet = false;
+
+/**
+ *  Prints the help text for this application.
+ */
+
+static void
+usage (int status)
+{
+    printf("%s%s", s_help_intro.c_str(), s_help_options.c_str());
+    exit(status);
+}
+
+/**
+ *  Decodes the options, saving them in the static settings above.
+ *
+ * \return
+ *      Returns the index of the first non-option argument.
+ */
+
+static int
+decode_switches (int argc, char ** argv)
+{
+    int c;
+    while
+    (
+        (
+            c = getopt_long
+            (
+                argc, argv,
+                "r"                             /* drop-redundant   */
+                "t:"                            /* thin             */
+                "p:"                            /* ppqn             */
+                "o:"                            /* output           */
+                "q"                             /* quiet            */
+                "h"                             /* help             */
+                , long_options, (int *) 0
+            )
+        ) != EOF
+    )
+    {
+        switch (c)
+        {
+        case 'r':
+            s_drop_redundant = true;
+            break;
+
+        case 't':
+            s_thin_ticks = atol(optarg);
+            break;
+
+        case 'p':
+            s_ppqn = atoi(optarg);
+            break;
+
+        case 'o':
+            s_output = optarg;
+            break;
+
+        case 'q':
+            s_quiet = true;
+            break;
+
+        case 'h':
+            usage(EXIT_SUCCESS);
+            break;
+
+        default:
+            usage(EXIT_FAILURE);
+            break;
+        }
+    }
+    return optind;
+}
+
+/**
+ *  Prints the header information and the statistics of each track.
+ *
+ * \param ms
+ *      The reader, after inspect() or import().
+ */
+
+static void
+show_stats (const seq64::midifile_stream & ms)
+{
+    const std::vector<seq64::midifile_stream::track_stats> & stats =
+        ms.stats();
+
+    long events = 0;
+    long dropped = 0;
+    if (! s_quiet)
+    {
+        printf
+        (
+            "Format %d, %d tracks, %d ppqn (imported at %d)\n",
+            ms.format(), int(stats.size()), ms.file_ppqn(), ms.ppqn()
+        );
+        printf
+        (
+            "%5s %4s %10s %10s %10s %10s %10s  %s\n", "Track", "Chan",
+            "Length", "Events", "Notes", "Controls", "Dropped", "Name"
+        );
+    }
+    std::vector<seq64::midifile_stream::track_stats>::const_iterator ti;
+    for (ti = stats.begin(); ti != stats.end(); ++ti)
+    {
+        events += ti->ts_events;
+        dropped += ti->ts_dropped;
+        if (! s_quiet)
+        {
+            printf
+            (
+                "%5d %4d %10ld %10ld %10ld %10ld %10ld  %s\n",
+                ti->ts_track, ti->ts_channel + 1, long(ti->ts_length),
+                ti->ts_events, ti->ts_notes, ti->ts_controls,
+                ti->ts_dropped, ti->ts_name.c_str()
+            );
+        }
+    }
+    printf("%ld events read, %ld dropped\n", events, dropped);
+}
+
+/**
+ *  The standard C/C++ entry point to this application.  The configuration
+ *  files are not read, and the perform object is never launched, so that
+ *  the tool can run anywhere.
+ *
+ * \param argc
+ *      The number of command-line parameters, including the name of the
+ *      application as parameter 0.
+ *
+ * \param argv
+ *      The array of pointers to the command-line parameters.
+ *
+ * \return
+ *      Returns EXIT_SUCCESS (0) or EXIT_FAILURE, depending on the status of
+ *      the run.
+ */
+
+int
+main (int argc, char * argv [])
+{
+    seq64::rc().set_defaults();             /* start out with normal values */
+    seq64::usr().set_defaults();            /* start out with normal values */
+    int index = decode_switches(argc, argv);
+    if (index != argc - 1)
+        usage(EXIT_FAILURE);
+
+    seq64::midifile_stream ms(argv[index], s_ppqn);
+    ms.drop_redundant(s_drop_redundant);
+    ms.thin_interval(seq64::midipulse(s_thin_ticks));
+
+    bool ok;
+    if (s_output.empty())
+    {
+        ok = ms.inspect();
+        if (ok)
+            show_stats(ms);
+        else
+            printf("? MIDI file not read: %s\n", ms.error_message().c_str());
+    }
+    else
+    {
+        seq64::keys_perform keys;           /* keystroke support            */
+        seq64::gui_assistant cli(keys);     /* keystroke support only       */
+        seq64::perform p(cli);              /* holds the imported tracks    */
+        ok = ms.import(p);
+        if (ok)
+        {
+            seq64::midifile f(s_output, ms.ppqn());
+            show_stats(ms);
+            ok = f.write(p);
+            if (! ok)
+                printf("? MIDI file not written: %s\n", s_output.c_str());
+        }
+        else
+            printf("? MIDI file not read: %s\n", ms.error_message().c_str());
+    }
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE ;
+}
+
+/*
+ * seq64smf.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
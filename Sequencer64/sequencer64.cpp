@@ -155,6 +155,8 @@ main (int argc, char * argv [])
                 else
                     printf("? MIDI file not found: %s\n", midifilename.c_str());
             }
+            else if (! seq64::rc().playlist_filename().empty())
+                (void) p.get_playlist().open(seq64::rc().playlist_filename());
 
             if (seq64::rc().lash_support())
                 seq64::create_lash_driver(p, argc, argv);
@@ -546,6 +546,107 @@
 
 #define SEQ64_RECENT_FILES_MAX          10
 
+/**
+ *  Provides the number of slots in the per-sequence queue that holds events
+ *  recorded by the MIDI input thread until they are merged into the
+ *  sequence's event list.  If the queue fills before a merge occurs, the
+ *  input thread does the merge itself, under the sequence lock.
+ */
+
+#define SEQ64_RECORD_QUEUE_SIZE         512
+
+/**
+ *  Provides the number of buckets in each per-buss histogram kept by the
+ *  clock_generator.  Each bucket counts the pulses whose interval deviated
+ *  from the nominal interval by a multiple of SEQ64_CLOCK_HISTOGRAM_US.  The
+ *  last bucket collects everything that is worse.
+ */
+
+#define SEQ64_CLOCK_HISTOGRAM_BUCKETS   32
+
+/**
+ *  Provides the width, in microseconds, of each clock-jitter histogram
+ *  bucket.
+ */
+
+#define SEQ64_CLOCK_HISTOGRAM_US        50
+
+/**
+ *  Provides the SCHED_FIFO priority of the clock_generator thread when the
+ *  --priority option is in force.  It is one higher than the output thread,
+ *  so that rendering the patterns cannot delay a clock pulse.
+ */
+
+#define SEQ64_CLOCK_THREAD_PRIORITY     2
+
+/**
+ *  Provides the number of slots in each output buss's queue of events
+ *  waiting to be sent.  Any thread can add an event; whichever thread holds
+ *  the buss's lock sends them.  If the queue fills, the producer waits for
+ *  the lock and sends the event itself.
+ */
+
+#define SEQ64_BUS_QUEUE_SIZE            256
+
+/**
+ *  Provides the longest time, in milliseconds, that the input thread sleeps
+ *  in the input_reactor when nothing arrives.  Shutdown no longer depends on
+ *  it, since the reactor can be woken, so it is just a safety net.
+ */
+
+#define SEQ64_INPUT_POLL_MS             1000
+
+/**
+ *  Provides the number of ready descriptors the input_reactor collects in
+ *  one epoll_wait() call.
+ */
+
+#define SEQ64_INPUT_REACTOR_EVENTS      16
+
+/**
+ *  Provides the size, in bytes, at which midifile writes its output buffer
+ *  to the file while saving.  Whole tracks are always kept together in the
+ *  buffer, so a single large track can exceed this size.
+ */
+
+#define SEQ64_MIDI_WRITE_CHUNK          (64 * 1024)
+
+/**
+ *  Provides the size, in bytes, of the buffer through which midifile_stream
+ *  reads a MIDI file.  This is all of the file that is held in memory at
+ *  once during a streaming import.
+ */
+
+#define SEQ64_MIDI_READ_CHUNK           (64 * 1024)
+
+/**
+ *  Provides the most worker threads that midifile uses to decode the tracks
+ *  of an SMF 1 file.  The number of processors, if lower, is used instead.
+ */
+
+#define SEQ64_PARSE_THREADS_MAX         8
+
+/**
+ *  Provides the fewest tracks an SMF 1 file must have before midifile
+ *  decodes them in parallel.  Smaller files are not worth the threads.
+ */
+
+#define SEQ64_PARSE_PARALLEL_MIN        8
+
+/**
+ *  Provides the most worker threads that midifile uses to fill the tracks of
+ *  an exported song.  The number of processors, if lower, is used instead.
+ */
+
+#define SEQ64_EXPORT_THREADS_MAX        8
+
+/**
+ *  Provides the number of tracks of an exported song that midifile fills
+ *  before writing them, which bounds the memory the filled tracks use.
+ */
+
+#define SEQ64_EXPORT_BATCH              (2 * SEQ64_EXPORT_THREADS_MAX)
+
 #endif      // SEQ64_APP_LIMITS_H
 
 /*
@@ -302,6 +302,9 @@ public:
     void continue_from (midipulse tick);
     void init_clock (midipulse tick);
     void clock (midipulse tick);
+    int clock_buses (std::vector<midibus *> & buses);
+    std::vector<businfo> * snapshot () const;
+    void share_io_mutex (bus_lock & m);
     void sysex (event * ev);
     void play (bussbyte bus, event * e24, midibyte channel);
     bool set_clock (bussbyte bus, clock_e clocktype);
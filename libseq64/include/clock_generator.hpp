@@ -0,0 +1,299 @@
+#ifndef SEQ64_CLOCK_GENERATOR_HPP
+#define SEQ64_CLOCK_GENERATOR_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          clock_generator.hpp
+ *
+ *  This module declares a class that emits outgoing MIDI clock from a
+ *  thread of its own.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  Normally the MIDI clock is emitted by perform::output_func(), after it has
+ *  played all of the patterns, via mastermidibase::emit_clock().  Every delay
+ *  in rendering the patterns, and every wait on the master buss mutex, thus
+ *  shows up as jitter in the clock pulses that drum machines and other
+ *  slaves follow.
+ *
+ *  When enabled (the -T/--clock-thread option), the clock_generator takes
+ *  over.  The output thread still calls mastermidibase::init_clock(), then
+ *  hands the starting tick to start().  From then on the generator thread
+ *  sleeps until the absolute deadline of each pulse, computed from the
+ *  starting point and the current tempo, and calls midibase::clock() on each
+ *  clock-enabled buss.  That locks only the buss's I/O mutex, never the
+ *  master buss mutex.  A tempo change re-anchors the timeline at the last
+ *  pulse, so that no error accumulates.
+ *
+ *  When the MIDI API writes every buss through one handle, as ALSA does,
+ *  the I/O mutex of every buss is the master buss's handle mutex (see
+ *  mastermidibase::api_shared_handle()).  The output thread takes the same
+ *  mutex to play, flush, start, and stop, so the two threads never write
+ *  to the handle at the same time.
+ *
+ *  For monitoring, the interval between consecutive pulses on each buss is
+ *  measured and kept in a histogram of deviations from the nominal interval.
+ */
+
+#include <atomic>                       /* std::atomic<>                    */
+#include <pthread.h>                    /* pthread_t                        */
+#include <vector>                       /* std::vector<>                    */
+
+#include "app_limits.h"                 /* SEQ64_CLOCK_HISTOGRAM_BUCKETS    */
+#include "midibyte.hpp"                 /* seq64::midipulse, midibpm        */
+#include "mutex.hpp"                    /* seq64::mutex, condition_var      */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+    class mastermidibase;
+    class midibus;
+
+/**
+ *  Holds the pulse-interval statistics for one output buss.  All times are
+ *  in microseconds.  A copy of this structure is handed out by
+ *  clock_generator::get_stats().
+ */
+
+struct clock_stats
+{
+    /**
+     *  The number of intervals measured.  This is one less than the number
+     *  of pulses sent since the last start().
+     */
+
+    long cs_count;
+
+    /**
+     *  The nominal pulse interval at the current tempo.
+     */
+
+    long cs_nominal_us;
+
+    /**
+     *  The shortest interval measured.
+     */
+
+    long cs_min_us;
+
+    /**
+     *  The longest interval measured.
+     */
+
+    long cs_max_us;
+
+    /**
+     *  The sum of all of the measured intervals, used to get the mean.
+     */
+
+    long long cs_total_us;
+
+    /**
+     *  Counts of the absolute deviation from the nominal interval, in
+     *  buckets SEQ64_CLOCK_HISTOGRAM_US wide.  The last bucket also counts
+     *  all larger deviations.
+     */
+
+    long cs_histogram[SEQ64_CLOCK_HISTOGRAM_BUCKETS];
+
+    void clear ();
+    void add (long interval_us);
+
+    /**
+     * \getter cs_total_us / cs_count
+     */
+
+    long mean_us () const
+    {
+        return cs_count > 0 ? long(cs_total_us / cs_count) : 0 ;
+    }
+};
+
+/**
+ *  Emits MIDI clock for the clock-enabled output busses from a dedicated
+ *  (optionally SCHED_FIFO) thread.  Owned by the perform object, which
+ *  creates it only when rc().clock_thread() is true.
+ */
+
+class clock_generator
+{
+
+private:
+
+    /**
+     *  The master buss, used only to obtain the list of clocked busses at
+     *  start().  It is never locked while pulses are being sent.
+     */
+
+    mastermidibase & m_master_bus;
+
+    /**
+     *  Protects the start/stop handshake with the generator thread, and lets
+     *  the thread sleep while playback is stopped.
+     */
+
+    condition_var m_condition_var;
+
+    /**
+     *  Protects m_stats.  It is held by the generator thread only long
+     *  enough to add one interval, and by monitors only long enough to copy
+     *  one clock_stats structure.
+     */
+
+    mutable mutex m_stats_mutex;
+
+    /**
+     *  The generator thread.
+     */
+
+    pthread_t m_thread;
+
+    /**
+     *  True if the thread was created, so that it must be joined.
+     */
+
+    bool m_thread_launched;
+
+    /**
+     *  Set to true to make the thread exit.
+     */
+
+    bool m_exiting;
+
+    /**
+     *  Set by start() and cleared by stop().  The thread checks it after
+     *  every sleep.
+     */
+
+    std::atomic<bool> m_running;
+
+    /**
+     *  True while the thread is waiting for start().  Protected by
+     *  m_condition_var.  The stop() function waits for this flag, so that no
+     *  clock pulse can follow the MIDI Stop that the caller sends next.
+     */
+
+    bool m_idle;
+
+    /**
+     *  The current tempo, which can be changed at any time by tempo().
+     */
+
+    std::atomic<midibpm> m_bpm;
+
+    /**
+     *  The PPQN of the busses, set by start().
+     */
+
+    int m_ppqn;
+
+    /**
+     *  The tick at which the clock starts, as passed to start().
+     */
+
+    midipulse m_start_tick;
+
+    /**
+     *  The clocked busses, indexed by buss number, with null entries for the
+     *  busses that are not clocked.  Filled in by start().
+     */
+
+    std::vector<midibus *> m_buses;
+
+    /**
+     *  The time of the last pulse sent on each buss, in microseconds on the
+     *  monotonic clock, or 0 if no pulse has been sent yet.  Used only by
+     *  the generator thread.
+     */
+
+    std::vector<long long> m_last_pulse_us;
+
+    /**
+     *  The pulse-interval statistics for each buss.
+     */
+
+    std::vector<clock_stats> m_stats;
+
+public:
+
+    clock_generator (mastermidibase & mmb);
+    ~clock_generator ();
+
+    bool launch ();
+    void start (midipulse tick, midibpm bpm, int ppqn);
+    void stop ();
+    void tempo (midibpm bpm);
+    bool get_stats (int bus, clock_stats & stats) const;
+    void show_stats () const;
+
+    /**
+     * \getter m_running
+     */
+
+    bool running () const
+    {
+        return m_running;
+    }
+
+    /**
+     * \getter m_stats.size()
+     *      Valid after the first start().
+     */
+
+    int bus_count () const
+    {
+        automutex locker(m_stats_mutex);
+        return int(m_stats.size());
+    }
+
+private:
+
+    clock_generator (const clock_generator &);                  /* no copy  */
+    clock_generator & operator = (const clock_generator &);     /* no copy  */
+
+    void generate ();
+    void measure (int bus, long long now_us, long nominal_us);
+
+    friend void * clock_thread_func (void * mygenerator);
+
+};          // class clock_generator
+
+/*
+ *  Free functions.
+ */
+
+extern void * clock_thread_func (void * mygenerator);
+
+}           // namespace seq64
+
+#endif      // SEQ64_CLOCK_GENERATOR_HPP
+
+/*
+ * clock_generator.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
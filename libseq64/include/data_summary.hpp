@@ -0,0 +1,167 @@
+#ifndef SEQ64_DATA_SUMMARY_HPP
+#define SEQ64_DATA_SUMMARY_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          data_summary.hpp
+ *
+ *  This module declares a class that summarizes one data lane of a pattern
+ *  (a controller, pitch wheel, velocity, and so on) at every zoom level.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  The data pane of the pattern editor draws a vertical line for each event
+ *  of the lane.  A recorded controller sweep can have tens of thousands of
+ *  events, and at low zoom most of those lines land on the same pixels.
+ *
+ *  This summary is a pyramid of levels.  Level k holds, for each span of
+ *  2^k ticks that has events, the lowest and highest value in the span,
+ *  the number of events, and whether any is selected.  A view zoomed to z
+ *  ticks per pixel uses the level with the largest span that divides z,
+ *  so it draws one column per pixel, whatever the number of events.
+ *  Each level is built from the one below it, so the whole pyramid costs
+ *  about two passes over the lane.
+ *
+ *  Tempo events, which the data pane shows in every lane, are few, and are
+ *  kept one by one, to be drawn exactly.  The summary uses no GUI toolkit.
+ */
+
+#include <cstddef>                      /* std::size_t                      */
+#include <vector>                       /* std::vector<>                    */
+
+#include "midibyte.hpp"                 /* seq64::midibyte, midipulse       */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+    class sequence;
+
+/**
+ *  The min/max pyramid of one data lane of a sequence.
+ */
+
+class data_summary
+{
+
+public:
+
+    /**
+     *  The summary of the events in one span of ticks.
+     */
+
+    struct column
+    {
+        midipulse c_tick;               /**< The first tick of the span.    */
+        int c_min;                      /**< The lowest value in the span.  */
+        int c_max;                      /**< The highest value in the span. */
+        int c_count;                    /**< The number of events in it.    */
+        bool c_selected;                /**< True if any is selected.       */
+    };
+
+    /**
+     *  A tempo event, as the data pane draws it.
+     */
+
+    struct tempo_mark
+    {
+        midipulse tm_tick;              /**< The time of the event.         */
+        int tm_value;                   /**< The height of its line.        */
+        midibpm tm_bpm;                 /**< The tempo, for its label.      */
+        bool tm_selected;               /**< True if it is selected.        */
+    };
+
+    /**
+     *  The number of levels.  The widest span, 2^(c_levels - 1) ticks, is
+     *  as wide as the maximum zoom (SEQ64_MAXIMUM_ZOOM).
+     */
+
+    static const int c_levels = 10;
+
+private:
+
+    /**
+     *  What the summary was built from.
+     */
+
+    bool m_valid;
+    midibyte m_status;
+    midibyte m_cc;
+
+    /**
+     *  The levels, each in time order.
+     */
+
+    std::vector<column> m_levels[c_levels];
+
+    /**
+     *  The tempo events, in time order.
+     */
+
+    std::vector<tempo_mark> m_tempos;
+
+public:
+
+    data_summary ();
+
+    bool current (midibyte status, midibyte cc) const;
+    void build (const sequence & seq, midibyte status, midibyte cc);
+    void clear ();
+    static int level_for (int zoom);
+    std::size_t first (int level, midipulse tick) const;
+
+    /**
+     * \getter m_levels[level]
+     *
+     * \param level
+     *      The level, which the caller must have checked.
+     */
+
+    const std::vector<column> & level (int level) const
+    {
+        return m_levels[level];
+    }
+
+    /**
+     * \getter m_tempos
+     */
+
+    const std::vector<tempo_mark> & tempos () const
+    {
+        return m_tempos;
+    }
+
+};          // class data_summary
+
+}           // namespace seq64
+
+#endif      // SEQ64_DATA_SUMMARY_HPP
+
+/*
+ * data_summary.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -0,0 +1,179 @@
+#ifndef SEQ64_DIRTY_SET_HPP
+#define SEQ64_DIRTY_SET_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          dirty_set.hpp
+ *
+ *  This module declares/defines a lock-free set of pattern numbers, used to
+ *  tell the user interface which patterns need to be redrawn.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  The set is a fixed bitmap with one bit per pattern slot.  Any thread
+ *  (the output thread toggling a mute, the input thread recording, the GUI
+ *  editing) may mark a pattern, and the GUI takes the marks back when it
+ *  draws.  Neither side locks anything, and neither side ever touches the
+ *  sequence itself, so the GUI timer no longer competes with the output
+ *  thread for the sequence mutexes just to find out that nothing changed.
+ *
+ *  Marks are not counted:  marking a pattern twice before it is taken
+ *  yields one redraw, which is all the user interface needs.
+ */
+
+#include <atomic>                       /* std::atomic<>                    */
+
+#include "globals.h"                    /* c_max_sequence                   */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  A bitmap of pattern numbers that can be marked and taken concurrently.
+ */
+
+class dirty_set
+{
+
+private:
+
+    /**
+     *  The number of bits in each word of the bitmap.
+     */
+
+    static const int c_word_bits = int(sizeof(unsigned long) * 8);
+
+    /**
+     *  The number of words needed to cover every pattern slot.
+     */
+
+    static const int c_words =
+        (c_max_sequence + c_word_bits - 1) / c_word_bits;
+
+    /**
+     *  The bitmap.  Bit (seq % c_word_bits) of word (seq / c_word_bits) is
+     *  set if pattern seq is marked.
+     */
+
+    std::atomic<unsigned long> m_words[c_words];
+
+private:
+
+    dirty_set (const dirty_set &);                  /* not copyable     */
+    dirty_set & operator = (const dirty_set &);     /* not assignable   */
+
+    /**
+     *  Provides the bit of a pattern within its word.
+     */
+
+    static unsigned long bit (int seq)
+    {
+        return 1UL << (seq % c_word_bits);
+    }
+
+public:
+
+    /**
+     *  Default constructor.  No pattern is marked.
+     */
+
+    dirty_set ()
+    {
+        clear();
+    }
+
+    /**
+     *  Unmarks every pattern.
+     */
+
+    void clear ()
+    {
+        for (int w = 0; w < c_words; ++w)
+            m_words[w].store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     *  Marks a pattern.  Callable from any thread.
+     *
+     * \param seq
+     *      The pattern number, which the caller must have checked.
+     */
+
+    void mark (int seq)
+    {
+        std::atomic<unsigned long> & word = m_words[seq / c_word_bits];
+        word.fetch_or(bit(seq), std::memory_order_release);
+    }
+
+    /**
+     *  Unmarks a pattern, telling if it was marked.
+     *
+     * \param seq
+     *      The pattern number, which the caller must have checked.
+     *
+     * \return
+     *      Returns true if the pattern was marked, in which case the caller
+     *      should redraw it.
+     */
+
+    bool take (int seq)
+    {
+        unsigned long b = bit(seq);
+        std::atomic<unsigned long> & word = m_words[seq / c_word_bits];
+        if ((word.load(std::memory_order_acquire) & b) == 0)
+            return false;                       /* the usual case, no write */
+
+        return (word.fetch_and(~b, std::memory_order_acq_rel) & b) != 0;
+    }
+
+    /**
+     *  Tells if any pattern is marked.  A view can check this once per
+     *  frame, and skip its per-pattern loop entirely when it is false.
+     */
+
+    bool any () const
+    {
+        for (int w = 0; w < c_words; ++w)
+        {
+            if (m_words[w].load(std::memory_order_acquire) != 0)
+                return true;
+        }
+        return false;
+    }
+
+};          // class dirty_set
+
+}           // namespace seq64
+
+#endif      // SEQ64_DIRTY_SET_HPP
+
+/*
+ * dirty_set.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -29,14 +29,23 @@
  * \library       sequencer64 application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2015-12-04
- * \updates       2017-07-30
+ * \updates       2026-10-18
  * \license       GNU GPLv2 or above
  *
  *  This module extends the event class to support conversions between events
  *  and human-readable (and editable) strings.
+ *
+ *  The container no longer copies every event into an editable_event.  It
+ *  holds a flat copy of the events of the sequence, taken once, in order,
+ *  and records the edits made since as deltas:  the positions of the copied
+ *  events that were deleted, and the events that were inserted.  An
+ *  editable_event, with its strings, is made only when an event is viewed
+ *  (see dref()), which the event editor does only for the rows in view.
+ *  Opening a pattern of tens of thousands of events is thus a single copy.
  */
 
 #include <map>                          /* std::multimap                */
+#include <vector>                       /* std::vector                  */
 
 #include "event_list.hpp"               /* seq64::event_list::event_key */
 #include "editable_event.hpp"           /* seq64::editable_event        */
@@ -69,36 +78,111 @@ class editable_events
 private:
 
     /**
-     *  Types to use to with the multimap implementation.  These typenames are
-     *  identical to those used in event_list, but of course they are in the
-     *  editable_events scope instead.  See the event_list class; that class
-     *  once again uses std::list, but still defines event_list::event_key for
-     *  use here.  We think the std::list implementation breaks editing, so
-     *  we're going back to the std::map implementation for the event-editor.
+     *  Types to use with the delta implementation.  The key typename is
+     *  identical to the one used in event_list, but of course it is in the
+     *  editable_events scope instead.  Inserted events are kept in a
+     *  multimap, as all the events once were, so that they sort themselves.
      */
 
     typedef event_list::event_key Key;
-    typedef std::pair<Key, editable_event> EventsPair;
-    typedef std::multimap<Key, editable_event> Events;
-    typedef Events::iterator iterator;
-    typedef Events::const_iterator const_iterator;
-    typedef Events::reverse_iterator reverse_iterator;
-    typedef Events::const_reverse_iterator const_reverse_iterator;
+    typedef std::pair<Key, event> EventsPair;
+    typedef std::vector<event> Base;
+    typedef std::multimap<Key, event> Added;
+    typedef std::vector<Base::size_type> Removed;
+
+public:
 
     /**
-     *  Holds the editable_events.  Just to be clear, since we currently do
-     *  not define SEQ64_USE_EVENT_MAP, this is an std::list container, not a
-     *  multimap.  BELAY THAT!  The multimap works better here.
+     *  Walks the events in order:  the copied events that were not deleted,
+     *  merged with the inserted events.  Among events with equal keys, the
+     *  copied ones come first, as they did when every event was inserted
+     *  into one multimap.  Like a multimap iterator, it stays valid until the
+     *  event it points to is removed.
      */
 
-    Events m_events;
+    class iterator
+    {
+        friend class editable_events;
+
+    private:
+
+        const editable_events * m_owner;    /**< The container walked.      */
+        bool m_is_added;                    /**< Is it an inserted event?   */
+        Base::size_type m_base;             /**< Position of a copied one.  */
+        Added::const_iterator m_added;      /**< Position of an added one.  */
+
+    public:
+
+        iterator ();
+
+        iterator & operator ++ ();
+        iterator & operator -- ();
+        bool operator == (const iterator & rhs) const;
+
+        /**
+         *  Post-increment, moving to the next event.
+         */
+
+        iterator operator ++ (int)
+        {
+            iterator result = *this;
+            ++*this;
+            return result;
+        }
+
+        /**
+         *  Post-decrement, moving to the previous event.
+         */
+
+        iterator operator -- (int)
+        {
+            iterator result = *this;
+            --*this;
+            return result;
+        }
+
+        /**
+         *  The complement of operator ==.
+         */
+
+        bool operator != (const iterator & rhs) const
+        {
+            return ! (*this == rhs);
+        }
+
+        editable_event operator * () const;
+
+    };
+
+    typedef iterator const_iterator;
+
+private:
+
+    /**
+     *  Holds the copy of the events of the sequence, in order.  It is never
+     *  changed after load_events().
+     */
+
+    Base m_base;
+
+    /**
+     *  Holds the positions in m_base of the events deleted since, sorted,
+     *  so that the ones before a position are found by binary search.
+     */
+
+    Removed m_removed;
+
+    /**
+     *  Holds the events inserted since, including modified events, which are
+     *  deleted and inserted again.
+     */
+
+    Added m_added;
 
     /**
      *  Points to the current event, which is the event that has just been
      *  inserted.  (From this event we can get the current time and other
-     *  parameters.)  If the container were a plain map, we could instead use
-     *  a key to access it.  But we can at least use an iterator, rather than
-     *  a bare pointer.
+     *  parameters.)
      */
 
     iterator m_current_event;
@@ -164,134 +248,66 @@ public:
 
     bool load_events ();
     bool save_events ();
+    bool get_events (event_list & evl) const;
 
-    /*
-     * Other operations:
-     *
-     *      replace event
-     *      get or format event data (for use in GUI)
-     */
-
-    /**
-     * \getter m_events
-     */
-
-    Events & events ()
-    {
-        return m_events;
-    }
-
-    /**
-     * \getter m_events.begin(), non-constant version.
-     */
-
-    iterator begin ()
-    {
-        return m_events.begin();
-    }
-
-    /**
-     * \getter m_events.begin(), constant version.
-     */
-
-    const_iterator begin () const
-    {
-        return m_events.begin();
-    }
+    iterator begin () const;
+    iterator end () const;
+    iterator at (int index) const;
+    int index_of (const iterator & ie) const;
 
     /**
-     * \getter m_events.end(), non-constant version.
-     */
-
-    iterator end ()
-    {
-        return m_events.end();
-    }
-
-    /**
-     * \getter m_events.end(), constant version.
-     */
-
-    const_iterator end () const
-    {
-        return m_events.end();
-    }
-
-    /**
-     *  Dereference access for list or map.
+     *  Makes the editable form of an event, with the strings shown by the
+     *  event editor.  It is made anew on each call, so callers should view
+     *  only the events they show.
      *
      * \param ie
-     *      Provides the iterator to the event to which to get a reference.
+     *      Provides the iterator to the event to view.
      */
 
-    static editable_event & dref (iterator ie)
+    static editable_event dref (const iterator & ie)
     {
-        return ie->second;
+        return *ie;
     }
 
     /**
-     *  Dereference const access for list or map.
-     *
-     * \param ie
-     *      Provides the iterator to the event to which to get a reference.
-     */
-
-    static const editable_event & dref (const_iterator ie)
-    {
-        return ie->second;
-    }
-
-    /**
-     *  Returns the number of events stored in m_events.  We like returning
-     *  an integer instead of size_t, and rename the function so nobody is
-     *  fooled.
+     *  Returns the number of events, the copied events that remain plus the
+     *  inserted ones.  We like returning an integer instead of size_t, and
+     *  rename the function so nobody is fooled.
      */
 
     int count () const
     {
-        return int(m_events.size());
+        return int(m_base.size() - m_removed.size() + m_added.size());
     }
 
     midipulse get_length () const;
 
     bool add (const event & e);
     bool add (const editable_event & e);
+    void remove (iterator ie);
 
     /**
-     *  Provides a wrapper for the iterator form of erase(), which is the
-     *  only one that the editable_events container uses.
+     *  Replaces an event.  Since its key might change, it is removed and
+     *  inserted again.
+     *
+     * \param ie
+     *      The event to replace, ignored if it is end().
+     *
+     * \param e
+     *      The new event.
      */
 
     bool replace (iterator ie, const editable_event & e)
     {
-        if (ie != m_events.end())           /* \change ca 2017-04-30    */
-            m_events.erase(ie);
-
+        remove(ie);
         return add(e);
     }
 
-    /**
-     *  Provides a wrapper for the iterator form of erase(), which is the
-     *  only one that sequence uses.
-     */
-
-    void remove (iterator ie)
-    {
-        if (ie != m_events.end())           /* \change ca 2017-04-30    */
-            m_events.erase(ie);
-    }
-
-    /**
-     *  Provides a wrapper for clear().
-     */
-
-    void clear ()
-    {
-        m_events.clear();
-    }
+    void clear ();
 
     /**
-     *  Sorts the event list; active only for the std::list implementation.
+     *  Sorts the event list; not needed, as the deltas keep themselves
+     *  sorted.
      */
 
     void sort ()
@@ -303,7 +319,7 @@ public:
 
     /**
      * \getter m_current_event
-     *      The caller must make sure the iterator is not Events::end().
+     *      The caller must make sure the iterator is not end().
      */
 
     iterator current_event () const
@@ -315,9 +331,9 @@ public:
      *  Validates the given iterator.
      */
 
-    bool is_valid_iterator (iterator & cit) const
+    bool is_valid_iterator (const iterator & cit) const
     {
-        return cit != m_events.end();
+        return cit != end();
     }
 
     void print () const;
@@ -336,13 +352,18 @@ private:
         m_current_event = cei;
     }
 
-#ifdef USE_VERIFY_AND_LINK                  /* not yet ready */
-    void clear_links ();
-    void verify_and_link (midipulse slength);
-    void mark_all ();
-    void unmark_all ();
-    void mark_out_of_range (midipulse slength);
-#endif
+    static bool key_before (const Key & k, const event & e);
+    static bool event_before (const event & a, const event & b);
+    const event & get (const iterator & ie) const;
+    bool is_removed (Base::size_type b) const;
+    Base::size_type removed_before (Base::size_type b) const;
+    Base::size_type base_after (const Key & k) const;
+    Base::size_type next_base (Base::size_type b) const;
+    Base::size_type prev_base (Base::size_type b) const;
+    iterator make_base (Base::size_type b) const;
+    iterator make_added (Added::const_iterator a) const;
+    iterator next (const iterator & ie) const;
+    iterator prev (const iterator & ie) const;
 
 };          // class editable_events
 
@@ -28,7 +28,7 @@
  * \library       sequencer64 application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2015-09-19
- * \updates       2017-07-30
+ * \updates       2026-10-18
  * \license       GNU GPLv2 or above
  *
  *  This module extracts the event-list functionality from the sequencer
@@ -45,11 +45,20 @@
  *  release mode, and a lot faster in debug mode.  Why?  Probably because
  *  the std::list implementation calls std::list::sort() a lot, and the
  *  std::multimap implementation is a lot faster at sorting.
+ *
+ *  An event list can also be "deferred":  it holds an event_list::loader
+ *  instead of events, and the loader decodes the events the first time the
+ *  list is used.  See realize().  The flags of a deferred list are those
+ *  the loader will produce, given to defer() when the track was indexed,
+ *  so that asking for them does not force the decoding.
  */
 
+#include <atomic>                       /* std::atomic<>                */
 #include <string>
 #include <stack>
+#include <vector>
 
+#include "mutex.hpp"                    /* seq64::mutex, automutex      */
 #include "seq64_features.h"             /* SEQ64_USE_EVENT_MAP          */
 
 #ifdef SEQ64_USE_EVENT_MAP
@@ -95,6 +104,7 @@ class event_list
     friend class sequence;              // tritto
     friend class seqdata;               // quaditto
     friend class seqevent;              // quintitto
+    friend class session_cache;         // access to append_in_order()
 
 private:
 
@@ -153,6 +163,52 @@ private:
     typedef Events::reverse_iterator reverse_iterator;
     typedef Events::const_reverse_iterator const_reverse_iterator;
 
+    /**
+     *  Holds the positions of events that were just inserted, so that a
+     *  caller can link or otherwise adjust only the new events instead of
+     *  the whole container.
+     */
+
+    typedef std::vector<iterator> Iterators;
+
+    /**
+     *  Holds read-only positions, as used by the seek index.
+     */
+
+    typedef std::vector<const_iterator> ConstIterators;
+
+    /**
+     *  Supplies the events of a deferred event list.  The midifile parser
+     *  can index a track without decoding its events, and attach one of
+     *  these to the sequence's event list instead.  The event list owns the
+     *  loader, and deletes it after using it.
+     */
+
+    class loader
+    {
+
+    public:
+
+        virtual ~loader ()
+        {
+            // Empty body
+        }
+
+        /**
+         *  Makes a copy of this loader, for a copy of the event list.
+         */
+
+        virtual loader * clone () const = 0;
+
+        /**
+         *  Decodes the events into the given list, which is empty.  Called
+         *  at most once per loader, and possibly on any thread.
+         */
+
+        virtual bool load (event_list & evl) = 0;
+
+    };
+
 private:
 
     /**
@@ -188,6 +244,77 @@ private:
 
     bool m_has_time_signature;
 
+    /**
+     *  If not null, the events have not been decoded yet, and m_events is
+     *  empty.  The first use of the list calls realize(), which hands the
+     *  list to this loader, then deletes it and sets this pointer to null.
+     *  It is atomic because the realization can be done by a prefetch
+     *  thread while other threads look at the list.
+     */
+
+    mutable std::atomic<loader *> m_loader;
+
+    /**
+     *  Serializes the realization of this list, and the copying of its
+     *  loader.  Each list has its own lock, so that the decoding of one
+     *  track never holds up a thread that uses another.
+     */
+
+    mutable mutex m_loader_mutex;
+
+    /**
+     *  The seek index, a sorted sample of every c_seek_stride'th position
+     *  in the list, used by seek() to binary-search to a time instead of
+     *  walking the list from the start.  It is built on first use, and
+     *  dropped (see unindex()) by every function that adds, removes,
+     *  reorders, or relinks events, so that it never holds a dead
+     *  position.  The exceptions are the functions used to merge recorded
+     *  events, insert_sorted(), merge_new(), and link_new_event(), which
+     *  keep it up to date instead, since a list insertion leaves the other
+     *  positions alone; and remove(), which drops it only if the removed
+     *  event is in it.  Like the rest of the list, it relies on the owner
+     *  (the sequence) to serialize access.
+     */
+
+    mutable ConstIterators m_seek_index;
+
+    /**
+     *  Built with the seek index:  the number of events from each sample
+     *  up to the next one.  It grows as events are inserted, and a gap that
+     *  reaches twice c_seek_stride is split (see index_inserted()).  It
+     *  can be too high after remove(), but never too low.
+     */
+
+    mutable std::vector<int> m_seek_counts;
+
+    /**
+     *  Built with the seek index:  the note-ons and tempos whose extent
+     *  does not fit within m_seek_longest of their start, namely notes
+     *  that wrap around the end of the pattern, and tempos that run to
+     *  the end of it.
+     */
+
+    mutable ConstIterators m_seek_strays;
+
+    /**
+     *  Built with the seek index:  the longest extent of a linked note-on
+     *  (or tempo) that is not a stray.
+     */
+
+    mutable midipulse m_seek_longest;
+
+    /**
+     *  True if the seek index and its companions are up to date.
+     */
+
+    mutable bool m_seek_valid;
+
+    /**
+     *  The number of events between the samples of the seek index.
+     */
+
+    static const int c_seek_stride = 64;
+
 public:
 
     event_list ();
@@ -201,6 +328,7 @@ public:
 
     iterator begin ()
     {
+        realize();
         return m_events.begin();
     }
 
@@ -210,11 +338,14 @@ public:
 
     const_iterator begin () const
     {
+        realize();
         return m_events.begin();
     }
 
     /**
-     * \getter m_events.end(), non-constant version.
+     * \getter m_events.end(), non-constant version.  This iterator is the
+     *      same before and after realize(), so there is no need to realize
+     *      the list here.
      */
 
     iterator end ()
@@ -239,6 +370,7 @@ public:
 
     int count () const
     {
+        realize();
         return int(m_events.size());
     }
 
@@ -252,6 +384,7 @@ public:
 
     bool empty () const
     {
+        realize();
         return m_events.empty();
     }
 
@@ -304,13 +437,16 @@ public:
 
     void push_back (const event & e)
     {
+        realize();
         m_events.push_back(e);
+        unindex();
     }
 
 #endif
 
     /**
      * \getter m_is_modified
+     *      A deferred list is not decoded; see defer().
      */
 
     bool is_modified () const
@@ -320,6 +456,7 @@ public:
 
     /**
      * \getter m_has_tempo
+     *      A deferred list is not decoded; see defer().
      */
 
     bool has_tempo () const
@@ -329,6 +466,7 @@ public:
 
     /**
      * \getter m_has_time_signature
+     *      A deferred list is not decoded; see defer().
      */
 
     bool has_time_signature () const
@@ -344,6 +482,7 @@ public:
 
     void unmodify ()
     {
+        realize();
         m_is_modified = false;
     }
 
@@ -358,6 +497,7 @@ public:
 
     void remove (iterator ie)
     {
+        index_removed(ie);
         m_events.erase(ie);
         m_is_modified = true;
     }
@@ -368,8 +508,10 @@ public:
 
     void clear ()
     {
+        realize();
         m_events.clear();
         m_is_modified = true;
+        unindex();
     }
 
     void merge (event_list & el, bool presort = true);
@@ -383,10 +525,44 @@ public:
 #ifdef SEQ64_USE_EVENT_MAP
         // we need nothin' for sorting a multimap
 #else
+        realize();
         m_events.sort();
+        unindex();
 #endif
     }
 
+    void defer
+    (
+        loader * ld, bool modified = false,
+        bool hastempo = false, bool hastimesig = false
+    );
+    const_iterator seek (midipulse tick) const;
+    iterator seek (midipulse tick);
+    midipulse longest_span () const;
+    const ConstIterators & strays () const;
+
+    /**
+     *  Decodes the events now, if the list is deferred.  Every function that
+     *  uses m_events calls this first; once the list is realized, the cost
+     *  is one atomic load.
+     */
+
+    void realize () const
+    {
+        if (not_nullptr(m_loader.load(std::memory_order_acquire)))
+            load_deferred();
+    }
+
+    /**
+     * \getter m_loader
+     *      Returns true if the events have not been decoded yet.
+     */
+
+    bool deferred () const
+    {
+        return not_nullptr(m_loader.load(std::memory_order_acquire));
+    }
+
     /**
      *  Dereference access for list or map.
      *
@@ -427,6 +603,11 @@ private:                                // functions for friend sequence
      */
 
     void link_new ();
+    bool link_new_event (iterator ev, iterator & partner);
+    event & append_in_order (const event & e);
+    void append_split (const event & e, iterator & ties);
+    iterator insert_sorted (const event & e);
+    void merge_new (event_list & el, Iterators & added);
     void clear_links ();
     void verify_and_link (midipulse slength);
     void link_tempos ();
@@ -443,6 +624,57 @@ private:                                // functions for friend sequence
     void select_all ();
     void unselect_all ();
     void print () const;
+    void take (event_list & source);
+    void load_deferred () const;
+    void splice_events (event_list & source);
+
+    /**
+     *  Raises the modified flag, plus the tempo and time-signature flags if
+     *  the added event is one of those Meta events, so that we do not force
+     *  the current tempo and time-signature when writing the MIDI file.
+     */
+
+    void set_added_flags (const event & e)
+    {
+        mark_added(e);
+        unindex();
+    }
+
+    /**
+     *  Raises the flags as set_added_flags() does, but leaves the seek
+     *  index to the caller.
+     */
+
+    void mark_added (const event & e)
+    {
+        m_is_modified = true;
+        if (e.is_tempo())
+            m_has_tempo = true;
+
+        if (e.is_time_signature())
+            m_has_time_signature = true;
+    }
+
+    /**
+     *  Drops the seek index, to be rebuilt on the next seek().  Called by
+     *  every function that adds, removes, reorders, or relinks events.
+     */
+
+    void unindex ()
+    {
+        m_seek_valid = false;
+    }
+
+    void build_index () const;
+
+private:
+
+    void index_inserted (const_iterator pos);
+    void index_linked (const_iterator on);
+    void index_removed (const_iterator pos);
+    void split_gap (std::size_t k);
+
+public:
 
     /**
      * \getter m_events
@@ -450,6 +682,7 @@ private:                                // functions for friend sequence
 
     const Events & events () const
     {
+        realize();
         return m_events;
     }
 
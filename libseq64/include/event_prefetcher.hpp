@@ -0,0 +1,127 @@
+#ifndef SEQ64_EVENT_PREFETCHER_HPP
+#define SEQ64_EVENT_PREFETCHER_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          event_prefetcher.hpp
+ *
+ *  This module declares a class that decodes deferred sequences on a
+ *  background thread.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  With the [lazy-loading] option, midifile::parse() only indexes the tracks
+ *  of a file; the events of each sequence are decoded the first time the
+ *  sequence is played, edited, or drawn (see event_list::realize()).  To
+ *  keep that decoding out of the way of the user and of the output thread,
+ *  the perform object hands the sequences of the current and next
+ *  screen-sets, and the sequences about to be played in Song mode, to this
+ *  class, which decodes them one at a time on its own thread.
+ *
+ *  The thread is started by the first request, so nothing runs when lazy
+ *  loading is off.  The lock is held while a sequence is decoded, so that
+ *  forget() can guarantee that a sequence about to be deleted is not in
+ *  use.  The output thread never decodes:  it skips a sequence that is not
+ *  decoded yet, and calls hurry(), which does not wait for the lock.
+ */
+
+#include <deque>                        /* std::deque<>                     */
+#include <vector>                       /* std::vector<>                    */
+#include <pthread.h>                    /* pthread_t C structure            */
+
+#include "mutex.hpp"                    /* seq64::condition_var             */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+    class sequence;
+
+/**
+ *  Decodes deferred sequences in the background.  Not copyable.
+ */
+
+class event_prefetcher
+{
+
+private:
+
+    /**
+     *  Protects the members below, wakes the thread when there is work, and
+     *  is held while a sequence is decoded.
+     */
+
+    condition_var m_condition;
+
+    /**
+     *  The prefetch thread, and whether it still needs to be joined.
+     */
+
+    pthread_t m_thread;
+    bool m_thread_launched;
+
+    /**
+     *  Tells the thread to exit.
+     */
+
+    bool m_stop;
+
+    /**
+     *  The sequences still to be decoded, in order of priority.
+     */
+
+    std::deque<sequence *> m_queue;
+
+public:
+
+    event_prefetcher ();
+    ~event_prefetcher ();
+
+    void request (const std::vector<sequence *> & seqs);
+    void hurry (sequence * s);
+    void forget (sequence * s);
+    void stop ();
+
+private:
+
+    event_prefetcher (const event_prefetcher &);            /* no copy      */
+    event_prefetcher & operator = (const event_prefetcher &);   /* no copy  */
+
+    bool launch ();
+    void run ();
+    static void * prefetch_thread_func (void * myprefetcher);
+
+};          // class event_prefetcher
+
+}           // namespace seq64
+
+#endif      // SEQ64_EVENT_PREFETCHER_HPP
+
+/*
+ * event_prefetcher.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
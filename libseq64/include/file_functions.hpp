@@ -36,6 +36,11 @@ extern bool file_accessible (const std::string & targetfile);
 extern bool file_executable (const std::string & targetfile);
 extern bool file_is_directory (const std::string & targetfile);
 extern bool make_directory (const std::string & pathname);
+extern std::string file_real_path (const std::string & filename);
+extern bool file_replace
+(
+    const std::string & source, const std::string & target
+);
 
 #endif      // SEQ64_FILE_FUNCTIONS_HPP
 
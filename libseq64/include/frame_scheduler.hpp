@@ -0,0 +1,199 @@
+#ifndef SEQ64_FRAME_SCHEDULER_HPP
+#define SEQ64_FRAME_SCHEDULER_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          frame_scheduler.hpp
+ *
+ *  This module declares a class that picks the redraw period of a window
+ *  and measures what each redraw costs.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  Every window used to redraw on a fixed timer, usr().window_redraw_rate(),
+ *  whether the transport was running or not, and whether the window could
+ *  be seen or not.  With several editors open, that is a lot of work for
+ *  the GUI thread, which competes with the output thread for the CPU.
+ *
+ *  A frame scheduler starts from that fixed period, and stretches it:
+ *
+ *      -   Running, window focused:  the base period.
+ *      -   Running, window unfocused:  twice the base period.
+ *      -   Stopped:  five times the base period.  Nothing moves, and the
+ *          frame only has to notice changes made by other threads.
+ *      -   Window hidden or iconified:  ten times the base period.
+ *
+ *  If the frames themselves grow costly, taking more than a quarter of the
+ *  period on average, the period is doubled (up to the hidden period), so
+ *  that the GUI never takes more than about a quarter of a CPU.
+ *
+ *  The cost of each frame is timed on the monotonic clock.  The last,
+ *  average, and worst costs are kept, for display or for the --verbose
+ *  statistics.  The scheduler uses no GUI toolkit.
+ */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  The redraw rate and cost of one window.
+ */
+
+class frame_scheduler
+{
+
+private:
+
+    /**
+     *  The period of the fixed timer this scheduler replaces, in ms.
+     */
+
+    int m_base_period_ms;
+
+    /**
+     *  The period currently chosen, in ms.
+     */
+
+    int m_period_ms;
+
+    /**
+     *  The start of the frame in progress, in microseconds on the monotonic
+     *  clock, or 0 outside of a frame.
+     */
+
+    long long m_frame_start_us;
+
+    /**
+     *  The number of frames measured.
+     */
+
+    long m_frames;
+
+    /**
+     *  The cost of the last frame, in microseconds.
+     */
+
+    long m_last_cost_us;
+
+    /**
+     *  The moving average of the frame costs, in microseconds.  Each new
+     *  frame counts for 1/8 of it.
+     */
+
+    long m_average_cost_us;
+
+    /**
+     *  The worst frame cost, in microseconds.
+     */
+
+    long m_max_cost_us;
+
+public:
+
+    frame_scheduler (int base_period_ms);
+
+    bool update (bool running, bool visible, bool focused);
+    void begin_frame ();
+    void end_frame ();
+    static long long now_us ();
+
+    /**
+     * \getter m_base_period_ms
+     */
+
+    int base_period_ms () const
+    {
+        return m_base_period_ms;
+    }
+
+    /**
+     * \getter m_period_ms
+     */
+
+    int period_ms () const
+    {
+        return m_period_ms;
+    }
+
+    /**
+     * \getter m_frames
+     */
+
+    long frames () const
+    {
+        return m_frames;
+    }
+
+    /**
+     * \getter m_last_cost_us
+     */
+
+    long last_cost_us () const
+    {
+        return m_last_cost_us;
+    }
+
+    /**
+     * \getter m_average_cost_us
+     */
+
+    long average_cost_us () const
+    {
+        return m_average_cost_us;
+    }
+
+    /**
+     * \getter m_max_cost_us
+     */
+
+    long max_cost_us () const
+    {
+        return m_max_cost_us;
+    }
+
+    /**
+     *  Provides the share of the GUI thread that the frames take, in
+     *  percent, from the average cost and the current period.
+     */
+
+    int load_percent () const
+    {
+        return int(m_average_cost_us / (10L * m_period_ms));
+    }
+
+};          // class frame_scheduler
+
+}           // namespace seq64
+
+#endif      // SEQ64_FRAME_SCHEDULER_HPP
+
+/*
+ * frame_scheduler.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -0,0 +1,183 @@
+#ifndef SEQ64_INPUT_REACTOR_HPP
+#define SEQ64_INPUT_REACTOR_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          input_reactor.hpp
+ *
+ *  This module declares a class that lets the input thread wait on all of
+ *  the MIDI input sources at once.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  The input thread used to call poll() with a one-second timeout on the
+ *  ALSA descriptors only, re-allocating the descriptor array on every port
+ *  hot-plug; JACK input was found by sleeping a millisecond and checking the
+ *  queues; and shutdown had to wait for the timeout to expire.
+ *
+ *  The input_reactor is a Linux epoll set holding:
+ *
+ *      -   Any number of source descriptors, such as the ALSA sequencer's
+ *          poll descriptors (or, later, local control sockets), added with
+ *          add_source().
+ *      -   A "notify" eventfd, which a producer that has no descriptor of its
+ *          own (the JACK process callback) bumps with notify() after
+ *          queueing input.
+ *      -   A "wake" eventfd, bumped by wake() to make wait() return at once,
+ *          for example when the input thread must exit.
+ *
+ *  All are edge-triggered.  A source that fires is remembered, and is
+ *  checked again (without blocking) by the next wait(), so that input left
+ *  in the kernel after the consumer has drained its buffer is not stranded.
+ *  The consumer drains everything available after each wait(), as
+ *  perform::input_func() already does.
+ *
+ *  On other platforms, valid() is false and the old polling is used.
+ */
+
+#include <atomic>                       /* std::atomic<>                    */
+#include <vector>                       /* std::vector<>                    */
+
+#include "mutex.hpp"                    /* seq64::mutex, automutex          */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Multiplexes the MIDI input sources for the input thread.  Only one thread
+ *  may call wait(); any thread may call the other functions.
+ */
+
+class input_reactor
+{
+
+private:
+
+    /**
+     *  The epoll descriptor, or -1 if it could not be created.
+     */
+
+    int m_epoll_fd;
+
+    /**
+     *  The eventfd used by wake().
+     */
+
+    int m_wake_fd;
+
+    /**
+     *  The eventfd used by notify().  It is added to the epoll set only by
+     *  enable_notify().
+     */
+
+    int m_notify_fd;
+
+    /**
+     *  True once enable_notify() has been called.
+     */
+
+    std::atomic<bool> m_notify_enabled;
+
+    /**
+     *  The source descriptors in the epoll set.  Protected by m_mutex.
+     */
+
+    std::vector<int> m_sources;
+
+    /**
+     *  The number of sources that can produce input, counting the notify
+     *  descriptor once enabled.  Zero means that the caller should fall back
+     *  to its own polling.
+     */
+
+    std::atomic<int> m_source_count;
+
+    /**
+     *  The sources reported ready by the last wait().  Used only by the
+     *  waiting thread.
+     */
+
+    std::vector<int> m_pending;
+
+    /**
+     *  Protects m_sources.
+     */
+
+    mutex m_mutex;
+
+public:
+
+    input_reactor ();
+    ~input_reactor ();
+
+    bool add_source (int fd);
+    bool remove_source (int fd);
+    bool enable_notify ();
+    int wait (int timeout_ms);
+    void wake ();
+    void notify ();
+
+    /**
+     * \getter m_epoll_fd
+     *      Returns true if the epoll set and the wake descriptor exist.
+     */
+
+    bool valid () const
+    {
+        return m_epoll_fd >= 0 && m_wake_fd >= 0;
+    }
+
+    /**
+     * \getter m_source_count
+     *      Returns true if the reactor is valid and has something to wait
+     *      for.
+     */
+
+    bool active () const
+    {
+        return valid() && m_source_count > 0;
+    }
+
+private:
+
+    input_reactor (const input_reactor &);                  /* no copy      */
+    input_reactor & operator = (const input_reactor &);     /* no copy      */
+
+    bool still_ready ();
+
+};          // class input_reactor
+
+}           // namespace seq64
+
+#endif      // SEQ64_INPUT_REACTOR_HPP
+
+/*
+ * input_reactor.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
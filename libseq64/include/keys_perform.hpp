@@ -61,6 +61,7 @@
 #include <string>                       /* std::string                      */
 
 #include "easy_macros.h"
+#include "seq64_features.h"             /* SEQ64_SONG_RECORDING             */
 
 /*
  *  Do not document a namespace; it breaks Doxygen.
@@ -128,6 +129,13 @@ struct keys_perform_transfer
 
 #endif
 
+    /*
+     * Playlist support
+     */
+
+    unsigned kpt_playlist_prev;
+    unsigned kpt_playlist_next;
+
 };
 
 /**
@@ -256,6 +264,8 @@ private:
     unsigned m_key_song_record;             /**< Turn on song-record.   */
     unsigned m_key_oneshot_queue;           /**< Turn on 1-shot record. */
 #endif
+    unsigned m_key_playlist_prev;           /**< Previous playlist song. */
+    unsigned m_key_playlist_next;           /**< Next playlist song.    */
 
 public:
 
@@ -778,6 +788,26 @@ public:
 
 #endif  // SEQ64_SONG_RECORDING
 
+    unsigned playlist_prev () const
+    {
+        return m_key_playlist_prev;
+    }
+
+    void playlist_prev (unsigned key)
+    {
+        m_key_playlist_prev = key;
+    }
+
+    unsigned playlist_next () const
+    {
+        return m_key_playlist_next;
+    }
+
+    void playlist_next (unsigned key)
+    {
+        m_key_playlist_next = key;
+    }
+
     /**
      * \getter m_key_show_ui_sequency_key
      *
@@ -1167,6 +1197,26 @@ protected:
         return &m_key_tap_bpm;
     }
 
+    /**
+     * \getter m_key_playlist_prev
+     *  Address getter for the previous-song operation.
+     */
+
+    unsigned * at_playlist_prev ()
+    {
+        return &m_key_playlist_prev;
+    }
+
+    /**
+     * \getter m_key_playlist_next
+     *  Address getter for the next-song operation.
+     */
+
+    unsigned * at_playlist_next ()
+    {
+        return &m_key_playlist_next;
+    }
+
 #ifdef SEQ64_SONG_RECORDING
 
     /**
@@ -0,0 +1,140 @@
+#ifndef SEQ64_MAPPED_FILE_HPP
+#define SEQ64_MAPPED_FILE_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          mapped_file.hpp
+ *
+ *  This module declares a small class providing a read-only view of a whole
+ *  file.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  On POSIX systems the file is memory-mapped, so that opening even a
+ *  multi-megabyte MIDI file costs no copying; pages are read in by the
+ *  kernel as the parser walks forward.  Elsewhere, or if mapping fails (for
+ *  example, on a pipe), the file is read into a buffer owned by this object.
+ *  Either way, the caller just sees data() and size().
+ */
+
+#include <cstddef>                      /* std::size_t                      */
+#include <string>                       /* std::string                      */
+#include <vector>                       /* std::vector<>                    */
+
+#include "midibyte.hpp"                 /* seq64::midibyte                  */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Holds a read-only view of a file, mapped or copied.  Not copyable.
+ */
+
+class mapped_file
+{
+
+private:
+
+    /**
+     *  The start of the mapping, or null if the file is not mapped.
+     */
+
+    void * m_map;
+
+    /**
+     *  The file contents, used only when the file could not be mapped.
+     */
+
+    std::vector<midibyte> m_buffer;
+
+    /**
+     *  Points to the file data, in either m_map or m_buffer.
+     */
+
+    const midibyte * m_data;
+
+    /**
+     *  The size of the file, in bytes.
+     */
+
+    std::size_t m_size;
+
+public:
+
+    mapped_file ();
+    ~mapped_file ();
+
+    bool open (const std::string & filename);
+    void close ();
+
+    /**
+     * \getter m_data
+     */
+
+    const midibyte * data () const
+    {
+        return m_data;
+    }
+
+    /**
+     * \getter m_size
+     */
+
+    std::size_t size () const
+    {
+        return m_size;
+    }
+
+    /**
+     * \getter m_map
+     *      Returns true if the file is memory-mapped, rather than copied.
+     */
+
+    bool mapped () const
+    {
+        return m_map != nullptr;
+    }
+
+private:
+
+    mapped_file (const mapped_file &);                      /* no copy      */
+    mapped_file & operator = (const mapped_file &);         /* no copy      */
+
+    bool read_all (const std::string & filename);
+
+};          // class mapped_file
+
+}           // namespace seq64
+
+#endif      // SEQ64_MAPPED_FILE_HPP
+
+/*
+ * mapped_file.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
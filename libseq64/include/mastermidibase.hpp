@@ -36,11 +36,14 @@
  *  PortMidi.
  */
 
+#include <atomic>                       /* for the published buss list      */
 #include <vector>                       /* for channel-filtered recording   */
 
 #include "businfo.hpp"                  /* seq64::businfo & busarray        */
+#include "input_reactor.hpp"            /* seq64::input_reactor             */
 #include "midibus_common.hpp"
 #include "mutex.hpp"
+#include "note_tracker.hpp"             /* seq64::note_tracker              */
 #include "user_midi_bus.hpp"
 
 /*
@@ -51,6 +54,7 @@ namespace seq64
 {
     class event;
     class midibus;
+    class offline_render;
     class sequence;
 
 /**
@@ -78,6 +82,16 @@ protected:
 
     midibus * m_bus_announce;
 
+    /**
+     *  Serializes output on the MIDI handle when all of the busses share one
+     *  (see api_shared_handle()).  In that case every buss uses this lock
+     *  instead of its own, and letting go of it sends the events queued on
+     *  any of them.  Also held by flush() around api_flush().  Declared
+     *  before the buss arrays, so that it outlives the busses.
+     */
+
+    bus_lock m_handle_mutex;
+
     /**
      *  Encapsulates information about the input busses.
      */
@@ -157,11 +171,67 @@ protected:
 
     /**
      *  The locking mutex.  This object is passed to an automutex object that
-     *  lends exception-safety to the mutex locking.
+     *  lends exception-safety to the mutex locking.  It protects the buss
+     *  arrays against changes, but is no longer taken to play, clock, or
+     *  flush; each buss serializes its own output.
      */
 
     mutex m_mutex;
 
+    /**
+     *  Lets the input thread sleep on all of the input sources at once.  The
+     *  backends add their descriptors (or enable notification) when they
+     *  set up their input; if they add none, poll_for_midi() falls back to
+     *  api_poll_for_midi().
+     */
+
+    input_reactor m_input_reactor;
+
+private:
+
+    /**
+     *  A copy of the output buss list, as used by the playback functions.
+     */
+
+    typedef std::vector<businfo> bus_snapshot;
+
+    /**
+     *  The currently published copy of the output busses.  The playback
+     *  functions read it without locking.  Writers (port hot-plugging, for
+     *  example) build a new copy under m_mutex and swap it in, RCU-style;
+     *  see publish_buses().  Null until activate() is called.
+     */
+
+    std::atomic<bus_snapshot *> m_out_buses;
+
+    /**
+     *  The number of threads currently reading m_out_buses.  A retired copy
+     *  is deleted only once this count has been seen at zero after the swap.
+     */
+
+    std::atomic<int> m_out_readers;
+
+    /**
+     *  Copies that have been replaced but might still be in use by a reader.
+     *  Protected by m_mutex.
+     */
+
+    std::vector<bus_snapshot *> m_retired_buses;
+
+    /**
+     *  Remembers the notes sounding on each output buss and channel, as fed
+     *  by play(), so that panic() can turn off just those notes.
+     */
+
+    note_tracker m_note_tracker;
+
+    /**
+     *  While an offline render is running, play() hands every event to it
+     *  instead of to the busses.  Null otherwise.
+     */
+
+    std::atomic<offline_render *> m_render;
+
 public:
 
     mastermidibase
@@ -294,10 +364,11 @@ public:
     void continue_from (midipulse tick);
     void init_clock (midipulse tick);
     void emit_clock (midipulse tick);
+    int get_clock_buses (std::vector<midibus *> & buses);
     void sysex (event * event);
     void print () const;
     void flush ();
-    void panic ();                                          /* kepler34 func  */
+    void panic (bool controllers = false);                  /* kepler34 func  */
     void set_sequence_input (bool state, sequence * seq);
     void dump_midi_input (event in);                        /* seq32 function */
     bool initialize_buses ();
@@ -307,8 +378,32 @@ public:
 
     int poll_for_midi ();
     bool is_more_input ();
+    void wake_input ();
     bool get_midi_event (event * in);
 
+    /**
+     *  Tells the backend which tick the performance is playing, before the
+     *  sequences send their events for it.  Only the loop-back backend,
+     *  which stamps its output with the tick, makes use of it.
+     */
+
+    void play_position (midipulse tick)
+    {
+        api_play_position(tick);
+    }
+
+    /**
+     *  Sends the output to an offline render, or back to the busses.
+     *
+     * \param r
+     *      The renderer, or null to stop rendering.
+     */
+
+    void render_to (offline_render * r)
+    {
+        m_render.store(r, std::memory_order_release);
+    }
+
     bool set_clock (bussbyte bus, clock_e clock_type);
     bool set_input (bussbyte bus, bool inputing);
     bool get_input (bussbyte bus);
@@ -352,9 +447,25 @@ protected:
         if (result)
             result = m_outbus_array.initialize();
 
+        if (result)
+            publish_buses();
+
         return result;
     }
 
+    /**
+     *  Indicates that all of the busses write through one MIDI handle, which
+     *  cannot be used by two threads at once.  The ALSA implementations
+     *  return true.  Then all of the busses share m_handle_mutex.
+     */
+
+    virtual bool api_shared_handle () const
+    {
+        return false;
+    }
+
+    void publish_buses ();
+
     virtual void api_init (int ppqn, midibpm bpm) = 0;
 
     /**
@@ -432,6 +543,16 @@ protected:
         // no code for base, alsmidi, or portmidi
     }
 
+    /**
+     *  Provides MIDI API-specific functionality for the play_position()
+     *  function.
+     */
+
+    virtual void api_play_position (midipulse /* tick */)
+    {
+        // no code for base, alsamidi, portmidi, or rtmidi
+    }
+
     virtual void api_port_start (int /* client */, int /* port */)
     {
         // no code for portmidi
@@ -454,6 +575,30 @@ protected:
 
 private:
 
+    /**
+     *  Starts a read of the published output busses.  Must be paired with
+     *  release_buses().
+     *
+     * \return
+     *      Returns the current copy, which might be null.
+     */
+
+    bus_snapshot * acquire_buses ()
+    {
+        m_out_readers.fetch_add(1);
+        return m_out_buses.load();
+    }
+
+    /**
+     *  Ends a read started by acquire_buses().
+     */
+
+    void release_buses ()
+    {
+        m_out_readers.fetch_sub(1);
+    }
+
+    void reclaim_buses ();
     bool save_clock (bussbyte bus, clock_e clock);
     bool save_input (bussbyte bus, bool inputing);
 #if 0
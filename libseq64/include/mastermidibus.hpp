@@ -37,6 +37,8 @@
 
 #if defined SEQ64_ALSAMIDI_SUPPORT
 #include "mastermidibus_am.hpp"         /* seq64::mastermidibus for ALSA    */
+#elif defined SEQ64_LOOPMIDI_SUPPORT
+#include "mastermidibus_lm.hpp"         /* seq64::mastermidibus, loop-back  */
 #elif defined SEQ64_RTMIDI_SUPPORT
 #include "mastermidibus_rm.hpp"         /* seq64::mastermidibus for RtMidi  */
 #elif defined SEQ64_PORTMIDI_SUPPORT
@@ -28,7 +28,7 @@
  * \library       sequencer64 application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2015-10-10
- * \updates       2017-09-11
+ * \updates       2026-10-18
  * \license       GNU GPLv2 or above
  *
  *  This class is meant to hold the bytes that represent MIDI events and other
@@ -37,6 +37,7 @@
 
 #include <cstddef>                      /* std::size_t          */
 #include <string>                       /* std::string          */
+#include <vector>                       /* std::vector          */
 
 #include "app_limits.h"                 /* SEQ64_NULL_SEQUENCE  */
 #include "midibyte.hpp"                 /* seq64::midibyte      */
@@ -228,6 +229,24 @@ class midi_container
 
 private:
 
+    /**
+     *  One event of the sequence, encoded once by encode_song_events() for
+     *  song_fill_seq_event(), which emits the events of the pattern once for
+     *  each repetition of each trigger.  Only the delta time differs from
+     *  one repetition to the next.
+     */
+
+    struct song_event
+    {
+        midipulse se_timestamp;         /**< The time-stamp of the event.   */
+        const event * se_event;         /**< The event, for SysEx and Meta. */
+        bool se_note_on;                /**< The event is a Note On.        */
+        bool se_note_off;               /**< The event is a Note Off.       */
+        midibyte se_note;               /**< The note number, if a note.    */
+        midibyte se_size;               /**< Bytes in se_bytes, 0 if ex.    */
+        midibyte se_bytes[3];           /**< The status and data bytes.     */
+    };
+
     /**
      *  Provide a hook into a sequence so that we can exchange data with a
      *  sequence object.
@@ -235,6 +254,21 @@ private:
 
     sequence & m_sequence;
 
+    /**
+     *  The encoded events of the sequence, for exporting a song.  Empty
+     *  until the first call to song_fill_seq_event().
+     */
+
+    std::vector<song_event> m_song_events;
+
+    /**
+     *  Indicates that m_song_events is in time-stamp order, as it should
+     *  be, so that song_fill_seq_event() can skip the events outside of a
+     *  trigger without looking at them.
+     */
+
+    bool m_song_events_sorted;
+
     /**
      *  Provides the position in the container when making a series of get()
      *  calls on the container.
@@ -255,7 +289,7 @@ public:
         // empty body
     }
 
-    void fill (int tracknumber, const perform & p);
+    void fill (int tracknumber, const midi_timing & mt);
 
     /**
      *  Returns the size of the container, in midibytes.  Must be overridden
@@ -285,6 +319,24 @@ public:
 
     virtual void put (midibyte b) = 0;
 
+    /**
+     *  Adds a number of MIDI bytes to the container at once, such as a whole
+     *  event.  This default puts them one at a time; a derived class can do
+     *  better.
+     *
+     * \param b
+     *      Points to the bytes to add.
+     *
+     * \param count
+     *      The number of bytes to add.
+     */
+
+    virtual void put_bytes (const midibyte * b, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+            put(b[i]);
+    }
+
     /**
      *  Provide a way to get the next byte from the container.  It also
      *  increments m_position_for_get.
@@ -333,6 +385,10 @@ protected:
 
 private:
 
+    static int encode_variable (midipulse v, midibyte * b);
+    int encode_event (const event & e, midibyte * b) const;
+    void encode_song_events ();
+    static bool song_event_before (const song_event & se, midipulse ts);
     void add_variable (midipulse v);
     void add_long (midipulse x);
     void add_short (midishort x);
@@ -344,12 +400,12 @@ private:
     void fill_proprietary ();
     void fill_time_sig_and_tempo
     (
-        const perform & p,
+        const midi_timing & mt,
         bool has_time_sig = false,
         bool has_tempo    = false
     );
-    void fill_time_sig (const perform & p);
-    void fill_tempo (const perform & p);
+    void fill_time_sig (const midi_timing & mt);
+    void fill_tempo (const midi_timing & mt);
     midipulse song_fill_seq_event
     (
         const trigger & trig, midipulse prev_timestamp
@@ -96,7 +96,7 @@ const int c_midi_control_thru         = c_midi_track_ctrl + 13;
 const int c_midi_control_bpm_page_up  = c_midi_track_ctrl + 14;
 const int c_midi_control_bpm_page_dn  = c_midi_track_ctrl + 15;
 const int c_midi_control_ss_set       = c_midi_track_ctrl + 16; /* pull #85 */
-const int c_midi_control_17           = c_midi_track_ctrl + 17;
+const int c_midi_control_playlist     = c_midi_track_ctrl + 17; /* songs    */
 const int c_midi_control_18           = c_midi_track_ctrl + 18;
 const int c_midi_control_19           = c_midi_track_ctrl + 19;
 const int c_midi_controls_extended    = c_midi_track_ctrl + 20; /* new = 84 */
@@ -27,7 +27,7 @@
  * \library       sequencer64 application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2015-11-24
- * \updates       2015-11-24
+ * \updates       2026-10-18
  * \license       GNU GPLv2 or above
  *
  *  Sequencer64 can also split an SMF 0 file into multiple tracks, effectively
@@ -139,10 +139,10 @@ public:
 
 private:
 
-    bool split_channel
+    void setup_channel
     (
         const sequence & main_seq,
-        sequence * seq,
+        sequence & seq,
         int channel
     );
 
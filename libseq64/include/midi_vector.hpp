@@ -28,7 +28,7 @@
  * \library       sequencer64 application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2015-10-11
- * \updates       2016-08-25
+ * \updates       2026-10-18
  * \license       GNU GPLv2 or above
  *
  *  This implementation attempts to avoid the reversals that can occur using
@@ -120,6 +120,21 @@ public:
         m_char_vector.push_back(b);
     }
 
+    /**
+     *  Appends a number of MIDI bytes to the vector in one operation.
+     *
+     * \param b
+     *      Points to the bytes to append.
+     *
+     * \param count
+     *      The number of bytes to append.
+     */
+
+    virtual void put_bytes (const midibyte * b, std::size_t count)
+    {
+        m_char_vector.insert(m_char_vector.end(), b, b + count);
+    }
+
     /**
      *  Provide a way to get the next byte from the container.  In this
      *  implementation, m_position_for_get is used.  As a side-effect, the
@@ -136,6 +151,17 @@ public:
         return result;
     }
 
+    /**
+     * \getter m_char_vector
+     *      Lets midifile::write_track() copy the whole track at once,
+     *      instead of calling get() for each byte.
+     */
+
+    const std::vector<midibyte> & bytes () const
+    {
+        return m_char_vector;
+    }
+
     /**
      *  Provides a way to clear the container.
      */
@@ -35,8 +35,13 @@
  *  base class for all such classes.
  */
 
+#include <atomic>                       /* std::atomic<>                */
+#include <vector>                       /* std::vector<>                */
+
 #include "app_limits.h"                 /* SEQ64_USE_DEFAULT_PPQN       */
 #include "easy_macros.h"                /* for autoconf header files    */
+#include "event.hpp"                    /* seq64::event                 */
+#include "mpsc_queue.hpp"               /* seq64::mpsc_queue<>          */
 #include "mutex.hpp"
 #include "midibus_common.hpp"
 
@@ -46,7 +51,126 @@
 
 namespace seq64
 {
-    class event;
+    class midibase;
+
+/**
+ *  Serializes the output of one or more busses.  Normally each buss has its
+ *  own; when the MIDI API writes all of the busses through one handle
+ *  (ALSA), they all share the master buss's.
+ *
+ *  A thread that plays an event on a buss queues it, counts it here, and
+ *  then sends it only if it can get the lock at once.  So unlock() sends
+ *  the queued events of every buss sharing the lock before letting go, and
+ *  looks at the count again afterwards, in case an event was queued by a
+ *  thread that found the lock busy.  The fences make sure that either that
+ *  thread sees the lock as free, or we see its event.
+ */
+
+class bus_lock
+{
+
+private:
+
+    /**
+     *  The recursive mutex itself.
+     */
+
+    mutex m_mutex;
+
+    /**
+     *  The number of events queued on the busses, and not yet sent.
+     */
+
+    std::atomic<int> m_queued;
+
+    /**
+     *  The busses sharing this lock.  Guarded by m_mutex.
+     */
+
+    std::vector<midibase *> m_buses;
+
+private:        // do not allow these functions to be used
+
+    bus_lock (const bus_lock &);
+    bus_lock & operator = (const bus_lock &);
+
+public:
+
+    bus_lock ();
+    void lock ();
+    bool try_lock ();
+    void unlock ();
+    void drain ();
+    void send_queued ();
+    void add_bus (midibase * bus);
+    void remove_bus (midibase * bus);
+
+    /**
+     *  Counts an event just queued on one of the busses.
+     */
+
+    void queued ()
+    {
+        m_queued.fetch_add(1);
+    }
+
+    /**
+     *  Counts an event just taken off the queue of one of the busses.
+     */
+
+    void sent ()
+    {
+        m_queued.fetch_sub(1);
+    }
+
+};
+
+/**
+ *  Locks a bus_lock when created, and unlocks it, sending any queued
+ *  events, when destroyed.  The bus_lock counterpart of automutex.
+ */
+
+class bus_locker
+{
+
+private:
+
+    /**
+     *  Provides the lock to be used.
+     */
+
+    bus_lock & m_lock;
+
+private:        // do not allow these functions to be used
+
+    bus_locker ();
+    bus_locker (const bus_locker &);
+    bus_locker & operator = (const bus_locker &);
+
+public:
+
+    /**
+     *  Locks the given lock.
+     *
+     * \param lk
+     *      The lock of the buss, or the one shared by all of the busses.
+     */
+
+    bus_locker (bus_lock & lk) : m_lock (lk)
+    {
+        m_lock.lock();
+    }
+
+    /**
+     *  Unlocks the lock, after sending the queued events.
+     */
+
+    ~bus_locker ()
+    {
+        m_lock.unlock();
+    }
+
+};
 
 /**
  *  This class implements with ALSA version of the midibase object.
@@ -60,6 +184,12 @@ class midibase
 
     friend class mastermidibus;
 
+    /**
+     *  The output lock sends the queued events of its busses.
+     */
+
+    friend class bus_lock;
+
 private:
 
     /**
@@ -178,10 +308,41 @@ private:
     bool m_is_system_port;
 
     /**
-     *  Locking mutex.
+     *  The output lock of this buss alone.
      */
 
-    mutex m_mutex;
+    bus_lock m_lock;
+
+    /**
+     *  The lock that serializes the actual output on this buss.  Normally
+     *  it points to m_lock.  When the MIDI API uses one handle for all of
+     *  the busses (ALSA), the master buss points it at a single lock shared
+     *  by all of them.  See share_io_mutex().
+     */
+
+    bus_lock * m_io_mutex;
+
+    /**
+     *  An event waiting in m_out_queue, with the channel to play it on, and
+     *  the lock it was counted on.
+     */
+
+    struct queued_event
+    {
+        event qe_event;
+        midibyte qe_channel;
+        bus_lock * qe_lock;                     /* the lock that counted it */
+    };
+
+    /**
+     *  Holds the events played on this buss that have not yet been sent.
+     *  Any thread can add to it without waiting; the thread that holds
+     *  m_io_mutex drains it, before letting go.  Thus a thread that finds the buss busy (for
+     *  example, the output thread while the GUI previews a note) never
+     *  blocks.
+     */
+
+    mpsc_queue<queued_event> m_out_queue;
 
 public:
 
@@ -479,16 +640,20 @@ public:
     bool init_out_sub ();
     bool init_in_sub ();
     void play (event * e24, midibyte channel);
+    void play_batch (const std::vector<event> & events);
     void sysex (event * e24);
     void flush ();
     void start ();
     void stop ();
-    void clock (midipulse tick);
+    int clock (midipulse tick);
+    void drain ();
     void continue_from (midipulse tick);
     void init_clock (midipulse tick);
     void print ();
     bool set_input (bool inputing);
 
+    void share_io_mutex (bus_lock & m);
+
 protected:
 
     /**
@@ -607,6 +772,19 @@ protected:
     virtual void api_stop () = 0;
     virtual void api_clock (midipulse tick) = 0;
 
+private:
+
+    /**
+     *  Provides the lock that serializes output on this buss.
+     */
+
+    bus_lock & io_mutex ()
+    {
+        return *m_io_mutex;
+    }
+
+    void drain_locked ();
+
 };          // class midibase (ALSA version)
 
 /*
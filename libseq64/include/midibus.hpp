@@ -37,6 +37,8 @@
 
 #if defined SEQ64_ALSAMIDI_SUPPORT
 #include "midibus_am.hpp"               /* seq64::midibus for ALSA          */
+#elif defined SEQ64_LOOPMIDI_SUPPORT
+#include "midibus_lm.hpp"               /* seq64::midibus, loop-back        */
 #elif defined SEQ64_RTMIDI_SUPPORT
 #include "midibus_rm.hpp"               /* seq64::midibus for RtMidi        */
 #elif defined SEQ64_PORTMIDI_SUPPORT
@@ -285,6 +285,28 @@ class midi_timing
 
     int m_ppqn;                         /* P (PPQN or ppqn)               */
 
+    /**
+     *  The MIDI clocks per metronome click, as written in a Time Signature
+     *  meta event.  Most commonly 24.
+     */
+
+    int m_clocks_per_metronome;
+
+    /**
+     *  The number of 32nd notes per quarter note, as written in a Time
+     *  Signature meta event.  Almost always 8.
+     */
+
+    int m_32nds_per_quarter;
+
+    /**
+     *  The tempo in microseconds per quarter note, as written in a Set Tempo
+     *  meta event.  It is the same tempo as m_beats_per_minute, but kept as
+     *  the integer value that the song holds, to avoid rounding.
+     */
+
+    int m_us_per_quarter_note;
+
 public:
 
     midi_timing ();
@@ -378,6 +400,60 @@ public:
         m_ppqn = p;
     }
 
+    /**
+     * \getter m_clocks_per_metronome
+     */
+
+    int clocks_per_metronome () const
+    {
+        return m_clocks_per_metronome;
+    }
+
+    /**
+     * \setter m_clocks_per_metronome
+     */
+
+    void clocks_per_metronome (int cpm)
+    {
+        m_clocks_per_metronome = cpm;
+    }
+
+    /**
+     * \getter m_32nds_per_quarter
+     */
+
+    int thirtyseconds_per_quarter () const
+    {
+        return m_32nds_per_quarter;
+    }
+
+    /**
+     * \setter m_32nds_per_quarter
+     */
+
+    void thirtyseconds_per_quarter (int tpq)
+    {
+        m_32nds_per_quarter = tpq;
+    }
+
+    /**
+     * \getter m_us_per_quarter_note
+     */
+
+    int us_per_quarter_note () const
+    {
+        return m_us_per_quarter_note;
+    }
+
+    /**
+     * \setter m_us_per_quarter_note
+     */
+
+    void us_per_quarter_note (int us)
+    {
+        m_us_per_quarter_note = us;
+    }
+
 };          // class midi_timing
 
 /**
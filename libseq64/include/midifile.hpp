@@ -43,11 +43,13 @@
  *  converting it to SMF 1.
  */
 
+#include <cstring>                      /* std::memcpy()                */
+#include <fstream>
 #include <string>
-#include <list>
 #include <vector>
 
 #include "globals.h"                    /* SEQ64_USE_DEFAULT_PPQN       */
+#include "mapped_file.hpp"              /* seq64::mapped_file           */
 #include "midibyte.hpp"                 /* midishort, midibyte, etc.    */
 #include "midi_splitter.hpp"            /* seq64::midi_splitter         */
 #include "mutex.hpp"                    /* seq64::mutex, automutex  */
@@ -67,6 +69,11 @@
 namespace seq64
 {
     class perform;                      /* forward reference            */
+    class sequence;                     /* forward reference            */
+    class session_cache;                /* forward reference            */
+    class song_snapshot;                /* forward reference            */
+
+    class midi_container;               /* forward reference            */
 
 #if defined SEQ64_USE_MIDI_VECTOR
     class midi_vector;
@@ -85,6 +92,61 @@ class midifile
 
 private:
 
+    /**
+     *  Describes one track chunk of an SMF 1 file, and receives the result
+     *  of decoding it.  The decoder must not touch the perform object, which
+     *  belongs to the main thread, so the settings a track makes to it are
+     *  recorded here and applied by install_track().  A value of 0 means "not
+     *  set".
+     */
+
+    struct track_chunk
+    {
+        midilong tc_id;                 /**< The chunk ID, 'MTrk' usually.  */
+        int tc_offset;                  /**< Offset of the chunk's data.    */
+        int tc_length;                  /**< Length of the chunk's data.    */
+        int tc_end;                     /**< Offset where decoding stopped. */
+        bool tc_ok;                     /**< The chunk decoded cleanly.     */
+        sequence * tc_seq;              /**< The detached sequence.         */
+        midishort tc_seqnum;            /**< The sequence number read.      */
+        int tc_beats_per_bar;           /**< For p.set_beats_per_bar().     */
+        int tc_beat_width;              /**< For p.set_beat_width().        */
+        int tc_clocks_per_metronome;    /**< For p.clocks_per_metronome().  */
+        int tc_32nds_per_quarter;       /**< For p.set_32nds_per_quarter(). */
+        double tc_tempo_us;             /**< The track's first tempo.       */
+        bool tc_has_events;             /**< A lazy track holds events.     */
+        bool tc_has_tempo;              /**< A lazy track holds a tempo.    */
+        bool tc_has_time_signature;     /**< It holds a time signature.     */
+        std::string tc_error;           /**< The last error message.        */
+
+        track_chunk ();
+    };
+
+    /**
+     *  Holds the work shared by the track-decoding threads.  Defined in the
+     *  cpp module.
+     */
+
+    struct parse_job;
+
+#ifdef SEQ64_STAZED_EXPORT_SONG
+
+    /**
+     *  Holds the work shared by the threads that fill the tracks of an
+     *  exported song.  Defined in the cpp module.
+     */
+
+    struct export_job;
+
+#endif
+
+    /**
+     *  Decodes the events of one track on demand, for a deferred event list.
+     *  Defined in the cpp module.
+     */
+
+    class track_loader;
+
     /**
      *  Provides locking for the sequence.  Made mutable for use in
      *  certain locked getter functions.
@@ -126,7 +188,7 @@ private:
      *  Holds the position in the MIDI file.  This is at least a 31-bit
      *  value in the recent architectures running Linux and Windows, so it
      *  will handle up to 2 Gb of data.  This member is used as the offset
-     *  into the m_data vector.
+     *  into the m_data array.
      */
 
     int m_pos;
@@ -138,24 +200,30 @@ private:
     const std::string m_name;
 
     /**
-     *  This vector of characters holds our MIDI data.  We could also use
-     *  a string of characters, unsigned.  This member is resized to the
-     *  putative size of the MIDI file, in the parse() function.  Then the
-     *  whole file is read into it, as if it were an array.  This member is an
-     *  input buffer.
+     *  Provides a read-only view of the whole MIDI file while parse() runs.
+     *  On POSIX systems the file is memory-mapped rather than copied into a
+     *  buffer.  It is released when parse() returns.
+     */
+
+    mapped_file m_file_map;
+
+    /**
+     *  Points to the MIDI data held by m_file_map, and is indexed by m_pos.
+     *  Null except while parse() runs.
      */
 
-    std::vector<midibyte> m_data;
+    const midibyte * m_data;
 
     /**
-     *  Provides a list of characters.  The class pushes each MIDI byte into
-     *  this list using the write_byte() function.  Also note that the write()
-     *  function calls sequence::fill_list() to fill a temporary
-     *  std::list<char> (!) buffer, then writes that data <i> backwards </i> to
-     *  this member.  This member is an output buffer.
+     *  Provides a contiguous output buffer.  The class appends each MIDI byte
+     *  to it using the write_byte() function, and appends whole tracks at
+     *  once in write_track().  The write() and write_song() functions hand
+     *  the buffer to the file in large chunks (see flush_buffer()), so it
+     *  never holds much more than one track.  This member used to be an
+     *  std::list, with one heap node per byte of the file.
      */
 
-    std::list<midibyte> m_char_list;
+    std::vector<midibyte> m_char_buffer;
 
     /**
      *  Use the new format for the proprietary footer section of the Seq24
@@ -200,6 +268,41 @@ private:
 
     midi_splitter m_smf0_splitter;
 
+    /**
+     *  If not null, install_track() logs each track here, so that parse()
+     *  can store the tracks in the session cache.
+     */
+
+    session_cache * m_session_cache;
+
+    /**
+     *  If true, parse_track() only indexes each SMF 1 track:  it sets up the
+     *  sequence's name, length, buss, channel, triggers, and other settings,
+     *  but leaves the events to a track_loader, which decodes them when the
+     *  sequence is first used.  Set from the [lazy-loading] option.
+     */
+
+    bool m_lazy_tracks;
+
+    /**
+     *  If true, parse() fills a staging perform object on a thread other
+     *  than the main thread (see the playlist class).  The global key,
+     *  scale, and background sequence are then saved in the members below,
+     *  instead of in the "user" settings, and the tracks are always decoded
+     *  in full.
+     */
+
+    bool m_detached;
+
+    /**
+     *  The musical key, scale, and background sequence read by a detached
+     *  parse(), or -1 if the file does not specify them.
+     */
+
+    int m_musical_key;
+    int m_musical_scale;
+    int m_background_sequence;
+
 public:
 
     midifile
@@ -213,6 +316,7 @@ public:
 
     bool parse (perform & p, int a_screen_set = 0);
     bool write (perform & p);
+    bool write (const song_snapshot & snapshot);
 
 #ifdef SEQ64_STAZED_EXPORT_SONG
     bool write_song (perform & p);
@@ -250,10 +354,63 @@ public:
         return m_ppqn;
     }
 
+    /**
+     * \setter m_detached
+     */
+
+    void detached (bool flag)
+    {
+        m_detached = flag;
+    }
+
+    /**
+     * \getter m_musical_key
+     */
+
+    int musical_key () const
+    {
+        return m_musical_key;
+    }
+
+    /**
+     * \getter m_musical_scale
+     */
+
+    int musical_scale () const
+    {
+        return m_musical_scale;
+    }
+
+    /**
+     * \getter m_background_sequence
+     */
+
+    int background_sequence () const
+    {
+        return m_background_sequence;
+    }
+
 private:
 
+    explicit midifile (const midifile * parent);
+    midifile (const midifile &);                            /* no copy      */
+    midifile & operator = (const midifile &);               /* no copy      */
+
     bool parse_smf_0 (perform & p, int screenset);
     bool parse_smf_1 (perform & p, int screenset, bool is_smf0 = false);
+    bool parse_smf_1_cached (perform & p);
+    bool index_tracks (int numtracks, std::vector<track_chunk> & chunks);
+    bool parse_tracks (midishort ppqn, std::vector<track_chunk> & chunks);
+    bool parse_track
+    (
+        int track, midishort ppqn, bool is_smf0, track_chunk & tc
+    );
+    void install_track
+    (
+        perform & p, int track, int screenset,
+        bool is_smf0, track_chunk & tc
+    );
+    static void * parse_thread_func (void * job);
     midilong parse_prop_header (int file_size);
     bool parse_proprietary_track (perform & a_perf, int file_size);
     bool checklen (midilong len, midibyte type);
@@ -279,13 +436,20 @@ private:
 
     void read_byte_array (midibyte * b, int len)
     {
-        for (int i = 0; i < len; ++i)
-            *b++ = read_byte();
+        if (len > 0 && m_pos + len <= m_file_size)
+        {
+            std::memcpy(b, m_data + m_pos, std::size_t(len));
+            m_pos += len;
+        }
+        else
+        {
+            for (int i = 0; i < len; ++i)
+                *b++ = read_byte();
+        }
     }
 
     /**
-     *  Writes 1 byte.  The byte is written to the m_char_list member, using a
-     *  call to push_back().
+     *  Writes 1 byte.  The byte is appended to the m_char_buffer member.
      *
      * \param c
      *      The MIDI byte to be "written".
@@ -293,9 +457,19 @@ private:
 
     void write_byte (midibyte c)
     {
-        m_char_list.push_back(c);
+        m_char_buffer.push_back(c);
     }
 
+    void patch_long (std::size_t offset, midilong x);
+    bool open_output (std::ofstream & file, const std::string & tempname);
+    bool flush_buffer (std::ofstream & file, bool force = false);
+    bool close_output
+    (
+        std::ofstream & file,
+        const std::string & tempname,
+        const std::string & target
+    );
+
     void write_varinum (midilong);
     void write_track_name (const std::string & trackname);
     std::string read_track_name();
@@ -306,7 +480,7 @@ private:
     void write_start_tempo (midibpm start_tempo);
     void write_time_sig (int beatsperbar, int beatwidth);
     void write_prop_header (midilong tag, long len);
-    bool write_proprietary_track (perform & a_perf);
+    bool write_proprietary_track (const song_snapshot & snapshot);
     long varinum_size (long len) const;
     long prop_item_size (long datalen) const;
     long track_name_size (const std::string & trackname) const;
@@ -321,6 +495,16 @@ private:
 #endif
     );
 
+#ifdef SEQ64_STAZED_EXPORT_SONG
+    void fill_song_tracks (export_job & ej);
+    static void fill_song_track
+    (
+        midi_container & lst, sequence & seq,
+        int track, const midi_timing & mt
+    );
+    static void * export_thread_func (void * job);
+#endif
+
     /**
      *  Returns the size of a sequence-number event, which is always 5
      *  bytes, plus one byte for the delta time that precedes it.
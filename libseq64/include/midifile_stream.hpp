@@ -0,0 +1,339 @@
+#ifndef SEQ64_MIDIFILE_STREAM_HPP
+#define SEQ64_MIDIFILE_STREAM_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          midifile_stream.hpp
+ *
+ *  This module declares a class that reads a MIDI file front to back
+ *  through a small buffer, optionally thinning out controller data.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  The midifile class needs the whole file in view, and all of the decoded
+ *  events in memory, before it is done.  That is fine for songs, but not
+ *  for the huge generated files (long controller captures, for example)
+ *  that some import and archive jobs have to deal with.
+ *
+ *  This class reads the file sequentially, SEQ64_MIDI_READ_CHUNK bytes at a
+ *  time, and decodes each track as it goes.  Each channel event passes
+ *  through a filter before it is stored, so that data that adds nothing
+ *  never takes up memory:
+ *
+ *      -   Redundant values.  A control change, pitch wheel, or channel
+ *          pressure event that repeats the last value kept for the same
+ *          channel (and controller) is dropped.
+ *      -   Thinning.  At most one value per channel (and controller) is
+ *          kept in each interval of the given number of ticks.  The latest
+ *          value seen within an interval is held back, and kept once the
+ *          interval is over, so that the final value of each sweep is
+ *          never lost.
+ *
+ *  The inspect() function only collects statistics, so it runs in constant
+ *  memory.  The import() function adds the tracks to a perform object, like
+ *  midifile::parse() does, but it does not read the Sequencer64 SeqSpec
+ *  data (triggers, buss, and so on), nor the proprietary track.  It is
+ *  meant for getting raw MIDI data into the application.
+ */
+
+#include <cstddef>                      /* std::size_t                      */
+#include <fstream>                      /* std::ifstream                    */
+#include <string>                       /* std::string                      */
+#include <vector>                       /* std::vector<>                    */
+
+#include "globals.h"                    /* SEQ64_USE_DEFAULT_PPQN           */
+#include "midibyte.hpp"                 /* seq64::midibyte, midipulse       */
+#include "midi_splitter.hpp"            /* seq64::midi_splitter             */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+    class perform;
+    class sequence;
+
+/**
+ *  Reads a MIDI file sequentially, with bounded memory.  Not copyable.
+ */
+
+class midifile_stream
+{
+
+public:
+
+    /**
+     *  What was found in one track of the file.
+     */
+
+    struct track_stats
+    {
+        int ts_track;                   /**< The index of the track.        */
+        int ts_seqnum;                  /**< Its sequence number, or 0.     */
+        std::string ts_name;            /**< The track name, if any.        */
+        int ts_channel;                 /**< Last channel seen, or -1.      */
+        midipulse ts_length;            /**< Time of the end of the track.  */
+        long ts_events;                 /**< Events read from the file.     */
+        long ts_notes;                  /**< Note on and off events read.   */
+        long ts_controls;               /**< Controller-type events read.   */
+        long ts_dropped;                /**< Events dropped by the filter.  */
+    };
+
+private:
+
+    /**
+     *  The number of filter slots per channel:  the 128 controllers, then
+     *  pitch wheel, then channel pressure.
+     */
+
+    static const int c_slots = 130;
+
+    /**
+     *  The filter state of one channel and controller.  The value is the
+     *  last one kept, or -1.  A held value is kept when its interval ends.
+     */
+
+    struct slot_state
+    {
+        int ss_value;                   /**< The last value kept, or -1.    */
+        midipulse ss_time;              /**< The time it was kept.          */
+        bool ss_held;                   /**< A later value is held back.    */
+        midipulse ss_held_time;         /**< The time of the held value.    */
+        midibyte ss_held_status;        /**< The held event's status.       */
+        midibyte ss_held_d0;            /**< The held event's first byte.   */
+        midibyte ss_held_d1;            /**< The held event's second byte.  */
+    };
+
+    /**
+     *  The full path to the MIDI file.
+     */
+
+    std::string m_name;
+
+    /**
+     *  The PPQN of the imported sequences, and whether the timestamps in
+     *  the file are scaled to it, as in the midifile class.
+     */
+
+    int m_ppqn;
+    bool m_use_default_ppqn;
+
+    /**
+     *  Splits an imported SMF 0 track by channel, as in the midifile class.
+     */
+
+    midi_splitter m_smf0_splitter;
+
+    /**
+     *  The filter settings.  A thinning interval of 0 disables thinning.
+     */
+
+    bool m_drop_redundant;
+    midipulse m_thin_interval;
+
+    /**
+     *  The file, and the buffer through which it is read.  m_pos and
+     *  m_end index m_buffer; m_offset is the file offset of m_buffer[0].
+     */
+
+    std::ifstream m_file;
+    std::vector<midibyte> m_buffer;
+    std::size_t m_pos;
+    std::size_t m_end;
+    long m_offset;
+
+    /**
+     *  Set when reading runs past the end of the file.
+     */
+
+    bool m_eof;
+
+    /**
+     *  The header of the file.
+     */
+
+    int m_format;
+    int m_track_count;
+    int m_file_ppqn;
+
+    /**
+     *  The first tempo and time signature found in track 0, or 0.
+     */
+
+    double m_tempo_us;
+    int m_beats_per_bar;
+    int m_beat_width;
+
+    /**
+     *  The filter state of the track being read.
+     */
+
+    std::vector<slot_state> m_slots;
+
+    /**
+     *  The statistics of each track read so far.
+     */
+
+    std::vector<track_stats> m_stats;
+
+    /**
+     *  The last error, with the file offset at which it happened.
+     */
+
+    std::string m_error_message;
+
+public:
+
+    midifile_stream
+    (
+        const std::string & name,
+        int ppqn = SEQ64_USE_DEFAULT_PPQN
+    );
+    ~midifile_stream ();
+
+    bool inspect ();
+    bool import (perform & p, int screenset = 0);
+
+    /**
+     * \setter m_drop_redundant
+     */
+
+    void drop_redundant (bool flag)
+    {
+        m_drop_redundant = flag;
+    }
+
+    /**
+     * \setter m_thin_interval
+     *      A value of 0 (or less) disables thinning.
+     */
+
+    void thin_interval (midipulse ticks)
+    {
+        m_thin_interval = ticks > 0 ? ticks : 0 ;
+    }
+
+    /**
+     * \getter m_format
+     */
+
+    int format () const
+    {
+        return m_format;
+    }
+
+    /**
+     * \getter m_file_ppqn
+     */
+
+    int file_ppqn () const
+    {
+        return m_file_ppqn;
+    }
+
+    /**
+     * \getter m_ppqn
+     */
+
+    int ppqn () const
+    {
+        return m_ppqn;
+    }
+
+    /**
+     * \getter m_tempo_us
+     */
+
+    double tempo_us () const
+    {
+        return m_tempo_us;
+    }
+
+    /**
+     * \getter m_stats
+     */
+
+    const std::vector<track_stats> & stats () const
+    {
+        return m_stats;
+    }
+
+    /**
+     * \getter m_error_message
+     */
+
+    const std::string & error_message () const
+    {
+        return m_error_message;
+    }
+
+private:
+
+    midifile_stream (const midifile_stream &);              /* no copy      */
+    midifile_stream & operator = (const midifile_stream &); /* no copy      */
+
+    bool read (perform * p, int screenset);
+    bool read_header ();
+    bool read_track (int track, midilong length, sequence * seq);
+    bool refill ();
+    void skip (midilong count);
+    midibyte read_byte ();
+    midishort read_short ();
+    midilong read_long ();
+    midilong read_varinum ();
+    void filter
+    (
+        sequence * seq, midipulse t, midibyte status,
+        midibyte d0, midibyte d1
+    );
+    void store
+    (
+        sequence * seq, midipulse t, midibyte status,
+        midibyte d0, midibyte d1
+    );
+    void flush (sequence * seq);
+    bool error (const std::string & msg);
+
+    /**
+     * \getter
+     *      The file offset of the next byte to be read.
+     */
+
+    long offset () const
+    {
+        return m_offset + long(m_pos);
+    }
+
+};          // class midifile_stream
+
+}           // namespace seq64
+
+#endif      // SEQ64_MIDIFILE_STREAM_HPP
+
+/*
+ * midifile_stream.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -0,0 +1,248 @@
+#ifndef SEQ64_MPSC_QUEUE_HPP
+#define SEQ64_MPSC_QUEUE_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          mpsc_queue.hpp
+ *
+ *  This module declares/defines a small lock-free, multiple-producer,
+ *  single-consumer queue.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  This is the companion of spsc_queue, for the cases where more than one
+ *  thread produces the items.  The MIDI output busses are the main user:
+ *  the output thread, the clock thread, the input thread (MIDI thru), and
+ *  the GUI (note previews, panic) can all play events on the same buss.
+ *
+ *  Each slot carries a sequence number, as in Dmitry Vyukov's well-known
+ *  bounded queue.  A producer claims a slot with a compare-and-swap on the
+ *  tail index, fills it, and then publishes it by bumping the slot's
+ *  sequence number.  The consumer never has to wait for a producer that has
+ *  claimed a slot but not yet published it; it simply sees the queue as
+ *  empty at that slot, and picks the item up on the next pop().
+ *
+ *  Only one thread at a time may call pop().  The drainer must serialize
+ *  itself, usually by holding the mutex of the resource the items go to.
+ */
+
+#include <atomic>                       /* std::atomic<>                    */
+#include <vector>                       /* std::vector<>                    */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Provides a bounded, lock-free ring buffer for many producer threads and
+ *  one consumer thread at a time.  The capacity is rounded up to a power of
+ *  two.
+ */
+
+template <typename T>
+class mpsc_queue
+{
+
+private:
+
+    /**
+     *  One slot of the ring.  The sequence number tells whose turn it is: it
+     *  equals the slot's position when the slot is free for a producer, and
+     *  the position plus one when it holds an item for the consumer.
+     */
+
+    struct slot
+    {
+        std::atomic<unsigned> s_sequence;
+        T s_item;
+    };
+
+    /**
+     *  Holds the slots.  Sized once, in the constructor.
+     */
+
+    std::vector<slot> m_slots;
+
+    /**
+     *  The slot count minus one.  Used to wrap the indices.
+     */
+
+    const unsigned m_mask;
+
+    /**
+     *  The position of the next slot to be read.  Written only by the
+     *  consumer.
+     */
+
+    std::atomic<unsigned> m_head;
+
+    /**
+     *  The position of the next slot to be claimed by a producer.
+     */
+
+    std::atomic<unsigned> m_tail;
+
+private:
+
+    mpsc_queue (const mpsc_queue &);                /* not copyable     */
+    mpsc_queue & operator = (const mpsc_queue &);   /* not assignable   */
+
+    /**
+     *  Rounds the requested capacity up to the next power of two, with a
+     *  minimum of 2.
+     */
+
+    static unsigned round_up (unsigned n)
+    {
+        unsigned result = 2;
+        while (result < n)
+            result <<= 1;
+
+        return result;
+    }
+
+public:
+
+    /**
+     *  Principal constructor.
+     *
+     * \param capacity
+     *      The desired number of slots.  This value is rounded up to a power
+     *      of two.
+     */
+
+    mpsc_queue (unsigned capacity = 256)
+     :
+        m_slots (round_up(capacity)),
+        m_mask  (round_up(capacity) - 1),
+        m_head  (0),
+        m_tail  (0)
+    {
+        for (unsigned i = 0; i < unsigned(m_slots.size()); ++i)
+            m_slots[i].s_sequence.store(i, std::memory_order_relaxed);
+    }
+
+    /**
+     * \getter m_slots.size()
+     */
+
+    unsigned capacity () const
+    {
+        return unsigned(m_slots.size());
+    }
+
+    /**
+     *  Returns true if no published item is waiting at the head.  The result
+     *  is only a snapshot, of course.
+     */
+
+    bool empty () const
+    {
+        unsigned head = m_head.load(std::memory_order_relaxed);
+        const slot & s = m_slots[head & m_mask];
+        return s.s_sequence.load(std::memory_order_acquire) != head + 1;
+    }
+
+    /**
+     *  Copies an item into the queue.  Any thread may call it.
+     *
+     * \param item
+     *      The item to copy into the next free slot.
+     *
+     * \return
+     *      Returns false if the queue is full, in which case the item was not
+     *      added.
+     */
+
+    bool push (const T & item)
+    {
+        unsigned tail = m_tail.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            slot & s = m_slots[tail & m_mask];
+            unsigned seq = s.s_sequence.load(std::memory_order_acquire);
+            int diff = int(seq - tail);
+            if (diff == 0)
+            {
+                if
+                (
+                    m_tail.compare_exchange_weak
+                    (
+                        tail, tail + 1, std::memory_order_relaxed
+                    )
+                )
+                {
+                    s.s_item = item;
+                    s.s_sequence.store(tail + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+                return false;                           /* full             */
+            else
+                tail = m_tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     *  Copies the oldest published item out of the queue and removes it.
+     *  Only one thread at a time may call this function.
+     *
+     * \param [out] item
+     *      The destination of the oldest item.  Unchanged if the queue is
+     *      empty.
+     *
+     * \return
+     *      Returns false if the queue was empty.
+     */
+
+    bool pop (T & item)
+    {
+        unsigned head = m_head.load(std::memory_order_relaxed);
+        slot & s = m_slots[head & m_mask];
+        unsigned seq = s.s_sequence.load(std::memory_order_acquire);
+        bool result = seq == head + 1;
+        if (result)
+        {
+            item = s.s_item;
+            s.s_sequence.store(head + capacity(), std::memory_order_release);
+            m_head.store(head + 1, std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+};          // class mpsc_queue
+
+}           // namespace seq64
+
+#endif      // SEQ64_MPSC_QUEUE_HPP
+
+/*
+ * mpsc_queue.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
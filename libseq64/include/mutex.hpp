@@ -80,6 +80,7 @@ public:
     mutex ();
     void lock () const;
     void unlock () const;
+    bool try_lock () const;
 
 };
 
@@ -0,0 +1,121 @@
+#ifndef SEQ64_NOTE_TRACKER_HPP
+#define SEQ64_NOTE_TRACKER_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          note_tracker.hpp
+ *
+ *  This module declares a class that remembers which notes are sounding on
+ *  each output buss and channel.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  The old panic() sent a Note Off for every note on every channel of every
+ *  possible buss, 32 x 16 x 128 = 65536 events, most of them to busses that
+ *  do not even exist.  That floods slow hardware ports for seconds.
+ *
+ *  Instead, mastermidibase::play() feeds every outgoing channel message to
+ *  the note_tracker.  A Note On sets the note's bit, a Note Off (or a Note
+ *  On with zero velocity) clears it.  Panic then needs to send a Note Off
+ *  only for the bits that are still set, plus, optionally, an All Notes Off
+ *  (CC 123) and All Sound Off (CC 120) for each channel that has seen any
+ *  traffic.
+ *
+ *  The bits are atomic words, so that the output, clock, input (MIDI thru),
+ *  and GUI threads can all update them without a lock.
+ *
+ *  The tracker does not count repeated Note Ons of the same note; one Note
+ *  Off covers them.  The sequences still count their own playing notes for
+ *  the normal stop path.
+ */
+
+#include <atomic>                       /* std::atomic<>                    */
+#include <vector>                       /* std::vector<>                    */
+
+#include "app_limits.h"                 /* SEQ64_DEFAULT_BUSS_MAX, etc.     */
+#include "midibyte.hpp"                 /* seq64::midibyte                  */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+    class event;
+
+/**
+ *  Holds one bit per (buss, channel, note), and one bit per (buss, channel)
+ *  to mark the channels that have been used.
+ */
+
+class note_tracker
+{
+
+private:
+
+    /**
+     *  The number of 32-bit words needed to hold one bit per note.
+     */
+
+    static const int c_words = SEQ64_MIDI_COUNT_MAX / 32;
+
+    /**
+     *  The sounding-note bits, indexed by buss, channel, and word.
+     */
+
+    std::atomic<unsigned> m_notes
+        [SEQ64_DEFAULT_BUSS_MAX][SEQ64_MIDI_CHANNEL_MAX][c_words];
+
+    /**
+     *  For each buss, one bit for each channel on which any channel message
+     *  has been sent since the last take() that sent the controllers.
+     */
+
+    std::atomic<unsigned> m_channels[SEQ64_DEFAULT_BUSS_MAX];
+
+public:
+
+    note_tracker ();
+
+    void track (int bus, const event & ev, midibyte channel);
+    bool sounding (int bus, midibyte channel, midibyte note) const;
+    int take (int bus, std::vector<event> & events, bool controllers);
+    void clear ();
+
+private:
+
+    note_tracker (const note_tracker &);                    /* no copy      */
+    note_tracker & operator = (const note_tracker &);       /* no copy      */
+
+};          // class note_tracker
+
+}           // namespace seq64
+
+#endif      // SEQ64_NOTE_TRACKER_HPP
+
+/*
+ * note_tracker.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
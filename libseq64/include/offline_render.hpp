@@ -0,0 +1,317 @@
+#ifndef SEQ64_OFFLINE_RENDER_HPP
+#define SEQ64_OFFLINE_RENDER_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          offline_render.hpp
+ *
+ *  This module declares/defines a class that plays a performance offline,
+ *  as fast as the CPU allows, and records what it sends.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  The output thread plays the performance against the wall clock.  This
+ *  class instead calls perform::play() for every tick in turn, keeping the
+ *  time on a manual virtual_clock that it moves forward by the length of a
+ *  tick at the current tempo.  While it runs, the master buss hands every
+ *  event to capture() rather than to the ports (see
+ *  mastermidibase::render_to()), so that the events are recorded with the
+ *  tick and the virtual time at which they were played.  An hour of music
+ *  takes a few seconds.
+ *
+ *  A list of actions, such as muting a pattern or queuing it at the start
+ *  of a bar, can be given beforehand, one per line of text:
+ *
+\verbatim
+        # bar  action     [value]
+        1      on         0
+        9      queue      3
+        17     off        0
+        17     group      1
+        25     mute-all
+        33     bpm        132
+        65     stop
+\endverbatim
+ *
+ *  Bars are counted from 1.  The actions are on, off, toggle, queue, and
+ *  oneshot, which take a pattern number; group, which takes a mute-group;
+ *  mute-all and unmute-all; transpose, which takes semitones; bpm; and
+ *  stop, which ends the render.
+ *
+ *  The record can be written as a type 1 MIDI file, one track per buss
+ *  plus a tempo track, or as a compact binary log (see write_log()).  A
+ *  performance must have been launched, since the sequences play through
+ *  the master buss, but no port is used, so any backend serves; a CI job
+ *  would normally use the loop-back one.  MIDI clock and SysEx are not
+ *  rendered.
+ */
+
+#include <string>                       /* std::string                      */
+#include <vector>                       /* std::vector<>                    */
+
+#include "midibyte.hpp"                 /* seq64::midibyte, midipulse, etc. */
+#include "mutex.hpp"                    /* seq64::mutex, automutex          */
+#include "virtual_clock.hpp"            /* seq64::virtual_clock             */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+    class event;
+    class perform;
+
+/**
+ *  Plays a performance offline, and records the events it emits.
+ */
+
+class offline_render
+{
+
+public:
+
+    /**
+     *  The kinds of scripted action.
+     */
+
+    enum action_t
+    {
+        ACTION_ON,                  /**< Turn the pattern on.               */
+        ACTION_OFF,                 /**< Turn the pattern off.              */
+        ACTION_TOGGLE,              /**< Toggle the pattern.                */
+        ACTION_QUEUE,               /**< Toggle at the pattern's next loop. */
+        ACTION_ONESHOT,             /**< Play the pattern once.             */
+        ACTION_GROUP,               /**< Select and apply a mute-group.     */
+        ACTION_MUTE_ALL,            /**< Mute every pattern.                */
+        ACTION_UNMUTE_ALL,          /**< Unmute every pattern.              */
+        ACTION_TRANSPOSE,           /**< Set the song transposition.        */
+        ACTION_BPM,                 /**< Change the tempo.                  */
+        ACTION_STOP                 /**< End the render.                    */
+    };
+
+    /**
+     *  One scripted action, applied before the first tick of its bar is
+     *  played.
+     */
+
+    struct action
+    {
+        int ra_bar;                 /**< The bar, counted from 1.           */
+        action_t ra_type;           /**< What to do.                        */
+        double ra_value;            /**< The pattern, group, or value.      */
+    };
+
+    /**
+     *  One recorded event.
+     */
+
+    struct message
+    {
+        long long rm_time_us;       /**< The virtual time it was sent.      */
+        midipulse rm_tick;          /**< The tick being played.             */
+        bussbyte rm_bus;            /**< The output buss.                   */
+        midibyte rm_status;         /**< The status, with channel.          */
+        midibyte rm_d0;             /**< The first data byte.               */
+        midibyte rm_d1;             /**< The second data byte.              */
+    };
+
+    /**
+     *  A change of tempo seen during the render, for the tempo track.
+     */
+
+    struct tempo_change
+    {
+        midipulse rt_tick;          /**< The tick of the change.            */
+        midibpm rt_bpm;             /**< The new tempo.                     */
+    };
+
+private:
+
+    /**
+     *  The performance to play.  It must outlive this object.
+     */
+
+    perform & m_perform;
+
+    /**
+     *  True to play the song (the triggers of the song editor), and false
+     *  to play the patterns that are armed, as in live mode.
+     */
+
+    bool m_song_mode;
+
+    /**
+     *  The number of ticks per call to perform::play().  One tick gives
+     *  the exact timing; a larger step is faster but coarser, much like
+     *  the output thread when it is late.
+     */
+
+    midipulse m_step;
+
+    /**
+     *  The scripted actions, in the order given.
+     */
+
+    std::vector<action> m_actions;
+
+    /**
+     *  The events recorded by the last run().
+     */
+
+    std::vector<message> m_messages;
+
+    /**
+     *  The tempo in force at tick 0, and each change after that.
+     */
+
+    std::vector<tempo_change> m_tempos;
+
+    /**
+     *  The time and tick of the frame being played, which stamp each
+     *  recorded event.
+     */
+
+    virtual_clock m_clock;
+
+    /**
+     *  Protects m_messages, since a pattern editor can preview a note on
+     *  another thread while the render runs.
+     */
+
+    mutable mutex m_mutex;
+
+    /**
+     *  The tick at which the last run() ended.
+     */
+
+    midipulse m_end_tick;
+
+    /**
+     *  Describes the last error.
+     */
+
+    std::string m_error;
+
+private:
+
+    offline_render (const offline_render &);                    /* no copy  */
+    offline_render & operator = (const offline_render &);
+
+public:
+
+    offline_render (perform & p, bool songmode = true);
+
+    bool add_action (const std::string & spec);
+    bool load_script (const std::string & filename);
+    bool run (int bars = 0);
+    bool write_midi (const std::string & filename) const;
+    bool write_log (const std::string & filename) const;
+    void capture (bussbyte bus, const event & ev, midibyte channel);
+    midipulse bar_ticks () const;
+
+    /**
+     * \setter m_song_mode
+     */
+
+    void song_mode (bool flag)
+    {
+        m_song_mode = flag;
+    }
+
+    /**
+     * \setter m_step
+     *      Values below 1 are ignored.
+     */
+
+    void step (midipulse ticks)
+    {
+        if (ticks > 0)
+            m_step = ticks;
+    }
+
+    /**
+     * \getter m_messages
+     *      Not to be called while run() is in progress.
+     */
+
+    const std::vector<message> & messages () const
+    {
+        return m_messages;
+    }
+
+    /**
+     * \getter m_tempos
+     */
+
+    const std::vector<tempo_change> & tempos () const
+    {
+        return m_tempos;
+    }
+
+    /**
+     * \getter m_end_tick
+     */
+
+    midipulse end_tick () const
+    {
+        return m_end_tick;
+    }
+
+    /**
+     * \return
+     *      Returns the virtual time at which the last run() ended, in
+     *      microseconds.
+     */
+
+    long long end_time_us () const
+    {
+        return m_clock.now_us();
+    }
+
+    /**
+     * \getter m_error
+     */
+
+    const std::string & error_message () const
+    {
+        return m_error;
+    }
+
+private:
+
+    bool apply (const action & a);
+    bool fail (const std::string & msg);
+
+};          // class offline_render
+
+}           // namespace seq64
+
+#endif      // SEQ64_OFFLINE_RENDER_HPP
+
+/*
+ * offline_render.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -53,19 +53,25 @@
  *  handle_midi_control_ex().
  */
 
+#include "dirty_set.hpp"                /* seq64::dirty_set                 */
+#include "event_prefetcher.hpp"         /* seq64::event_prefetcher          */
 #include "globals.h"                    /* globals, nullptr, & more         */
 #include "jack_assistant.hpp"           /* optional seq64::jack_assistant   */
 #include "gui_assistant.hpp"            /* seq64::gui_assistant             */
 #include "keys_perform.hpp"             /* seq64::keys_perform              */
 #include "mastermidibus.hpp"            /* seq64::mastermidibus for ALSA    */
 #include "midi_control.hpp"             /* seq64::midi_control "struct"     */
+#include "playlist.hpp"                 /* seq64::playlist                  */
 #include "sequence.hpp"                 /* seq64::sequence                  */
+#include "song_saver.hpp"               /* seq64::song_saver                */
+#include "transport_snapshot.hpp"       /* seq64::transport_snapshot        */
 
 #ifdef SEQ64_SONG_BOX_SELECT
 #include <functional>                   /* std::function, function objects  */
 #include <set>                          /* std::set, arbitary selection     */
 #endif
 
+#include <atomic>                       /* std::atomic<>                    */
 #include <vector>                       /* std::vector                      */
 #include <pthread.h>                    /* pthread_t C structure            */
 
@@ -131,6 +137,7 @@
 
 namespace seq64
 {
+    class clock_generator;
     class keystroke;
 
 /**
@@ -177,11 +184,15 @@ class perform
     friend class keybindentry;
     friend class mainwnd;
     friend class midifile;
+    friend class midifile_stream;       // sets the tempo, like midifile
+    friend class offline_render;        // plays the song without waiting
     friend class optionsfile;           // needs cleanup
     friend class options;
     friend class perfedit;
     friend class perfroll;
     friend class sequence;              // for setting tempo from events
+    friend class song_saver;            // clears and restores modified flag
+    friend class song_snapshot;         // copies the song for saving
     friend void * input_thread_func (void * myperf);
     friend void * output_thread_func (void * myperf);
 
@@ -263,6 +274,20 @@ public:
         FF_RW_FORWARD   =  1
     };
 
+    /**
+     *  Provides the states of a song handed to the output thread by
+     *  queue_song(), to be swapped in at a bar boundary.
+     */
+
+    enum song_swap_t
+    {
+        SONG_SWAP_NONE,         /**< No song is queued.                     */
+        SONG_SWAP_QUEUED,       /**< The song waits for its tick.           */
+        SONG_SWAP_BUSY,         /**< The output thread is swapping it in.   */
+        SONG_SWAP_DONE,         /**< Swapped in; call finish_song_swap().   */
+        SONG_SWAP_REFUSED       /**< Not swapped; a pattern was in edit.    */
+    };
+
 #ifdef USE_CONSOLIDATED_PLAYBACK
 
     /**
@@ -457,46 +482,18 @@ private:
     bool m_seqs_active[c_max_sequence];
 
     /**
-     *  Each boolean value in this array is set to true if a sequence was
-     *  active, meaning that it was found to be active at the time we were
-     *  setting it to inactive.  This value seems to be used only in
-     *  maintaining dirtiness-status; did some process modify the sequence?
-     *  Was it's mute/unmute status changed?
-     */
-
-    bool m_was_active_main[c_max_sequence];
-
-    /**
-     *  Each boolean value in this array is set to true if a sequence was
-     *  active, meaning that it was found to be active at the time we were
-     *  setting it to inactive.  This value seems to be used only in
-     *  maintaining dirtiness-status for editing the mute/unmute status during
-     *  pattern editing.
-     */
-
-    bool m_was_active_edit[c_max_sequence];
-
-    /**
-     *  Each boolean value in this array is set to true if a sequence was
-     *  active, meaning that it was found to be active at the time we were
-     *  setting it to inactive.  This value seems to be used only in
-     *  maintaining dirtiness-status for editing the mute/unmute status during
-     *  performance/song editing.
+     *  The patterns that need to be redrawn in the main window, the pattern
+     *  editor, the song editor, and the song editor's names column.  A
+     *  pattern is marked by sequence::set_dirty() and set_dirty_mp(), and
+     *  also when it is made inactive (deleted), so that its slot is cleared.
+     *  The is_dirty_main() etc. functions take the marks, without locking
+     *  the sequences.  See the dirty_set class.
      */
 
-    bool m_was_active_perf[c_max_sequence];
-
-    /**
-     *  Each boolean value in this array is set to true if a sequence was
-     *  active, meaning that it was found to be active at the time we were
-     *  setting it to inactive.  This value seems to be used only in
-     *  maintaining dirtiness-status for editing the mute/unmute status during
-     *  performance names editing.  Not sure that it serves a real purpose;
-     *  perhaps created with an eye to editing the pattern name in the song
-     *  editor?
-     */
-
-    bool m_was_active_names[c_max_sequence];
+    dirty_set m_dirty_main;
+    dirty_set m_dirty_edit;
+    dirty_set m_dirty_perf;
+    dirty_set m_dirty_names;
 
     /**
      *  Saves the current playing state of each pattern.
@@ -714,6 +711,14 @@ private:
 
     mastermidibus * m_master_bus;
 
+    /**
+     *  Emits the outgoing MIDI clock from its own thread, if the
+     *  -T/--clock-thread option is in force; otherwise it is null, and
+     *  output_func() emits the clock itself.
+     */
+
+    clock_generator * m_clock_generator;
+
     /**
      *  Provides storage for this "rc" configuration option so that the
      *  perform object can set it in the master buss once that has been
@@ -777,6 +782,14 @@ private:
 
     mutable midipulse m_tick;
 
+    /**
+     *  A lock-free copy of m_tick, m_is_running, and m_is_pattern_playing,
+     *  published whenever they change, for the user interface to read once
+     *  per frame.  See the transport_snapshot class.
+     */
+
+    transport_snapshot m_transport;
+
     /**
      *  Let's try to save the last JACK pad structure tick for re-use with
      *  resume after pausing.
@@ -955,6 +968,29 @@ private:
 
     bool m_is_modified;
 
+    /**
+     *  Saves the song on a background thread, so that the GUI does not stall
+     *  on the disk.  See mainwnd::file_save() and the autosave option.
+     */
+
+    song_saver m_song_saver;
+
+    /**
+     *  Decodes the events of lazily-loaded sequences in the background,
+     *  starting with the current and next screen-sets.  See the
+     *  [lazy-loading] option and prefetch_events().
+     */
+
+    event_prefetcher m_event_prefetcher;
+
+    /**
+     *  The list of songs to play live, the next few of which are parsed in
+     *  the background, to be swapped in without a pause.  See the
+     *  [playlist] option and get_playlist().
+     */
+
+    playlist m_playlist;
+
 #ifdef SEQ64_SONG_BOX_SELECT
 
     /**
@@ -976,6 +1012,37 @@ private:
 
     condition_var m_condition_var;
 
+    /**
+     *  True while the output thread waits for playback to start, so that
+     *  adopt_song() can replace the sequences without the thread being in
+     *  play().  Protected by m_condition_var.
+     */
+
+    bool m_output_idle;
+
+    /**
+     *  The staging perform object of a song queued by queue_song(), and the
+     *  tick at which the output thread swaps it in.  The main thread sets
+     *  them before m_song_swap becomes SONG_SWAP_QUEUED, and the output
+     *  thread claims the song by moving it to SONG_SWAP_BUSY.
+     */
+
+    perform * m_song_queued;
+    midipulse m_song_swap_tick;
+
+    /**
+     *  The state of the queued song, a song_swap_t value.
+     */
+
+    std::atomic<int> m_song_swap;
+
+    /**
+     *  The sequences that the output thread swapped out, which
+     *  finish_song_swap() deletes on the main thread.
+     */
+
+    std::vector<sequence *> m_retired_seqs;
+
 #ifdef SEQ64_JACK_SUPPORT
 
     /**
@@ -1294,6 +1361,8 @@ public:
         return m_us_per_quarter_note;
     }
 
+    midi_timing timing ();
+
     /**
      * \getter m_gui_support
      *      The const getter.
@@ -1314,6 +1383,15 @@ public:
         return m_gui_support;
     }
 
+    /**
+     * \getter m_song_saver
+     */
+
+    song_saver & saver ()
+    {
+        return m_song_saver;
+    }
+
     /**
      * \getter m_gui_support.keys()
      *      The const getter.
@@ -1345,6 +1423,37 @@ public:
         return *m_master_bus;
     }
 
+    /**
+     * \getter m_master_bus
+     *      Null until launch() is called, and always null in the staging
+     *      perform objects of the playlist class.
+     */
+
+    mastermidibus * master_bus_pointer ()
+    {
+        return m_master_bus;
+    }
+
+    /**
+     * \getter m_playlist
+     */
+
+    playlist & get_playlist ()
+    {
+        return m_playlist;
+    }
+
+    /**
+     * \getter m_clock_generator
+     *      Provides access to the clock-jitter statistics for monitoring.
+     *      Null unless the -T/--clock-thread option is in force.
+     */
+
+    const clock_generator * clock_gen () const
+    {
+        return m_clock_generator;
+    }
+
     /**
      * \setter m_master_bus.filter_by_channel()
      */
@@ -1670,6 +1779,18 @@ public:
         return m_tick;
     }
 
+    /**
+     * \getter m_transport
+     *      Provides the play tick and the running and playing flags, as one
+     *      consistent reading.  This is what the user interface should use
+     *      to draw progress; it never waits on the output thread.
+     */
+
+    transport_snapshot::state transport () const
+    {
+        return m_transport.get();
+    }
+
     void set_tick (midipulse tick);
 
     /**
@@ -1797,16 +1918,20 @@ public:
 
     /**
      * \getter m_master_bus.get_beats_per_minute
-     *      Retrieves the BPM setting of the master MIDI buss.
+     *      Retrieves the BPM setting of the master MIDI buss.  If there is
+     *      no master buss (the performance is not launched, as in seq64smf,
+     *      or is being staged), the value stored by set_beats_per_minute()
+     *      is used.
      *
      * \return
-     *      Returns the value of beats/minute from the master buss.
+     *      Returns the value of beats/minute from the master buss, or
+     *      m_bpm.
      */
 
     midibpm get_beats_per_minute ()
     {
         return not_nullptr(m_master_bus) ?
-            m_master_bus->get_beats_per_minute() : 0.0 ;
+            m_master_bus->get_beats_per_minute() : m_bpm ;
     }
 
     bool reload_mute_groups (std::string & errmessage);
@@ -2201,13 +2326,53 @@ public:
     bool intersect_triggers (int seqnum, midipulse tick);
     midipulse get_max_trigger ();
 
+    int merge_recorded_events (bool wait = true);
     bool is_dirty_main (int seq);
     bool is_dirty_edit (int seq);
     bool is_dirty_perf (int seq);
     bool is_dirty_names (int seq);
+    void mark_dirty (int seq, bool edit);
+
+    /**
+     * \getter m_dirty_perf.any()
+     *      Lets the song editor skip its per-pattern loop when nothing has
+     *      changed.
+     */
+
+    bool any_dirty_perf () const
+    {
+        return m_dirty_perf.any();
+    }
+
+    /**
+     * \getter m_dirty_names.any()
+     */
+
+    bool any_dirty_names () const
+    {
+        return m_dirty_names.any();
+    }
+
     bool is_exportable (int seq) const;
 
     void set_screenset (int ss);
+    void prefetch_events (bool songmode = false);
+    void copy_song_settings (const perform & source);
+    bool any_sequence_in_edit () const;
+    bool adopt_song (perform & staged);
+    bool queue_song (perform & staged, midipulse tick);
+    bool cancel_song ();
+    void finish_song_swap ();
+
+    /**
+     * \getter m_song_swap
+     *      Can be called from any thread.
+     */
+
+    song_swap_t song_swap () const
+    {
+        return song_swap_t(m_song_swap.load(std::memory_order_acquire));
+    }
 
     /**
      * \getter m_screenset
@@ -2654,6 +2819,7 @@ private:
     void is_running (bool running)
     {
         m_is_running = running;
+        m_transport.running(running);
     }
 
     /**
@@ -2663,6 +2829,7 @@ private:
     void is_pattern_playing (bool flag)
     {
         m_is_pattern_playing = flag;
+        m_transport.playing(flag);
     }
 
     /**
@@ -2757,6 +2924,8 @@ private:
 
     bool log_current_tempo ();
     bool create_master_bus ();
+    void install_song (perform & staged);
+    void swap_queued_song (midipulse tick);
 #ifdef USE_STAZED_PARSE_SYSEX               // more code to incorporate!!!
     void parse_sysex (event a_e);           // copy, or reference???
 #endif
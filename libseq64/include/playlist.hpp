@@ -0,0 +1,251 @@
+#ifndef SEQ64_PLAYLIST_HPP
+#define SEQ64_PLAYLIST_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          playlist.hpp
+ *
+ *  This module declares a class that plays a list of MIDI files live,
+ *  parsing the next songs in the background.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  Changing songs during a live set used to mean opening the next file:
+ *  perform::clear_all(), then a blocking midifile::parse() into the live
+ *  perform object, with the user interface frozen for the duration.
+ *
+ *  A playlist is a text file listing the songs of the set.  This class
+ *  keeps the next few songs (see the [playlist] option) parsed ahead, each
+ *  in a staging perform object of its own, on a background thread.  A
+ *  staging object is never launched, so it has no master buss and no
+ *  threads; midifile::parse() is told that it is detached, so that it
+ *  leaves the global "user" settings alone.  When a song is selected (by
+ *  the playlist keys or MIDI control), poll(), called by the main window's
+ *  timer, swaps it in, which only moves pointers and copies settings.  If
+ *  playback is stopped, the swap is made at once, with
+ *  perform::adopt_song().  Otherwise the song is handed to the output
+ *  thread with perform::queue_song(), to be swapped in at the next multiple
+ *  of the configured number of bars, without stopping playback; or, if that
+ *  number is 0, the swap waits for the stop.  A song that is selected
+ *  before it has been parsed is swapped in as soon as it is ready, and a
+ *  song that cannot be swapped in because a pattern is being edited stays
+ *  staged until it can.
+ */
+
+#include <deque>                        /* std::deque<>                     */
+#include <string>                       /* std::string                      */
+#include <vector>                       /* std::vector<>                    */
+#include <pthread.h>                    /* pthread_t C structure            */
+
+#include "midibyte.hpp"                 /* seq64::midipulse                 */
+#include "mutex.hpp"                    /* seq64::condition_var             */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+    class perform;
+
+/**
+ *  Preloads and swaps in the songs of a playlist.  Not copyable.
+ */
+
+class playlist
+{
+
+private:
+
+    /**
+     *  One song, parsed or being parsed, ready to be swapped in.
+     */
+
+    struct song
+    {
+        perform * s_perform;            /**< The staging perform object.    */
+        bool s_ready;                   /**< The parse has finished.        */
+        bool s_ok;                      /**< The parse succeeded.           */
+        std::string s_error;            /**< The parse error, if any.       */
+        int s_ppqn;                     /**< The PPQN the parse used.       */
+        int s_musical_key;              /**< The song's key, or -1.         */
+        int s_musical_scale;            /**< The song's scale, or -1.       */
+        int s_background_sequence;      /**< Background sequence, or -1.    */
+    };
+
+    /**
+     *  The live perform object, which owns this playlist.
+     */
+
+    perform & m_perform;
+
+    /**
+     *  Protects the members below, and wakes the thread when there is work.
+     *  It is not held during a parse.
+     */
+
+    condition_var m_condition;
+
+    /**
+     *  The parsing thread, and whether it still needs to be joined.
+     */
+
+    pthread_t m_thread;
+    bool m_thread_launched;
+
+    /**
+     *  Tells the thread to exit.
+     */
+
+    bool m_stop;
+
+    /**
+     *  The full path of each song, in playlist order.
+     */
+
+    std::vector<std::string> m_files;
+
+    /**
+     *  The staged song for each entry of m_files, or null.
+     */
+
+    std::vector<song *> m_songs;
+
+    /**
+     *  The indices of the songs still to be parsed, most urgent first.
+     */
+
+    std::deque<int> m_queue;
+
+    /**
+     *  The song being parsed, or null.  If it is dropped from m_songs in the
+     *  meantime, the thread deletes it when the parse is done.
+     */
+
+    song * m_parsing;
+
+    /**
+     *  The index of the song in the live perform object, or -1.
+     */
+
+    int m_current;
+
+    /**
+     *  The PPQN of the current song, for the main window.
+     */
+
+    int m_current_ppqn;
+
+    /**
+     *  The index of the song to be swapped in next, or -1.  Set by
+     *  select(), which can be called from the MIDI input thread.
+     */
+
+    int m_selected;
+
+    /**
+     *  The song handed to the output thread by perform::queue_song(), and
+     *  its index, or -1 if the playlist has been replaced in the meantime.
+     *  It is not in m_songs until it is taken back.
+     */
+
+    song * m_queued;
+    int m_queued_index;
+
+    /**
+     *  Set once the selected song has been refused because a pattern is
+     *  being edited, so that the error is reported only once.
+     */
+
+    bool m_refused;
+
+public:
+
+    playlist (perform & p);
+    ~playlist ();
+
+    bool open (const std::string & filename);
+    void select (int index);
+    void next ();
+    void previous ();
+    bool poll ();
+    void stop ();
+
+    /**
+     * \getter m_files.size()
+     */
+
+    int count () const
+    {
+        return int(m_files.size());
+    }
+
+    /**
+     * \getter m_current
+     */
+
+    int current () const
+    {
+        return m_current;
+    }
+
+    /**
+     * \getter m_current_ppqn
+     */
+
+    int current_ppqn () const
+    {
+        return m_current_ppqn;
+    }
+
+    const std::string & current_name () const;
+
+private:
+
+    playlist (const playlist &);                            /* no copy      */
+    playlist & operator = (const playlist &);               /* no copy      */
+
+    void schedule ();
+    bool wanted (int index) const;
+    midipulse swap_tick () const;
+    void requeue ();
+    void refuse ();
+    bool install (song & s);
+    void apply (const song & s);
+    void parse (const std::string & filename, song & s);
+    void discard (int index);
+    void run ();
+    static void * playlist_thread_func (void * myplaylist);
+
+};          // class playlist
+
+}           // namespace seq64
+
+#endif      // SEQ64_PLAYLIST_HPP
+
+/*
+ * playlist.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
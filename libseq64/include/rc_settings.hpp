@@ -117,6 +117,11 @@ private:
 
     bool m_verbose_option;          /**< [auto-option-save] setting.        */
     bool m_auto_option_save;        /**< [auto-option-save] setting.        */
+    int m_auto_song_save;           /**< [auto-song-save] seconds, 0 = off. */
+    bool m_session_cache;           /**< [session-cache] binary track cache. */
+    bool m_lazy_loading;            /**< [lazy-loading] decode on first use. */
+    int m_playlist_preload;         /**< [playlist] songs parsed ahead.     */
+    int m_playlist_bars;            /**< [playlist] swap bars, 0 = at stop. */
     bool m_legacy_format;           /**< Write files in legacy format.      */
     bool m_lash_support;            /**< Enable LASH, if compiled in.       */
     bool m_allow_mod4_mode;         /**< Allow Mod4 to hold drawing mode.   */
@@ -125,6 +130,7 @@ private:
     bool m_show_midi;               /**< Show MIDI events to console.       */
     bool m_priority;                /**< Run at high priority (Linux only). */
     bool m_stats;                   /**< Show some output statistics.       */
+    bool m_clock_thread;            /**< Emit MIDI clock from own thread.   */
     bool m_pass_sysex;              /**< Pass SysEx to outputs, not ready.  */
     bool m_with_jack_transport;     /**< Enable synchrony with JACK.        */
     bool m_with_jack_master;        /**< Serve as a JACK transport Master.  */
@@ -158,6 +164,13 @@ private:
 
     std::string m_last_used_dir;
 
+    /**
+     *  Holds the name of the [playlist] file, a list of MIDI files to play
+     *  live, one per line.  Empty if there is no playlist.
+     */
+
+    std::string m_playlist_filename;
+
     /**
      *  Holds the current "rc" and "user" configuration directory.  This value
      *  is "~/.config/sequencer64" by default.
@@ -252,6 +265,62 @@ public:
         return m_auto_option_save;
     }
 
+    /**
+     * \getter m_auto_song_save
+     *      The interval between background backups of a modified song, in
+     *      seconds, or 0 if the song is not backed up.
+     */
+
+    int auto_song_save () const
+    {
+        return m_auto_song_save;
+    }
+
+    /**
+     * \getter m_session_cache
+     *      True if the tracks of a loaded MIDI file are kept in a binary
+     *      cache, to speed up the next load of the same file.
+     */
+
+    bool session_cache () const
+    {
+        return m_session_cache;
+    }
+
+    /**
+     * \getter m_lazy_loading
+     *      True if the events of each sequence of a MIDI file are decoded
+     *      only when the sequence is first played, edited, or drawn.
+     */
+
+    bool lazy_loading () const
+    {
+        return m_lazy_loading;
+    }
+
+    /**
+     * \getter m_playlist_preload
+     *      The number of songs after the current one in the playlist that are
+     *      parsed in the background.
+     */
+
+    int playlist_preload () const
+    {
+        return m_playlist_preload;
+    }
+
+    /**
+     * \getter m_playlist_bars
+     *      If 0, the next song of the playlist is swapped in only when
+     *      playback is stopped.  Otherwise, it is swapped in at the next
+     *      multiple of this number of bars.
+     */
+
+    int playlist_bars () const
+    {
+        return m_playlist_bars;
+    }
+
     /**
      * \getter m_legacy_format
      */
@@ -324,6 +393,15 @@ public:
         return m_stats;
     }
 
+    /**
+     * \getter m_clock_thread
+     */
+
+    bool clock_thread () const
+    {
+        return m_clock_thread;
+    }
+
     /**
      * \getter m_pass_sysex
      */
@@ -486,6 +564,24 @@ public:
 
     void last_used_dir (const std::string & value);
 
+    /**
+     * \getter m_playlist_filename
+     */
+
+    const std::string & playlist_filename () const
+    {
+        return m_playlist_filename;
+    }
+
+    /**
+     * \setter m_playlist_filename
+     */
+
+    void playlist_filename (const std::string & value)
+    {
+        m_playlist_filename = value;
+    }
+
     /**
      * \getter m_config_directory
      */
@@ -591,6 +687,37 @@ protected:
         m_auto_option_save = flag;
     }
 
+    /**
+     * \setter m_auto_song_save
+     *      A negative value disables the backups.
+     */
+
+    void auto_song_save (int seconds)
+    {
+        m_auto_song_save = seconds > 0 ? seconds : 0 ;
+    }
+
+    /**
+     * \setter m_session_cache
+     */
+
+    void session_cache (bool flag)
+    {
+        m_session_cache = flag;
+    }
+
+    /**
+     * \setter m_lazy_loading
+     */
+
+    void lazy_loading (bool flag)
+    {
+        m_lazy_loading = flag;
+    }
+
+    void playlist_preload (int count);
+    void playlist_bars (int bars);
+
     /**
      * \setter m_legacy_format
      */
@@ -663,6 +790,15 @@ protected:
         m_stats = flag;
     }
 
+    /**
+     * \setter m_clock_thread
+     */
+
+    void clock_thread (bool flag)
+    {
+        m_clock_thread = flag;
+    }
+
     /**
      * \setter m_pass_sysex
      */
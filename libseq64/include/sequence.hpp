@@ -38,8 +38,11 @@
  *  module, and now just call its member functions to do the actual work.
  */
 
+#include <atomic>                       /* std::atomic<unsigned>    */
+#include <functional>                   /* std::function            */
 #include <string>
 #include <stack>
+#include <vector>                       /* std::vector              */
 
 #include "seq64_features.h"             /* various feature #defines */
 #include "calculations.hpp"             /* measures_to_ticks()      */
@@ -48,6 +51,7 @@
 #include "midibus.hpp"                  /* seq64::midibus           */
 #include "mutex.hpp"                    /* seq64::mutex, automutex  */
 #include "scales.h"                     /* key and scale constants  */
+#include "spsc_queue.hpp"               /* seq64::spsc_queue<>      */
 #include "triggers.hpp"                 /* seq64::triggers, etc.    */
 
 /**
@@ -167,6 +171,32 @@ public:
         e_remove_one            /**< To remove one note under the cursor.   */
     };
 
+    /**
+     *  One drawable item of a sequence, as handed to the visitor of
+     *  visit_notes().  This replaces the return parameters of the old
+     *  get_next_note_event() function.
+     */
+
+    struct note_info
+    {
+        draw_type_t ni_type;    /**< DRAW_NORMAL_LINKED, DRAW_TEMPO, etc.   */
+        midipulse ni_start;     /**< The time of the note or tempo.         */
+        midipulse ni_finish;    /**< The time of its end, or 0 if unlinked. */
+        int ni_note;            /**< The note, or the tempo scaled to 127.  */
+        bool ni_selected;       /**< The selection status of the event.     */
+        int ni_velocity;        /**< The note velocity.                     */
+    };
+
+    /**
+     *  The visitors of visit_notes(), visit_events(), and visit_triggers().
+     *  They are called with the sequence locked, so they must not modify
+     *  it, and should be quick.
+     */
+
+    typedef std::function<void (const note_info &)> note_visitor;
+    typedef std::function<void (const event &)> event_visitor;
+    typedef std::function<void (const trigger &)> trigger_visitor;
+
 private:
 
     /**
@@ -183,6 +213,7 @@ private:
      */
 
     static event_list m_events_clipboard;   /* shared between sequences */
+    static std::atomic<unsigned> m_edit_counter;    /* for m_edit_version   */
 
     /**
      *  For pause support, we need a way for the sequence to find out if JACK
@@ -258,12 +289,6 @@ private:
 
     EventStack m_events_redo;
 
-    /**
-     *  An iterator for drawing events.
-     */
-
-    event_list::iterator m_iterator_draw;
-
     /**
      *  A new feature for recording, based on a "stazed" feature.  If true
      *  (not yet the default), then the seqedit window will record only MIDI
@@ -328,6 +353,46 @@ private:
 
     short m_playing_notes[SEQ64_MIDI_NOTES_MAX];
 
+    /**
+     *  Holds events recorded by the MIDI input thread while the pattern is
+     *  playing.  The input thread pushes events here without taking m_mutex,
+     *  and merge_recorded_events() folds them into m_events in batches, so
+     *  that recording into a large pattern does not hold up play().  The
+     *  queue is allocated the first time recording is enabled, since most
+     *  sequences are never recorded into, and is kept until destruction so
+     *  that the input thread never sees it disappear.  The pointer is
+     *  published atomically, since the input thread reads it without the
+     *  lock.  Only the holder of m_mutex pops from the queue; the input
+     *  thread only pushes.
+     */
+
+    std::atomic<spsc_queue<event> *> m_record_queue;
+
+    /**
+     *  Holds the recorded events that did not fit in the recording queue.
+     *  The input thread appends to it, under m_mutex, while the queue is
+     *  full, and keeps doing so until merge_recorded_events() empties it,
+     *  so that the events are merged in the order they came in.
+     */
+
+    std::vector<event> m_record_overflow;
+
+    /**
+     *  True while m_record_overflow holds events.  Read by the input thread
+     *  without the lock, to decide whether to use the queue.
+     */
+
+    std::atomic<bool> m_record_overflowing;
+
+    /**
+     *  The number of events at the head of the recording queue that are
+     *  stale, because an overwrite-mode loop reset came after them.  The
+     *  input thread sets it, under m_mutex, and merge_recorded_events()
+     *  pops and drops that many events.
+     */
+
+    unsigned m_record_discard;
+
     /**
      *  Indicates if the sequence was playing.
      */
@@ -451,13 +516,27 @@ private:
     /**
      *  These flags indicate that the content of the sequence has changed due
      *  to recording, editing, performance management, or even (?) a
-     *  name change.
+     *  name change.  They are atomic, so that they can be set by the MIDI
+     *  threads and taken by the GUI without locking the sequence.  The
+     *  views of the main window and song editor use the marks published to
+     *  the parent perform object instead; see perform::mark_dirty().
      */
 
-    bool m_dirty_main;          /**< Provides the main dirtiness flag.      */
-    bool m_dirty_edit;          /**< Provides the main is-edited flag.      */
-    bool m_dirty_perf;          /**< Provides performance dirty flagflag.   */
-    bool m_dirty_names;         /**< Provides the names dirtiness flag.     */
+    std::atomic<bool> m_dirty_main;     /**< The main dirtiness flag.       */
+    std::atomic<bool> m_dirty_edit;     /**< The main is-edited flag.       */
+    std::atomic<bool> m_dirty_perf;     /**< The performance dirty flag.    */
+    std::atomic<bool> m_dirty_names;    /**< The names dirtiness flag.      */
+
+    /**
+     *  Changes whenever the events of the sequence change, so that views
+     *  can cache what they draw from them (see mainwid).  Each change takes
+     *  the next value of m_edit_counter, which is shared by all sequences,
+     *  so that a version never matches another sequence, even one that
+     *  reuses the address of a deleted sequence.  Mute, queue, and other
+     *  status changes leave it alone.
+     */
+
+    std::atomic<unsigned> m_edit_version;
 
     /**
      *  Indicates that the sequence is currently being edited.
@@ -674,6 +753,7 @@ public:
     ~sequence ();
 
     void partial_assign (const sequence & rhs);
+    void snapshot_assign (const sequence & rhs);
 
     /**
      * \getter m_events
@@ -1347,6 +1427,15 @@ public:
     void set_dirty_mp ();
     void set_dirty ();
 
+    /**
+     * \getter m_edit_version
+     */
+
+    unsigned edit_version () const
+    {
+        return m_edit_version;
+    }
+
     /**
      * \getter m_midi_channel
      */
@@ -1393,6 +1482,7 @@ public:
         midibyte d0, midibyte d1, bool paint = false
     );
     bool append_event (const event & er);
+    void take_events (event_list & evl);
 
     /**
      *  Calls event_list::sort().
@@ -1553,6 +1643,7 @@ public:
     midipulse clip_timestamp (midipulse ontime, midipulse offtime);
     void move_selected_notes (midipulse deltatick, int deltanote);
     bool stream_event (event & ev);
+    int merge_recorded_events (bool wait = true);
     bool change_event_data_range
     (
         midipulse tick_s, midipulse tick_f,
@@ -1614,29 +1705,30 @@ public:
     void off_playing_notes ();
     void stop (bool song_mode = false);
     void pause (bool song_mode = false);
-    void inc_draw_marker ();
-    void reset_draw_marker ();
-    void reset_draw_trigger_marker ();
-    void reset_ex_iterator (event_list::const_iterator & evi);
-    draw_type_t get_next_note_event
+    void reset_ex_iterator
     (
-        midipulse & tick_s, midipulse & tick_f, int & note,
-        bool & selected, int & velocity
-    );
-    bool get_minmax_note_events (int & lowest, int & highest);
-    bool get_next_event (midibyte & status, midibyte & cc);
+        event_list::const_iterator & evi, midipulse tick = 0
+    ) const;
+    void visit_notes
+    (
+        midipulse tick_s, midipulse tick_f, const note_visitor & visitor
+    ) const;
+    void visit_events
+    (
+        midipulse tick_s, midipulse tick_f, midibyte status, midibyte cc,
+        const event_visitor & visitor
+    ) const;
+    void visit_triggers
+    (
+        midipulse tick_s, midipulse tick_f, const trigger_visitor & visitor
+    ) const;
+    bool get_minmax_note_events (int & lowest, int & highest) const;
     bool get_next_event_ex
     (
         midibyte status, midibyte cc,
         event_list::const_iterator & ev,
         int evtype = EVENTS_ALL
     );
-
-    bool get_next_trigger
-    (
-        midipulse & tick_on, midipulse & tick_off,
-        bool & selected, midipulse & tick_offset
-    );
     void quantize_events
     (
         midibyte status, midibyte cc,
@@ -1792,6 +1884,11 @@ private:
 
     void set_parent (perform * p);
     void put_event_on_bus (event & ev);
+    int merge_recorded_locked (spsc_queue<event> & q);
+    void quantize_recorded_note
+    (
+        event_list::iterator on, event_list::iterator off
+    );
 #ifdef SEQ64_STAZED_EXPAND_RECORD
     void reset_loop ();
 #endif
@@ -1802,6 +1899,16 @@ private:
     void remove (event & e);
     void remove_all ();
 
+    /**
+     *  Gives the sequence a new edit version.  Called, with the lock held,
+     *  by every function that changes the events.
+     */
+
+    void bump_edit_version ()
+    {
+        m_edit_version = ++m_edit_counter;
+    }
+
     /**
      *  Checks to see if the event's channel matches the sequence's nominal
      *  channel.
@@ -0,0 +1,193 @@
+#ifndef SEQ64_SESSION_CACHE_HPP
+#define SEQ64_SESSION_CACHE_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          session_cache.hpp
+ *
+ *  This module declares a class that keeps a binary copy of the tracks of a
+ *  loaded MIDI file, so that the next load of the same file can skip the
+ *  decoding.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  Loading a set with a thousand patterns spends most of its time decoding
+ *  the track chunks, sorting each event list, and linking the Note Ons to
+ *  their Note Offs in verify_and_link().  None of that changes from one load
+ *  of the same file to the next.
+ *
+ *  When the [session-cache] option is on, midifile::parse() hands each
+ *  decoded SMF 1 track to this class, which writes the sequences (events in
+ *  order, with their links stored as indices, plus the triggers and track
+ *  settings) to a cache file in the configuration directory.  The next
+ *  parse() maps that file with a single mmap() and rebuilds the sequences
+ *  directly.
+ *
+ *  The MIDI file remains the source of truth.  The cache is used only if its
+ *  format version, the size, modification time, and content hash of the
+ *  MIDI file, and the load settings that affect decoding (PPQN and buss
+ *  override) all match.  Otherwise the file is parsed as usual, and the
+ *  cache is rewritten.  The small proprietary track at the end of the file
+ *  (mute groups, notepads, and so on) is always parsed from the MIDI file
+ *  itself.
+ */
+
+#include <cstddef>                      /* std::size_t                      */
+#include <string>                       /* std::string                      */
+#include <vector>                       /* std::vector<>                    */
+
+#include "midibyte.hpp"                 /* seq64::midibyte, midilong        */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+    class sequence;
+
+/**
+ *  Writes and reads the cache file of one MIDI file.  Not copyable.
+ */
+
+class session_cache
+{
+
+public:
+
+    /**
+     *  Describes one track chunk, as midifile::install_track() received it.
+     *  Replaying these in order rebuilds the same perform settings that the
+     *  parse produced.
+     */
+
+    struct track_info
+    {
+        int ti_track;                   /**< The index of the track.        */
+        midilong ti_id;                 /**< The chunk ID, normally MTrk.   */
+        int ti_offset;                  /**< The chunk data offset.         */
+        int ti_length;                  /**< The chunk data length.         */
+        int ti_seqnum;                  /**< The sequence number read.      */
+        int ti_beats_per_bar;           /**< Time signature, if read.       */
+        int ti_beat_width;              /**< Time signature, if read.       */
+        int ti_clocks_per_metronome;    /**< Time signature, if read.       */
+        int ti_32nds_per_quarter;       /**< Time signature, if read.       */
+        double ti_tempo_us;             /**< The first tempo of track 0.    */
+        sequence * ti_seq;              /**< The decoded sequence.          */
+    };
+
+private:
+
+    /**
+     *  The full path to the MIDI file.
+     */
+
+    std::string m_midi_name;
+
+    /**
+     *  The full path to the cache file.
+     */
+
+    std::string m_cache_name;
+
+    /**
+     *  The load settings that change the decoded events.
+     */
+
+    int m_ppqn;
+    bool m_use_default_ppqn;
+    int m_buss_override;
+
+    /**
+     *  The tracks logged during a parse, or rebuilt by load().  Sequences
+     *  rebuilt by load() belong to this object until the caller takes them
+     *  (by nulling ti_seq); logged sequences belong to the perform object.
+     */
+
+    std::vector<track_info> m_tracks;
+
+    /**
+     *  True if the sequences in m_tracks were created by load().
+     */
+
+    bool m_owns_sequences;
+
+public:
+
+    session_cache
+    (
+        const std::string & midifilename,
+        int ppqn,
+        bool use_default_ppqn
+    );
+    ~session_cache ();
+
+    bool load (const midibyte * data, std::size_t size, int & propoffset);
+    bool store (const midibyte * data, std::size_t size, int propoffset);
+
+    /**
+     *  Adds a track, as installed by the parser, to the list to be stored.
+     */
+
+    void log_track (const track_info & ti)
+    {
+        m_tracks.push_back(ti);
+    }
+
+    /**
+     * \getter m_tracks
+     */
+
+    std::vector<track_info> & tracks ()
+    {
+        return m_tracks;
+    }
+
+    /**
+     * \getter m_cache_name
+     */
+
+    const std::string & cache_name () const
+    {
+        return m_cache_name;
+    }
+
+private:
+
+    session_cache (const session_cache &);                  /* no copy      */
+    session_cache & operator = (const session_cache &);     /* no copy      */
+
+    void clear ();
+
+};          // class session_cache
+
+}           // namespace seq64
+
+#endif      // SEQ64_SESSION_CACHE_HPP
+
+/*
+ * session_cache.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
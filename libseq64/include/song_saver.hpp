@@ -0,0 +1,186 @@
+#ifndef SEQ64_SONG_SAVER_HPP
+#define SEQ64_SONG_SAVER_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          song_saver.hpp
+ *
+ *  This module declares a class that saves a song on a background thread.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  The GUI thread calls start(), which takes a song_snapshot (the only part
+ *  of the save that touches the perform object) and hands it to a worker
+ *  thread that fills the track containers and writes the file.  The GUI
+ *  polls finished() from its timer to learn the outcome, so that it never
+ *  blocks on the disk.
+ *
+ *  Only one save runs at a time.  A save requested while another is running
+ *  is refused; the caller can wait() and retry, or simply let the next
+ *  autosave pick up the changes.
+ */
+
+#include <atomic>                       /* std::atomic<>                    */
+#include <string>                       /* std::string                      */
+#include <pthread.h>                    /* pthread_t C structure            */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+    class perform;
+    class song_snapshot;
+
+/**
+ *  Runs one save at a time on its own thread.  Not copyable.
+ */
+
+class song_saver
+{
+
+private:
+
+    /**
+     *  The states of the saver.  Only the worker thread changes the state
+     *  from running to done; only the owner's thread changes it otherwise.
+     */
+
+    enum status
+    {
+        SAVE_IDLE,
+        SAVE_RUNNING,
+        SAVE_DONE
+    };
+
+    /**
+     *  Provides the performance whose "modified" flag is cleared or restored
+     *  by a save.  Set by start().
+     */
+
+    perform * m_perform;
+
+    /**
+     *  The thread doing the save, and whether it still needs to be joined.
+     */
+
+    pthread_t m_thread;
+    bool m_thread_launched;
+
+    /**
+     *  The current state, one of the status values.
+     */
+
+    std::atomic<int> m_status;
+
+    /**
+     *  The copy of the song being written.  Owned by this object while a
+     *  save is in progress.
+     */
+
+    song_snapshot * m_snapshot;
+
+    /**
+     *  The parameters of the midifile object that does the writing.
+     */
+
+    std::string m_filename;
+    int m_ppqn;
+    bool m_oldformat;
+    bool m_globalbgs;
+
+    /**
+     *  True if this is an autosave, which leaves the "modified" flag alone,
+     *  since the song itself has not been saved.
+     */
+
+    bool m_autosave;
+
+    /**
+     *  The outcome of the save, valid once m_status is SAVE_DONE.
+     */
+
+    bool m_result;
+    std::string m_error_message;
+
+public:
+
+    song_saver ();
+    ~song_saver ();
+
+    bool start
+    (
+        perform & p,
+        const std::string & filename,
+        int ppqn,
+        bool oldformat,
+        bool globalbgs,
+        bool autosave = false
+    );
+    bool finished (bool & ok, std::string & filename, std::string & errmsg);
+    bool wait ();
+
+    /**
+     * \getter m_status
+     *      Returns true if a save has been started and finished() has not
+     *      yet reported it.
+     */
+
+    bool busy () const
+    {
+        return m_status.load() != SAVE_IDLE;
+    }
+
+    /**
+     * \getter m_autosave
+     *      Valid while busy().
+     */
+
+    bool autosave () const
+    {
+        return m_autosave;
+    }
+
+private:
+
+    song_saver (const song_saver &);                        /* no copy      */
+    song_saver & operator = (const song_saver &);           /* no copy      */
+
+    void write ();
+    void collect (bool & ok, std::string & filename, std::string & errmsg);
+
+    static void * save_thread_func (void * mysaver);
+
+};          // class song_saver
+
+}           // namespace seq64
+
+#endif      // SEQ64_SONG_SAVER_HPP
+
+/*
+ * song_saver.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -0,0 +1,238 @@
+#ifndef SEQ64_SONG_SNAPSHOT_HPP
+#define SEQ64_SONG_SNAPSHOT_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          song_snapshot.hpp
+ *
+ *  This module declares a class holding a detached copy of everything
+ *  midifile writes when saving a song.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  midifile::write() used to walk the live perform object while it filled
+ *  the track containers and wrote the file, all on the GUI thread.  A save
+ *  during a live set froze the interface, and a sequence edited during the
+ *  save could be written half-changed.
+ *
+ *  Now the caller takes a song_snapshot on the thread that owns the perform
+ *  object.  take() copies each active sequence (its events, triggers, and
+ *  settings, under the sequence's lock), the timing values, the screen-set
+ *  notepads, the mute groups, and the global key, scale, and background
+ *  sequence.  After that, the snapshot shares nothing with the perform
+ *  object, and midifile::write() can turn it into a file on any thread,
+ *  while the user goes on editing.
+ */
+
+#include <string>                       /* std::string                      */
+#include <vector>                       /* std::vector<>                    */
+
+#include "midibyte.hpp"                 /* seq64::midi_timing               */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+    class perform;
+    class sequence;
+
+/**
+ *  Holds a consistent copy of a song, ready to be written.  Not copyable.
+ */
+
+class song_snapshot
+{
+
+private:
+
+    /**
+     *  The copied sequences, in track order.  Owned by this object.
+     */
+
+    std::vector<sequence *> m_sequences;
+
+    /**
+     *  The sequence (track) number of each entry in m_sequences.
+     */
+
+    std::vector<int> m_track_numbers;
+
+    /**
+     *  The song's tempo, time signature, and PPQN.
+     */
+
+    midi_timing m_timing;
+
+    /**
+     *  The tempo track number.
+     */
+
+    int m_tempo_track;
+
+    /**
+     *  The notepad text of each screen-set.
+     */
+
+    std::vector<std::string> m_notepads;
+
+    /**
+     *  True if any mute group has an unmuted sequence.
+     */
+
+    bool m_any_group_unmutes;
+
+    /**
+     *  The state of each sequence in each mute group, indexed by group times
+     *  c_seqs_in_set plus the sequence.
+     */
+
+    std::vector<bool> m_group_mutes;
+
+    /**
+     *  The global musical key, scale, and background sequence from the
+     *  "user" settings.
+     */
+
+    int m_musical_key;
+    int m_musical_scale;
+    int m_background_sequence;
+
+public:
+
+    song_snapshot ();
+    ~song_snapshot ();
+
+    int take (perform & p);
+    void clear ();
+
+    /**
+     * \getter m_sequences.size()
+     */
+
+    int count () const
+    {
+        return int(m_sequences.size());
+    }
+
+    /**
+     * \getter m_track_numbers[index]
+     */
+
+    int track_number (int index) const
+    {
+        return m_track_numbers[index];
+    }
+
+    /**
+     * \getter m_sequences[index]
+     */
+
+    sequence & track (int index) const
+    {
+        return *m_sequences[index];
+    }
+
+    /**
+     * \getter m_timing
+     */
+
+    const midi_timing & timing () const
+    {
+        return m_timing;
+    }
+
+    /**
+     * \getter m_tempo_track
+     */
+
+    int tempo_track () const
+    {
+        return m_tempo_track;
+    }
+
+    /**
+     * \getter m_notepads[screenset]
+     */
+
+    const std::string & notepad (int screenset) const
+    {
+        return m_notepads[screenset];
+    }
+
+    /**
+     * \getter m_any_group_unmutes
+     */
+
+    bool any_group_unmutes () const
+    {
+        return m_any_group_unmutes;
+    }
+
+    bool group_mute_state (int group, int seq) const;
+
+    /**
+     * \getter m_musical_key
+     */
+
+    int musical_key () const
+    {
+        return m_musical_key;
+    }
+
+    /**
+     * \getter m_musical_scale
+     */
+
+    int musical_scale () const
+    {
+        return m_musical_scale;
+    }
+
+    /**
+     * \getter m_background_sequence
+     */
+
+    int background_sequence () const
+    {
+        return m_background_sequence;
+    }
+
+private:
+
+    song_snapshot (const song_snapshot &);                  /* no copy      */
+    song_snapshot & operator = (const song_snapshot &);     /* no copy      */
+
+};          // class song_snapshot
+
+}           // namespace seq64
+
+#endif      // SEQ64_SONG_SNAPSHOT_HPP
+
+/*
+ * song_snapshot.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
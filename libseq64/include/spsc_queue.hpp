@@ -0,0 +1,241 @@
+#ifndef SEQ64_SPSC_QUEUE_HPP
+#define SEQ64_SPSC_QUEUE_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          spsc_queue.hpp
+ *
+ *  This module declares/defines a small lock-free, single-producer,
+ *  single-consumer queue.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  The queue is a fixed-size ring of pre-constructed slots.  Items are
+ *  copied into and out of the slots, so that no allocation occurs once the
+ *  queue is constructed (as long as copying the item type does not itself
+ *  allocate).  This makes the queue usable from the MIDI input and output
+ *  threads, which must never wait on a mutex held by a slower thread.
+ *
+ *  The rules are simple:
+ *
+ *      -   Only one thread may call push().
+ *      -   Only one thread at a time may call pop() or clear().  If more than
+ *          one thread needs to drain the queue, the drainers must serialize
+ *          themselves, for example by holding the mutex that protects the
+ *          destination of the popped items.
+ *
+ *  If push() finds the queue full, it returns false, and the caller must
+ *  decide what to do with the item (usually, fall back to the old locked
+ *  path).
+ */
+
+#include <atomic>                       /* std::atomic<>                    */
+#include <vector>                       /* std::vector<>                    */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Provides a bounded, lock-free ring buffer for one producer thread and one
+ *  consumer thread.  The capacity is rounded up to a power of two, so that
+ *  the index arithmetic is a simple mask.
+ */
+
+template <typename T>
+class spsc_queue
+{
+
+private:
+
+    /**
+     *  Holds the items.  The vector is sized once, in the constructor, and is
+     *  never resized.
+     */
+
+    std::vector<T> m_slots;
+
+    /**
+     *  The slot count minus one.  Used to wrap the indices.
+     */
+
+    const unsigned m_mask;
+
+    /**
+     *  The index of the next slot to be read.  Written only by the consumer.
+     */
+
+    std::atomic<unsigned> m_head;
+
+    /**
+     *  The index of the next slot to be written.  Written only by the
+     *  producer.
+     */
+
+    std::atomic<unsigned> m_tail;
+
+private:
+
+    spsc_queue (const spsc_queue &);                /* not copyable     */
+    spsc_queue & operator = (const spsc_queue &);   /* not assignable   */
+
+    /**
+     *  Rounds the requested capacity up to the next power of two, with a
+     *  minimum of 2.
+     */
+
+    static unsigned round_up (unsigned n)
+    {
+        unsigned result = 2;
+        while (result < n)
+            result <<= 1;
+
+        return result;
+    }
+
+public:
+
+    /**
+     *  Principal constructor.
+     *
+     * \param capacity
+     *      The desired number of slots.  This value is rounded up to a power
+     *      of two.
+     */
+
+    spsc_queue (unsigned capacity = 1024)
+     :
+        m_slots (round_up(capacity)),
+        m_mask  (round_up(capacity) - 1),
+        m_head  (0),
+        m_tail  (0)
+    {
+        // Empty body
+    }
+
+    /**
+     * \getter m_slots.size()
+     */
+
+    unsigned capacity () const
+    {
+        return unsigned(m_slots.size());
+    }
+
+    /**
+     *  Returns true if no items are waiting.  The result is only a snapshot,
+     *  of course.
+     */
+
+    bool empty () const
+    {
+        return m_head.load(std::memory_order_acquire) ==
+            m_tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     *  Returns the number of items waiting.  Also only a snapshot.
+     */
+
+    unsigned size () const
+    {
+        return m_tail.load(std::memory_order_acquire) -
+            m_head.load(std::memory_order_acquire);
+    }
+
+    /**
+     *  Copies an item into the queue.  Producer thread only.
+     *
+     * \param item
+     *      The item to copy into the next free slot.
+     *
+     * \return
+     *      Returns false if the queue is full, in which case the item was not
+     *      added.
+     */
+
+    bool push (const T & item)
+    {
+        unsigned tail = m_tail.load(std::memory_order_relaxed);
+        unsigned head = m_head.load(std::memory_order_acquire);
+        bool result = (tail - head) < capacity();
+        if (result)
+        {
+            m_slots[tail & m_mask] = item;
+            m_tail.store(tail + 1, std::memory_order_release);
+        }
+        return result;
+    }
+
+    /**
+     *  Copies the oldest item out of the queue and removes it.  Consumer
+     *  thread only.
+     *
+     * \param [out] item
+     *      The destination of the oldest item.  Unchanged if the queue is
+     *      empty.
+     *
+     * \return
+     *      Returns false if the queue was empty.
+     */
+
+    bool pop (T & item)
+    {
+        unsigned head = m_head.load(std::memory_order_relaxed);
+        unsigned tail = m_tail.load(std::memory_order_acquire);
+        bool result = head != tail;
+        if (result)
+        {
+            item = m_slots[head & m_mask];
+            m_head.store(head + 1, std::memory_order_release);
+        }
+        return result;
+    }
+
+    /**
+     *  Discards every item currently in the queue.  Consumer thread only.
+     */
+
+    void clear ()
+    {
+        m_head.store
+        (
+            m_tail.load(std::memory_order_acquire), std::memory_order_release
+        );
+    }
+
+};          // class spsc_queue
+
+}           // namespace seq64
+
+#endif      // SEQ64_SPSC_QUEUE_HPP
+
+/*
+ * spsc_queue.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
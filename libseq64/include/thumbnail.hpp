@@ -0,0 +1,140 @@
+#ifndef SEQ64_THUMBNAIL_HPP
+#define SEQ64_THUMBNAIL_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          thumbnail.hpp
+ *
+ *  This module declares a class that holds the miniature piano roll of a
+ *  pattern, as drawn in the main window.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  The main window used to walk every event of a pattern each time its slot
+ *  was redrawn, which happens on every screen-set change, mute toggle, queue
+ *  change, and so on.  A thumbnail is the result of that walk, scaled to the
+ *  size of the slot:  the horizontal runs of pixels covered by notes, merged
+ *  so that a dense pattern costs no more than its picture, plus the tempo
+ *  lines.  It has no colors; those depend on the status of the pattern, and
+ *  are applied as the runs are drawn.
+ *
+ *  A thumbnail is rendered again only when the edit version of the sequence
+ *  (see sequence::edit_version()), its length, or the size of the slot
+ *  changes.  Rendering uses no GUI toolkit.
+ */
+
+#include <vector>                       /* std::vector<>                    */
+
+#include "midibyte.hpp"                 /* seq64::midipulse                 */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+    class sequence;
+
+/**
+ *  The cached picture of the events of one sequence.
+ */
+
+class thumbnail
+{
+
+public:
+
+    /**
+     *  A horizontal line, in pixels relative to the top-left corner of the
+     *  note area of the slot.  Both ends are included.
+     */
+
+    struct span
+    {
+        int s_y;                        /**< The row of the line.           */
+        int s_x0;                       /**< The first column.              */
+        int s_x1;                       /**< The last column.               */
+    };
+
+private:
+
+    /**
+     *  What the thumbnail was rendered from, to tell if it is current.
+     */
+
+    const sequence * m_seq;
+    unsigned m_version;
+    midipulse m_length;
+    int m_width;
+    int m_height;
+
+    /**
+     *  The note runs, sorted by row and column, with no overlaps.
+     */
+
+    std::vector<span> m_notes;
+
+    /**
+     *  The tempo lines, in event order.  They are drawn two pixels thick.
+     */
+
+    std::vector<span> m_tempos;
+
+public:
+
+    thumbnail ();
+
+    bool current (const sequence & seq, int width, int height) const;
+    void render (const sequence & seq, int width, int height);
+    void clear ();
+
+    /**
+     * \getter m_notes
+     */
+
+    const std::vector<span> & notes () const
+    {
+        return m_notes;
+    }
+
+    /**
+     * \getter m_tempos
+     */
+
+    const std::vector<span> & tempos () const
+    {
+        return m_tempos;
+    }
+
+};          // class thumbnail
+
+}           // namespace seq64
+
+#endif      // SEQ64_THUMBNAIL_HPP
+
+/*
+ * thumbnail.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
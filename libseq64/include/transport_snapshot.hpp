@@ -0,0 +1,190 @@
+#ifndef SEQ64_TRANSPORT_SNAPSHOT_HPP
+#define SEQ64_TRANSPORT_SNAPSHOT_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          transport_snapshot.hpp
+ *
+ *  This module declares/defines a lock-free copy of the transport state,
+ *  published by the performance for the user interface.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  The output thread moves the play tick many times per GUI frame.  The
+ *  user interface only needs to know where the transport was when it
+ *  draws, so the tick and the running and playing flags are packed into
+ *  one atomic word.  A reader always sees a consistent set of values, and
+ *  neither side waits on the other.  The flags take the low two bits, which
+ *  leaves 61 bits for the tick, far more than any song needs.
+ */
+
+#include <atomic>                       /* std::atomic<>                    */
+
+#include "midibyte.hpp"                 /* seq64::midipulse                 */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  The transport state, as published by the performance.
+ */
+
+class transport_snapshot
+{
+
+public:
+
+    /**
+     *  One reading of the transport state.
+     */
+
+    struct state
+    {
+        midipulse ts_tick;              /**< The play tick (progress).      */
+        bool ts_running;                /**< True if the transport runs.    */
+        bool ts_playing;                /**< True if patterns are playing.  */
+    };
+
+private:
+
+    /**
+     *  The flag bits of the packed word.
+     */
+
+    static const long long c_running = 0x01;
+    static const long long c_playing = 0x02;
+    static const int c_flag_bits = 2;
+
+    /**
+     *  The packed state:  the tick shifted left by c_flag_bits, or'ed with
+     *  the flags.
+     */
+
+    std::atomic<long long> m_word;
+
+private:
+
+    transport_snapshot (const transport_snapshot &);            /* no copy  */
+    transport_snapshot & operator = (const transport_snapshot &);
+
+    /**
+     *  Sets or clears one flag, leaving the rest of the word alone.
+     */
+
+    void flag (long long bit, bool on)
+    {
+        if (on)
+            m_word.fetch_or(bit, std::memory_order_release);
+        else
+            m_word.fetch_and(~bit, std::memory_order_release);
+    }
+
+public:
+
+    /**
+     *  Default constructor.  The transport is stopped at tick 0.
+     */
+
+    transport_snapshot () : m_word (0)
+    {
+        // no code
+    }
+
+    /**
+     *  Publishes the play tick, keeping the flags.  Callable from any
+     *  thread; usually the output thread.
+     *
+     * \param tick
+     *      The new tick.  A negative tick is published as 0.
+     */
+
+    void tick (midipulse tick)
+    {
+        if (tick < 0)
+            tick = 0;
+
+        long long old = m_word.load(std::memory_order_relaxed);
+        long long word;
+        do
+        {
+            word = (static_cast<long long>(tick) << c_flag_bits) |
+                (old & (c_running | c_playing));
+        }
+        while
+        (
+            ! m_word.compare_exchange_weak
+            (
+                old, word, std::memory_order_release, std::memory_order_relaxed
+            )
+        );
+    }
+
+    /**
+     *  Publishes the running flag.
+     */
+
+    void running (bool on)
+    {
+        flag(c_running, on);
+    }
+
+    /**
+     *  Publishes the pattern-playing flag.
+     */
+
+    void playing (bool on)
+    {
+        flag(c_playing, on);
+    }
+
+    /**
+     *  Reads the whole state at once.  Callable from any thread; usually
+     *  the GUI thread, once per frame.
+     */
+
+    state get () const
+    {
+        long long word = m_word.load(std::memory_order_acquire);
+        state result;
+        result.ts_tick = midipulse(word >> c_flag_bits);
+        result.ts_running = (word & c_running) != 0;
+        result.ts_playing = (word & c_playing) != 0;
+        return result;
+    }
+
+};          // class transport_snapshot
+
+}           // namespace seq64
+
+#endif      // SEQ64_TRANSPORT_SNAPSHOT_HPP
+
+/*
+ * transport_snapshot.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -288,6 +288,7 @@ class triggers
     friend class midi_container;
     friend class midifile;
     friend class sequence;
+    friend class session_cache;         /* stores and restores triggers */
     friend class Seq24PerfInput;        /* we need better encapsulation */
     friend class FruityPerfInput;       /* we need better encapsulation */
 
@@ -366,12 +367,6 @@ private:
 
     List::iterator m_iterator_play_trigger;
 
-    /**
-     *  An iterator for cycling through the triggers during drawing.
-     */
-
-    List::iterator m_iterator_draw_trigger;
-
     /**
      *  Set to true if there is an active trigger in the trigger clipboard.
      */
@@ -522,22 +517,6 @@ public:
         m_number_selected = 0;
     }
 
-    bool next
-    (
-        midipulse & tick_on, midipulse & tick_off,
-        bool & selected, midipulse & tick_offset
-    );
-    trigger next_trigger ();
-
-    /**
-     *  Sets the draw-trigger iterator to the beginning of the trigger list.
-     */
-
-    void reset_draw_trigger_marker ()
-    {
-        m_iterator_draw_trigger = m_triggers.begin();
-    }
-
     void set_trigger_paste_tick (midipulse tick)
     {
         m_paste_tick = tick;
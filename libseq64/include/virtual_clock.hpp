@@ -0,0 +1,207 @@
+#ifndef SEQ64_VIRTUAL_CLOCK_HPP
+#define SEQ64_VIRTUAL_CLOCK_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          virtual_clock.hpp
+ *
+ *  This module declares/defines a clock that either follows the monotonic
+ *  clock or is moved by hand.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  The loop-back MIDI backend stamps what it sends and receives with this
+ *  clock, rather than with the time of the machine.  In the free-running
+ *  mode the clock counts microseconds from its creation, so that the output
+ *  of a live performance can be timed exactly.  In the manual mode it moves
+ *  only when set() or advance() is called, so that a test or an offline
+ *  render decides what time it is, and can run as fast as the CPU allows.
+ *  Switching between the modes keeps the time continuous.
+ *
+ *  The clock also holds the tick that the performance last played, which
+ *  mastermidibase::play_position() passes along, so that each message can
+ *  be stamped with both.
+ */
+
+#include <atomic>                       /* std::atomic<>                    */
+#include <time.h>                       /* clock_gettime()                  */
+
+#include "midibyte.hpp"                 /* seq64::midipulse                 */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  A settable clock, in microseconds, plus the current play tick.
+ */
+
+class virtual_clock
+{
+
+private:
+
+    /**
+     *  True if the clock moves only by set() and advance().
+     */
+
+    std::atomic<bool> m_manual;
+
+    /**
+     *  In the free-running mode, the monotonic time that is time 0 of this
+     *  clock.  In the manual mode, the time of this clock.
+     */
+
+    std::atomic<long long> m_base_us;
+
+    /**
+     *  The tick that the performance last played.
+     */
+
+    std::atomic<midipulse> m_tick;
+
+private:
+
+    virtual_clock (const virtual_clock &);                      /* no copy  */
+    virtual_clock & operator = (const virtual_clock &);
+
+public:
+
+    /**
+     *  Default constructor.  The clock starts at time 0 and tick 0.
+     *
+     * \param manual
+     *      If true, the clock stays at 0 until it is set or advanced.
+     */
+
+    virtual_clock (bool manual = false)
+     :
+        m_manual    (manual),
+        m_base_us   (manual ? 0 : monotonic_us()),
+        m_tick      (0)
+    {
+        // no code
+    }
+
+    /**
+     * \return
+     *      Returns the time of this clock, in microseconds.
+     */
+
+    long long now_us () const
+    {
+        long long base = m_base_us.load(std::memory_order_acquire);
+        return m_manual.load(std::memory_order_acquire) ?
+            base : monotonic_us() - base ;
+    }
+
+    /**
+     * \getter m_manual
+     */
+
+    bool manual () const
+    {
+        return m_manual.load(std::memory_order_acquire);
+    }
+
+    /**
+     *  Switches between the manual and free-running modes, without a jump
+     *  in the time.  Call it from the thread that drives the clock.
+     */
+
+    void manual (bool on)
+    {
+        if (on != manual())
+        {
+            long long t = now_us();
+            m_base_us.store(on ? t : monotonic_us() - t);
+            m_manual.store(on, std::memory_order_release);
+        }
+    }
+
+    /**
+     *  Sets the time of a manual clock.  Has no effect on a free-running
+     *  clock.
+     */
+
+    void set (long long us)
+    {
+        if (manual())
+            m_base_us.store(us, std::memory_order_release);
+    }
+
+    /**
+     *  Moves a manual clock forward.  Has no effect on a free-running clock.
+     */
+
+    void advance (long long us)
+    {
+        if (manual())
+            m_base_us.fetch_add(us, std::memory_order_acq_rel);
+    }
+
+    /**
+     * \getter m_tick
+     */
+
+    midipulse tick () const
+    {
+        return m_tick.load(std::memory_order_acquire);
+    }
+
+    /**
+     * \setter m_tick
+     */
+
+    void tick (midipulse t)
+    {
+        m_tick.store(t, std::memory_order_release);
+    }
+
+    /**
+     * \return
+     *      Returns the monotonic time of the machine, in microseconds.
+     */
+
+    static long long monotonic_us ()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+    }
+
+};          // class virtual_clock
+
+}           // namespace seq64
+
+#endif      // SEQ64_VIRTUAL_CLOCK_HPP
+
+/*
+ * virtual_clock.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -425,6 +425,77 @@ busarray::clock (midipulse tick)
         bi->clock(tick);
 }
 
+/**
+ *  Collects the busses that are active and have their clock enabled, for use
+ *  by the clock_generator.  The vector is indexed by buss number, so that
+ *  busses without a clock get a null pointer.  The midibus objects are
+ *  never deleted while the application runs (port_exit() only deactivates
+ *  them), so the pointers remain valid after the caller unlocks.
+ *
+ * \param [out] buses
+ *      Receives the buss pointers.  It is cleared first.
+ *
+ * \return
+ *      Returns the number of clocked busses found.
+ */
+
+int
+busarray::clock_buses (std::vector<midibus *> & buses)
+{
+    int result = 0;
+    buses.clear();
+    std::vector<businfo>::iterator bi;
+    for (bi = m_container.begin(); bi != m_container.end(); ++bi)
+    {
+        midibus * b = nullptr;
+        if (bi->active() && not_nullptr(bi->bus()))
+        {
+            if (bi->bus()->get_clock() != e_clock_off)
+            {
+                b = bi->bus();
+                ++result;
+            }
+        }
+        buses.push_back(b);
+    }
+    return result;
+}
+
+/**
+ *  Makes a copy of the buss list, for the master buss to publish to the
+ *  playback functions.  The copy shares the midibus pointers, and does not
+ *  own them; it must be deleted with plain delete, never turned back into a
+ *  busarray (whose destructor deletes the busses).
+ *
+ * \return
+ *      Returns a new copy of the businfo container.
+ */
+
+std::vector<businfo> *
+busarray::snapshot () const
+{
+    return new std::vector<businfo>(m_container);
+}
+
+/**
+ *  Makes every buss serialize its output with the given lock.  Used when
+ *  the busses share one MIDI handle.
+ *
+ * \param m
+ *      The shared lock.
+ */
+
+void
+busarray::share_io_mutex (bus_lock & m)
+{
+    std::vector<businfo>::iterator bi;
+    for (bi = m_container.begin(); bi != m_container.end(); ++bi)
+    {
+        if (not_nullptr(bi->bus()))
+            bi->bus()->share_io_mutex(m);
+    }
+}
+
 /**
  *  Handles SysEx events; used for output busses.
  *
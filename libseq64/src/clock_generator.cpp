@@ -0,0 +1,491 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          clock_generator.cpp
+ *
+ *  This module defines the class that emits outgoing MIDI clock from a
+ *  thread of its own.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  See the clock_generator.hpp module for the overview.
+ */
+
+#include <errno.h>                      /* EINTR                            */
+#include <sched.h>                      /* SCHED_FIFO                       */
+#include <stdio.h>                      /* printf()                         */
+#include <string.h>                     /* memset()                         */
+#include <time.h>                       /* clock_nanosleep()                */
+
+#include "calculations.hpp"             /* clock_ticks_from_ppqn()          */
+#include "clock_generator.hpp"          /* seq64::clock_generator           */
+#include "easy_macros.h"                /* errprint(), infoprint()          */
+#include "mastermidibase.hpp"           /* seq64::mastermidibase            */
+#include "midibus.hpp"                  /* seq64::midibus                   */
+#include "settings.hpp"                 /* seq64::rc()                      */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Gets the current time on the monotonic clock, in nanoseconds.  The
+ *  monotonic clock is not affected by changes to the system time, so it is
+ *  the right clock for sleeping until an absolute deadline.
+ */
+
+static long long
+monotonic_ns ()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ *  Sleeps until the given absolute time on the monotonic clock.  Returns at
+ *  once if the time has already passed.
+ *
+ * \param deadline_ns
+ *      The time at which to wake, in nanoseconds.
+ */
+
+static void
+sleep_until_ns (long long deadline_ns)
+{
+    struct timespec ts;
+    ts.tv_sec = time_t(deadline_ns / 1000000000LL);
+    ts.tv_nsec = long(deadline_ns % 1000000000LL);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+        ;
+}
+
+/**
+ *  Zeroes all of the statistics.
+ */
+
+void
+clock_stats::clear ()
+{
+    cs_count = 0;
+    cs_nominal_us = 0;
+    cs_min_us = 0;
+    cs_max_us = 0;
+    cs_total_us = 0;
+    for (int b = 0; b < SEQ64_CLOCK_HISTOGRAM_BUCKETS; ++b)
+        cs_histogram[b] = 0;
+}
+
+/**
+ *  Adds one measured interval.  The cs_nominal_us member must already be
+ *  set.
+ *
+ * \param interval_us
+ *      The time since the previous pulse on the same buss.
+ */
+
+void
+clock_stats::add (long interval_us)
+{
+    if (cs_count == 0 || interval_us < cs_min_us)
+        cs_min_us = interval_us;
+
+    if (cs_count == 0 || interval_us > cs_max_us)
+        cs_max_us = interval_us;
+
+    ++cs_count;
+    cs_total_us += interval_us;
+
+    long deviation = interval_us - cs_nominal_us;
+    if (deviation < 0)
+        deviation = -deviation;
+
+    long bucket = deviation / SEQ64_CLOCK_HISTOGRAM_US;
+    if (bucket >= SEQ64_CLOCK_HISTOGRAM_BUCKETS)
+        bucket = SEQ64_CLOCK_HISTOGRAM_BUCKETS - 1;
+
+    ++cs_histogram[bucket];
+}
+
+/**
+ *  Principal constructor.  The thread is not created until launch() is
+ *  called.
+ *
+ * \param mmb
+ *      The master buss, which must outlive this object.
+ */
+
+clock_generator::clock_generator (mastermidibase & mmb)
+ :
+    m_master_bus        (mmb),
+    m_condition_var     (),
+    m_stats_mutex       (),
+    m_thread            (),
+    m_thread_launched   (false),
+    m_exiting           (false),
+    m_running           (false),
+    m_idle              (true),
+    m_bpm               (SEQ64_DEFAULT_BPM),
+    m_ppqn              (SEQ64_DEFAULT_PPQN),
+    m_start_tick        (0),
+    m_buses             (),
+    m_last_pulse_us     (),
+    m_stats             ()
+{
+    // Empty body
+}
+
+/**
+ *  Tells the thread to exit, and waits for it.  The perform object must
+ *  delete this object before it deletes the master buss.
+ */
+
+clock_generator::~clock_generator ()
+{
+    m_condition_var.lock();
+    m_exiting = true;
+    m_running = false;
+    m_condition_var.signal();
+    m_condition_var.unlock();
+    if (m_thread_launched)
+        pthread_join(m_thread, NULL);
+}
+
+/**
+ *  Creates the generator thread, which then waits for start().
+ *
+ * \return
+ *      Returns true if the thread was created.
+ */
+
+bool
+clock_generator::launch ()
+{
+    int err = pthread_create(&m_thread, NULL, clock_thread_func, this);
+    m_thread_launched = err == 0;
+    if (! m_thread_launched)
+    {
+        errprint("clock_generator: could not create the clock thread");
+    }
+
+    return m_thread_launched;
+}
+
+/**
+ *  Starts the clock.  Called by perform::output_func() right after
+ *  mastermidibase::init_clock(), which sets each buss's starting point and
+ *  sends MIDI Start or Continue.  The list of clocked busses is obtained now,
+ *  and the statistics are reset.
+ *
+ *  If the clock is already running (for example, JACK has just re-acquired
+ *  its lock), it is stopped first, so that the timeline is re-anchored at
+ *  the new tick.
+ *
+ * \param tick
+ *      The tick at which playback starts.  It corresponds to "now".
+ *
+ * \param bpm
+ *      The current tempo.
+ *
+ * \param ppqn
+ *      The PPQN of the busses.
+ */
+
+void
+clock_generator::start (midipulse tick, midibpm bpm, int ppqn)
+{
+    if (m_running)
+        stop();
+
+    m_condition_var.lock();
+    {
+        automutex locker(m_stats_mutex);
+        (void) m_master_bus.get_clock_buses(m_buses);
+        m_last_pulse_us.assign(m_buses.size(), 0);
+        m_stats.resize(m_buses.size());
+        for (size_t b = 0; b < m_stats.size(); ++b)
+            m_stats[b].clear();
+    }
+    m_start_tick = tick;
+    m_ppqn = ppqn;
+    m_bpm = bpm;
+    m_running = true;
+    m_condition_var.signal();
+    m_condition_var.unlock();
+}
+
+/**
+ *  Stops the clock, and waits until the thread has stopped sending pulses.
+ *  The wait is at most one pulse interval.  The caller can then send MIDI
+ *  Stop knowing that no stray clock will follow it.
+ */
+
+void
+clock_generator::stop ()
+{
+    m_running = false;
+    m_condition_var.lock();
+    while (! m_idle)
+        m_condition_var.wait();
+
+    m_condition_var.unlock();
+}
+
+/**
+ *  Changes the tempo.  The generator picks up the new value before the next
+ *  pulse, and anchors the new tempo at the last pulse it sent.  Lock-free, so
+ *  it can be called from any thread.
+ *
+ * \param bpm
+ *      The new tempo.
+ */
+
+void
+clock_generator::tempo (midibpm bpm)
+{
+    m_bpm = bpm;
+}
+
+/**
+ *  Copies the statistics of one buss.
+ *
+ * \threadsafe
+ *
+ * \param bus
+ *      The buss number.
+ *
+ * \param [out] stats
+ *      The destination of the copy.  Unchanged if the buss number is bad.
+ *
+ * \return
+ *      Returns true if the buss number is valid and the buss is clocked.
+ */
+
+bool
+clock_generator::get_stats (int bus, clock_stats & stats) const
+{
+    automutex locker(m_stats_mutex);
+    bool result = bus >= 0 && bus < int(m_stats.size());
+    if (result)
+        result = not_nullptr(m_buses[bus]);
+
+    if (result)
+        stats = m_stats[bus];
+
+    return result;
+}
+
+/**
+ *  Prints the statistics of each clocked buss to the console.  Called by
+ *  perform::output_func() when playback stops and the --stats option is in
+ *  force.  Only the histogram buckets with counts are shown.
+ */
+
+void
+clock_generator::show_stats () const
+{
+    int count = bus_count();
+    printf("\n-- clock thread pulse intervals --\n");
+    for (int bus = 0; bus < count; ++bus)
+    {
+        clock_stats cs;
+        if (get_stats(bus, cs) && cs.cs_count > 0)
+        {
+            printf
+            (
+                "bus %d: %ld intervals, nominal %ld us, "
+                "min %ld us, mean %ld us, max %ld us\n",
+                bus, cs.cs_count, cs.cs_nominal_us,
+                cs.cs_min_us, cs.mean_us(), cs.cs_max_us
+            );
+            for (int b = 0; b < SEQ64_CLOCK_HISTOGRAM_BUCKETS; ++b)
+            {
+                if (cs.cs_histogram[b] > 0)
+                {
+                    printf
+                    (
+                        "  [%s%5d us][%8ld]\n",
+                        b == SEQ64_CLOCK_HISTOGRAM_BUCKETS - 1 ? ">=" : "< ",
+                        b == SEQ64_CLOCK_HISTOGRAM_BUCKETS - 1 ?
+                            b * SEQ64_CLOCK_HISTOGRAM_US :
+                            (b + 1) * SEQ64_CLOCK_HISTOGRAM_US,
+                        cs.cs_histogram[b]
+                    );
+                }
+            }
+        }
+    }
+}
+
+/**
+ *  Records the time of a pulse on a buss, and adds the interval since the
+ *  previous pulse to the buss's statistics.
+ *
+ * \param bus
+ *      The buss number.
+ *
+ * \param now_us
+ *      The time the pulse was sent.
+ *
+ * \param nominal_us
+ *      The ideal interval at the current tempo.
+ */
+
+void
+clock_generator::measure (int bus, long long now_us, long nominal_us)
+{
+    long long last_us = m_last_pulse_us[bus];
+    m_last_pulse_us[bus] = now_us;
+    if (last_us > 0)
+    {
+        automutex locker(m_stats_mutex);
+        m_stats[bus].cs_nominal_us = nominal_us;
+        m_stats[bus].add(long(now_us - last_us));
+    }
+}
+
+/**
+ *  The body of the generator thread.  It waits for start(), then sends one
+ *  pulse per deadline until stop() is called.
+ *
+ *  The deadline of each pulse is computed from an anchor (a time and a tick)
+ *  rather than by adding intervals, so that rounding and late wake-ups do
+ *  not accumulate.  The anchor is the starting point, or the last pulse
+ *  before a tempo change.  The first pulse is at the first multiple of the
+ *  clock interval (PPQN / 24) at or after the starting tick, which is where
+ *  midibase::init_clock() expects it.
+ */
+
+void
+clock_generator::generate ()
+{
+    for (;;)
+    {
+        m_condition_var.lock();
+        while (! m_running && ! m_exiting)
+        {
+            m_idle = true;
+            m_condition_var.signal();           /* release a waiting stop() */
+            m_condition_var.wait();
+        }
+        bool exiting = m_exiting;
+        m_idle = exiting;
+        midipulse tick = m_start_tick;
+        int ppqn = m_ppqn;
+        m_condition_var.unlock();
+        if (exiting)
+            break;
+
+        int ct = clock_ticks_from_ppqn(ppqn);
+        if (ct < 1)
+            ct = 1;
+
+        midipulse pulse = ((tick + ct - 1) / ct) * ct;
+        long long anchor_ns = monotonic_ns();
+        midipulse anchor_tick = tick;
+        long long last_ns = anchor_ns;
+        midipulse last_tick = anchor_tick;
+        midibpm bpm = m_bpm;
+        while (m_running)
+        {
+            midibpm b = m_bpm;
+            if (b != bpm && b > 0.0)
+            {
+                anchor_ns = last_ns;            /* re-anchor at last pulse  */
+                anchor_tick = last_tick;
+                bpm = b;
+            }
+
+            double ns_per_tick = 60000000000.0 / (bpm * ppqn);
+            long long deadline_ns = anchor_ns +
+                (long long)(double(pulse - anchor_tick) * ns_per_tick);
+
+            sleep_until_ns(deadline_ns);
+            if (! m_running)
+                break;
+
+            long long now_us = monotonic_ns() / 1000;
+            long nominal_us = long(ns_per_tick * ct / 1000.0);
+            for (int bus = 0; bus < int(m_buses.size()); ++bus)
+            {
+                /* midibase::clock() holds the buss's (or handle's) mutex */
+
+                midibus * mb = m_buses[bus];
+                if (not_nullptr(mb) && mb->clock(pulse) > 0)
+                    measure(bus, now_us, nominal_us);
+            }
+            last_ns = deadline_ns;
+            last_tick = pulse;
+            pulse += ct;
+        }
+    }
+}
+
+/**
+ *  The thread function.  With the --priority option, it gives the thread a
+ *  SCHED_FIFO priority one above the output thread.  Failure to do so is
+ *  reported, but the clock still runs at normal priority.
+ *
+ * \param mygenerator
+ *      The clock_generator object.
+ *
+ * \return
+ *      Always returns nullptr.
+ */
+
+void *
+clock_thread_func (void * mygenerator)
+{
+    clock_generator * cg = (clock_generator *) mygenerator;
+    if (rc().priority())
+    {
+        struct sched_param schp;
+        memset(&schp, 0, sizeof(sched_param));
+        schp.sched_priority = SEQ64_CLOCK_THREAD_PRIORITY;
+        if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &schp) != 0)
+        {
+            errprint
+            (
+                "clock_thread_func: couldn't set SCHED_FIFO, "
+                "need root priviledges."
+            );
+        }
+        else
+        {
+            infoprint("[Clock thread priority set above output]");
+        }
+    }
+    cg->generate();
+    return nullptr;
+}
+
+}           // namespace seq64
+
+/*
+ * clock_generator.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -114,6 +114,7 @@ static struct option long_options [] =
     {"inverse",             0, 0, 'K'},
     {"stats",               0, 0, 'S'},
     {"priority",            0, 0, 'p'},
+    {"clock-thread",        0, 0, 'T'},                 /* new */
     {"ignore",              required_argument, 0, 'i'},
     {"interaction-method",  required_argument, 0, 'x'},
 #ifdef SEQ64_JACK_SUPPORT
@@ -183,7 +184,7 @@ static struct option long_options [] =
  *
 \verbatim
         0123456789 @AaBbCcDdEeFfGgHhIiJjKkLlMmNnOoPpQqRrSsTtUuVvWwXxYyZz#
-         ooooooooo oxxxxxx x  xx  xx xxx xxxxxxx *xx xxxxx xxxxx   x    x
+         ooooooooo oxxxxxx x  xx  xx xxx xxxxxxx *xx xxxxxxxxxxx   x    x
 \endverbatim
  *
  *  Previous arg-list, items missing! "ChVH:lRrb:q:Lni:jJmaAM:pPusSU:x:"
@@ -193,7 +194,7 @@ static struct option long_options [] =
  */
 
 static const std::string s_arg_list =
-    "AaB:b:Cc:F:f:H:hi:JjKkLlM:mNn:Ppq:RrtSsU:uVvx:#"   /* modern args      */
+    "AaB:b:Cc:F:f:H:hi:JjKkLlM:mNn:Ppq:RrSsTtU:uVvx:#"  /* modern args      */
     "1234:5:67:89@"                                     /* legacy args      */
     ;
 
@@ -239,6 +240,8 @@ static const char * const s_help_1b =
 "   -q, --ppqn qn            Specify default PPQN to replace 192.  The MIDI\n"
 "                            file might specify its own PPQN.\n"
 "   -p, --priority           Run high priority, FIFO scheduler (needs root).\n"
+"   -T, --clock-thread       Emit MIDI clock from its own thread, on absolute\n"
+"                            deadlines.  With -S, shows clock jitter on stop.\n"
 "   -P, --pass-sysex         Passes incoming SysEx messages to all outputs.\n"
 "                            Not yet fully implemented.\n"
 "   -i, --ignore n           Ignore ALSA device number.\n"
@@ -957,6 +960,10 @@ parse_command_line_options (perform & p, int argc, char * argv [])
             seq64::rc().stats(true);
             break;
 
+        case 'T':
+            seq64::rc().clock_thread(true);
+            break;
+
         case 's':
             seq64::rc().show_midi(true);
             break;
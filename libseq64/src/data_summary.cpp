@@ -0,0 +1,261 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          data_summary.cpp
+ *
+ *  This module defines a class that summarizes one data lane of a pattern
+ *  at every zoom level.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  The values are the heights that seqdata has always drawn:  the first
+ *  data byte for one-byte messages, the second otherwise, and the scaled
+ *  tempo for tempo events.
+ */
+
+#include <limits>                       /* std::numeric_limits<>            */
+
+#include "calculations.hpp"             /* seq64::tempo_to_note_value()     */
+#include "data_summary.hpp"             /* seq64::data_summary              */
+#include "sequence.hpp"                 /* seq64::sequence                  */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Default constructor.  The summary is not current for any lane.
+ */
+
+data_summary::data_summary ()
+ :
+    m_valid     (false),
+    m_status    (0),
+    m_cc        (0),
+    m_levels    (),
+    m_tempos    ()
+{
+    // no code
+}
+
+/**
+ *  Tells if the summary was built for the given lane, and not cleared
+ *  since.  The owner clears it whenever the events may have changed.
+ *
+ * \param status
+ *      The status of the events of the lane.
+ *
+ * \param cc
+ *      The controller number, used only for control changes.
+ *
+ * \return
+ *      Returns true if build() need not be called.
+ */
+
+bool
+data_summary::current (midibyte status, midibyte cc) const
+{
+    return m_valid && m_status == status && m_cc == cc;
+}
+
+/**
+ *  Walks the events of the lane once, to fill the lowest level, one column
+ *  per distinct tick, and the tempo marks.  Each higher level is then made
+ *  by merging neighboring pairs of spans of the level below it.
+ *
+ * \param seq
+ *      The sequence to summarize.  It is locked only for the walk.
+ *
+ * \param status
+ *      The status of the events of the lane.
+ *
+ * \param cc
+ *      The controller number, used only for control changes.
+ */
+
+void
+data_summary::build (const sequence & seq, midibyte status, midibyte cc)
+{
+    clear();
+
+    std::vector<column> & base = m_levels[0];
+    bool onebyte = event::is_one_byte_msg(status);
+    seq.visit_events
+    (
+        0, std::numeric_limits<midipulse>::max(), status, cc,
+        [&] (const event & e)
+        {
+            midipulse t = e.get_timestamp();
+            if (e.is_tempo())
+            {
+                tempo_mark tm;
+                tm.tm_tick = t;
+                tm.tm_bpm = e.tempo();
+                tm.tm_value = int(tempo_to_note_value(tm.tm_bpm));
+                tm.tm_selected = e.is_selected();
+                m_tempos.push_back(tm);
+                return;
+            }
+            if (e.is_ex_data())
+                return;                             /* other Meta events    */
+
+            midibyte d0, d1;
+            e.get_data(d0, d1);
+
+            int value = onebyte ? d0 : d1 ;
+            if (! base.empty() && base.back().c_tick == t)
+            {
+                column & c = base.back();
+                if (value < c.c_min)
+                    c.c_min = value;
+
+                if (value > c.c_max)
+                    c.c_max = value;
+
+                ++c.c_count;
+                c.c_selected = c.c_selected || e.is_selected();
+            }
+            else
+            {
+                column c;
+                c.c_tick = t;
+                c.c_min = c.c_max = value;
+                c.c_count = 1;
+                c.c_selected = e.is_selected();
+                base.push_back(c);
+            }
+        }
+    );
+
+    for (int k = 1; k < c_levels; ++k)
+    {
+        const std::vector<column> & below = m_levels[k - 1];
+        std::vector<column> & here = m_levels[k];
+        here.reserve(below.size() / 2 + 1);
+        for (std::size_t i = 0; i < below.size(); ++i)
+        {
+            const column & b = below[i];
+            midipulse t = (b.c_tick >> k) << k;         /* start of span    */
+            if (! here.empty() && here.back().c_tick == t)
+            {
+                column & c = here.back();
+                if (b.c_min < c.c_min)
+                    c.c_min = b.c_min;
+
+                if (b.c_max > c.c_max)
+                    c.c_max = b.c_max;
+
+                c.c_count += b.c_count;
+                c.c_selected = c.c_selected || b.c_selected;
+            }
+            else
+            {
+                here.push_back(b);
+                here.back().c_tick = t;
+            }
+        }
+    }
+    m_status = status;
+    m_cc = cc;
+    m_valid = true;
+}
+
+/**
+ *  Empties the summary, so that it is current for no lane.
+ */
+
+void
+data_summary::clear ()
+{
+    m_valid = false;
+    for (int k = 0; k < c_levels; ++k)
+        m_levels[k].clear();
+
+    m_tempos.clear();
+}
+
+/**
+ *  Picks the level to draw at a zoom:  the one with the widest span that
+ *  divides the width of a pixel, so that no span straddles two pixels.  For
+ *  the usual power-of-two zooms, that is one span per pixel.
+ *
+ * \param zoom
+ *      The number of ticks per pixel.
+ *
+ * \return
+ *      Returns the level, from 0 to c_levels - 1.
+ */
+
+int
+data_summary::level_for (int zoom)
+{
+    int k = 0;
+    while (k < c_levels - 1 && zoom > 0 && zoom % (2 << k) == 0)
+        ++k;
+
+    return k;
+}
+
+/**
+ *  Finds the first column of a level that ends after the given tick, by
+ *  binary search.
+ *
+ * \param level
+ *      The level, which the caller must have checked.
+ *
+ * \param tick
+ *      The left edge of the view.
+ *
+ * \return
+ *      Returns the index of the column, which is the size of the level if
+ *      there is none.
+ */
+
+std::size_t
+data_summary::first (int level, midipulse tick) const
+{
+    const std::vector<column> & cols = m_levels[level];
+    midipulse span = midipulse(1) << level;
+    std::size_t low = 0;
+    std::size_t high = cols.size();
+    while (low < high)
+    {
+        std::size_t mid = (low + high) / 2;
+        if (cols[mid].c_tick + span <= tick)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+}           // namespace seq64
+
+/*
+ * data_summary.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -25,13 +25,22 @@
  * \library       sequencer64 application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2015-12-04
- * \updates       2017-07-30
+ * \updates       2026-10-18
  * \license       GNU GPLv2 or above
  *
  *  A MIDI editable event is encapsulated by the seq64::editable_events
  *  object.
+ *
+ *  The events are a copy of those of the sequence plus the deltas made by
+ *  the user (see the header).  Walking, counting, and indexing merge the two
+ *  on the fly.  The deltas are the few events a user edits by hand, so the
+ *  merging costs little more than a binary search of the copy.
  */
 
+#include <algorithm>                    /* std::upper_bound(), etc.     */
+#include <iterator>                     /* std::distance()              */
+#include <limits>                       /* std::numeric_limits<>        */
+
 #include "editable_events.hpp"          /* seq64::editable_events       */
 #include "sequence.hpp"                 /* seq64::sequence              */
 
@@ -48,6 +57,76 @@ namespace seq64
  * sequence, and load up the CC/name pairs on the fly.
  */
 
+/*
+ * Section: editable_events::iterator
+ */
+
+/**
+ *  Default constructor, for an iterator that points nowhere.
+ */
+
+editable_events::iterator::iterator ()
+ :
+    m_owner     (nullptr),
+    m_is_added  (false),
+    m_base      (0),
+    m_added     ()
+{
+    // no code
+}
+
+/**
+ *  Moves to the next event.  The caller must make sure the iterator is not
+ *  end().
+ */
+
+editable_events::iterator &
+editable_events::iterator::operator ++ ()
+{
+    *this = m_owner->next(*this);
+    return *this;
+}
+
+/**
+ *  Moves to the previous event.  The caller must make sure the iterator is
+ *  not begin().
+ */
+
+editable_events::iterator &
+editable_events::iterator::operator -- ()
+{
+    *this = m_owner->prev(*this);
+    return *this;
+}
+
+/**
+ *  Tells if two iterators point to the same event.
+ */
+
+bool
+editable_events::iterator::operator == (const iterator & rhs) const
+{
+    if (m_is_added != rhs.m_is_added)
+        return false;
+
+    return m_is_added ? m_added == rhs.m_added : m_base == rhs.m_base ;
+}
+
+/**
+ *  Makes the editable form of the event.  The caller must make sure the
+ *  iterator is not end().
+ */
+
+editable_event
+editable_events::iterator::operator * () const
+{
+    return editable_event(*m_owner, m_owner->get(*this));
+}
+
+/*
+ * Section: editable_events
+ */
+
 /**
  *  This constructor hooks into the sequence object.
  *
@@ -62,20 +141,22 @@ namespace seq64
 
 editable_events::editable_events (sequence & seq, midibpm bpm)
  :
-    m_events            (),
-    m_current_event     (m_events.end()),
+    m_base              (),
+    m_removed           (),
+    m_added             (),
+    m_current_event     (),
     m_sequence          (seq),
     m_midi_parameters
     (
         bpm, seq.get_beats_per_bar(), seq.get_beat_width(), seq.get_ppqn()
     )
 {
-    // Empty body
+    m_current_event = end();
 }
 
 /**
- *  This copy constructor initializes most of the class members.
- *  Note that we need to reconstitute the event links here, as well.
+ *  This copy constructor initializes most of the class members.  The current
+ *  event belongs to rhs, so it is not copied.
  *
  * \param rhs
  *      Provides the editable_events object to be copied.
@@ -83,20 +164,18 @@ editable_events::editable_events (sequence & seq, midibpm bpm)
 
 editable_events::editable_events (const editable_events & rhs)
  :
-    m_events            (rhs.m_events),
-    m_current_event     (rhs.m_current_event),
+    m_base              (rhs.m_base),
+    m_removed           (rhs.m_removed),
+    m_added             (rhs.m_added),
+    m_current_event     (),
     m_sequence          (rhs.m_sequence),
     m_midi_parameters   (rhs.m_midi_parameters)
 {
-#ifdef USE_VERIFY_AND_LINK                  /* not yet ready */
-    if (m_events.count() > 1)
-        m_events.verify_and_link();
-#endif
+    m_current_event = end();
 }
 
 /**
  *  This principal assignment operator sets most of the class members.
- *  Note that we need to reconstitute the event links here, as well.
  *
  * \param rhs
  *      Provides the editable_events object to be assigned.
@@ -111,14 +190,12 @@ editable_events::operator = (const editable_events & rhs)
 {
     if (this != &rhs)
     {
-        m_events            = rhs.m_events;
-        m_current_event     = rhs.m_current_event;
+        m_base              = rhs.m_base;
+        m_removed           = rhs.m_removed;
+        m_added             = rhs.m_added;
+        m_current_event     = end();
         m_midi_parameters   = rhs.m_midi_parameters;
         m_sequence.partial_assign(rhs.m_sequence);
-#ifdef USE_VERIFY_AND_LINK                  /* not yet ready */
-        if (m_events.count() > 1)
-            m_events.verify_and_link();
-#endif
     }
     return *this;
 }
@@ -137,8 +214,9 @@ editable_events::get_length () const
     midipulse result = 0;
     if (count() > 0)
     {
-        const_reverse_iterator lci = m_events.rbegin(); /* get last element */
-        result = lci->second.timestamp();               /* get length value */
+        iterator last = end();
+        --last;                                         /* get last element */
+        result = get(last).get_timestamp();             /* get length value */
     }
     return result;
 }
@@ -162,14 +240,8 @@ editable_events::add (const event & e)
 }
 
 /**
- *  Adds an editable event to the internal event list.  For the std::multimap
- *  implementation, this is an option if we want to make sure the insertion
- *  succeed:
- *
-\verbatim
- *      std::pair<Events::iterator, bool> result = m_events.insert(p);
- *      return result.second;
-\endverbatim
+ *  Adds an editable event to the inserted events.  Only its event part is
+ *  kept; its strings are made again when it is viewed.
  *
  * \param e
  *      Provides the regular event to be added to the list of editable events.
@@ -187,71 +259,116 @@ editable_events::add (const event & e)
 bool
 editable_events::add (const editable_event & e)
 {
-    size_t count = m_events.size();         /* save initial size            */
-    event_list::event_key key(e);           /* create the key value         */
-
-#if __cplusplus >= 201103L                  /* C++11                        */
-    EventsPair p = std::make_pair(key, e);
-#else
-    EventsPair p = std::make_pair<event_key, event>(key, e);
-#endif
-
-    iterator ei = m_events.insert(p);       /* std::multimap operation      */
-    bool result = m_events.size() == (count + 1);
+    int oldcount = count();                 /* save initial size            */
+    const event & ev = e;                   /* the part that is kept        */
+    Key key(ev);                            /* create the key value         */
+    Added::const_iterator ai = m_added.insert(EventsPair(key, ev));
+    bool result = count() == (oldcount + 1);
     if (result)
-        current_event(ei);
+        current_event(make_added(ai));
 
     return result;
 }
 
 /**
- *  Accesses the sequence's event-list, iterating through it from beginning to
- *  end, wrapping each event in the list in an editable event and inserting it
- *  into the editable-event container.
+ *  Removes an event.  Other iterators stay valid.
  *
- *  Note that the new events will not have valid links (actually, no links).
- *  These links are used for associating Note Off events with their respective
- *  Note On events.  To be consistent, we must take the time to reconstitute
- *  these links, using event_list::verify_and_link().
+ * \param ie
+ *      The event to remove, ignored if it is end().
+ */
+
+void
+editable_events::remove (iterator ie)
+{
+    if (ie == end())                        /* \change ca 2017-04-30    */
+        return;
+
+    if (ie == m_current_event)
+        m_current_event = end();
+
+    if (ie.m_is_added)
+        m_added.erase(ie.m_added);
+    else if (! is_removed(ie.m_base))
+    {
+        m_removed.insert
+        (
+            std::lower_bound(m_removed.begin(), m_removed.end(), ie.m_base),
+            ie.m_base
+        );
+    }
+}
+
+/**
+ *  Empties the container, including the copy of the events.
+ */
+
+void
+editable_events::clear ()
+{
+    m_base.clear();
+    m_removed.clear();
+    m_added.clear();
+    m_current_event = end();
+}
+
+/**
+ *  Copies the events of the sequence, in order, under its lock, and drops
+ *  any edits.  No editable_event is made here.
+ *
+ *  The copy is sorted by key, as the event list is.  If it somehow is not,
+ *  it is sorted, stably, so that the order of events with equal keys is
+ *  kept, as the multimap once did.
  *
  * \return
- *      Returns true if the size of the final editable_event container matches
- *      the size of the original events container.
+ *      Returns true if the size of the copy matches the size of the original
+ *      events container.
  */
 
 bool
 editable_events::load_events ()
 {
-    bool result;
-    int original_count = m_sequence.events().count();
-
-    for
+    clear();
+    m_base.reserve(std::size_t(m_sequence.event_count()));
+    m_sequence.visit_events
     (
-        event_list::const_iterator ei = m_sequence.events().begin();
-        ei != m_sequence.events().end(); ++ei
-    )
-    {
-        if (! add(DREF(ei)))
-            break;
-    }
-    result = count() == original_count;
+        0, std::numeric_limits<midipulse>::max(), EVENT_ANY, 0,
+        [this] (const event & e) { m_base.push_back(e); }
+    );
+    if (! std::is_sorted(m_base.begin(), m_base.end(), event_before))
+        std::stable_sort(m_base.begin(), m_base.end(), event_before);
 
-#ifdef USE_VERIFY_AND_LINK                  /* not yet ready */
-    if (result && count() > 1)
-        m_events.verify_and_link();
-#endif
+    m_current_event = end();
 
 #ifdef PLATFORM_DEBUG_TMI
-    m_sequence.events().print();
     print();
 #endif
 
-    return result;
+    return count() == m_sequence.event_count();
+}
+
+/**
+ *  Writes the edited events, in order, into an event list.
+ *
+ * \param evl
+ *      The list to fill.  It should be empty.
+ *
+ * \return
+ *      Returns true if every event was added.
+ */
+
+bool
+editable_events::get_events (event_list & evl) const
+{
+    for (iterator ei = begin(); ei != end(); ++ei)
+    {
+        if (! evl.add(get(ei)))
+            return false;
+    }
+    return evl.count() == count();
 }
 
 /**
- *  Erases the sequence's event container and recreates it using the edited
- *  container of editable events.
+ *  Replaces the events of the sequence with the edited events.
  *
  *  Note that the old events are replaced only if the container of editable
  *  events is not empty.  There are safer ways for the user to erase all the
@@ -271,18 +388,129 @@ editable_events::save_events ()
     bool result = count() > 0;
     if (result)
     {
-        m_sequence.events().clear();
-        for (const_iterator ei = events().begin(); ei != events().end(); ++ei)
+        event_list newevents;
+        result = get_events(newevents);
+        if (result)
         {
-            event ev = EEDREF(ei);            /* actually a conversion! */
-            if (! m_sequence.add_event(ev))
-                break;
+            m_sequence.copy_events(newevents);
+            result = m_sequence.event_count() == count();
         }
-        result = m_sequence.events().count () == count();
     }
     return result;
 }
 
+/**
+ * \return
+ *      Returns an iterator to the first event, or end() if there is none.
+ *      Among copied and inserted events with equal keys, the copied one
+ *      comes first.
+ */
+
+editable_events::iterator
+editable_events::begin () const
+{
+    Base::size_type b = next_base(0);
+    Added::const_iterator a = m_added.begin();
+    bool base_first = b < m_base.size() &&
+        (a == m_added.end() || ! (a->first < Key(m_base[b])));
+
+    if (base_first)
+        return make_base(b);
+    else if (a != m_added.end())
+        return make_added(a);
+    else
+        return end();
+}
+
+/**
+ * \return
+ *      Returns the iterator past the last event.
+ */
+
+editable_events::iterator
+editable_events::end () const
+{
+    return make_base(m_base.size());
+}
+
+/**
+ *  Finds the event at a given position, without walking the events before
+ *  it.  The inserted events are placed among the copied ones by binary
+ *  search, and the copied event is then found by skipping the deleted ones
+ *  before it.
+ *
+ * \param index
+ *      The position of the event, re 0.
+ *
+ * \return
+ *      Returns the iterator to the event, or end() if the index is out of
+ *      range.
+ */
+
+editable_events::iterator
+editable_events::at (int index) const
+{
+    if (index < 0 || index >= count())
+        return end();
+
+    Base::size_type before = 0;                 /* inserted events before   */
+    Base::size_type position = Base::size_type(index);
+    for (Added::const_iterator a = m_added.begin(); a != m_added.end(); ++a)
+    {
+        Base::size_type b = base_after(a->first);
+        Base::size_type p = before + b - removed_before(b);
+        if (p == position)
+            return make_added(a);
+        else if (p > position)
+            break;
+
+        ++before;
+    }
+
+    Base::size_type b = position - before;      /* ordinal among the copied */
+    Removed::const_iterator r;
+    for (r = m_removed.begin(); r != m_removed.end(); ++r)
+    {
+        if (*r <= b)
+            ++b;
+        else
+            break;
+    }
+    return make_base(b);
+}
+
+/**
+ *  The inverse of at().
+ *
+ * \param ie
+ *      The event to locate.
+ *
+ * \return
+ *      Returns the position of the event, re 0, or count() for end().
+ */
+
+int
+editable_events::index_of (const iterator & ie) const
+{
+    if (ie == end())
+        return count();
+
+    Base::size_type result;
+    if (ie.m_is_added)
+    {
+        Base::size_type b = base_after(ie.m_added->first);
+        result = b - removed_before(b) +
+            std::distance(m_added.begin(), ie.m_added);
+    }
+    else
+    {
+        Key k(m_base[ie.m_base]);
+        result = ie.m_base - removed_before(ie.m_base) +
+            std::distance(m_added.begin(), m_added.lower_bound(k));
+    }
+    return int(result);
+}
+
 /**
  *  Prints a list of the currently-held events.  Useful for debugging.
  */
@@ -291,159 +519,232 @@ void
 editable_events::print () const
 {
     printf("editable_events[%d]:\n", count());
-    for (Events::const_iterator i = m_events.begin(); i != m_events.end(); ++i)
+    for (iterator i = begin(); i != end(); ++i)
         dref(i).print();
 }
 
-#ifdef USE_VERIFY_AND_LINK                  /* not yet ready */
+/**
+ *  Orders the copied events by key, for the binary searches.
+ */
 
-/*
- *  These functions are DUPLICATES of the functions in event_list.
- *  We would like to be able to re-use this code somehow, perhaps by
- *  making them member template functions, templated on the type of
- *  event container.
+bool
+editable_events::key_before (const Key & k, const event & e)
+{
+    return k < Key(e);
+}
+
+/**
+ *  Orders two events by key.
  */
 
+bool
+editable_events::event_before (const event & a, const event & b)
+{
+    return Key(a) < Key(b);
+}
+
 /**
- *  Clears all event links and unmarks them all.
+ *  Gets the event an iterator points to.  The caller must make sure it is not
+ *  end().
  */
 
-void
-editable_events::clear_links ()
+const event &
+editable_events::get (const iterator & ie) const
 {
-    for (Events::iterator i = m_events.begin(); i != m_events.end(); ++i)
-    {
-        event & e = dref(i);
-        e.clear_link();
-        e.unmark();
-    }
+    return ie.m_is_added ? ie.m_added->second : m_base[ie.m_base] ;
 }
 
 /**
- *  This function verifies state: all note-ons have an off, and it links
- *  note-offs with their note-ons.
- *
- * \threadsafe
- *
- * \param slength
- *      Provides the length beyond which events will be pruned.
+ * \return
+ *      Returns true if the copied event at the given position was deleted.
  */
 
-void
-editable_events::verify_and_link (midipulse slength)
+bool
+editable_events::is_removed (Base::size_type b) const
+{
+    return std::binary_search(m_removed.begin(), m_removed.end(), b);
+}
+
+/**
+ * \return
+ *      Returns the number of deleted copied events before the given
+ *      position in m_base.
+ */
+
+editable_events::Base::size_type
+editable_events::removed_before (Base::size_type b) const
+{
+    return std::lower_bound(m_removed.begin(), m_removed.end(), b) -
+        m_removed.begin();
+}
+
+/**
+ * \return
+ *      Returns the position of the first copied event with a key greater
+ *      than the given key, deleted or not.
+ */
+
+editable_events::Base::size_type
+editable_events::base_after (const Key & k) const
+{
+    return std::upper_bound
+    (
+        m_base.begin(), m_base.end(), k, key_before
+    ) - m_base.begin();
+}
+
+/**
+ * \return
+ *      Returns the position of the first copied event at or after the given
+ *      position that was not deleted, or m_base.size() if there is none.
+ */
+
+editable_events::Base::size_type
+editable_events::next_base (Base::size_type b) const
 {
-    clear_links();
-    for (event_list::iterator on = m_events.begin(); on != m_events.end(); on++)
+    while (b < m_base.size() && is_removed(b))
+        ++b;
+
+    return b;
+}
+
+/**
+ * \return
+ *      Returns the position of the last copied event before the given
+ *      position that was not deleted, or m_base.size() if there is none.
+ */
+
+editable_events::Base::size_type
+editable_events::prev_base (Base::size_type b) const
+{
+    while (b > 0)
     {
-        event & eon = dref(on);
-        if (eon.is_note_on())               /* Note On, find its Note Off   */
-        {
-            event_list::iterator off = on;  /* get next possible Note Off   */
-            off++;
-            bool endfound = false;
-            while (off != m_events.end())
-            {
-                event & eoff = dref(off);
-                if                          /* Off, == notes, not marked    */
-                (
-                    eoff.is_note_off() &&
-                    eoff.get_note() == eon.get_note() &&
-                    ! eoff.is_marked()
-                )
-                {
-                    eon.link(&eoff);                    /* link + mark */
-                    eoff.link(&eon);
-                    eon.mark();
-                    eoff.mark();
-                    endfound = true;
-                    break;
-                }
-                off++;
-            }
-            if (! endfound)
-            {
-                off = m_events.begin();
-                while (off != on)
-                {
-                    event & eoff = dref(off);
-                    if
-                    (
-                        eoff.is_note_off() &&
-                        eoff.get_note() == eon.get_note() &&
-                        ! eoff.is_marked()
-                    )
-                    {
-                        eon.link(&eoff);                /* link + mark */
-                        eoff.link(&eon);
-                        eon.mark();
-                        eoff.mark();
-                        endfound = true;
-                        break;
-                    }
-                    off++;
-                }
-            }
-        }
+        --b;
+        if (! is_removed(b))
+            return b;
     }
-    unmark_all();
-    mark_out_of_range(slength);
+    return m_base.size();
 }
 
 /**
- *  Marks all events.  Not yet used, but might come in handy with the event
- *  editor dialog.
+ * \return
+ *      Returns an iterator to a copied event, or end() for m_base.size().
  */
 
-void
-editable_events::mark_all ()
+editable_events::iterator
+editable_events::make_base (Base::size_type b) const
 {
-    for (Events::iterator i = m_events.begin(); i != m_events.end(); ++i)
-        dref(i).mark();
+    iterator result;
+    result.m_owner = this;
+    result.m_is_added = false;
+    result.m_base = b;
+    result.m_added = m_added.end();
+    return result;
 }
 
 /**
- *  Unmarks all events.
+ * \return
+ *      Returns an iterator to an inserted event.
  */
 
-void
-editable_events::unmark_all ()
+editable_events::iterator
+editable_events::make_added (Added::const_iterator a) const
 {
-    for (Events::iterator i = m_events.begin(); i != m_events.end(); ++i)
-        dref(i).unmark();
+    iterator result;
+    result.m_owner = this;
+    result.m_is_added = true;
+    result.m_base = m_base.size();
+    result.m_added = a;
+    return result;
 }
 
 /**
- *  Marks all events that have a time-stamp that is out of range.
- *  Used for killing (pruning) those events not in range.  If the current
- *  time-stamp is greater than the length, then the event is marked for
- *  pruning.
+ *  Finds the event after the given one:  the earlier of the next copied
+ *  event and the next inserted event, the copied one first if their keys
+ *  are equal.
  *
- * \note
- *      This code was comparing the timestamp as greater than or equal to the
- *      sequence length.  However, being equal is fine.  This may explain why
- *      the midifile code would add one tick to the length of the last note
- *      when processing the end-of-track.
+ * \param ie
+ *      The current event, which must not be end().
  *
- * \param slength
- *      Provides the length beyond which events will be pruned.
+ * \return
+ *      Returns the next event, or end().
  */
 
-void
-editable_events::mark_out_of_range (midipulse slength)
+editable_events::iterator
+editable_events::next (const iterator & ie) const
 {
-    for (Events::iterator i = m_events.begin(); i != m_events.end(); ++i)
+    Base::size_type b;
+    Added::const_iterator a;
+    if (ie.m_is_added)
     {
-        event & e = dref(i);
-        if (e.get_timestamp() > slength)
-        {
-            e.mark();                           /* we have to prune it  */
-            if (e.is_linked())
-                e.get_linked()->mark();
-        }
+        a = ie.m_added;
+        ++a;
+        b = next_base(base_after(ie.m_added->first));
+    }
+    else
+    {
+        b = next_base(ie.m_base + 1);
+        a = m_added.lower_bound(Key(m_base[ie.m_base]));
     }
+
+    bool base_first = b < m_base.size() &&
+        (a == m_added.end() || ! (a->first < Key(m_base[b])));
+
+    if (base_first)
+        return make_base(b);
+    else if (a != m_added.end())
+        return make_added(a);
+    else
+        return end();
 }
 
-#endif  // USE_VERIFY_AND_LINK
+/**
+ *  Finds the event before the given one:  the later of the previous copied
+ *  event and the previous inserted event, the inserted one if their keys
+ *  are equal.
+ *
+ * \param ie
+ *      The current event, which may be end(), but must not be begin().
+ *
+ * \return
+ *      Returns the previous event, or end() if there is none.
+ */
+
+editable_events::iterator
+editable_events::prev (const iterator & ie) const
+{
+    Base::size_type b;
+    Added::const_iterator a;
+    if (ie.m_is_added)
+    {
+        a = ie.m_added;
+        b = prev_base(base_after(ie.m_added->first));
+    }
+    else if (ie.m_base == m_base.size())                /* end()            */
+    {
+        a = m_added.end();
+        b = prev_base(m_base.size());
+    }
+    else
+    {
+        a = m_added.lower_bound(Key(m_base[ie.m_base]));
+        b = prev_base(ie.m_base);
+    }
+
+    bool have_added = a != m_added.begin();
+    if (have_added)
+        --a;
+
+    bool added_last = have_added &&
+        (b == m_base.size() || ! (a->first < Key(m_base[b])));
+
+    if (added_last)
+        return make_added(a);
+    else if (b < m_base.size())
+        return make_base(b);
+    else
+        return end();
+}
 
 }           // namespace seq64
 
@@ -452,4 +753,3 @@ editable_events::mark_out_of_range (midipulse slength)
  *
  * vim: sw=4 ts=4 wm=4 et ft=cpp
  */
-
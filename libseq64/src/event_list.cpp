@@ -25,7 +25,7 @@
  * \library       sequencer64 application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2015-09-19
- * \updates       2017-08-06
+ * \updates       2026-10-18
  * \license       GNU GPLv2 or above
  *
  *  This container now can indicate if certain Meta events (time-signaure or
@@ -39,6 +39,7 @@
  */
 
 #include <stdio.h>                      /* C::printf()                  */
+#include <algorithm>                    /* std::find()                  */
 
 #include "easy_macros.h"
 #include "event_list.hpp"
@@ -121,13 +122,21 @@ event_list::event_list ()
     m_events                (),
     m_is_modified           (false),
     m_has_tempo             (false),
-    m_has_time_signature    (false)
+    m_has_time_signature    (false),
+    m_loader                (nullptr),
+    m_loader_mutex          (),
+    m_seek_index            (),
+    m_seek_counts           (),
+    m_seek_strays           (),
+    m_seek_longest          (0),
+    m_seek_valid            (false)
 {
     // No code needed
 }
 
 /**
- *  Copy constructor.
+ *  Copy constructor.  A deferred list is copied by copying its loader, so
+ *  that the copy does not force the events of the original to be decoded.
  *
  * \param rhs
  *      Provides the event list to be copied.
@@ -135,17 +144,25 @@ event_list::event_list ()
 
 event_list::event_list (const event_list & rhs)
  :
-    m_events                (rhs.m_events),
-    m_is_modified           (rhs.m_is_modified),
-    m_has_tempo             (rhs.m_has_tempo),
-    m_has_time_signature    (rhs.m_has_time_signature)
+    m_events                (),
+    m_is_modified           (false),
+    m_has_tempo             (false),
+    m_has_time_signature    (false),
+    m_loader                (nullptr),
+    m_loader_mutex          (),
+    m_seek_index            (),
+    m_seek_counts           (),
+    m_seek_strays           (),
+    m_seek_longest          (0),
+    m_seek_valid            (false)
 {
-    // No code needed
+    *this = rhs;
 }
 
 /**
  *  Principal assignment operator.  Follows the stock rules for such an
- *  operator, just assigning member values.
+ *  operator, just assigning member values, except that a deferred list is
+ *  copied by copying its loader.
  *
  * \param rhs
  *      Provides the event list to be assigned.
@@ -156,21 +173,136 @@ event_list::operator = (const event_list & rhs)
 {
     if (this != &rhs)
     {
-        m_events                = rhs.m_events;
+        loader * ld = nullptr;
+        if (rhs.deferred())                 /* rare; lock only if so    */
+        {
+            automutex locker(rhs.m_loader_mutex);
+            loader * rhsloader = rhs.m_loader.load(std::memory_order_acquire);
+            if (not_nullptr(rhsloader))
+                ld = rhsloader->clone();
+        }
+        if (is_nullptr(ld))
+            m_events            = rhs.m_events;     /* rhs is realized      */
+        else
+            m_events.clear();
+
         m_is_modified           = rhs.m_is_modified;
         m_has_tempo             = rhs.m_has_tempo;
         m_has_time_signature    = rhs.m_has_time_signature;
+        unindex();                          /* never copy rhs positions */
+        delete m_loader.exchange(ld, std::memory_order_acq_rel);
     }
     return *this;
 }
 
 /**
- *  A rote destructor.
+ *  Deletes the loader of a list that was never realized.
  */
 
 event_list::~event_list ()
 {
-    // No code needed
+    delete m_loader.load(std::memory_order_acquire);
+}
+
+/**
+ *  Makes this list a deferred list.  Any events in the list are discarded,
+ *  and the loader will supply them on first use.  The flags are set now,
+ *  to what the decoded list will have, so that is_modified(), has_tempo(),
+ *  and has_time_signature() can answer without decoding it.
+ *
+ * \param ld
+ *      The loader, which now belongs to this list.  If null, the list is
+ *      simply emptied.
+ *
+ * \param modified
+ *      True if the loader will add any event, which raises the modified
+ *      flag, as it does in a normal load.
+ *
+ * \param hastempo
+ *      True if the loader will add a Set Tempo event.
+ *
+ * \param hastimesig
+ *      True if the loader will add a Time Signature event.
+ */
+
+void
+event_list::defer
+(
+    loader * ld, bool modified, bool hastempo, bool hastimesig
+)
+{
+    automutex locker(m_loader_mutex);
+    m_events.clear();
+    m_is_modified = modified;
+    m_has_tempo = hastempo;
+    m_has_time_signature = hastimesig;
+    delete m_loader.exchange(ld, std::memory_order_acq_rel);
+}
+
+/**
+ *  Moves all of the events of another list into this empty list, along with
+ *  its flags.  The events are moved without copying, so the links between
+ *  them stay valid.  Neither list may be deferred.
+ *
+ * \param source
+ *      The list to empty.
+ */
+
+void
+event_list::take (event_list & source)
+{
+    splice_events(source);
+    m_is_modified = source.m_is_modified;
+    m_has_tempo = source.m_has_tempo;
+    m_has_time_signature = source.m_has_time_signature;
+}
+
+/**
+ *  The first half of take():  moves the events, but not the flags.
+ *
+ * \param source
+ *      The list to empty.
+ */
+
+void
+event_list::splice_events (event_list & source)
+{
+#ifdef SEQ64_USE_EVENT_MAP
+    m_events.swap(source.m_events);
+#else
+    m_events.splice(m_events.end(), source.m_events);
+#endif
+    unindex();
+    source.unindex();
+}
+
+/**
+ *  The slow half of realize().  Decodes the events into a separate list,
+ *  and moves them into this one, so that no other thread sees a partly
+ *  decoded list, and only then clears m_loader.  The flags are left as
+ *  defer() set them, since other threads read them without the lock.  If
+ *  decoding fails, the list stays empty.
+ *
+ *  Realizing a list does not change what the list contains, as seen from
+ *  outside, so this function is const, like the accessors that call it.
+ */
+
+void
+event_list::load_deferred () const
+{
+    automutex locker(m_loader_mutex);
+    loader * ld = m_loader.load(std::memory_order_acquire);
+    if (is_nullptr(ld))
+        return;                             /* another thread did it    */
+
+    event_list decoded;
+    if (ld->load(decoded))
+        const_cast<event_list *>(this)->splice_events(decoded);
+    else
+        errprint("could not decode the events of a deferred track");
+
+    m_loader.store(nullptr, std::memory_order_release);
+    delete ld;
 }
 
 /**
@@ -197,6 +329,295 @@ event_list::get_length () const
     return result;
 }
 
+/**
+ *  Builds the seek index:  samples every c_seek_stride'th position, and
+ *  notes the longest extent of a linked note-on or tempo, so that seek()
+ *  callers know how far back an event can start and still reach a given
+ *  time.  Note-ons that wrap around the end of the pattern, and unlinked
+ *  tempos (which run to the end of it), are listed as strays instead.
+ *  Linked note-offs are covered by their note-ons.
+ */
+
+void
+event_list::build_index () const
+{
+    realize();
+    m_seek_index.clear();
+    m_seek_counts.clear();
+    m_seek_strays.clear();
+    m_seek_longest = 0;
+
+    int n = 0;
+    for (const_iterator i = m_events.begin(); i != m_events.end(); ++i, ++n)
+    {
+        if (n % c_seek_stride == 0)
+        {
+            m_seek_index.push_back(i);
+            m_seek_counts.push_back(0);
+        }
+        ++m_seek_counts.back();
+
+        const event & e = dref(i);
+        bool istempo = e.is_tempo();
+        if (e.is_note_on() || istempo)
+        {
+            if (e.is_linked())
+            {
+                midipulse span =
+                    e.get_linked()->get_timestamp() - e.get_timestamp();
+
+                if (span < 0)
+                    m_seek_strays.push_back(i);     /* wraps around     */
+                else if (span > m_seek_longest)
+                    m_seek_longest = span;
+            }
+            else if (istempo)
+                m_seek_strays.push_back(i);         /* runs to the end  */
+        }
+    }
+    m_seek_valid = true;
+}
+
+/**
+ *  Keeps the seek index up to date after an event is inserted at the given
+ *  position.  The other positions are still good, so only the count of the
+ *  gap the event went into changes, unless it went ahead of the first
+ *  sample, in which case it becomes the first sample.  An unlinked tempo
+ *  would be a stray, but tempos are rarely inserted this way, so the index
+ *  is simply dropped.
+ *
+ * \param pos
+ *      The position of the new event.
+ */
+
+void
+event_list::index_inserted (const_iterator pos)
+{
+    if (! m_seek_valid)
+        return;
+
+    const event & e = dref(pos);
+    if (e.is_tempo())
+    {
+        unindex();
+        return;
+    }
+
+    std::size_t low = 0;                    /* the samples not after e  */
+    std::size_t high = m_seek_index.size();
+    while (low < high)
+    {
+        std::size_t mid = (low + high) / 2;
+        if (e < dref(m_seek_index[mid]))
+            high = mid;
+        else
+            low = mid + 1;
+    }
+    if (low == 0)
+    {
+        m_seek_index.insert(m_seek_index.begin(), pos);
+        m_seek_counts.insert(m_seek_counts.begin(), 1);
+    }
+    else if (++m_seek_counts[low - 1] >= 2 * c_seek_stride)
+        split_gap(low - 1);
+}
+
+/**
+ *  Counts the events from a sample of the seek index up to the next one,
+ *  and if there are at least twice c_seek_stride of them, adds a sample
+ *  c_seek_stride events in.
+ *
+ * \param k
+ *      The number of the sample.
+ */
+
+void
+event_list::split_gap (std::size_t k)
+{
+    const_iterator i = m_seek_index[k];
+    const_iterator stop = k + 1 < m_seek_index.size() ?
+        m_seek_index[k + 1] : m_events.end() ;
+
+    const_iterator middle = i;
+    int n = 0;
+    for ( ; i != stop; ++i, ++n)
+    {
+        if (n == c_seek_stride)
+            middle = i;
+    }
+    if (n >= 2 * c_seek_stride)
+    {
+        m_seek_index.insert(m_seek_index.begin() + k + 1, middle);
+        m_seek_counts.insert(m_seek_counts.begin() + k + 1, n - c_seek_stride);
+        m_seek_counts[k] = c_seek_stride;
+    }
+    else
+        m_seek_counts[k] = n;
+}
+
+/**
+ *  Keeps the seek index up to date after a note is linked:  the note-on
+ *  either becomes a stray or may raise the longest extent, as in
+ *  build_index().
+ *
+ * \param on
+ *      The position of the linked note-on.
+ */
+
+void
+event_list::index_linked (const_iterator on)
+{
+    if (! m_seek_valid)
+        return;
+
+    const event & e = dref(on);
+    midipulse span = e.get_linked()->get_timestamp() - e.get_timestamp();
+    if (span < 0)
+    {
+        if (std::find(m_seek_strays.begin(), m_seek_strays.end(), on) ==
+            m_seek_strays.end())
+        {
+            m_seek_strays.push_back(on);    /* wraps around     */
+        }
+    }
+    else if (span > m_seek_longest)
+        m_seek_longest = span;
+}
+
+/**
+ *  Drops the seek index if the event about to be removed is one of its
+ *  samples or strays.  Otherwise the index stays good, with one gap count
+ *  too high, which split_gap() corrects.  The longest extent may also be
+ *  too long, which only makes seek() callers start a little early.
+ *
+ * \param pos
+ *      The position of the event about to be removed.
+ */
+
+void
+event_list::index_removed (const_iterator pos)
+{
+    if (! m_seek_valid)
+        return;
+
+    midipulse t = dref(pos).get_timestamp();
+    std::size_t low = 0;                    /* first sample at/after t  */
+    std::size_t high = m_seek_index.size();
+    while (low < high)
+    {
+        std::size_t mid = (low + high) / 2;
+        if (dref(m_seek_index[mid]).get_timestamp() < t)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    for ( ; low < m_seek_index.size(); ++low)
+    {
+        const_iterator sample = m_seek_index[low];
+        if (sample == pos)
+        {
+            unindex();
+            return;
+        }
+        if (dref(sample).get_timestamp() > t)
+            break;
+    }
+    if (std::find(m_seek_strays.begin(), m_seek_strays.end(), pos) !=
+        m_seek_strays.end())
+    {
+        unindex();
+    }
+}
+
+/**
+ *  Finds the first event at or after the given time, like
+ *  std::lower_bound(), by a binary search of the seek index followed by a
+ *  walk of at most c_seek_stride events.  The list must be sorted, as it is
+ *  everywhere but in the middle of a bulk load.
+ *
+ *  To visit every event whose extent reaches a time, a caller seeks to
+ *  that time less longest_span(), and also checks the strays().
+ *
+ * \param tick
+ *      The time to seek.
+ *
+ * \return
+ *      Returns the position of the first event whose timestamp is not less
+ *      than tick, or end() if there is none.
+ */
+
+event_list::const_iterator
+event_list::seek (midipulse tick) const
+{
+    if (! m_seek_valid)
+        build_index();
+
+    std::size_t low = 0;
+    std::size_t high = m_seek_index.size();
+    while (low < high)                      /* first sample at/after tick */
+    {
+        std::size_t mid = (low + high) / 2;
+        if (dref(m_seek_index[mid]).get_timestamp() < tick)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    const_iterator result = low > 0 ? m_seek_index[low - 1] : m_events.begin();
+    while (result != m_events.end() && dref(result).get_timestamp() < tick)
+        ++result;
+
+    return result;
+}
+
+/**
+ *  The modifiable version of seek(), for sequence::play().  An empty
+ *  erase() is the standard way to turn the position into an iterator; it
+ *  changes nothing.
+ *
+ * \param tick
+ *      The time to seek.
+ *
+ * \return
+ *      Returns the position of the first event whose timestamp is not less
+ *      than tick, or end() if there is none.
+ */
+
+event_list::iterator
+event_list::seek (midipulse tick)
+{
+    const_iterator ci = static_cast<const event_list &>(*this).seek(tick);
+    return m_events.erase(ci, ci);
+}
+
+/**
+ * \getter m_seek_longest
+ *      Builds the seek index if needed.
+ */
+
+midipulse
+event_list::longest_span () const
+{
+    if (! m_seek_valid)
+        build_index();
+
+    return m_seek_longest;
+}
+
+/**
+ * \getter m_seek_strays
+ *      Builds the seek index if needed.
+ */
+
+const event_list::ConstIterators &
+event_list::strays () const
+{
+    if (! m_seek_valid)
+        build_index();
+
+    return m_seek_strays;
+}
+
 /**
  *  Adds an event to the internal event list without sorting.  It is a
  *  wrapper, wrapper for insert() or push_front(), with an option to call
@@ -234,6 +655,7 @@ event_list::get_length () const
 bool
 event_list::append (const event & e)
 {
+    realize();
 #ifdef SEQ64_USE_EVENT_MAP
 
     event_key key(e);
@@ -252,14 +674,81 @@ event_list::append (const event & e)
 
 #endif
 
-    m_is_modified = true;
-    if (e.is_tempo())
-        m_has_tempo = true;
+    set_added_flags(e);
+    return true;
+}
 
-    if (e.is_time_signature())
-        m_has_time_signature = true;
+/**
+ *  Adds an event that sorts at or after every event already in the list, as
+ *  when rebuilding a list that was saved in order.  No sorting is needed,
+ *  and the event's address is returned so that the caller can restore its
+ *  links.
+ *
+ * \param e
+ *      Provides the event to be added.
+ *
+ * \return
+ *      Returns a reference to the event in the container.
+ */
 
-    return true;
+event &
+event_list::append_in_order (const event & e)
+{
+    realize();
+    set_added_flags(e);
+
+#ifdef SEQ64_USE_EVENT_MAP
+
+    event_key key(e);
+    iterator i = m_events.insert(m_events.end(), std::make_pair(key, e));
+    return i->second;
+
+#else
+
+    m_events.push_back(e);
+    return m_events.back();
+
+#endif
+}
+
+/**
+ *  Adds an event taken, in order, from the sorted SMF 0 track to the list
+ *  of one of the tracks split from it, without sorting.  The std::list
+ *  version of add() puts an event ahead of the events that sort equal to
+ *  it, so the SMF 0 track holds such ties in the reverse of file order,
+ *  and the split tracks used to reverse them again, one add() at a time.
+ *  To keep that order, a tie goes in ahead of the events it ties with.
+ *  The multimap keeps ties in file order everywhere, so there the event
+ *  simply goes at the end.
+ *
+ * \param e
+ *      Provides the event to be added.  It must not sort before the last
+ *      event in the list.
+ *
+ * \param ties
+ *      The first of the events at the end of the list that sort equal to
+ *      each other, or end() if the list is empty.  It is updated for the
+ *      next call.
+ */
+
+void
+event_list::append_split (const event & e, iterator & ties)
+{
+    set_added_flags(e);
+
+#ifdef SEQ64_USE_EVENT_MAP
+
+    event_key key(e);
+    ties = m_events.insert(m_events.end(), std::make_pair(key, e));
+
+#else
+
+    if (ties != m_events.end() && ! (*ties < e))
+        ties = m_events.insert(ties, e);        /* goes ahead of its ties   */
+    else
+        ties = m_events.insert(m_events.end(), e);
+
+#endif
 }
 
 #ifdef SEQ64_USE_EVENT_MAP
@@ -306,6 +795,10 @@ event_list::append (const event & e)
 void
 event_list::merge (event_list & el, bool /*presort*/ )
 {
+    realize();
+    el.realize();
+    unindex();
+    el.unindex();
     int initialsize = count();
     int addedsize = el.count();
     m_events.insert(el.events().begin(), el.events().end());
@@ -326,6 +819,10 @@ event_list::merge (event_list & el, bool /*presort*/ )
 void
 event_list::merge (event_list & el, bool presort)
 {
+    realize();
+    el.realize();
+    unindex();
+    el.unindex();
     if (presort)
         el.m_events.sort();
 
@@ -344,6 +841,8 @@ event_list::merge (event_list & el, bool presort)
 void
 event_list::link_new ()
 {
+    unindex();
+    realize();
     bool endfound = false;
     for (Events::iterator on = m_events.begin(); on != m_events.end(); ++on)
     {
@@ -393,6 +892,193 @@ event_list::link_new ()
     }
 }
 
+/**
+ *  Links a single, newly-inserted, unlinked note event.  This is the
+ *  incremental version of link_new(), used when merging recorded events, so
+ *  that the whole container need not be rescanned for every batch of
+ *  incoming events.
+ *
+ *  For a Note On, the search for an unlinked Note Off of the same note
+ *  proceeds forward from the event, and then wraps around from the
+ *  beginning, just as in link_new().  For a Note Off, the search for an
+ *  unlinked Note On proceeds backward from the event, and then wraps around
+ *  from the end, so that the most recent open Note On is closed first.
+ *
+ * \threadunsafe
+ *
+ * \param ev
+ *      Provides the position of the new event.
+ *
+ * \param [out] partner
+ *      Set to the position of the event that was linked to \a ev, if any.
+ *
+ * \return
+ *      Returns true if a link was made.
+ */
+
+bool
+event_list::link_new_event (iterator ev, iterator & partner)
+{
+    bool result = false;
+    event & e = dref(ev);
+    if (e.is_linked())
+        return false;
+
+    if (e.is_note_on())
+    {
+        iterator off = ev;
+        for (++off; off != m_events.end(); ++off)
+        {
+            event & eoff = dref(off);
+            if (eoff.is_note_off() && eoff.get_note() == e.get_note() &&
+                ! eoff.is_linked())
+            {
+                result = true;
+                break;
+            }
+        }
+        if (! result)
+        {
+            for (off = m_events.begin(); off != ev; ++off)
+            {
+                event & eoff = dref(off);
+                if (eoff.is_note_off() && eoff.get_note() == e.get_note() &&
+                    ! eoff.is_linked())
+                {
+                    result = true;
+                    break;
+                }
+            }
+        }
+        if (result)
+            partner = off;
+    }
+    else if (e.is_note_off())
+    {
+        iterator on = ev;
+        while (on != m_events.begin())
+        {
+            event & eon = dref(--on);
+            if (eon.is_note_on() && eon.get_note() == e.get_note() &&
+                ! eon.is_linked())
+            {
+                result = true;
+                break;
+            }
+        }
+        if (! result)
+        {
+            on = m_events.end();
+            while (on != ev)
+            {
+                event & eon = dref(--on);
+                if (eon.is_note_on() && eon.get_note() == e.get_note() &&
+                    ! eon.is_linked())
+                {
+                    result = true;
+                    break;
+                }
+            }
+        }
+        if (result)
+            partner = on;
+    }
+    if (result)
+    {
+        event & ep = dref(partner);
+        e.link(&ep);
+        ep.link(&e);
+        index_linked(e.is_note_on() ? ev : partner);
+    }
+    return result;
+}
+
+/**
+ *  Inserts an event at its sorted position, without sorting the whole
+ *  container.  Equivalent events already present stay ahead of the new
+ *  one, as with std::list::merge().
+ *
+ * \threadunsafe
+ *
+ * \param e
+ *      Provides the event to be copied into the container.
+ *
+ * \return
+ *      Returns the position of the new event.
+ */
+
+event_list::iterator
+event_list::insert_sorted (const event & e)
+{
+    realize();
+    mark_added(e);
+#ifdef SEQ64_USE_EVENT_MAP
+    iterator result = m_events.insert(EventsPair(event_key(e), e));
+#else
+    iterator pos = m_events.end();
+    while (pos != m_events.begin())             /* recent events go last    */
+    {
+        iterator prev = pos;
+        if (! (e < dref(--prev)))
+            break;
+
+        pos = prev;
+    }
+    iterator result = m_events.insert(pos, e);
+#endif
+    index_inserted(result);
+    return result;
+}
+
+/**
+ *  Merges a batch of new events into the container, in a single pass for
+ *  the std::list implementation, and records where each one landed.  The
+ *  pass starts where seek() puts the first new event, rather than at the
+ *  start of the list, and the seek index is kept up to date rather than
+ *  dropped, so that the next play() need not rebuild it.  The source list
+ *  is emptied.
+ *
+ * \threadunsafe
+ *
+ * \param el
+ *      Provides the new events, in any order.
+ *
+ * \param [out] added
+ *      Receives the positions of the new events, in time order.
+ */
+
+void
+event_list::merge_new (event_list & el, Iterators & added)
+{
+    realize();
+    el.realize();
+    el.sort();
+    added.reserve(added.size() + el.m_events.size());
+
+#ifdef SEQ64_USE_EVENT_MAP
+    for (iterator i = el.m_events.begin(); i != el.m_events.end(); ++i)
+        added.push_back(insert_sorted(dref(i)));
+#else
+    if (! el.m_events.empty())
+    {
+        iterator pos = seek(dref(el.m_events.begin()).get_timestamp());
+        for (iterator i = el.m_events.begin(); i != el.m_events.end(); ++i)
+        {
+            const event & e = dref(i);
+            while (pos != m_events.end() && ! (e < dref(pos)))
+                ++pos;
+
+            mark_added(e);
+            iterator ins = m_events.insert(pos, e);
+            index_inserted(ins);
+            added.push_back(ins);
+        }
+    }
+#endif
+
+    el.clear();
+}
+
 /**
  *  This function verifies state: all note-ons have an off, and it links
  *  note-offs with their note-ons.
@@ -414,6 +1100,8 @@ event_list::link_new ()
 void
 event_list::verify_and_link (midipulse slength)
 {
+    unindex();
+    realize();
     clear_links();
     for (event_list::iterator on = m_events.begin(); on != m_events.end(); ++on)
     {
@@ -497,6 +1185,8 @@ event_list::verify_and_link (midipulse slength)
 void
 event_list::clear_links ()
 {
+    unindex();
+    realize();
     for (Events::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
         event & e = dref(i);
@@ -520,6 +1210,8 @@ event_list::clear_links ()
 void
 event_list::link_tempos ()
 {
+    unindex();
+    realize();
     clear_tempo_links();
     for (event_list::iterator t = m_events.begin(); t != m_events.end(); ++t)
     {
@@ -549,6 +1241,8 @@ event_list::link_tempos ()
 void
 event_list::clear_tempo_links ()
 {
+    unindex();
+    realize();
     for (Events::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
         event & e = dref(i);
@@ -567,6 +1261,7 @@ event_list::clear_tempo_links ()
 bool
 event_list::mark_selected ()
 {
+    realize();
     bool result = false;
     for (Events::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
@@ -588,6 +1283,7 @@ event_list::mark_selected ()
 void
 event_list::mark_all ()
 {
+    realize();
     for (Events::iterator i = m_events.begin(); i != m_events.end(); ++i)
         dref(i).mark();
 }
@@ -599,6 +1295,7 @@ event_list::mark_all ()
 void
 event_list::unmark_all ()
 {
+    realize();
     for (Events::iterator i = m_events.begin(); i != m_events.end(); ++i)
         dref(i).unmark();
 }
@@ -622,6 +1319,7 @@ event_list::unmark_all ()
 void
 event_list::mark_out_of_range (midipulse slength)
 {
+    realize();
     for (Events::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
         event & e = dref(i);
@@ -651,6 +1349,8 @@ event_list::mark_out_of_range (midipulse slength)
 bool
 event_list::remove_marked ()
 {
+    unindex();
+    realize();
     bool result = false;
     Events::iterator i = m_events.begin();
     while (i != m_events.end())
@@ -676,6 +1376,7 @@ event_list::remove_marked ()
 void
 event_list::unpaint_all ()
 {
+    realize();
     for (Events::iterator i = m_events.begin(); i != m_events.end(); ++i)
         dref(i).unpaint();
 }
@@ -687,6 +1388,7 @@ event_list::unpaint_all ()
 int
 event_list::count_selected_notes () const
 {
+    realize();
     int result = 0;
     for (Events::const_iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
@@ -708,6 +1410,7 @@ event_list::count_selected_notes () const
 bool
 event_list::any_selected_notes () const
 {
+    realize();
     bool result = false;
     for (Events::const_iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
@@ -740,6 +1443,7 @@ event_list::any_selected_notes () const
 int
 event_list::count_selected_events (midibyte status, midibyte cc) const
 {
+    realize();
     int result = 0;
     for (Events::const_iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
@@ -770,6 +1474,7 @@ event_list::count_selected_events (midibyte status, midibyte cc) const
 void
 event_list::select_all ()
 {
+    realize();
     for (Events::iterator i = m_events.begin(); i != m_events.end(); ++i)
         dref(i).select();
 }
@@ -781,6 +1486,7 @@ event_list::select_all ()
 void
 event_list::unselect_all ()
 {
+    realize();
     for (Events::iterator i = m_events.begin(); i != m_events.end(); ++i)
         dref(i).unselect();
 }
@@ -792,6 +1498,7 @@ event_list::unselect_all ()
 void
 event_list::print () const
 {
+    realize();
     printf("events[%d]:\n", count());
     for (Events::const_iterator i = m_events.begin(); i != m_events.end(); ++i)
         dref(i).print();
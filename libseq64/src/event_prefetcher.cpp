@@ -0,0 +1,235 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          event_prefetcher.cpp
+ *
+ *  This module defines the class that decodes deferred sequences on a
+ *  background thread.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  See the event_prefetcher.hpp module for the overview.
+ */
+
+#include <algorithm>                    /* std::remove()                    */
+
+#include "easy_macros.h"                /* nullptr, errprint()              */
+#include "event_prefetcher.hpp"         /* seq64::event_prefetcher          */
+#include "sequence.hpp"                 /* seq64::sequence                  */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Default constructor.  The thread is not started until the first
+ *  request().
+ */
+
+event_prefetcher::event_prefetcher ()
+ :
+    m_condition         (),
+    m_thread            (),
+    m_thread_launched   (false),
+    m_stop              (false),
+    m_queue             ()
+{
+    // Empty body
+}
+
+/**
+ *  Stops the thread.
+ */
+
+event_prefetcher::~event_prefetcher ()
+{
+    stop();
+}
+
+/**
+ *  Replaces the work list with the given sequences, which are decoded in
+ *  the given order.  Sequences that are already decoded are skipped when
+ *  their turn comes.  The caller must keep each sequence alive until it is
+ *  decoded, or call forget() before deleting it.
+ *
+ * \param seqs
+ *      The sequences to decode, most urgent first.
+ */
+
+void
+event_prefetcher::request (const std::vector<sequence *> & seqs)
+{
+    automutex locker(m_condition);
+    if (m_stop)
+        return;
+
+    m_queue.assign(seqs.begin(), seqs.end());
+    if (launch())
+        m_condition.signal();
+}
+
+/**
+ *  Puts one sequence at the head of the work list, for the output thread,
+ *  which has skipped it because it is not decoded yet.  The lock is only
+ *  tried, since it is held during each decode; if it is busy, nothing is
+ *  done, and the output thread asks again on its next frame.
+ *
+ * \param s
+ *      The sequence to decode next.  The same rules as for request() apply.
+ */
+
+void
+event_prefetcher::hurry (sequence * s)
+{
+    if (m_condition.try_lock())
+    {
+        if (! m_stop && (m_queue.empty() || m_queue.front() != s))
+        {
+            m_queue.push_front(s);
+            if (launch())
+                m_condition.signal();
+        }
+        m_condition.unlock();
+    }
+}
+
+/**
+ *  Removes a sequence from the work list.  Since the lock is held while a
+ *  sequence is decoded, when this function returns the thread is not using
+ *  the sequence, and will not use it again, so it can be deleted.
+ *
+ * \param s
+ *      The sequence about to be deleted.
+ */
+
+void
+event_prefetcher::forget (sequence * s)
+{
+    automutex locker(m_condition);
+    m_queue.erase
+    (
+        std::remove(m_queue.begin(), m_queue.end(), s), m_queue.end()
+    );
+}
+
+/**
+ *  Drops any remaining work and joins the thread.  No further requests are
+ *  accepted.
+ */
+
+void
+event_prefetcher::stop ()
+{
+    {
+        automutex locker(m_condition);
+        m_stop = true;
+        m_queue.clear();
+        m_condition.signal();
+    }
+    if (m_thread_launched)
+    {
+        pthread_join(m_thread, NULL);
+        m_thread_launched = false;
+    }
+}
+
+/**
+ *  Starts the thread, if there is work and it is not running yet.  The lock
+ *  must be held.
+ *
+ * \return
+ *      Returns false if the thread could not be started, in which case the
+ *      work list is dropped, and each sequence is decoded on first use.
+ */
+
+bool
+event_prefetcher::launch ()
+{
+    if (! m_thread_launched && ! m_queue.empty())
+    {
+        int err = pthread_create(&m_thread, NULL, prefetch_thread_func, this);
+        if (err == 0)
+        {
+            m_thread_launched = true;
+        }
+        else
+        {
+            errprint("could not start the prefetch thread");
+            m_queue.clear();            /* decode on first use instead  */
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ *  The body of the prefetch thread.  Waits for work, and decodes the queued
+ *  sequences one at a time, until stop() is called.
+ */
+
+void
+event_prefetcher::run ()
+{
+    automutex locker(m_condition);
+    for (;;)
+    {
+        while (m_queue.empty() && ! m_stop)
+            m_condition.wait();
+
+        if (m_stop)
+            break;
+
+        sequence * s = m_queue.front();
+        m_queue.pop_front();
+        s->events().realize();          /* no-op if already decoded     */
+    }
+}
+
+/**
+ *  The prefetch thread's function.
+ *
+ * \param myprefetcher
+ *      The event_prefetcher object, cast to void.
+ *
+ * \return
+ *      Always returns nullptr.
+ */
+
+void *
+event_prefetcher::prefetch_thread_func (void * myprefetcher)
+{
+    event_prefetcher * p = static_cast<event_prefetcher *>(myprefetcher);
+    p->run();
+    return nullptr;
+}
+
+}           // namespace seq64
+
+/*
+ * event_prefetcher.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
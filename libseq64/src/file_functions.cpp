@@ -14,6 +14,8 @@
  *    project.
  */
 
+#include <cstdio>                       /* std::rename(), std::remove()     */
+#include <cstdlib>                      /* realpath(), free()               */
 #include <sys/types.h>
 #include <sys/stat.h>
 
@@ -294,6 +296,80 @@ make_directory (const std::string & pathname)
     return result;
 }
 
+/**
+ *  Resolves a file name to the file it finally names, following symbolic
+ *  links, so that a file can be replaced without replacing a link to it.
+ *
+ * \param filename
+ *      The name to resolve.
+ *
+ * \return
+ *      Returns the resolved name, or the name itself if it could not be
+ *      resolved, such as when the file does not exist yet.  On Windows, the
+ *      name is returned as is.
+ */
+
+std::string
+file_real_path (const std::string & filename)
+{
+    std::string result = filename;
+#if ! defined _MSC_VER && ! defined PLATFORM_MINGW
+    if (! filename.empty())
+    {
+        char * resolved = realpath(filename.c_str(), NULL);
+        if (not_nullptr(resolved))
+        {
+            result = resolved;
+            free(resolved);
+        }
+    }
+#endif
+    return result;
+}
+
+/**
+ *  Replaces a file with another, such as a freshly-written temporary file.
+ *  On POSIX systems, rename() does this atomically: a reader sees either
+ *  the old file or the new one, never a partial file.  Windows will not
+ *  rename over an existing file, so there the target is removed first,
+ *  which leaves a short window without it.
+ *
+ *  The source takes the permissions of the file it replaces, which it
+ *  would otherwise lose, since it was created with the default mode.  The
+ *  owner is not changed.  The target should already be resolved with
+ *  file_real_path(), or a symbolic link would be replaced by the file.
+ *
+ * \param source
+ *      The file to be renamed, which should be in the same directory (and
+ *      thus on the same file-system) as the target.
+ *
+ * \param target
+ *      The file to be replaced.  It need not exist.
+ *
+ * \return
+ *      Returns true if the source now has the target's name.
+ */
+
+bool
+file_replace (const std::string & source, const std::string & target)
+{
+    bool result = ! source.empty() && ! target.empty();
+    if (result)
+    {
+        stat_t statusbuf;
+        bool exists = S_STAT(target.c_str(), &statusbuf) == 0;
+#if defined _MSC_VER || defined PLATFORM_MINGW
+        if (exists)
+            (void) std::remove(target.c_str());
+#else
+        if (exists)
+            (void) chmod(source.c_str(), statusbuf.st_mode & 07777);
+#endif
+        result = std::rename(source.c_str(), target.c_str()) == 0;
+    }
+    return result;
+}
+
 }           // namespace seq64
 
 /*
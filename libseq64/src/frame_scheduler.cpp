@@ -0,0 +1,183 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          frame_scheduler.cpp
+ *
+ *  This module defines a class that picks the redraw period of a window
+ *  and measures what each redraw costs.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  The caller brackets each frame with begin_frame() and end_frame(), then
+ *  calls update() with the state of the transport and of the window, and
+ *  reconnects its timer if the period changed.
+ */
+
+#include <time.h>                       /* clock_gettime()                  */
+
+#include "frame_scheduler.hpp"          /* seq64::frame_scheduler           */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  The stretch factors of the base period.  See the banner of the header.
+ */
+
+static const int c_unfocused_factor = 2;
+static const int c_stopped_factor   = 5;
+static const int c_hidden_factor    = 10;
+
+/**
+ *  The share of the period, as a divisor, above which the frames are
+ *  considered too costly for the period.
+ */
+
+static const int c_cost_divisor     = 4;
+
+/**
+ *  Principal constructor.
+ *
+ * \param base_period_ms
+ *      The fixed redraw period used so far, usr().window_redraw_rate().
+ *      The scheduler starts at this period.
+ */
+
+frame_scheduler::frame_scheduler (int base_period_ms)
+ :
+    m_base_period_ms    (base_period_ms > 0 ? base_period_ms : 1),
+    m_period_ms         (m_base_period_ms),
+    m_frame_start_us    (0),
+    m_frames            (0),
+    m_last_cost_us      (0),
+    m_average_cost_us   (0),
+    m_max_cost_us       (0)
+{
+    // no code
+}
+
+/**
+ *  Picks the period for the next frames.
+ *
+ * \param running
+ *      True if the transport is running, so that progress bars move.
+ *
+ * \param visible
+ *      True if the window is mapped and not iconified.
+ *
+ * \param focused
+ *      True if the window has the keyboard focus.
+ *
+ * \return
+ *      Returns true if the period changed, in which case the caller must
+ *      reconnect its timer with period_ms().
+ */
+
+bool
+frame_scheduler::update (bool running, bool visible, bool focused)
+{
+    int factor = 1;
+    if (! visible)
+        factor = c_hidden_factor;
+    else if (! running)
+        factor = c_stopped_factor;
+    else if (! focused)
+        factor = c_unfocused_factor;
+
+    int hidden = m_base_period_ms * c_hidden_factor;
+    int period = m_base_period_ms * factor;
+    while
+    (
+        period < hidden &&
+        m_average_cost_us * c_cost_divisor > period * 1000L
+    )
+    {
+        period *= 2;                                /* frames too costly    */
+    }
+    if (period > hidden)
+        period = hidden;
+
+    bool result = period != m_period_ms;
+    m_period_ms = period;
+    return result;
+}
+
+/**
+ *  Marks the start of a frame.
+ */
+
+void
+frame_scheduler::begin_frame ()
+{
+    m_frame_start_us = now_us();
+}
+
+/**
+ *  Marks the end of a frame, and adds its cost to the statistics.  Does
+ *  nothing if begin_frame() was not called.
+ */
+
+void
+frame_scheduler::end_frame ()
+{
+    if (m_frame_start_us == 0)
+        return;
+
+    long cost = long(now_us() - m_frame_start_us);
+    m_frame_start_us = 0;
+    m_last_cost_us = cost;
+    if (m_frames == 0)
+        m_average_cost_us = cost;
+    else
+        m_average_cost_us += (cost - m_average_cost_us) / 8;
+
+    if (cost > m_max_cost_us)
+        m_max_cost_us = cost;
+
+    ++m_frames;
+}
+
+/**
+ * \return
+ *      Returns the current time on the monotonic clock, in microseconds.
+ */
+
+long long
+frame_scheduler::now_us ()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+}           // namespace seq64
+
+/*
+ * frame_scheduler.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
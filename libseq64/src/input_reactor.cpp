@@ -0,0 +1,384 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          input_reactor.cpp
+ *
+ *  This module defines the class that lets the input thread wait on all of
+ *  the MIDI input sources at once.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  See the input_reactor.hpp module for the overview.
+ */
+
+#include <algorithm>                    /* std::find()                      */
+
+#include "app_limits.h"                 /* SEQ64_INPUT_REACTOR_EVENTS       */
+#include "easy_macros.h"                /* errprint()                       */
+#include "input_reactor.hpp"            /* seq64::input_reactor             */
+#include "platform_macros.h"            /* PLATFORM_LINUX                   */
+
+#if defined PLATFORM_LINUX
+#include <errno.h>                      /* EEXIST, EINTR                    */
+#include <poll.h>                       /* poll()                           */
+#include <stdint.h>                     /* uint64_t                         */
+#include <sys/epoll.h>                  /* epoll_create1(), epoll_wait()    */
+#include <sys/eventfd.h>                /* eventfd()                        */
+#include <unistd.h>                     /* close(), read(), write()         */
+#endif
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+#if defined PLATFORM_LINUX
+
+/**
+ *  Adds a descriptor to an epoll set, edge-triggered, for reading.
+ *
+ * \return
+ *      Returns true if the descriptor was added, or was already there.
+ */
+
+static bool
+epoll_add (int epollfd, int fd)
+{
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLET;
+    ev.data.fd = fd;
+    return epoll_ctl(epollfd, EPOLL_CTL_ADD, fd, &ev) == 0 || errno == EEXIST;
+}
+
+/**
+ *  Resets the counter of an eventfd, so that its next write makes a new
+ *  edge.
+ */
+
+static void
+eventfd_drain (int fd)
+{
+    uint64_t count;
+    while (read(fd, &count, sizeof count) == ssize_t(sizeof count))
+        ;
+}
+
+/**
+ *  Bumps the counter of an eventfd.  This is a single non-blocking write(),
+ *  safe enough to call from the JACK process callback.
+ */
+
+static void
+eventfd_bump (int fd)
+{
+    uint64_t one = 1;
+    ssize_t rc = write(fd, &one, sizeof one);
+    (void) rc;                                  /* EAGAIN: already set  */
+}
+
+#endif  // PLATFORM_LINUX
+
+/**
+ *  Default constructor.  Creates the epoll set and the two eventfds, and
+ *  adds the wake descriptor.  If anything fails, valid() returns false.
+ */
+
+input_reactor::input_reactor ()
+ :
+    m_epoll_fd          (-1),
+    m_wake_fd           (-1),
+    m_notify_fd         (-1),
+    m_notify_enabled    (false),
+    m_sources           (),
+    m_source_count      (0),
+    m_pending           (),
+    m_mutex             ()
+{
+#if defined PLATFORM_LINUX
+    m_pending.reserve(SEQ64_INPUT_REACTOR_EVENTS);
+    m_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epoll_fd >= 0)
+    {
+        m_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        m_notify_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (m_wake_fd >= 0 && ! epoll_add(m_epoll_fd, m_wake_fd))
+        {
+            close(m_wake_fd);
+            m_wake_fd = -1;
+        }
+    }
+    if (! valid())
+    {
+        errprint("input_reactor: epoll setup failed, using poll()");
+    }
+#endif
+}
+
+/**
+ *  Closes the descriptors that this object created.  The source descriptors
+ *  belong to their owners, and are not closed.
+ */
+
+input_reactor::~input_reactor ()
+{
+#if defined PLATFORM_LINUX
+    if (m_notify_fd >= 0)
+        close(m_notify_fd);
+
+    if (m_wake_fd >= 0)
+        close(m_wake_fd);
+
+    if (m_epoll_fd >= 0)
+        close(m_epoll_fd);
+#endif
+}
+
+/**
+ *  Adds a source descriptor, such as an ALSA sequencer poll descriptor, to
+ *  the set.  Adding a descriptor that is already present does nothing, so a
+ *  backend can simply re-add its descriptors after a port hot-plug.
+ *
+ * \threadsafe
+ *
+ * \param fd
+ *      The descriptor to watch for input.
+ *
+ * \return
+ *      Returns true if the descriptor is now in the set.
+ */
+
+bool
+input_reactor::add_source (int fd)
+{
+    bool result = false;
+#if defined PLATFORM_LINUX
+    automutex locker(m_mutex);
+    if (valid() && fd >= 0)
+    {
+        if (std::find(m_sources.begin(), m_sources.end(), fd) != m_sources.end())
+            return true;
+
+        result = epoll_add(m_epoll_fd, fd);
+        if (result)
+        {
+            m_sources.push_back(fd);
+            ++m_source_count;
+        }
+    }
+#endif
+    return result;
+}
+
+/**
+ *  Removes a source descriptor from the set.  This must be done before the
+ *  owner closes it.
+ *
+ * \threadsafe
+ *
+ * \param fd
+ *      The descriptor to stop watching.
+ *
+ * \return
+ *      Returns true if the descriptor was in the set.
+ */
+
+bool
+input_reactor::remove_source (int fd)
+{
+    bool result = false;
+#if defined PLATFORM_LINUX
+    automutex locker(m_mutex);
+    std::vector<int>::iterator fi =
+        std::find(m_sources.begin(), m_sources.end(), fd);
+
+    if (fi != m_sources.end())
+    {
+        (void) epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+        m_sources.erase(fi);
+        --m_source_count;
+        result = true;
+    }
+#endif
+    return result;
+}
+
+/**
+ *  Adds the notify descriptor to the set.  Called by a backend whose input
+ *  arrives in a queue rather than on a descriptor, so that wait() wakes up
+ *  when notify() is called.
+ *
+ * \threadsafe
+ *
+ * \return
+ *      Returns true if notification is enabled.
+ */
+
+bool
+input_reactor::enable_notify ()
+{
+#if defined PLATFORM_LINUX
+    automutex locker(m_mutex);
+    if (! m_notify_enabled && valid() && m_notify_fd >= 0)
+    {
+        if (epoll_add(m_epoll_fd, m_notify_fd))
+        {
+            m_notify_enabled = true;
+            ++m_source_count;
+        }
+    }
+#endif
+    return m_notify_enabled;
+}
+
+/**
+ *  Checks, without blocking, whether any source that fired in the last
+ *  wait() still has input.  An edge-triggered source does not fire again
+ *  for input that was already waiting, so this check keeps such input from
+ *  being stranded when the consumer reads only part of it.
+ *
+ * \return
+ *      Returns true if a source is still readable.  The pending list then
+ *      holds only those sources.
+ */
+
+bool
+input_reactor::still_ready ()
+{
+    bool result = false;
+#if defined PLATFORM_LINUX
+    struct pollfd fds[SEQ64_INPUT_REACTOR_EVENTS];
+    int count = 0;
+    std::vector<int>::const_iterator pi;
+    for (pi = m_pending.begin(); pi != m_pending.end(); ++pi)
+    {
+        fds[count].fd = *pi;
+        fds[count].events = POLLIN;
+        fds[count].revents = 0;
+        ++count;
+    }
+    m_pending.clear();
+    if (poll(fds, count, 0) > 0)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            if ((fds[i].revents & POLLIN) != 0)
+                m_pending.push_back(fds[i].fd);
+        }
+        result = ! m_pending.empty();
+    }
+#endif
+    return result;
+}
+
+/**
+ *  Waits until a source has input, wake() is called, or the timeout
+ *  expires.  Only the input thread may call this function.
+ *
+ * \param timeout_ms
+ *      The longest time to wait, in milliseconds.
+ *
+ * \return
+ *      Returns the number of sources with input, 0 if there are none (a
+ *      timeout or a wake-up), or -1 on error, like poll().
+ */
+
+int
+input_reactor::wait (int timeout_ms)
+{
+    int result = 0;
+#if defined PLATFORM_LINUX
+    if (! m_pending.empty() && still_ready())
+        return int(m_pending.size());
+
+    struct epoll_event events[SEQ64_INPUT_REACTOR_EVENTS];
+    int count = epoll_wait
+    (
+        m_epoll_fd, events, SEQ64_INPUT_REACTOR_EVENTS, timeout_ms
+    );
+    if (count < 0)
+        return errno == EINTR ? 0 : -1 ;
+
+    for (int i = 0; i < count; ++i)
+    {
+        int fd = events[i].data.fd;
+        if (fd == m_wake_fd)
+        {
+            eventfd_drain(fd);
+        }
+        else if (fd == m_notify_fd)
+        {
+            eventfd_drain(fd);                  /* the queue holds input    */
+            ++result;
+        }
+        else
+        {
+            m_pending.push_back(fd);
+            ++result;
+        }
+    }
+#else
+    (void) timeout_ms;
+#endif
+    return result;
+}
+
+/**
+ *  Makes the current or next wait() return at once.
+ *
+ * \threadsafe
+ */
+
+void
+input_reactor::wake ()
+{
+#if defined PLATFORM_LINUX
+    if (m_wake_fd >= 0)
+        eventfd_bump(m_wake_fd);
+#endif
+}
+
+/**
+ *  Tells the waiting thread that input has been queued.  Does nothing
+ *  unless enable_notify() has been called.
+ *
+ * \threadsafe
+ */
+
+void
+input_reactor::notify ()
+{
+#if defined PLATFORM_LINUX
+    if (m_notify_enabled)
+        eventfd_bump(m_notify_fd);
+#endif
+}
+
+}           // namespace seq64
+
+/*
+ * input_reactor.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
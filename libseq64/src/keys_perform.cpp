@@ -89,12 +89,13 @@ keys_perform::keys_perform ()
     m_key_pattern_edit              (SEQ64_equal),
     m_key_pattern_shift             (SEQ64_slash),
     m_key_event_edit                (SEQ64_minus),
-    m_key_stop                      (SEQ64_Escape)
+    m_key_stop                      (SEQ64_Escape),
 #ifdef SEQ64_SONG_RECORDING
-    ,
     m_key_song_record               (SEQ64_P),
-    m_key_oneshot_queue             (SEQ64_p)
+    m_key_oneshot_queue             (SEQ64_p),
 #endif
+    m_key_playlist_prev             (SEQ64_F11),
+    m_key_playlist_next             (SEQ64_F12)
 {
     // Empty body
 }
@@ -173,6 +174,8 @@ keys_perform::set_keys (const keys_perform_transfer & kpt)
      m_key_song_record               = kpt.kpt_song_record;
      m_key_oneshot_queue             = kpt.kpt_oneshot_queue;
 #endif
+     m_key_playlist_prev             = kpt.kpt_playlist_prev;
+     m_key_playlist_next             = kpt.kpt_playlist_next;
      m_key_show_ui_sequence_key      = kpt.kpt_show_ui_sequence_key;
      m_key_show_ui_sequence_number   = kpt.kpt_show_ui_sequence_number;
 }
@@ -220,6 +223,8 @@ keys_perform::get_keys (keys_perform_transfer & kpt)
      kpt.kpt_song_record            = m_key_song_record;
      kpt.kpt_oneshot_queue          = m_key_oneshot_queue;
 #endif
+     kpt.kpt_playlist_prev          = m_key_playlist_prev;
+     kpt.kpt_playlist_next          = m_key_playlist_next;
      kpt.kpt_show_ui_sequence_key   = m_key_show_ui_sequence_key;
      kpt.kpt_show_ui_sequence_number = m_key_show_ui_sequence_number;
 }
@@ -477,6 +482,12 @@ keyval_normalize (keys_perform_transfer & k)
 
     if (invalid_key(k.kpt_stop))
         k.kpt_stop = SEQ64_Escape;                      /* Escape   */
+
+    if (invalid_key(k.kpt_playlist_prev))
+        k.kpt_playlist_prev = SEQ64_F11;
+
+    if (invalid_key(k.kpt_playlist_next))
+        k.kpt_playlist_next = SEQ64_F12;
 }
 
 }           // namespace seq64
@@ -0,0 +1,189 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          mapped_file.cpp
+ *
+ *  This module defines a small class providing a read-only view of a whole
+ *  file.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  See the mapped_file.hpp module for the overview.
+ */
+
+#include <fstream>                      /* std::ifstream                    */
+#include <new>                          /* std::bad_alloc                   */
+
+#include "easy_macros.h"                /* nullptr, PLATFORM_UNIX           */
+#include "mapped_file.hpp"              /* seq64::mapped_file               */
+
+#if defined PLATFORM_UNIX
+#include <fcntl.h>                      /* ::open(), O_RDONLY               */
+#include <sys/mman.h>                   /* ::mmap(), ::munmap()             */
+#include <sys/stat.h>                   /* ::fstat()                        */
+#include <unistd.h>                     /* ::close()                        */
+#endif
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Default constructor.  Nothing is open.
+ */
+
+mapped_file::mapped_file ()
+ :
+    m_map       (nullptr),
+    m_buffer    (),
+    m_data      (nullptr),
+    m_size      (0)
+{
+    // Empty body
+}
+
+/**
+ *  Unmaps or frees the file data.
+ */
+
+mapped_file::~mapped_file ()
+{
+    close();
+}
+
+/**
+ *  Opens the file and makes its contents available through data().  Any
+ *  file already open is closed first.
+ *
+ * \param filename
+ *      The name of the file.
+ *
+ * \return
+ *      Returns true if the file was opened and is not empty.
+ */
+
+bool
+mapped_file::open (const std::string & filename)
+{
+    close();
+
+#if defined PLATFORM_UNIX
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+        void * p = ::mmap
+        (
+            nullptr, std::size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0
+        );
+        if (p != MAP_FAILED)
+        {
+            (void) ::madvise(p, std::size_t(st.st_size), MADV_SEQUENTIAL);
+            m_map = p;
+            m_data = static_cast<const midibyte *>(p);
+            m_size = std::size_t(st.st_size);
+        }
+    }
+    ::close(fd);                        /* the mapping stays valid      */
+    if (mapped())
+        return true;
+#endif
+
+    return read_all(filename);
+}
+
+/**
+ *  The fallback for open(): reads the whole file into m_buffer.
+ *
+ * \param filename
+ *      The name of the file.
+ *
+ * \return
+ *      Returns true if the file was read and is not empty.
+ */
+
+bool
+mapped_file::read_all (const std::string & filename)
+{
+    std::ifstream file
+    (
+        filename.c_str(), std::ios::in | std::ios::binary | std::ios::ate
+    );
+    if (! file.is_open())
+        return false;
+
+    std::streamoff filesize = file.tellg();
+    if (filesize <= 0)
+        return false;
+
+    file.seekg(0, std::ios::beg);
+    try
+    {
+        m_buffer.resize(std::size_t(filesize));
+    }
+    catch (const std::bad_alloc &)
+    {
+        return false;
+    }
+    file.read(reinterpret_cast<char *>(&m_buffer[0]), filesize);
+    if (! file)
+    {
+        m_buffer.clear();
+        return false;
+    }
+    m_data = &m_buffer[0];
+    m_size = m_buffer.size();
+    return true;
+}
+
+/**
+ *  Releases the file data.  After this call, data() is null and size() is
+ *  0.
+ */
+
+void
+mapped_file::close ()
+{
+#if defined PLATFORM_UNIX
+    if (mapped())
+        (void) ::munmap(m_map, m_size);
+#endif
+    m_map = nullptr;
+    std::vector<midibyte>().swap(m_buffer);     /* really free it       */
+    m_data = nullptr;
+    m_size = 0;
+}
+
+}           // namespace seq64
+
+/*
+ * mapped_file.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
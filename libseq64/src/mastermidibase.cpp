@@ -37,6 +37,7 @@
 #include "easy_macros.h"
 #include "event.hpp"                    /* seq64::event                     */
 #include "mastermidibase.hpp"           /* seq64::mastermidibase            */
+#include "offline_render.hpp"           /* seq64::offline_render            */
 #include "sequence.hpp"                 /* seq64::sequence                  */
 #include "settings.hpp"                 /* seq64::rc() and choose_ppqn()    */
 
@@ -68,6 +69,7 @@ mastermidibase::mastermidibase
 ) :
     m_max_busses        (c_max_busses),
     m_bus_announce      (nullptr),      /* used only for ALSA announce bus  */
+    m_handle_mutex      (),
     m_inbus_array       (),
     m_outbus_array      (),
     m_master_clocks     (),
@@ -79,7 +81,13 @@ mastermidibase::mastermidibase
     m_vector_sequence   (),             /* stazed feature                   */
     m_filter_by_channel (false),        /* set based on configuration       */
     m_seq               (nullptr),
-    m_mutex             ()
+    m_mutex             (),
+    m_input_reactor     (),
+    m_out_buses         (nullptr),
+    m_out_readers       (0),
+    m_retired_buses     (),
+    m_note_tracker      (),
+    m_render            (nullptr)
 {
     // Empty body now
 }
@@ -104,6 +112,55 @@ mastermidibase::~mastermidibase ()
         delete m_bus_announce;
         m_bus_announce = nullptr;
     }
+    delete m_out_buses.exchange(nullptr);
+    reclaim_buses();
+}
+
+/**
+ *  Publishes a fresh copy of the output busses for the playback functions,
+ *  which read it without locking.  Must be called after any change to the
+ *  output buss array (activation, port start or exit).  If the busses share
+ *  a MIDI handle, they are pointed at m_handle_mutex first, so that a new
+ *  buss is never seen unprotected.
+ *
+ *  The old copy is retired, and deleted once no reader can still hold it.
+ *
+ * \threadsafe
+ */
+
+void
+mastermidibase::publish_buses ()
+{
+    automutex locker(m_mutex);
+    if (api_shared_handle())
+        m_outbus_array.share_io_mutex(m_handle_mutex);
+
+    bus_snapshot * old = m_out_buses.exchange(m_outbus_array.snapshot());
+    if (not_nullptr(old))
+        m_retired_buses.push_back(old);
+
+    reclaim_buses();
+}
+
+/**
+ *  Deletes the retired copies of the output busses, if no reader is active.
+ *  A reader that starts after the exchange in publish_buses() can only see
+ *  the new copy, so seeing the count at zero once is enough.  Otherwise the
+ *  copies are kept until the next publish_buses().  The caller holds
+ *  m_mutex, except in the destructor.
+ */
+
+void
+mastermidibase::reclaim_buses ()
+{
+    if (m_out_readers.load() == 0)
+    {
+        std::vector<bus_snapshot *>::iterator bi;
+        for (bi = m_retired_buses.begin(); bi != m_retired_buses.end(); ++bi)
+            delete *bi;
+
+        m_retired_buses.clear();
+    }
 }
 
 /**
@@ -117,6 +174,7 @@ void
 mastermidibase::start ()
 {
     automutex locker(m_mutex);
+    bus_locker handle(m_handle_mutex);
     api_start();
     m_outbus_array.start();
 }
@@ -136,6 +194,7 @@ void
 mastermidibase::continue_from (midipulse tick)
 {
     automutex locker(m_mutex);
+    bus_locker handle(m_handle_mutex);
     api_continue_from(tick);
     m_outbus_array.continue_from(tick);
 }
@@ -155,6 +214,7 @@ void
 mastermidibase::init_clock (midipulse tick)
 {
     automutex locker(m_mutex);
+    bus_locker handle(m_handle_mutex);
     api_init_clock(tick);
     m_outbus_array.init_clock(tick);
 }
@@ -172,6 +232,7 @@ void
 mastermidibase::stop ()
 {
     automutex locker(m_mutex);
+    bus_locker handle(m_handle_mutex);
     m_outbus_array.stop();
     api_stop();
 }
@@ -181,6 +242,8 @@ mastermidibase::stop ()
  *  api_clock() function, which does nothing for the <i> original </i> ALSA
  *  implementation and the PortMidi implementation.
  *
+ *  Reads the published buss list, so it does not wait on m_mutex.
+ *
  * \threadsafe
  *
  * \param tick
@@ -190,13 +253,43 @@ mastermidibase::stop ()
 void
 mastermidibase::emit_clock (midipulse tick)
 {
-    automutex locker(m_mutex);
-
     /*
      * Doesn't do anything: api_clock();
      */
 
-    m_outbus_array.clock(tick);
+    bus_snapshot * buses = acquire_buses();
+    if (not_nullptr(buses))
+    {
+        bus_snapshot::iterator bi;
+        for (bi = buses->begin(); bi != buses->end(); ++bi)
+        {
+            if (not_nullptr(bi->bus()))
+                (void) bi->bus()->clock(tick);
+        }
+    }
+    release_buses();
+}
+
+/**
+ *  Obtains the clock-enabled output busses for the clock_generator, which
+ *  then clocks them directly, locking only each buss's own mutex.  The
+ *  master mutex is held only while the list is copied.
+ *
+ * \threadsafe
+ *
+ * \param [out] buses
+ *      Receives the buss pointers, indexed by buss number.  Busses that are
+ *      inactive or have the clock off are null.
+ *
+ * \return
+ *      Returns the number of clocked busses.
+ */
+
+int
+mastermidibase::get_clock_buses (std::vector<midibus *> & buses)
+{
+    automutex locker(m_mutex);
+    return m_outbus_array.clock_buses(buses);
 }
 
 /**
@@ -213,6 +306,7 @@ void
 mastermidibase::set_ppqn (int ppqn)
 {
     automutex locker(m_mutex);
+    bus_locker handle(m_handle_mutex);
     m_ppqn = choose_ppqn(ppqn);                     /* m_ppqn = ppqn        */
     api_set_ppqn(ppqn);
 }
@@ -231,6 +325,7 @@ void
 mastermidibase::set_beats_per_minute (midibpm bpm)
 {
     automutex locker(m_mutex);
+    bus_locker handle(m_handle_mutex);
     m_beats_per_minute = bpm;
     api_set_beats_per_minute(bpm);
 }
@@ -238,7 +333,9 @@ mastermidibase::set_beats_per_minute (midibpm bpm)
 /**
  *  Flushes our local queue events out  The implementation-specific API
  *  function is called.  For example, ALSA provides a function to "drain" the
- *  output.
+ *  output.  Only the handle mutex is needed, since that is what the busses
+ *  use to write to a shared handle.  The events queued on the busses that
+ *  share it are sent first, so that they go out with the flush.
  *
  * \threadsafe
  */
@@ -246,32 +343,46 @@ mastermidibase::set_beats_per_minute (midibpm bpm)
 void
 mastermidibase::flush ()
 {
-    automutex locker(m_mutex);
+    bus_locker locker(m_handle_mutex);
+    m_handle_mutex.send_queued();
     api_flush();
 }
 
 /**
  *  Stops all notes on all channels on all busses.  Adapted from Oli Kester's
- *  Kepler34 project.
+ *  Kepler34 project, which sent a Note Off for every note of every channel
+ *  of every possible buss.  Now only the notes that the note tracker has
+ *  seen turned on, and not yet off, are sent, one batch per buss.
+ *
+ * \threadsafe
+ *
+ * \param controllers
+ *      If true, also send All Notes Off (CC 123) and All Sound Off (CC 120)
+ *      on each channel that has been used on each buss, to catch notes that
+ *      did not come from us (or that a synthesizer holds with its sustain
+ *      pedal).
  */
 
 void
-mastermidibase::panic ()
+mastermidibase::panic (bool controllers)
 {
-    event e;
-    e.set_status(EVENT_NOTE_OFF);
-    flush();
-    for (int bus = 0; bus < SEQ64_DEFAULT_BUSS_MAX; ++bus)
+    std::vector<event> events;
+    bus_snapshot * buses = acquire_buses();
+    if (not_nullptr(buses))
     {
-        for (int channel = 0; channel < SEQ64_MIDI_CHANNEL_MAX; ++channel)
+        for (int bus = 0; bus < int(buses->size()); ++bus)
         {
-            for (int note = 0; note < SEQ64_MIDI_COUNT_MAX; ++note)
+            businfo & bi = (*buses)[bus];
+            events.clear();
+            if (m_note_tracker.take(bus, events, controllers) > 0)
             {
-                e.set_data(note, SEQ64_MAX_NOTE_ON_VELOCITY);
-                play (bus, &e, channel);
+                if (bi.active())
+                    bi.bus()->play_batch(events);
             }
         }
     }
+    release_buses();
+    flush();
 }
 
 /**
@@ -289,9 +400,21 @@ mastermidibase::panic ()
 void
 mastermidibase::sysex (event * ev)
 {
-    automutex locker(m_mutex);
-    m_outbus_array.sysex(ev);
-    flush();                /* recursive locking! */
+    if (not_nullptr(m_render.load(std::memory_order_acquire)))
+        return;                                 /* not rendered, see below  */
+
+    bus_snapshot * buses = acquire_buses();
+    if (not_nullptr(buses))
+    {
+        bus_snapshot::iterator bi;
+        for (bi = buses->begin(); bi != buses->end(); ++bi)
+        {
+            if (not_nullptr(bi->bus()))
+                bi->bus()->sysex(ev);
+        }
+    }
+    release_buses();
+    flush();
 }
 
 /**
@@ -300,6 +423,13 @@ mastermidibase::sysex (event * ev)
  *
  *  There's currently no implementation-specific API function here.
  *
+ *  The buss is found in the published buss list, without locking, and
+ *  midibase::play() queues the event on that buss alone.  So playing on one
+ *  buss never waits for another buss, nor for a port hot-plug.  The event
+ *  is also handed to the note tracker, for panic().  During an offline
+ *  render (see render_to()), the event goes to the renderer instead, and
+ *  no buss is touched.
+ *
  * \threadsafe
  *
  * \param bus
@@ -317,8 +447,24 @@ mastermidibase::sysex (event * ev)
 void
 mastermidibase::play (bussbyte bus, event * e24, midibyte channel)
 {
-    automutex locker(m_mutex);
-    m_outbus_array.play(bus, e24, channel);
+    offline_render * r = m_render.load(std::memory_order_acquire);
+    if (not_nullptr(r))
+    {
+        r->capture(bus, *e24, channel);
+        return;
+    }
+
+    bus_snapshot * buses = acquire_buses();
+    if (not_nullptr(buses) && bus < bussbyte(buses->size()))
+    {
+        businfo & bi = (*buses)[bus];
+        if (bi.active())
+        {
+            bi.bus()->play(e24, channel);
+            m_note_tracker.track(bus, *e24, channel);
+        }
+    }
+    release_buses();
 }
 
 /**
@@ -405,6 +551,9 @@ mastermidibase::initialize_buses ()
     if (result)
         result = m_outbus_array.initialize();
 
+    if (result)
+        publish_buses();
+
     return result;
 }
 
@@ -576,10 +725,10 @@ mastermidibase::print () const
 }
 
 /**
- *  Initiate a poll() on the existing poll descriptors.
- *  This base-class implementation could be made identical to
- *  portmidi's poll_for_midi() function, maybe.  But currently it is better
- *  just call the implementation-specific API function.
+ *  Waits for input on all of the input sources.  If the backend has put its
+ *  sources into the input reactor, the reactor does the waiting, and can be
+ *  cut short by wake_input().  Otherwise, the implementation-specific API
+ *  function is called, as before.
  *
  *  Do we need to use a mutex lock?  NO!  It causes a deadlock!!!
  *
@@ -590,7 +739,23 @@ mastermidibase::print () const
 int
 mastermidibase::poll_for_midi ()
 {
-    return api_poll_for_midi();
+    if (m_input_reactor.active())
+        return m_input_reactor.wait(SEQ64_INPUT_POLL_MS);
+    else
+        return api_poll_for_midi();
+}
+
+/**
+ *  Makes a pending poll_for_midi() return at once, so that the input thread
+ *  can notice that it must exit.  Has no effect with the old polling.
+ *
+ * \threadsafe
+ */
+
+void
+mastermidibase::wake_input ()
+{
+    m_input_reactor.wake();
 }
 
 /**
@@ -637,6 +802,7 @@ mastermidibase::port_start (int client, int port)
 {
     automutex locker(m_mutex);
     api_port_start(client, port);
+    publish_buses();
 }
 
 /**
@@ -665,6 +831,7 @@ mastermidibase::port_exit (int client, int port)
     automutex locker(m_mutex);
     m_outbus_array.port_exit(client, port);
     m_inbus_array.port_exit(client, port);
+    publish_buses();
 }
 
 /**
@@ -24,7 +24,7 @@
  * \library       sequencer64 application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2015-10-10
- * \updates       2017-08-15
+ * \updates       2026-10-18
  * \license       GNU GPLv2 or above
  *
  *  This class is important when writing the MIDI and sequencer data out to a
@@ -32,6 +32,9 @@
  *  sequence/pattern/track.
  */
 
+#include <algorithm>                    /* std::lower_bound()               */
+#include <cstring>                      /* std::memcpy()                    */
+
 #include "globals.h"                    /* c_timesig and other flags        */
 #include "calculations.hpp"             /* log2_time_sig_value(), etc.      */
 #include "midi_container.hpp"           /* seq64::midi_container ABC        */
@@ -57,6 +60,8 @@ namespace seq64
 midi_container::midi_container (sequence & seq)
  :
     m_sequence          (seq),
+    m_song_events       (),
+    m_song_events_sorted(true),
     m_position_for_get  (0)
 {
     // Empty body
@@ -69,12 +74,19 @@ midi_container::midi_container (sequence & seq)
  *  sequence::add_list_var().
  *
  * \param v
- *      The data value to be added to the current event in the MIDI container.
+ *      The data value to be encoded.
+ *
+ * \param [out] b
+ *      Receives the encoded bytes.  It must have room for eight bytes.
+ *
+ * \return
+ *      Returns the number of bytes encoded.
  */
 
-void
-midi_container::add_variable (midipulse v)
+int
+midi_container::encode_variable (midipulse v, midibyte * b)
 {
+    int count = 0;
     midipulse buffer = v & 0x7F;                /* mask off a no-sign byte  */
     while (v >>= 7)                             /* shift right 7 bits, test */
     {
@@ -83,12 +95,27 @@ midi_container::add_variable (midipulse v)
     }
     for (;;)
     {
-        put(midibyte(buffer) & 0xFF);           /* add the LSB              */
+        b[count++] = midibyte(buffer) & 0xFF;   /* add the LSB              */
         if (buffer & 0x80)                      /* if bit 7 set             */
             buffer >>= 8;                       /* get next MSB             */
         else
             break;
     }
+    return count;
+}
+
+/**
+ *  Adds a variable-length value to the container.  See encode_variable().
+ *
+ * \param v
+ *      The data value to be added to the current event in the MIDI container.
+ */
+
+void
+midi_container::add_variable (midipulse v)
+{
+    midibyte b[8];
+    put_bytes(b, std::size_t(encode_variable(v, b)));
 }
 
 /**
@@ -150,36 +177,60 @@ midi_container::add_event (const event & e, midipulse deltatime)
     }
     else
     {
-        midibyte d0 = e.data(0);                    /* encode status & data */
-        midibyte d1 = e.data(1);
-        midibyte channel = m_sequence.get_midi_channel();
-        midibyte st = e.get_status();
-        add_variable(deltatime);                    /* encode delta_time    */
-        if (channel == EVENT_NULL_CHANNEL)
-            put(st | e.get_channel());              /* channel from event   */
-        else
-            put(st | channel);                      /* the sequence channel */
+        midibyte b[16];                             /* the whole event      */
+        int count = encode_variable(deltatime, b);  /* encode delta_time    */
+        count += encode_event(e, b + count);
+        put_bytes(b, std::size_t(count));
+    }
+}
 
-        switch (st & EVENT_CLEAR_CHAN_MASK)                     /* 0xF0 */
-        {
-        case EVENT_NOTE_OFF:                                    /* 0x80 */
-        case EVENT_NOTE_ON:                                     /* 0x90 */
-        case EVENT_AFTERTOUCH:                                  /* 0xA0 */
-        case EVENT_CONTROL_CHANGE:                              /* 0xB0 */
-        case EVENT_PITCH_WHEEL:                                 /* 0xE0 */
-            put(d0);
-            put(d1);
-            break;
+/**
+ *  Encodes the status and data bytes of a regular (not SysEx or Meta) MIDI
+ *  event.  See add_event().
+ *
+ * \param e
+ *      Provides the MIDI event to encode.
+ *
+ * \param [out] b
+ *      Receives the bytes.  It must have room for three bytes.
+ *
+ * \return
+ *      Returns the number of bytes encoded.
+ */
 
-        case EVENT_PROGRAM_CHANGE:                              /* 0xC0 */
-        case EVENT_CHANNEL_PRESSURE:                            /* 0xD0 */
-            put(d0);
-            break;
+int
+midi_container::encode_event (const event & e, midibyte * b) const
+{
+    int count = 0;
+    midibyte d0 = e.data(0);                        /* encode status & data */
+    midibyte d1 = e.data(1);
+    midibyte channel = m_sequence.get_midi_channel();
+    midibyte st = e.get_status();
+    if (channel == EVENT_NULL_CHANNEL)
+        b[count++] = st | e.get_channel();          /* channel from event   */
+    else
+        b[count++] = st | channel;                  /* the sequence channel */
 
-        default:
-            break;
-        }
+    switch (st & EVENT_CLEAR_CHAN_MASK)                         /* 0xF0 */
+    {
+    case EVENT_NOTE_OFF:                                        /* 0x80 */
+    case EVENT_NOTE_ON:                                         /* 0x90 */
+    case EVENT_AFTERTOUCH:                                      /* 0xA0 */
+    case EVENT_CONTROL_CHANGE:                                  /* 0xB0 */
+    case EVENT_PITCH_WHEEL:                                     /* 0xE0 */
+        b[count++] = d0;
+        b[count++] = d1;
+        break;
+
+    case EVENT_PROGRAM_CHANGE:                                  /* 0xC0 */
+    case EVENT_CHANNEL_PRESSURE:                                /* 0xD0 */
+        b[count++] = d0;
+        break;
+
+    default:
+        break;
     }
+    return count;
 }
 
 /**
@@ -200,8 +251,8 @@ midi_container::add_ex_event (const event & e, midipulse deltatime)
 
     int count = e.get_sysex_size();             /* applies for meta, too    */
     put(count);
-    for (int i = 0; i < count; ++i)
-        put(e.get_sysex()[i]);
+    if (count > 0)
+        put_bytes(&e.get_sysex()[0], std::size_t(count));
 }
 
 /**
@@ -277,16 +328,16 @@ midi_container::fill_meta_track_end (midipulse deltatime)
 void
 midi_container::fill_time_sig_and_tempo
 (
-    const perform & p,
+    const midi_timing & mt,
     bool has_time_sig,
     bool has_tempo
 )
 {
     if (! has_tempo)
-        fill_tempo(p);
+        fill_tempo(mt);
 
     if (! has_time_sig)
-        fill_time_sig(p);
+        fill_time_sig(mt);
 }
 
 
@@ -298,18 +349,18 @@ midi_container::fill_time_sig_and_tempo
  *  usage in this particular track.  For export, we cannot guarantee that the
  *  first (0th) track/sequence is exportable.
  *
- * \param p
- *      Provides the performance object from which we get some global MIDI
- *      parameters.
+ * \param mt
+ *      Provides the global MIDI parameters, copied from the performance
+ *      object.
  */
 
 void
-midi_container::fill_time_sig (const perform & p)
+midi_container::fill_time_sig (const midi_timing & mt)
 {
-    int beatwidth = p.get_beat_width();
-    int bpb = p.get_beats_per_bar();;
-    int cpm = p.clocks_per_metronome();
-    int get32pq = p.get_32nds_per_quarter();
+    int beatwidth = mt.beat_width();
+    int bpb = mt.beats_per_measure();
+    int cpm = mt.clocks_per_metronome();
+    int get32pq = mt.thirtyseconds_per_quarter();
     int bw = log2_time_sig_value(beatwidth);
     add_variable(0);                            /* delta time       */
     put(0xFF);                                  /* meta event       */
@@ -334,16 +385,16 @@ midi_container::fill_time_sig (const perform & p)
  *      Accidentally committed along with fruity changes, sigh, so go back a
  *      couple of commits to see the changes.
  *
- * \param p
- *      Provides the performance object from which we get some global MIDI
- *      parameters.
+ * \param mt
+ *      Provides the global MIDI parameters, copied from the performance
+ *      object.
  */
 
 void
-midi_container::fill_tempo (const perform & p)
+midi_container::fill_tempo (const midi_timing & mt)
 {
     midibyte t[4];                              /* hold tempo bytes */
-    int usperqn = p.us_per_quarter_note();
+    int usperqn = mt.us_per_quarter_note();
     tempo_us_to_bytes(t, usperqn);
     add_variable(0);                            /* delta time       */
     put(0xFF);                                  /* meta event       */
@@ -462,10 +513,62 @@ midi_container::fill_proprietary ()
     }
 }
 
+/**
+ *  Encodes the events of the sequence into m_song_events, in one pass, for
+ *  song_fill_seq_event(), and notes whether they are in time-stamp order.
+ */
+
+void
+midi_container::encode_song_events ()
+{
+    const event_list & evl = m_sequence.events();
+    m_song_events.clear();
+    m_song_events.reserve(std::size_t(evl.count()));
+    m_song_events_sorted = true;
+
+    event_list::const_iterator i;
+    for (i = evl.begin(); i != evl.end(); ++i)
+    {
+        const event & e = DREF(i);
+        song_event se;
+        se.se_timestamp = e.get_timestamp();
+        se.se_event = &e;
+        se.se_note_on = e.is_note_on();
+        se.se_note_off = e.is_note_off();
+        se.se_note = e.get_note();
+        se.se_size = 0;
+        if (! e.is_ex_data())
+            se.se_size = midibyte(encode_event(e, se.se_bytes));
+
+        if (! m_song_events.empty())
+        {
+            if (se.se_timestamp < m_song_events.back().se_timestamp)
+                m_song_events_sorted = false;
+        }
+        m_song_events.push_back(se);
+    }
+}
+
+/**
+ *  Orders song events by time-stamp, for std::lower_bound().
+ */
+
+bool
+midi_container::song_event_before (const song_event & se, midipulse ts)
+{
+    return se.se_timestamp < ts;
+}
+
 /**
  *  Fills in sequence events based on the trigger and events in the sequence
  *  associated with this midi_container.
  *
+ *  The events are taken from m_song_events, which holds the events already
+ *  encoded, so each repetition of the pattern only has to add the delta
+ *  times.  Events before the trigger are skipped with a binary search, and
+ *  once past the end of the trigger, with no notes left to turn off, the
+ *  rest of the repetition is skipped, since it would all be dropped.
+ *
  * \param trig
  *      The current trigger to be processed.
  *
@@ -506,29 +609,52 @@ midi_container::song_fill_seq_event
     if (trig_offset > start_offset)                 /* offset len too far   */
         timestamp_adjust -= len;
 
+    if (m_song_events.empty())
+        encode_song_events();
+
+    int notes_used = 0;                             /* sum of note_is_used  */
+    std::vector<song_event>::const_iterator evbegin = m_song_events.begin();
+    std::vector<song_event>::const_iterator evend = m_song_events.end();
     for (int p = 0; p <= times_played; ++p)
     {
         midipulse delta_time = 0;
-        event_list::Events::iterator i;
-        for (i = m_sequence.events().begin(); i != m_sequence.events().end(); ++i)
+        std::vector<song_event>::const_iterator i = evbegin;
+        if (m_song_events_sorted)                   /* skip to the trigger  */
+        {
+            i = std::lower_bound
+            (
+                evbegin, evend, trig.tick_start() - timestamp_adjust,
+                song_event_before
+            );
+        }
+        for ( ; i != evend; ++i)
         {
-            const event & e = DREF(i);
-            midipulse timestamp = e.get_timestamp() + timestamp_adjust;
+            const song_event & se = *i;
+            midipulse timestamp = se.se_timestamp + timestamp_adjust;
             if (timestamp >= trig.tick_start())     /* at/after trigger     */
             {
+                if (timestamp > trig.tick_end())
+                {
+                    if (m_song_events_sorted && notes_used == 0)
+                        break;                      /* the rest is dropped  */
+                }
+
                 /*
                  * Save the note; eliminate Note Off if Note On is unused.
                  */
 
-                midibyte note = e.get_note();
-                if (e.is_note_on())
+                midibyte note = se.se_note;
+                if (se.se_note_on)
                 {
                     if (timestamp <= trig.tick_end())
+                    {
                         note_is_used[note]++;       /* count the note       */
+                        ++notes_used;
+                    }
                     else
                         continue;                   /* skip                 */
                 }
-                else if (e.is_note_off())
+                else if (se.se_note_off)
                 {
                     if (note_is_used[note] > 0)
                     {
@@ -538,6 +664,7 @@ midi_container::song_fill_seq_event
                          */
 
                         note_is_used[note]--;       /* turn off the note    */
+                        --notes_used;
                         if (timestamp > trig.tick_end())
                             timestamp = trig.tick_end();
                     }
@@ -554,13 +681,21 @@ midi_container::song_fill_seq_event
 
             if (timestamp >= trig.tick_end())       /* event past trigger   */
             {
-                if (! e.is_note_on() && ! e.is_note_off())
+                if (! se.se_note_on && ! se.se_note_off)
                     continue;                       /* drop the event       */
             }
 
             delta_time = timestamp - prev_timestamp;
             prev_timestamp = timestamp;
-            add_event(e, delta_time);
+            if (se.se_size > 0)
+            {
+                midibyte b[16];                     /* the whole event      */
+                int count = encode_variable(delta_time, b);
+                std::memcpy(b + count, se.se_bytes, se.se_size);
+                put_bytes(b, std::size_t(count + se.se_size));
+            }
+            else
+                add_ex_event(*se.se_event, delta_time);
         }
         timestamp_adjust += len;        // any side-effects on sequence length?
     }
@@ -655,22 +790,23 @@ midi_container::song_fill_seq_trigger
  *      them being part of the edit.
  *
  * \threadunsafe
- *      The sequence object bound to this container needs to provide the
- *      locking mechanism when calling this function.
+ *      The sequence object bound to this container is a song_snapshot copy,
+ *      owned by the writer, so its events are read in place.
  *
  * \param track
  *      Provides the track number, re 0.  This number is masked into the track
  *      information.
  *
- * \param p
- *      The performance object that will hold some of the parameters needed
- *      when filling the MIDI container.
+ * \param mt
+ *      The song's timing parameters, needed for the time signature and tempo
+ *      of the first track.  The caller copies them from the performance
+ *      object, so that this function does not need it.
  */
 
 void
-midi_container::fill (int track, const perform & p)
+midi_container::fill (int track, const midi_timing & mt)
 {
-    event_list evl = m_sequence.events();           /* used below */
+    const event_list & evl = m_sequence.events();   /* a snapshot copy  */
     fill_seq_number(track);
     fill_seq_name(m_sequence.name());
 
@@ -684,16 +820,15 @@ midi_container::fill (int track, const perform & p)
 
     if (track == 0 && ! rc().legacy_format())
     {
-        fill_time_sig_and_tempo(p, evl.has_time_signature(), evl.has_tempo());
+        fill_time_sig_and_tempo(mt, evl.has_time_signature(), evl.has_tempo());
     }
 
     midipulse timestamp = 0;
     midipulse deltatime = 0;
     midipulse prevtimestamp = 0;
-    for (event_list::iterator i = evl.begin(); i != evl.end(); ++i)
+    for (event_list::const_iterator i = evl.begin(); i != evl.end(); ++i)
     {
-        event & er = DREF(i);
-        const event & e = er;
+        const event & e = DREF(i);
         timestamp = e.get_timestamp();
         deltatime = timestamp - prevtimestamp;
         if (deltatime < 0)                          /* midipulse == long    */
@@ -25,7 +25,7 @@
  * \library       sequencer64 application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2015-11-24
- * \updates       2017-07-09
+ * \updates       2026-10-18
  * \license       GNU GPLv2 or above
  *
  *  We have recently updated this module to put Set Tempo events into the
@@ -173,6 +173,23 @@ midi_splitter::log_main_sequence (sequence & seq, int seqnum)
  *  one channel it contains.  In fact, we just want to keep it in pattern slot
  *  number 16, to keep it out of the way.
  *
+ *  The split is done in one pass over the SMF 0 track, which is sorted.
+ *  Each event is appended to the list of each channel that gets it, so
+ *  every list stays sorted, and each list is then moved, not copied, into
+ *  its new sequence.  This used to be done by one pass per channel, with
+ *  an add_event() (which sorts the whole list, for the std::list
+ *  implementation) per event, and took minutes for a long SMF 0 file.
+ *  See event_list::append_split() for the order of events at the same time.
+ *
+ *  Note that the events that are read from the MIDI file have delta times.
+ *  Sequencer64 converts these delta times to cumulative times.    We
+ *  need to preserve that here.  Conversion back to delta times is needed only
+ *  when saving the sequences to a file.  This is done in
+ *  midi_container::fill().
+ *
+ *  Luckily, we don't have to worry about copying triggers, since the imported
+ *  SMF 0 track won't have any Seq24/Sequencer24 triggers.
+ *
  * \param p
  *      Provides a reference to the perform object into which sequences/tracks
  *      are to be added.
@@ -194,27 +211,77 @@ midi_splitter::split (perform & p, int screenset)
     {
         if (m_smf0_channels_count > 0)
         {
+            const sequence & main_seq = *m_smf0_main_sequence;
+            event_list lists[SEQ64_MIDI_CHANNEL_MAX];
+            event_list::iterator ties[SEQ64_MIDI_CHANNEL_MAX];
+            midipulse lengths[SEQ64_MIDI_CHANNEL_MAX];
+            for (int chan = 0; chan < SEQ64_MIDI_CHANNEL_MAX; ++chan)
+            {
+                ties[chan] = lists[chan].end();
+                lengths[chan] = 0;
+            }
+
+            /*
+             * Meta events go to channel 0 only; SysEx events, and any
+             * events without a channel, go to every channel.  The length
+             * of a sequence is the time-stamp of its last event.
+             */
+
+            const event_list & evl = m_smf0_main_sequence->events();
+            event_list::const_iterator i;
+            for (i = evl.begin(); i != evl.end(); ++i)
+            {
+                const event & er = DREF(i);
+                int first = 0;
+                int last = SEQ64_MIDI_CHANNEL_MAX;          /* one past it  */
+                if (er.is_meta())
+                {
+                    last = 1;
+                }
+                else if (! er.is_sysex())
+                {
+                    int channel = er.get_channel();
+                    if (channel < SEQ64_MIDI_CHANNEL_MAX)
+                    {
+                        first = channel;
+                        last = channel + 1;
+                    }
+                    else if (channel != EVENT_NULL_CHANNEL)
+                        last = 0;                           /* bad channel  */
+                }
+                for (int chan = first; chan < last; ++chan)
+                {
+                    if (m_smf0_channels[chan])
+                    {
+                        lists[chan].append_split(er, ties[chan]);
+                        lengths[chan] = er.get_timestamp();
+                    }
+                }
+            }
+
             int seqnum = screenset * usr().seqs_in_set();
             for (int chan = 0; chan < SEQ64_MIDI_CHANNEL_MAX; ++chan, ++seqnum)
             {
-                if (m_smf0_channels[chan])
+                if (m_smf0_channels[chan] && ! lists[chan].empty())
                 {
                     /*
-                     * The master MIDI buss must be set before the split,
-                     * otherwise the null pointer causes a segfault.
+                     * The master MIDI buss must be set first,
+                     * otherwise the null pointer causes a segfault.  It is
+                     * null in the staging perform object of a playlist,
+                     * and is set when the song is installed.  A channel
+                     * with no events, not even meta events, gets no
+                     * sequence.
                      */
 
                     sequence * s = new sequence(m_ppqn);
-                    s->set_master_midi_bus(&p.master_bus());
-                    if (split_channel(*m_smf0_main_sequence, s, chan))
-                    {
-                        p.add_sequence(s, seqnum);
+                    s->set_master_midi_bus(p.master_bus_pointer());
+                    setup_channel(main_seq, *s, chan);
+                    s->take_events(lists[chan]);
+                    s->set_length(lengths[chan]);       /* also links notes */
+                    p.add_sequence(s, seqnum);
 #ifdef SEQ64_USE_DEBUG_OUTPUT
-                        s->show_events();
+                    s->show_events();
 #endif
-                    }
-                    else
-                        delete s;   /* empty sequence, not even meta events */
                 }
             }
             m_smf0_main_sequence->set_midi_channel(EVENT_NULL_CHANNEL);
@@ -225,55 +292,31 @@ midi_splitter::split (perform & p, int screenset)
 }
 
 /**
- *  This function splits the given sequence into a new sequence, for the given
- *  channel found in the SMF 0 track.  It is called for each possible channel,
- *  resulting in multiple passes over the SMF 0 track.
- *
- *  Note that the events that are read from the MIDI file have delta times.
- *  Sequencer64 converts these delta times to cumulative times.    We
- *  need to preserve that here.  Conversion back to delta times is needed only
- *  when saving the sequences to a file.  This is done in
- *  midi_container::fill().
- *
- *  We have to accumulate the delta times in order to be able to set the
- *  length of the sequence in pulses.
- *
- *  Luckily, we don't have to worry about copying triggers, since the imported
- *  SMF 0 track won't have any Seq24/Sequencer24 triggers.
+ *  Makes the settings of a new sequence for the given channel found in the
+ *  SMF 0 track:  its name, channel, and buss.
  *
  *  It doesn't set the sequence number of the sequence; that is set when the
  *  sequence is added to the perform object.
  *
  * \param main_seq
  *      This parameter is the whole SMF 0 track that was read from the MIDI
- *      file.  It contains all of the channel data that needs to be split into
- *      separate sequences.
+ *      file.
  *
  * \param s
- *      Provides the new sequence that needs to have its settings made, and
- *      all of the selected channel events added to it.
+ *      Provides the new sequence that needs to have its settings made.
  *
  * \param channel
- *      Provides the MIDI channel number (re 0) that marks the channel data
- *      the needs to be extracted and added to the new sequence.  If this
- *      channel is 0, then we need to add certain Meta events to this
- *      sequence, as well.  So far we support only Tempo Meta events.
- *
- * \return
- *      Returns true if at least one event got added.   If none were added,
- *      the caller should delete the sequence object represented by parameter
- *      \a s.
+ *      Provides the MIDI channel number (re 0) of the new sequence.
  */
 
-bool
-midi_splitter::split_channel
+void
+midi_splitter::setup_channel
 (
     const sequence & main_seq,
-    sequence * s,
+    sequence & s,
     int channel
 )
 {
-    bool result = false;
     char tmp[24];
     if (main_seq.name().empty())
     {
@@ -287,41 +330,10 @@ midi_splitter::split_channel
         );
     }
 
-    s->set_name(std::string(tmp));
-    s->set_midi_channel(channel);
-    s->set_midi_bus(main_seq.get_midi_bus());
-    s->zero_markers();
-
-    midipulse length_in_ticks = 0;      /* an accumulator of delta times    */
-    const event_list & evl = main_seq.events();
-    for (event_list::const_iterator i = evl.begin(); i != evl.end(); ++i)
-    {
-        const event & er = DREF(i);
-        if (er.is_ex_data())
-        {
-            if (channel == 0 || er.is_sysex())
-            {
-                length_in_ticks = er.get_timestamp();
-                if (s->add_event(er))
-                    result = true;      /* an event got added               */
-            }
-        }
-        else if (er.check_channel(channel))
-        {
-            length_in_ticks = er.get_timestamp();
-            if (s->add_event(er))
-                result = true;          /* an event got added               */
-        }
-    }
-
-    /*
-     * No triggers to add.  Whew!  And setting the length is now a no-brainer,
-     * since the tick value is that of the last logged event in the sequence.
-     */
-
-    s->set_length(length_in_ticks);
-    s->sort_events();
-    return result;
+    s.set_name(std::string(tmp));
+    s.set_midi_channel(channel);
+    s.set_midi_bus(main_seq.get_midi_bus());
+    s.zero_markers();
 }
 
 }           // namespace seq64
@@ -46,6 +46,8 @@
  *          at 0.
  */
 
+#include <algorithm>                    /* std::find()                      */
+
 #include "globals.h"
 #include "calculations.hpp"             /* clock_ticks_from_ppqn()          */
 #include "event.hpp"                    /* seq64::event (MIDI event)        */
@@ -65,6 +67,129 @@
 namespace seq64
 {
 
+/**
+ *  Creates an output lock with no busses and nothing queued.
+ */
+
+bus_lock::bus_lock () :
+    m_mutex     (),
+    m_queued    (0),
+    m_buses     ()
+{
+    // Empty body
+}
+
+/**
+ *  Takes the lock, waiting for it if needed.
+ */
+
+void
+bus_lock::lock ()
+{
+    m_mutex.lock();
+}
+
+/**
+ *  Takes the lock if it is free (or already held by this thread).
+ *
+ * \return
+ *      Returns true if the lock was taken.
+ */
+
+bool
+bus_lock::try_lock ()
+{
+    return m_mutex.try_lock();
+}
+
+/**
+ *  Sends the queued events of every buss sharing the lock, then lets go of
+ *  it.  If an event is still counted afterwards, the thread that queued it
+ *  may have found the lock busy and left it to us, so we take the lock
+ *  again and send it, unless another thread has the lock by then, in which
+ *  case that thread sends it.
+ *
+ * \threadsafe
+ */
+
+void
+bus_lock::unlock ()
+{
+    for (;;)
+    {
+        send_queued();
+        m_mutex.unlock();
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_queued.load() <= 0)
+            break;
+
+        if (! m_mutex.try_lock())
+            break;                                      /* holder sends it  */
+    }
+}
+
+/**
+ *  Sends the queued events, if no other thread holds the lock.  If one
+ *  does, it will send them before it lets go.  Called after queueing an
+ *  event.
+ *
+ * \threadsafe
+ */
+
+void
+bus_lock::drain ()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_mutex.try_lock())
+        unlock();                                       /* sends them       */
+}
+
+/**
+ *  Sends the queued events of every buss sharing the lock.  The caller
+ *  must hold the lock.
+ */
+
+void
+bus_lock::send_queued ()
+{
+    std::vector<midibase *>::iterator bi;
+    for (bi = m_buses.begin(); bi != m_buses.end(); ++bi)
+        (*bi)->drain_locked();
+}
+
+/**
+ *  Adds a buss to the busses whose queues are sent by unlock().
+ *
+ * \param bus
+ *      The buss to add, if not already there.
+ */
+
+void
+bus_lock::add_bus (midibase * bus)
+{
+    bus_locker locker(*this);
+    if (std::find(m_buses.begin(), m_buses.end(), bus) == m_buses.end())
+        m_buses.push_back(bus);
+}
+
+/**
+ *  Removes a buss from the busses whose queues are sent by unlock().
+ *
+ * \param bus
+ *      The buss to remove.
+ */
+
+void
+bus_lock::remove_bus (midibase * bus)
+{
+    bus_locker locker(*this);
+    std::vector<midibase *>::iterator bi =
+        std::find(m_buses.begin(), m_buses.end(), bus);
+
+    if (bi != m_buses.end())
+        m_buses.erase(bi);
+}
+
 /**
  *  Initialize this static member.
  */
@@ -176,8 +301,11 @@ midibase::midibase
     m_is_virtual_port   (makevirtual),
     m_is_input_port     (isinput),
     m_is_system_port    (makesystem),
-    m_mutex             ()
+    m_lock              (),
+    m_io_mutex          (&m_lock),
+    m_out_queue         (SEQ64_BUS_QUEUE_SIZE)
 {
+    m_lock.add_bus(this);
     if (! makevirtual)
     {
         if (! busname.empty() && ! portname.empty())
@@ -192,12 +320,43 @@ midibase::midibase
 }
 
 /**
- *  A rote empty destructor.
+ *  Takes the buss off the shared output lock, if any, which must still
+ *  exist.  Its own lock goes with it.  Events still queued cannot be sent
+ *  now, since the port is gone, but they are uncounted, so that no lock
+ *  waits for them.
  */
 
 midibase::~midibase()
 {
-    // empty body
+    if (m_io_mutex != &m_lock)
+        m_io_mutex->remove_bus(this);
+
+    queued_event qe;
+    while (m_out_queue.pop(qe))
+        qe.qe_lock->sent();
+}
+
+/**
+ *  Makes this buss use the given lock to serialize its output, instead of
+ *  its own.  Called by the master buss when all of the busses share one
+ *  MIDI handle, before the buss is published to the playback functions.
+ *
+ *  The buss stays on its own lock's list too.  An event queued while the
+ *  lock changes is counted on the old lock, and taking that lock still
+ *  sends it.
+ *
+ * \param m
+ *      The shared lock, which must outlive this buss.
+ */
+
+void
+midibase::share_io_mutex (bus_lock & m)
+{
+    if (&m != m_io_mutex)
+    {
+        m.add_bus(this);
+        m_io_mutex = &m;
+    }
 }
 
 /**
@@ -548,6 +707,11 @@ midibase::print ()
  *  direct-passing mode to send the event without queueing, and puts it in the
  *  queue.
  *
+ *  The event is first added to this buss's lock-free queue, and then
+ *  drain() sends it, unless another thread is already sending on this buss.
+ *  In that case that thread sends it, and the caller does not wait.  Only if
+ *  the queue is full does the caller wait for the buss.
+ *
  * \threadsafe
  *
  * \param e24
@@ -561,8 +725,78 @@ midibase::print ()
 void
 midibase::play (event * e24, midibyte channel)
 {
-    automutex locker(m_mutex);
-    api_play(e24, channel);
+    bus_lock & lk = io_mutex();
+    queued_event qe;
+    qe.qe_event = *e24;
+    qe.qe_channel = channel;
+    qe.qe_lock = &lk;
+    if (m_out_queue.push(qe))
+    {
+        lk.queued();
+        lk.drain();
+    }
+    else
+    {
+        bus_locker locker(lk);
+        drain_locked();                                 /* keep the order   */
+        api_play(e24, channel);
+    }
+}
+
+/**
+ *  Plays a list of events while holding the buss once, and then flushes the
+ *  buss.  Used for the targeted panic, so that its Note Offs go out together
+ *  rather than competing one by one with the output thread.
+ *
+ * \threadsafe
+ *
+ * \param events
+ *      The events to be played on this bus.  Each event's own channel is
+ *      used.
+ */
+
+void
+midibase::play_batch (const std::vector<event> & events)
+{
+    bus_locker locker(io_mutex());
+    drain_locked();                                     /* keep the order   */
+    std::vector<event>::const_iterator ei;
+    for (ei = events.begin(); ei != events.end(); ++ei)
+    {
+        event e = *ei;
+        api_play(&e, e.get_channel());
+    }
+    api_flush();
+}
+
+/**
+ *  Sends the queued events, if no other thread is sending on this buss.
+ *  If one is, it will send them before it lets go of the buss.  See
+ *  bus_lock::unlock().
+ *
+ * \threadsafe
+ */
+
+void
+midibase::drain ()
+{
+    io_mutex().drain();
+}
+
+/**
+ *  Sends all of the queued events of this buss.  The caller must hold
+ *  io_mutex().
+ */
+
+void
+midibase::drain_locked ()
+{
+    queued_event qe;
+    while (m_out_queue.pop(qe))
+    {
+        api_play(&qe.qe_event, qe.qe_channel);
+        qe.qe_lock->sent();
+    }
 }
 
 /**
@@ -576,7 +810,8 @@ midibase::play (event * e24, midibyte channel)
 void
 midibase::sysex (event * e24)
 {
-    automutex locker(m_mutex);
+    bus_locker locker(io_mutex());
+    drain_locked();
     api_sysex(e24);
 }
 
@@ -587,7 +822,8 @@ midibase::sysex (event * e24)
 void
 midibase::flush ()
 {
-    automutex locker(m_mutex);
+    bus_locker locker(io_mutex());
+    drain_locked();
     api_flush();
 }
 
@@ -602,6 +838,7 @@ midibase::flush ()
 void
 midibase::init_clock (midipulse tick)
 {
+    bus_locker locker(io_mutex());
     if (m_clock_type == e_clock_pos && tick != 0)
     {
         continue_from(tick);
@@ -643,6 +880,7 @@ midibase::init_clock (midipulse tick)
 void
 midibase::continue_from (midipulse tick)
 {
+    bus_locker locker(io_mutex());
     midipulse pp16th = m_ppqn / 4;
     midipulse leftover = tick % pp16th;
     midipulse beats = tick / pp16th;
@@ -665,6 +903,7 @@ midibase::continue_from (midipulse tick)
 void
 midibase::start ()
 {
+    bus_locker locker(io_mutex());
     m_lasttick = -1;
     if (m_clock_type != e_clock_off)
     {
@@ -715,6 +954,7 @@ midibase::set_input (bool inputing)     // not part of portmidi
 void
 midibase::stop ()
 {
+    bus_locker locker(io_mutex());
     m_lasttick = -1;
     if (m_clock_type != e_clock_off)
     {
@@ -730,12 +970,18 @@ midibase::stop ()
  *
  * \param tick
  *      Provides the starting tick.
+ *
+ * \return
+ *      Returns the number of clock pulses actually sent.  The clock_generator
+ *      uses this value to time only the pulses that went out.
  */
 
-void
+int
 midibase::clock (midipulse tick)
 {
-    automutex locker(m_mutex);
+    bus_locker locker(io_mutex());
+    drain_locked();
+    int result = 0;
     if (m_clock_type != e_clock_off)
     {
         bool done = m_lasttick >= tick;
@@ -747,6 +993,7 @@ midibase::clock (midipulse tick)
             if ((m_lasttick % ct) == 0)                 /* tick time yet?   */
             {
                 api_clock(tick);
+                ++result;
 
                 /*
                  * TMI: printf("midibase::clock(%ld)\n", tick);
@@ -755,6 +1002,7 @@ midibase::clock (midipulse tick)
         }
         api_flush();                                    /* and send it out  */
     }
+    return result;
 }
 
 /**
@@ -89,7 +89,10 @@ midi_timing::midi_timing ()
     m_beats_per_minute      (0),
     m_beats_per_measure     (0),
     m_beat_width            (0),
-    m_ppqn                  (0)
+    m_ppqn                  (0),
+    m_clocks_per_metronome  (24),
+    m_32nds_per_quarter     (8),
+    m_us_per_quarter_note   (0)
 {
     // Empty body
 }
@@ -108,6 +111,9 @@ midi_timing::midi_timing ()
  *
  * \param ppqn
  *      Copied into the m_ppqn member.
+ *
+ *  The clocks per metronome and 32nds per quarter get their usual values,
+ *  and the microseconds per quarter note is calculated from bpminute.
  */
 
 midi_timing::midi_timing
@@ -120,7 +126,10 @@ midi_timing::midi_timing
     m_beats_per_minute      (bpminute),
     m_beats_per_measure     (bpmeasure),
     m_beat_width            (beatwidth),
-    m_ppqn                  (ppqn)
+    m_ppqn                  (ppqn),
+    m_clocks_per_metronome  (24),
+    m_32nds_per_quarter     (8),
+    m_us_per_quarter_note   (bpminute > 0 ? int(60000000.0 / bpminute) : 0)
 {
     // Empty body
 }
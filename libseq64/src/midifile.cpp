@@ -52,14 +52,21 @@
  *          -   Sequence events.
  */
 
+#include <atomic>                       /* std::atomic<int>                 */
+#include <cstdio>                       /* std::remove()                    */
 #include <fstream>
+#include <pthread.h>                    /* pthread_create(), pthread_join() */
+#include <thread>                       /* std::thread::hardware_concurr... */
 
 #include "app_limits.h"                 /* SEQ64_USE_MIDI_VECTOR            */
 #include "calculations.hpp"             /* bpm_from_tempo_us()              */
+#include "file_functions.hpp"           /* seq64::file_replace()            */
 #include "perform.hpp"                  /* must precede midifile.hpp !      */
 #include "midifile.hpp"                 /* seq64::midifile                  */
 #include "sequence.hpp"                 /* seq64::sequence                  */
+#include "session_cache.hpp"            /* seq64::session_cache             */
 #include "settings.hpp"                 /* seq64::rc() and choose_ppqn()    */
+#include "song_snapshot.hpp"            /* seq64::song_snapshot             */
 
 #ifdef SEQ64_USE_MIDI_VECTOR
 #include "midi_vector.hpp"              /* seq64::midi_vector container     */
@@ -68,11 +75,11 @@
 #endif
 
 /**
- *  A manifest constant for controlling the length of a line-reading
- *  array in a configuration file.
+ *  The suffix added to the MIDI file name to make the name of the temporary
+ *  file that is written first, and then renamed over the real file.
  */
 
-#define SEQ64_MIDI_LINE_MAX         1024
+#define SEQ64_MIDI_TEMP_SUFFIX      ".tmp"
 
 /**
  *  The maximum length of a Seq24 track name.  This is a bit excessive.
@@ -188,17 +195,60 @@ midifile::midifile
     m_disable_reported          (false),
     m_pos                       (0),
     m_name                      (name),
-    m_data                      (),
-    m_char_list                 (),
+    m_file_map                  (),
+    m_data                      (nullptr),
+    m_char_buffer               (),
     m_new_format                (! oldformat),
     m_global_bgsequence         (globalbgs),
     m_ppqn                      (0),
     m_use_default_ppqn          (ppqn == SEQ64_USE_DEFAULT_PPQN),
-    m_smf0_splitter             (ppqn)
+    m_smf0_splitter             (ppqn),
+    m_session_cache             (nullptr),
+    m_lazy_tracks               (false),
+    m_detached                  (false),
+    m_musical_key               (-1),
+    m_musical_scale             (-1),
+    m_background_sequence       (-1)
 {
     m_ppqn = choose_ppqn(ppqn);
 }
 
+/**
+ *  Creates a view of the data that another midifile is parsing, with its
+ *  own read position and error message.  Used by the track-decoding threads
+ *  of parse_tracks().  The view must not outlive the parent's parse().
+ *
+ * \param parent
+ *      The midifile whose data is being parsed.
+ */
+
+midifile::midifile (const midifile * parent)
+ :
+    m_mutex                     (),
+    m_file_size                 (parent->m_file_size),
+    m_error_message             (),
+    m_error_is_fatal            (false),
+    m_disable_reported          (false),
+    m_pos                       (0),
+    m_name                      (parent->m_name),
+    m_file_map                  (),
+    m_data                      (parent->m_data),
+    m_char_buffer               (),
+    m_new_format                (parent->m_new_format),
+    m_global_bgsequence         (parent->m_global_bgsequence),
+    m_ppqn                      (parent->m_ppqn),
+    m_use_default_ppqn          (parent->m_use_default_ppqn),
+    m_smf0_splitter             (parent->m_ppqn),
+    m_session_cache             (nullptr),
+    m_lazy_tracks               (parent->m_lazy_tracks),
+    m_detached                  (parent->m_detached),
+    m_musical_key               (-1),
+    m_musical_scale             (-1),
+    m_background_sequence       (-1)
+{
+    // Empty body
+}
+
 /**
  *  A rote destructor.
  */
@@ -209,10 +259,9 @@ midifile::~midifile ()
 }
 
 /**
- *  Reads 4 bytes of data using read_byte().
- *
- * \warning
- *      This code looks endian-dependent and integer-size dependent.
+ *  Reads 4 bytes of data.  If all four are inside the file, they are decoded
+ *  straight from m_data, and m_pos is advanced once; otherwise read_byte()
+ *  is used, so that running off the end is reported as before.
  *
  * \return
  *      Returns the four bytes, shifted appropriately and added together,
@@ -222,6 +271,17 @@ midifile::~midifile ()
 midilong
 midifile::read_long ()
 {
+    if (m_pos + 4 <= m_file_size)
+    {
+        const midibyte * p = m_data + m_pos;
+        m_pos += 4;
+        return
+        (
+            (midilong(p[0]) << 24) | (midilong(p[1]) << 16) |
+            (midilong(p[2]) << 8) | midilong(p[3])
+        );
+    }
+
     midilong result = read_byte() << 24;
     result += read_byte() << 16;
     result += read_byte() << 8;
@@ -230,7 +290,8 @@ midifile::read_long ()
 }
 
 /**
- *  Reads 2 bytes of data using read_byte().
+ *  Reads 2 bytes of data, decoding them straight from m_data if both are
+ *  inside the file.
  *
  * \return
  *      Returns the two bytes, shifted appropriately and added together,
@@ -240,13 +301,20 @@ midifile::read_long ()
 midishort
 midifile::read_short ()
 {
+    if (m_pos + 2 <= m_file_size)
+    {
+        const midibyte * p = m_data + m_pos;
+        m_pos += 2;
+        return midishort((midishort(p[0]) << 8) | midishort(p[1]));
+    }
+
     midishort result = read_byte() << 8;
     result += read_byte();
     return result;
 }
 
 /**
- *  Reads 1 byte of data directly from the m_data vector, incrementing
+ *  Reads 1 byte of data directly from the m_data array, incrementing
  *  m_pos after doing so.
  *
  * \return
@@ -276,6 +344,11 @@ midifile::read_byte ()
  *  byte.  Bit 7 is a continuation bit.  See write_varinum() for more
  *  information.
  *
+ *  Delta times and lengths are decoded in a local cursor, with m_pos
+ *  stored once at the end, as long as the four bytes that a legal VLV can
+ *  span are inside the file.  Near the end of the file, the byte-at-a-time
+ *  loop is used.
+ *
  * \return
  *      Returns the accumulated values as a single number.
  */
@@ -283,6 +356,35 @@ midifile::read_byte ()
 midilong
 midifile::read_varinum ()
 {
+    if (m_pos + 4 <= m_file_size)
+    {
+        const midibyte * p = m_data + m_pos;
+        midilong result = p[0] & 0x7F;
+        if ((p[0] & 0x80) == 0)
+        {
+            m_pos += 1;
+            return result;
+        }
+        result = (result << 7) | (p[1] & 0x7F);
+        if ((p[1] & 0x80) == 0)
+        {
+            m_pos += 2;
+            return result;
+        }
+        result = (result << 7) | (p[2] & 0x7F);
+        if ((p[2] & 0x80) == 0)
+        {
+            m_pos += 3;
+            return result;
+        }
+        result = (result << 7) | (p[3] & 0x7F);
+        if ((p[3] & 0x80) == 0)
+        {
+            m_pos += 4;
+            return result;
+        }
+    }
+
     midilong result = 0;
     midibyte c;
     while (((c = read_byte()) & 0x80) != 0x00)      /* while bit 7 is set  */
@@ -368,12 +470,8 @@ bool
 midifile::parse (perform & p, int screenset)
 {
     bool result = true;
-    std::ifstream file
-    (
-        m_name.c_str(), std::ios::in | std::ios::binary | std::ios::ate
-    );
     m_error_is_fatal = false;
-    if (! file.is_open())
+    if (! m_file_map.open(m_name))
     {
         m_error_is_fatal = true;
         m_error_message = "Error opening MIDI file '";
@@ -383,29 +481,18 @@ midifile::parse (perform & p, int screenset)
         return false;
     }
 
-    int file_size = file.tellg();                   /* get end offset       */
-    if (size_t(file_size) <= sizeof(long))
+    int file_size = int(m_file_map.size());         /* get end offset       */
+    if (m_file_map.size() <= sizeof(long))
     {
+        m_file_map.close();
         m_error_is_fatal = true;
         m_error_message = "Invalid file size... trying to read a directory?";
         errprint(m_error_message.c_str());
         return false;
     }
-    file.seekg(0, std::ios::beg);                   /* seek to start        */
-    try
-    {
-        m_data.resize(file_size);                   /* allocate more data   */
-        m_file_size = file_size;                    /* save for checking    */
-    }
-    catch (const std::bad_alloc & ex)
-    {
-        m_error_is_fatal = true;
-        m_error_message = "Memory allocation failed in midifile::parse()";
-        errprint(m_error_message.c_str());
-        return false;
-    }
-    file.read((char *)(&m_data[0]), file_size);     /* vector == array :-)  */
-    file.close();
+    m_data = m_file_map.data();                     /* no copy if mapped    */
+    m_file_size = file_size;                        /* save for checking    */
+    m_pos = 0;
     m_error_message.clear();
     m_disable_reported = false;
     m_smf0_splitter.initialize();                   /* SMF 0 support        */
@@ -416,32 +503,50 @@ midifile::parse (perform & p, int screenset)
     {
         m_error_is_fatal = true;
         errdump("Invalid MIDI header chunk detected", ID);
-        return false;
-    }
-
-    midishort Format = read_short();                /* 0, 1, or 2           */
-    if (Format == 0)
-    {
-        result = parse_smf_0(p, screenset);
-    }
-    else if (Format == 1)
-    {
-        result = parse_smf_1(p, screenset);
-    }
-    else
-    {
-        m_error_is_fatal = true;
-        errdump("Unsupported MIDI format number", midilong(Format));
         result = false;
     }
-    if (result)
+    else
     {
-        if (file_size > m_pos)                      /* any more data left?  */
-            result = parse_proprietary_track(p, file_size);
+        midishort Format = read_short();            /* 0, 1, or 2           */
+        if (Format == 0)
+        {
+            result = parse_smf_0(p, screenset);
+        }
+        else if (Format == 1)
+        {
+            /*
+             * Lazy loading wins over the session cache, which would need
+             * every track decoded in order to store it.
+             */
 
-        if (result && screenset != 0)
-             p.modify();                            /* modification flag    */
+            m_lazy_tracks = rc().lazy_loading() && ! m_detached;
+            if (screenset == 0 && rc().session_cache() && ! m_lazy_tracks)
+                result = parse_smf_1_cached(p);
+            else
+                result = parse_smf_1(p, screenset);
+        }
+        else
+        {
+            m_error_is_fatal = true;
+            errdump("Unsupported MIDI format number", midilong(Format));
+            result = false;
+        }
+        if (result)
+        {
+            if (file_size > m_pos)                  /* any more data left?  */
+                result = parse_proprietary_track(p, file_size);
+
+            if (result && screenset != 0)
+                 p.modify();                        /* modification flag    */
+
+            if (result && m_lazy_tracks)
+                p.prefetch_events();                /* decode current sets  */
+        }
     }
+    m_lazy_tracks = false;
+    m_data = nullptr;
+    m_file_size = 0;
+    m_file_map.close();                             /* unmap or free it     */
     return result;
 }
 
@@ -558,19 +663,18 @@ midifile::add_trigger (sequence & seq, midishort ppqn)
  *  already been read into memory.  It also assumes that the ID, track-length,
  *  and format have already been read.
  *
- *  If the MIDI file contains both proprietary (c_timesig) and MIDI type 0x58
- *  then it came from seq42 or seq32 (Stazed versions).  In this case the MIDI
- *  type is parsed first (because it is listed first) then it gets overwritten
- *  by the proprietary, above.
- *
- * Tempo events:
+ *  Each track chunk is an independent range of bytes, so a file with many
+ *  tracks is loaded in two phases.  First, index_tracks() walks the chunk
+ *  headers to find where every track starts.  Then parse_tracks() decodes
+ *  the tracks into detached sequences on a few worker threads.  Finally, the
+ *  sequences are installed into the perform object, in file order, on this
+ *  thread, so the result is the same as a track-by-track load.
  *
- *      If valid, set the global tempo to the first encountered tempo; this is
- *      legacy behavior.  Bad tempos occur and stick around, munging exported
- *      songs.  We log only the first tempo officially; the rest are stored as
- *      events if in the first track.  We also adjust the upper draw-tempo
- *      range value to about twice this value, to give some headroom... it
- *      will not be saved unless the --user-save option is in force.
+ *  If the chunk lengths cannot be trusted (a track's End of Track event is
+ *  not where its chunk header says the chunk ends) or any track fails to
+ *  decode, the parallel results are discarded and the file is parsed again,
+ *  one track at a time, exactly as before.  SMF 0 files, and files with few
+ *  tracks, are always parsed one track at a time.
  *
  * \param p
  *      Provides a reference to the perform object into which sequences/tracks
@@ -601,478 +705,998 @@ midifile::parse_smf_1 (perform & p, int screenset, bool is_smf0)
      * be read properly after all normal tracks have been processed.
      */
 
-    char buss_override = usr().midi_buss_override();
+    if (! is_smf0 && NumTracks >= SEQ64_PARSE_PARALLEL_MIN)
+    {
+        int startpos = m_pos;
+        std::vector<track_chunk> chunks;
+        if (index_tracks(NumTracks, chunks) && parse_tracks(ppqn, chunks))
+        {
+            for (int track = 0; track < int(chunks.size()); ++track)
+                install_track(p, track, screenset, false, chunks[track]);
+
+            return true;                        /* m_pos is past the tracks */
+        }
+
+        std::vector<track_chunk>::iterator ci;
+        for (ci = chunks.begin(); ci != chunks.end(); ++ci)
+            delete ci->tc_seq;                  /* start over, serially     */
+
+        m_pos = startpos;
+        m_disable_reported = false;
+        m_error_message.clear();
+    }
+
     for (int track = 0; track < NumTracks; ++track)
     {
-        midipulse Delta;                            /* MIDI delta time      */
-        midipulse RunningTime;
-        midipulse CurrentTime = 0;
-        char TrackName[SEQ64_TRACKNAME_MAX];        /* track name from file */
         midilong ID = read_long();                  /* get track marker     */
         midilong TrackLength = read_long();         /* get track length     */
         if (ID == SEQ64_MTRK_TAG)                   /* magic number 'MTrk'  */
         {
-            bool timesig_set = false;               /* seq24 style wins     */
-            midishort seqnum = 0;
-            midibyte status = 0;
-            midibyte laststatus;
-            midilong seqspec = 0;                   /* sequencer-specific   */
-            bool done = false;                      /* done for each track  */
-            sequence * s = new sequence(m_ppqn);    /* create new sequence  */
-            midilong len;                           /* important counter!   */
-            midibyte d0, d1;                        /* was data[2];         */
-            if (s == nullptr)
+            track_chunk tc;
+            tc.tc_id = ID;
+            tc.tc_offset = m_pos;
+            tc.tc_length = int(TrackLength);
+            if (parse_track(track, ppqn, is_smf0, tc))
             {
-                errdump("MIDI file parsing: sequence allocation failed");
+                install_track(p, track, screenset, is_smf0, tc);
+            }
+            else
+            {
+                delete tc.tc_seq;
                 return false;
             }
-            sequence & seq = *s;                /* references are nicer     */
-            seq.set_master_midi_bus(&p.master_bus());   /* set master buss  */
-            RunningTime = 0;                    /* reset time               */
-            while (! done)                      /* get each event in track  */
+        }
+        else
+        {
+            /*
+             * We don't know what kind of chunk it is.  It's not a MTrk, we
+             * don't know how to deal with it, so we just eat it.  If this
+             * happened on the first track, it is a fatal error.
+             */
+
+            if (track > 0)                              /* non-fatal later  */
             {
-                event e;                        /* safer here, if "slower"  */
-                Delta = read_varinum();         /* get time delta           */
-                laststatus = status;
-                status = m_data[m_pos];         /* get next status byte     */
-                if ((status & 0x80) == 0x00)    /* is it a status bit ?     */
-                    status = laststatus;        /* no, it's running status  */
-                else
-                    ++m_pos;                    /* it's a status, increment */
+                errdump("Unsupported MIDI track ID, skipping...", ID);
+            }
+            else                                        /* fatal in 1st one */
+            {
+                errdump("Unsupported MIDI track ID on first track.", ID);
+                result = false;
+                break;
+            }
+            m_pos += TrackLength;
+        }
+    }                                                   /* for each track   */
+    return result;
+}
 
-                e.set_status(status);           /* set the members in event */
+/**
+ *  Loads the tracks of an SMF 1 file from the session cache, if the cache
+ *  matches the file.  Otherwise, parses the tracks as usual, and then stores
+ *  them in the cache for the next load.  Either way, the tracks go through
+ *  install_track(), so the perform object ends up the same, and m_pos is
+ *  left at the proprietary track, which is always parsed from the file.
+ *
+ *  Only a clean parse is stored; a file that produced any error message is
+ *  parsed every time, so that the message is not lost.
+ *
+ * \param p
+ *      Provides a reference to the perform object into which sequences/tracks
+ *      are to be added.
+ *
+ * \return
+ *      Returns true if the parsing succeeded.
+ */
 
-                /*
-                 * Current time is re the ppqn according to the file, we have
-                 * to adjust it to our own ppqn.  PPQN / ppqn gives us the
-                 * ratio.  (This change is not enough; a song with a ppqn of
-                 * 120 plays too fast in Seq24, which has a constant ppqn of
-                 * 192.  Triggers must also be modified)
-                 */
+bool
+midifile::parse_smf_1_cached (perform & p)
+{
+    session_cache cache(m_name, m_ppqn, m_use_default_ppqn);
+    int propoffset = 0;
+    if (cache.load(m_data, std::size_t(m_file_size), propoffset))
+    {
+        std::vector<session_cache::track_info> & tracks = cache.tracks();
+        std::vector<session_cache::track_info>::iterator ti;
+        for (ti = tracks.begin(); ti != tracks.end(); ++ti)
+        {
+            track_chunk tc;
+            tc.tc_id = ti->ti_id;
+            tc.tc_offset = ti->ti_offset;
+            tc.tc_length = ti->ti_length;
+            tc.tc_ok = true;
+            tc.tc_seq = ti->ti_seq;
+            tc.tc_seqnum = ti->ti_seqnum;
+            tc.tc_beats_per_bar = ti->ti_beats_per_bar;
+            tc.tc_beat_width = ti->ti_beat_width;
+            tc.tc_clocks_per_metronome = ti->ti_clocks_per_metronome;
+            tc.tc_32nds_per_quarter = ti->ti_32nds_per_quarter;
+            tc.tc_tempo_us = ti->ti_tempo_us;
+            ti->ti_seq = nullptr;                   /* p will own it        */
+            install_track(p, ti->ti_track, 0, false, tc);
+        }
+        m_pos = propoffset;
+        return true;
+    }
 
-                RunningTime += Delta;           /* add in the time          */
-                if (m_use_default_ppqn)         /* legacy handling of ppqn  */
-                {
-                    if (ppqn > 0)
-                    {
-                        CurrentTime = RunningTime * m_ppqn / ppqn;
-                        e.set_timestamp(CurrentTime);
-                    }
-                }
-                else
-                {
-                    CurrentTime = RunningTime;
-                    e.set_timestamp(CurrentTime);
-                }
+    m_session_cache = &cache;                       /* install_track() logs */
+    bool result = parse_smf_1(p, 0);
+    m_session_cache = nullptr;
+    if (result && m_error_message.empty())
+        (void) cache.store(m_data, std::size_t(m_file_size), m_pos);
 
-                midibyte eventcode = status & EVENT_CLEAR_CHAN_MASK;   /* F0 */
-                midibyte channel = status & EVENT_GET_CHAN_MASK;       /* 0F */
-                switch (eventcode)
-                {
-                case EVENT_NOTE_OFF:          /* cases for 2-data-byte events */
-                case EVENT_NOTE_ON:
-                case EVENT_AFTERTOUCH:
-                case EVENT_CONTROL_CHANGE:
-                case EVENT_PITCH_WHEEL:
+    return result;
+}
 
-                    d0 = read_byte();                     /* was data[0]      */
-                    d1 = read_byte();                     /* was data[1]      */
-                    if (is_note_off_velocity(eventcode, d1))
-                        e.set_status(EVENT_NOTE_OFF, channel); /* vel 0==off  */
+/**
+ *  Marks a track chunk as empty.
+ */
 
-                    e.set_data(d0, d1);                   /* set data and add */
+midifile::track_chunk::track_chunk ()
+ :
+    tc_id                       (0),
+    tc_offset                   (0),
+    tc_length                   (0),
+    tc_end                      (0),
+    tc_ok                       (false),
+    tc_seq                      (nullptr),
+    tc_seqnum                   (0),
+    tc_beats_per_bar            (0),
+    tc_beat_width               (0),
+    tc_clocks_per_metronome     (0),
+    tc_32nds_per_quarter        (0),
+    tc_tempo_us                 (0.0),
+    tc_has_events               (false),
+    tc_has_tempo                (false),
+    tc_has_time_signature       (false),
+    tc_error                    ()
+{
+    // Empty body
+}
 
-                    /*
-                     * Replaced seq.add_event() with seq.append_event().  The
-                     * latter doesn't sort events; sort after we get them all.
-                     */
+/**
+ *  The first phase of a parallel SMF 1 load.  Walks the track chunk headers,
+ *  starting at m_pos, recording the ID, offset, and length of each chunk,
+ *  and leaves m_pos just past the last chunk.  Nothing is decoded.
+ *
+ * \param numtracks
+ *      The number of tracks given in the file header.
+ *
+ * \param chunks
+ *      Receives one entry per track.
+ *
+ * \return
+ *      Returns false if a chunk runs past the end of the file, or if the
+ *      first chunk is not a track.  The caller then parses the file one
+ *      track at a time, which reports the problem as it always has.
+ */
 
-                    seq.append_event(e);                  /* does not sort    */
-                    seq.set_midi_channel(channel);        /* set midi channel */
-                    if (is_smf0)
-                        m_smf0_splitter.increment(channel);
-                    break;
+bool
+midifile::index_tracks (int numtracks, std::vector<track_chunk> & chunks)
+{
+    chunks.resize(std::size_t(numtracks));
+    for (int track = 0; track < numtracks; ++track)
+    {
+        if (m_pos + 8 > m_file_size)
+            return false;
 
-                case EVENT_PROGRAM_CHANGE:    /* cases for 1-data-byte events */
-                case EVENT_CHANNEL_PRESSURE:
+        track_chunk & tc = chunks[track];
+        tc.tc_id = read_long();
+        tc.tc_length = int(read_long());
+        tc.tc_offset = m_pos;
+        if (tc.tc_length < 0 || tc.tc_length > m_file_size - m_pos)
+            return false;
 
-                    d0 = read_byte();                     /* was data[0]      */
-                    e.set_data(d0);                       /* set data and add */
+        if (track == 0 && tc.tc_id != SEQ64_MTRK_TAG)
+            return false;
 
-                    /*
-                     * We will replace seq.add_event() with
-                     * seq.append_event().  The latter won't bother sorting
-                     * events; they'll be sorted after we get them all.
-                     */
+        m_pos += tc.tc_length;
+    }
+    return true;
+}
 
-                    seq.append_event(e);                  /* does not sort    */
-                    seq.set_midi_channel(channel);        /* set midi channel */
-                    if (is_smf0)
-                        m_smf0_splitter.increment(channel);
-                    break;
+/**
+ *  The work shared by the threads started by parse_tracks().  Each thread
+ *  takes the next undecoded track from pj_next until none are left.
+ */
 
-                case 0xF0:                                /* Meta MIDI events */
+struct midifile::parse_job
+{
+    const midifile * pj_parent;         /**< Supplies the file data.        */
+    midishort pj_ppqn;                  /**< The PPQN read from the file.   */
+    std::vector<track_chunk> * pj_chunks;   /**< The tracks to decode.      */
+    std::atomic<int> pj_next;           /**< The next track to take.        */
+};
 
-                    if (status == 0xFF)
-                    {
-                        midibyte mtype = read_byte();     /* get meta type    */
-                        len = read_varinum();             /* if 0 catch later */
-                        switch (mtype)
-                        {
-                        case 0x7F:                        /* "proprietary"    */
-
-                            if (len > 4)                  /* FF 7F len data   */
-                            {
-                                seqspec = read_long();
-                                len -= 4;
-                            }
-                            else if (! checklen(len, mtype))
-                                return false;
-
-                            if (seqspec == c_midibus)
-                            {
-                                seq.set_midi_bus(read_byte());
-                                --len;
-                            }
-                            else if (seqspec == c_midich)
-                            {
-                                midibyte channel = read_byte();
-                                seq.set_midi_channel(channel);
-                                if (is_smf0)
-                                    m_smf0_splitter.increment(channel);
-
-                                --len;
-                            }
-                            else if (seqspec == c_timesig)
-                            {
-                                timesig_set = true;
-                                int bpm = int(read_byte());
-                                int bw = int(read_byte());
-                                seq.set_beats_per_bar(bpm);
-                                seq.set_beat_width(bw);
-                                p.set_beats_per_bar(bpm);
-                                p.set_beat_width(bw);
-                                len -= 2;
-                            }
-                            else if (seqspec == c_triggers)
-                            {
-                                printf("Old-style triggers event encountered\n");
-                                int num_triggers = len / 4;
-                                for (int i = 0; i < num_triggers; i += 2)
-                                {
-                                    midilong on = read_long();
-                                    midilong length = read_long() - on;
-                                    len -= 8;
-                                    seq.add_trigger(on, length, 0, false);
-                                }
-                            }
-                            else if (seqspec == c_triggers_new)
-                            {
-                                int num_triggers = len / 12;
-                                midishort p = m_use_default_ppqn ? ppqn : 0 ;
-                                for (int i = 0; i < num_triggers; ++i)
-                                {
-                                    len -= 12;
-                                    add_trigger(seq, p);
-                                }
-                            }
-                            else if (seqspec == c_musickey)
-                            {
-                                seq.musical_key(read_byte());
-                                --len;
-                            }
-                            else if (seqspec == c_musicscale)
-                            {
-                                seq.musical_scale(read_byte());
-                                --len;
-                            }
-                            else if (seqspec == c_backsequence)
-                            {
-                                seq.background_sequence(int(read_long()));
-                                len -= 4;
-                            }
-#ifdef SEQ64_STAZED_TRANSPOSE
-                            else if (seqspec == c_transpose)
-                            {
-                                seq.set_transposable(read_byte() != 0);
-                                --len;
-                            }
-#endif
-                            else if (SEQ64_IS_PROPTAG(seqspec))
-                            {
-                                errdump
-                                (
-                                    "Unsupported track SeqSpec, skipping...",
-                                    seqspec
-                                );
-                            }
-                            m_pos += len;               /* eat the rest     */
-                            break;
+/**
+ *  The body of each track-decoding thread, and of the calling thread too.
+ *  It uses its own midifile view of the parent's data, so that each thread
+ *  has its own read position and error message.
+ *
+ * \param job
+ *      Points to the parse_job.
+ *
+ * \return
+ *      Always returns null.
+ */
 
-                        case 0x58:                      /* Time Signature   */
-
-                            if (! checklen(len, mtype))
-                                return false;
-
-                            if ((len == 4) && ! timesig_set)
-                            {
-                                int bpm = int(read_byte());         // nn
-                                int logbase2 = int(read_byte());    // dd
-                                int cc = read_byte();               // cc
-                                int bb = read_byte();               // bb
-                                int bw = beat_pow2(logbase2);
-                                seq.set_beats_per_bar(bpm);
-                                seq.set_beat_width(bw);
-                                seq.clocks_per_metronome(cc);
-                                seq.set_32nds_per_quarter(bb);
-                                if (track == 0)
-                                {
-                                    p.set_beats_per_bar(bpm);
-                                    p.set_beat_width(bw);
-                                    p.clocks_per_metronome(cc);
-                                    p.set_32nds_per_quarter(bb);
-                                }
-
-                                midibyte bt[4];
-                                bt[0] = midibyte(bpm);
-                                bt[1] = midibyte(logbase2);
-                                bt[2] = midibyte(cc);
-                                bt[3] = midibyte(bb);
-
-                                bool ok = e.append_meta_data(mtype, bt, 4);
-                                if (ok)
-                                    seq.append_event(e);        /* new 0.93 */
-                            }
-                            else
-                                m_pos += len;           /* eat it           */
-                            break;
+void *
+midifile::parse_thread_func (void * job)
+{
+    parse_job & pj = *static_cast<parse_job *>(job);
+    std::vector<track_chunk> & chunks = *pj.pj_chunks;
+    midifile view(pj.pj_parent);
+    for (;;)
+    {
+        int track = pj.pj_next++;
+        if (track >= int(chunks.size()))
+            break;
 
-                        case 0x51:                      /* Set Tempo        */
-
-                            if (! checklen(len, mtype))
-                                return false;
-
-                            if (len == 3)
-                            {
-                                /*
-                                 * See "Tempo events" in the function banner.
-                                 */
-
-                                midibyte bt[4];
-                                bt[0] = read_byte();                // tt
-                                bt[1] = read_byte();                // tt
-                                bt[2] = read_byte();                // tt
-                                bt[3] = 0;
-
-                                double tt = tempo_us_from_bytes(bt);
-                                if (tt > 0)
-                                {
-                                    static bool gotfirst = false;
-                                    if (track == 0)
-                                    {
-                                        midibpm bpm = bpm_from_tempo_us(tt);
-                                        if (! gotfirst)
-                                        {
-                                            gotfirst = true;
-                                            p.set_beats_per_minute(bpm);
-                                            p.us_per_quarter_note(int(tt));
-                                            seq.us_per_quarter_note(int(tt));
-
-                                            /*
-                                             * Let's not override the settings
-                                             * in the "usr" file.
-                                             *
-                                             * usr().midi_bpm_maximum(2.1 * bpm);
-                                             */
-                                        }
-                                    }
-
-                                    bool ok = e.append_meta_data(mtype, bt, 3);
-                                    if (ok)
-                                        seq.append_event(e);    /* new 0.93 */
-                                }
-                            }
-                            else
-                                m_pos += len;           /* eat it           */
-                            break;
+        track_chunk & tc = chunks[track];
+        if (tc.tc_id == SEQ64_MTRK_TAG)
+        {
+            view.m_pos = tc.tc_offset;
+            view.m_disable_reported = false;
+            view.m_error_message.clear();
+            tc.tc_ok = view.parse_track(track, pj.pj_ppqn, false, tc);
+            tc.tc_end = view.m_pos;
+            tc.tc_error = view.m_error_message;
+        }
+        else
+            tc.tc_ok = true;                    /* skipped when installed   */
+    }
+    return nullptr;
+}
 
-                        case 0x2F:                      /* End of Track     */
-
-                            /*
-                             * "If Delta is 0, then another event happened at
-                             * the same time as track-end.  Class sequence
-                             * discards the last note.  This fixes that.  A
-                             * native Seq24 file will always have a Delta >= 1."
-                             * Not true!  We've fixed the real issue by
-                             * commenting this code:
-                             *
-                             *  if (Delta == 0)
-                             *      ++CurrentTime;
-                             *
-                             * Question:  What if BPM is set *after* this
-                             *            event?
-                             */
-
-                            seq.set_length(CurrentTime, false);
-                            seq.zero_markers();
-                            done = true;
-                            break;
+/**
+ *  The second phase of a parallel SMF 1 load.  Decodes the indexed tracks
+ *  into detached sequences, using up to SEQ64_PARSE_THREADS_MAX threads
+ *  (counting this one).  The perform object is not touched.
+ *
+ * \param ppqn
+ *      The PPQN read from the file header.
+ *
+ * \param chunks
+ *      The tracks found by index_tracks().
+ *
+ * \return
+ *      Returns true if every track decoded cleanly and ended exactly where
+ *      its chunk header says it ends.
+ */
+
+bool
+midifile::parse_tracks (midishort ppqn, std::vector<track_chunk> & chunks)
+{
+    parse_job pj;
+    pj.pj_parent = this;
+    pj.pj_ppqn = ppqn;
+    pj.pj_chunks = &chunks;
+    pj.pj_next = 0;
 
-                        case 0x03:                      /* Track name       */
+    int threads = int(std::thread::hardware_concurrency());
+    if (threads > SEQ64_PARSE_THREADS_MAX)
+        threads = SEQ64_PARSE_THREADS_MAX;
 
-                            if (! checklen(len, mtype))
-                                return false;
+    if (threads > int(chunks.size()))
+        threads = int(chunks.size());
 
-                            if (len > SEQ64_TRACKNAME_MAX)
-                                len = SEQ64_TRACKNAME_MAX;
+    std::vector<pthread_t> workers;
+    for (int t = 1; t < threads; ++t)           /* this thread is one, too  */
+    {
+        pthread_t tid;
+        if (pthread_create(&tid, NULL, parse_thread_func, &pj) == 0)
+            workers.push_back(tid);
+        else
+            break;                              /* make do with fewer       */
+    }
+    (void) parse_thread_func(&pj);
 
-                            for (int i = 0; i < int(len); ++i)
-                                TrackName[i] = char(read_byte());
+    std::vector<pthread_t>::iterator wi;
+    for (wi = workers.begin(); wi != workers.end(); ++wi)
+        pthread_join(*wi, NULL);
 
-                            TrackName[len] = '\0';
-                            seq.set_name(TrackName);
-                            break;
+    std::vector<track_chunk>::const_iterator ci;
+    for (ci = chunks.begin(); ci != chunks.end(); ++ci)
+    {
+        if (! ci->tc_ok)
+            return false;
+
+        bool istrack = ci->tc_id == SEQ64_MTRK_TAG;
+        if (istrack && ci->tc_end != ci->tc_offset + ci->tc_length)
+            return false;                       /* chunk length is wrong    */
+    }
+    return true;
+}
 
-                        case 0x00:                      /* sequence number  */
+/**
+ *  Holds a copy of the bytes of one track chunk, and the parse settings in
+ *  force when it was indexed, so that it does not depend on the MIDI file,
+ *  which may be changed or removed after the load.
+ */
 
-                            if (! checklen(len, mtype))
-                                return false;
+class midifile::track_loader : public event_list::loader
+{
 
-                            seqnum = read_short();
-                            break;
+private:
 
-                        default:
+    std::string m_name;                 /**< The MIDI file, for messages.   */
+    std::vector<midibyte> m_data;       /**< The data of the track chunk.   */
+    int m_track;                        /**< The index of the track.        */
+    midishort m_file_ppqn;              /**< The PPQN in the file header.   */
+    int m_ppqn;                         /**< The PPQN of the sequences.     */
+    bool m_use_default_ppqn;            /**< Scale the file's timestamps.   */
 
-                            if (! checklen(len, mtype))
-                                return false;
+public:
 
-                            for (int i = 0; i < int(len); ++i)
-                                (void) read_byte();     /* ignore the rest  */
-                            break;
-                        }
+    track_loader
+    (
+        const midifile & parent, int track, midishort ppqn,
+        int offset, int end
+    );
+
+    virtual loader * clone () const
+    {
+        return new track_loader(*this);
+    }
+
+    virtual bool load (event_list & evl);
+
+};
+
+/**
+ *  Copies the track data out of the file being parsed.
+ *
+ * \param parent
+ *      The midifile that is indexing the track.
+ *
+ * \param track
+ *      The index of the track in the file.
+ *
+ * \param ppqn
+ *      The PPQN read from the file header.
+ *
+ * \param offset
+ *      The offset of the first byte of the track's data.
+ *
+ * \param end
+ *      The offset just past the track's End of Track event.
+ */
+
+midifile::track_loader::track_loader
+(
+    const midifile & parent, int track, midishort ppqn,
+    int offset, int end
+) :
+    m_name              (parent.m_name),
+    m_data              (parent.m_data + offset, parent.m_data + end),
+    m_track             (track),
+    m_file_ppqn         (ppqn),
+    m_ppqn              (parent.m_ppqn),
+    m_use_default_ppqn  (parent.m_use_default_ppqn)
+{
+    // Empty body
+}
+
+/**
+ *  Decodes the track with parse_track(), just as a normal load does, into a
+ *  scratch sequence, and moves its events, already sorted and linked, into
+ *  the deferred list.  The sequence settings the track makes were already
+ *  applied when the track was indexed.
+ *
+ * \param evl
+ *      The empty list that receives the events.
+ *
+ * \return
+ *      Returns true if the track decoded cleanly.
+ */
+
+bool
+midifile::track_loader::load (event_list & evl)
+{
+    if (m_data.empty())
+        return false;
+
+    midifile view(m_name);
+    view.m_data = &m_data[0];
+    view.m_file_size = int(m_data.size());
+    view.m_ppqn = m_ppqn;
+    view.m_use_default_ppqn = m_use_default_ppqn;
+
+    track_chunk tc;
+    tc.tc_length = view.m_file_size;
+    bool result = view.parse_track(m_track, m_file_ppqn, false, tc);
+    if (result)
+        evl.take(tc.tc_seq->events());
+
+    delete tc.tc_seq;
+    return result;
+}
+
+/**
+ *  Decodes one track, starting at m_pos, into a new sequence, which is
+ *  stored in tc.tc_seq even if decoding fails, so that the caller can free
+ *  it.  The sequence is detached:  it has no master buss and is not added
+ *  to the perform object, and the settings the track makes to the perform
+ *  object are recorded in tc, for install_track() to apply.  Therefore this
+ *  function can run on a worker thread.
+ *
+ *  If m_lazy_tracks is set, the track is only indexed:  everything but the
+ *  events is set up, and a track_loader attached to the event list calls
+ *  this function again, without m_lazy_tracks, when the events are first
+ *  needed.  Walking the track is still required, to find its length and
+ *  the SeqSpecs at its end, but no events are stored, sorted, or linked.
+ *
+ *  If the MIDI file contains both proprietary (c_timesig) and MIDI type 0x58
+ *  then it came from seq42 or seq32 (Stazed versions).  In this case the MIDI
+ *  type is parsed first (because it is listed first) then it gets overwritten
+ *  by the proprietary, above.
+ *
+ * Tempo events:
+ *
+ *      If valid, set the global tempo to the first encountered tempo; this is
+ *      legacy behavior.  Bad tempos occur and stick around, munging exported
+ *      songs.  We log only the first tempo officially; the rest are stored as
+ *      events if in the first track.  The first tempo of the first track is
+ *      recorded in tc.tc_tempo_us, and install_track() applies it.
+ *
+ * \param track
+ *      The index of the track in the file.
+ *
+ * \param ppqn
+ *      The PPQN read from the file header.
+ *
+ * \param is_smf0
+ *      True if we detected that the MIDI file is in SMF 0 format.
+ *
+ * \param tc
+ *      Receives the sequence and the settings made by the track.
+ *
+ * \return
+ *      Returns true if the track was decoded.
+ */
+
+bool
+midifile::parse_track
+(
+    int track, midishort ppqn, bool is_smf0, track_chunk & tc
+)
+{
+    midipulse Delta;                            /* MIDI delta time      */
+    midipulse RunningTime = 0;                  /* reset time           */
+    midipulse CurrentTime = 0;
+    char TrackName[SEQ64_TRACKNAME_MAX];        /* track name from file */
+    bool timesig_set = false;                   /* seq24 style wins     */
+    midibyte status = 0;
+    midibyte laststatus;
+    midilong seqspec = 0;                       /* sequencer-specific   */
+    bool done = false;                          /* done for each track  */
+    midilong len;                               /* important counter!   */
+    midibyte d0, d1;                            /* was data[2];         */
+    sequence * s = new sequence(m_ppqn);        /* create new sequence  */
+    if (s == nullptr)
+    {
+        errdump("MIDI file parsing: sequence allocation failed");
+        return false;
+    }
+    tc.tc_seq = s;
+
+    sequence & seq = *s;                        /* references are nicer */
+    while (! done)                      /* get each event in track  */
+    {
+        event e;                        /* safer here, if "slower"  */
+        Delta = read_varinum();         /* get time delta           */
+        laststatus = status;
+        status = m_data[m_pos];         /* get next status byte     */
+        if ((status & 0x80) == 0x00)    /* is it a status bit ?     */
+            status = laststatus;        /* no, it's running status  */
+        else
+            ++m_pos;                    /* it's a status, increment */
+
+        e.set_status(status);           /* set the members in event */
+
+        /*
+         * Current time is re the ppqn according to the file, we have
+         * to adjust it to our own ppqn.  PPQN / ppqn gives us the
+         * ratio.  (This change is not enough; a song with a ppqn of
+         * 120 plays too fast in Seq24, which has a constant ppqn of
+         * 192.  Triggers must also be modified)
+         */
+
+        RunningTime += Delta;           /* add in the time          */
+        if (m_use_default_ppqn)         /* legacy handling of ppqn  */
+        {
+            if (ppqn > 0)
+            {
+                CurrentTime = RunningTime * m_ppqn / ppqn;
+                e.set_timestamp(CurrentTime);
+            }
+        }
+        else
+        {
+            CurrentTime = RunningTime;
+            e.set_timestamp(CurrentTime);
+        }
+
+        midibyte eventcode = status & EVENT_CLEAR_CHAN_MASK;   /* F0 */
+        midibyte channel = status & EVENT_GET_CHAN_MASK;       /* 0F */
+        switch (eventcode)
+        {
+        case EVENT_NOTE_OFF:          /* cases for 2-data-byte events */
+        case EVENT_NOTE_ON:
+        case EVENT_AFTERTOUCH:
+        case EVENT_CONTROL_CHANGE:
+        case EVENT_PITCH_WHEEL:
+
+            d0 = read_byte();                     /* was data[0]      */
+            d1 = read_byte();                     /* was data[1]      */
+            if (is_note_off_velocity(eventcode, d1))
+                e.set_status(EVENT_NOTE_OFF, channel); /* vel 0==off  */
+
+            e.set_data(d0, d1);                   /* set data and add */
+
+            /*
+             * Replaced seq.add_event() with seq.append_event().  The
+             * latter doesn't sort events; sort after we get them all.
+             */
+
+            if (m_lazy_tracks)
+                tc.tc_has_events = true;          /* for defer()      */
+            else
+                seq.append_event(e);              /* does not sort    */
+
+            seq.set_midi_channel(channel);        /* set midi channel */
+            if (is_smf0)
+                m_smf0_splitter.increment(channel);
+            break;
+
+        case EVENT_PROGRAM_CHANGE:    /* cases for 1-data-byte events */
+        case EVENT_CHANNEL_PRESSURE:
+
+            d0 = read_byte();                     /* was data[0]      */
+            e.set_data(d0);                       /* set data and add */
+
+            /*
+             * We will replace seq.add_event() with
+             * seq.append_event().  The latter won't bother sorting
+             * events; they'll be sorted after we get them all.
+             */
+
+            if (m_lazy_tracks)
+                tc.tc_has_events = true;          /* for defer()      */
+            else
+                seq.append_event(e);              /* does not sort    */
+
+            seq.set_midi_channel(channel);        /* set midi channel */
+            if (is_smf0)
+                m_smf0_splitter.increment(channel);
+            break;
+
+        case 0xF0:                                /* Meta MIDI events */
+
+            if (status == 0xFF)
+            {
+                midibyte mtype = read_byte();     /* get meta type    */
+                len = read_varinum();             /* if 0 catch later */
+                switch (mtype)
+                {
+                case 0x7F:                        /* "proprietary"    */
+
+                    if (len > 4)                  /* FF 7F len data   */
+                    {
+                        seqspec = read_long();
+                        len -= 4;
                     }
-                    else if (status == EVENT_MIDI_SYSEX)    /* 0xF0 */
+                    else if (! checklen(len, mtype))
+                        return false;
+
+                    if (seqspec == c_midibus)
                     {
-                        /*
-                         * Some files do not properly encode SysEx messages;
-                         * see the function banner for notes.
-                         */
+                        seq.set_midi_bus(read_byte());
+                        --len;
+                    }
+                    else if (seqspec == c_midich)
+                    {
+                        midibyte channel = read_byte();
+                        seq.set_midi_channel(channel);
+                        if (is_smf0)
+                            m_smf0_splitter.increment(channel);
 
-                        midibyte check = read_byte();
-                        if (is_sysex_special_id(check))
+                        --len;
+                    }
+                    else if (seqspec == c_timesig)
+                    {
+                        timesig_set = true;
+                        int bpm = int(read_byte());
+                        int bw = int(read_byte());
+                        seq.set_beats_per_bar(bpm);
+                        seq.set_beat_width(bw);
+                        tc.tc_beats_per_bar = bpm;
+                        tc.tc_beat_width = bw;
+                        len -= 2;
+                    }
+                    else if (seqspec == c_triggers)
+                    {
+                        printf("Old-style triggers event encountered\n");
+                        int num_triggers = len / 4;
+                        for (int i = 0; i < num_triggers; i += 2)
                         {
-                            /*
-                             * TMI: errdump("SysEx ID byte = 7D to 7F");
-                             */
+                            midilong on = read_long();
+                            midilong length = read_long() - on;
+                            len -= 8;
+                            seq.add_trigger(on, length, 0, false);
                         }
-                        else                            /* handle normally  */
+                    }
+                    else if (seqspec == c_triggers_new)
+                    {
+                        int num_triggers = len / 12;
+                        midishort pq = m_use_default_ppqn ? ppqn : 0 ;
+                        for (int i = 0; i < num_triggers; ++i)
                         {
-                            --m_pos;                    /* put byte back    */
-                            len = read_varinum();       /* sysex            */
-#ifdef USE_SYSEX_PROCESSING
-                            int bcount = 0;
-                            while (len--)
-                            {
-                                midibyte b = read_byte();
-                                ++bcount;
-                                if (! e.append_sysex(b)) /* SysEx end byte? */
-                                    break;
-                            }
-                            m_pos += len;               /* skip the rest    */
-#else
-                            m_pos += len;               /* skip it          */
-                            if (m_data[m_pos-1] != 0xF7)
-                                errdump("SysEx terminator byte F7 not found");
+                            len -= 12;
+                            add_trigger(seq, pq);
+                        }
+                    }
+                    else if (seqspec == c_musickey)
+                    {
+                        seq.musical_key(read_byte());
+                        --len;
+                    }
+                    else if (seqspec == c_musicscale)
+                    {
+                        seq.musical_scale(read_byte());
+                        --len;
+                    }
+                    else if (seqspec == c_backsequence)
+                    {
+                        seq.background_sequence(int(read_long()));
+                        len -= 4;
+                    }
+#ifdef SEQ64_STAZED_TRANSPOSE
+                    else if (seqspec == c_transpose)
+                    {
+                        seq.set_transposable(read_byte() != 0);
+                        --len;
+                    }
 #endif
+                    else if (SEQ64_IS_PROPTAG(seqspec))
+                    {
+                        errdump
+                        (
+                            "Unsupported track SeqSpec, skipping...",
+                            seqspec
+                        );
+                    }
+                    m_pos += len;               /* eat the rest     */
+                    break;
+
+                case 0x58:                      /* Time Signature   */
+
+                    if (! checklen(len, mtype))
+                        return false;
+
+                    if ((len == 4) && ! timesig_set)
+                    {
+                        int bpm = int(read_byte());         // nn
+                        int logbase2 = int(read_byte());    // dd
+                        int cc = read_byte();               // cc
+                        int bb = read_byte();               // bb
+                        int bw = beat_pow2(logbase2);
+                        seq.set_beats_per_bar(bpm);
+                        seq.set_beat_width(bw);
+                        seq.clocks_per_metronome(cc);
+                        seq.set_32nds_per_quarter(bb);
+                        if (track == 0)
+                        {
+                            tc.tc_beats_per_bar = bpm;
+                            tc.tc_beat_width = bw;
+                            tc.tc_clocks_per_metronome = cc;
+                            tc.tc_32nds_per_quarter = bb;
                         }
+
+                        midibyte bt[4];
+                        bt[0] = midibyte(bpm);
+                        bt[1] = midibyte(logbase2);
+                        bt[2] = midibyte(cc);
+                        bt[3] = midibyte(bb);
+
+                        if (m_lazy_tracks)
+                            tc.tc_has_time_signature = true;
+                        else if (e.append_meta_data(mtype, bt, 4))
+                            seq.append_event(e);        /* new 0.93 */
                     }
                     else
-                    {
-                        errdump("Unexpected meta code", midilong(status));
+                        m_pos += len;           /* eat it           */
+                    break;
+
+                case 0x51:                      /* Set Tempo        */
+
+                    if (! checklen(len, mtype))
                         return false;
+
+                    if (len == 3)
+                    {
+                        /*
+                         * See "Tempo events" in the function banner.
+                         */
+
+                        midibyte bt[4];
+                        bt[0] = read_byte();                // tt
+                        bt[1] = read_byte();                // tt
+                        bt[2] = read_byte();                // tt
+                        bt[3] = 0;
+
+                        double tt = tempo_us_from_bytes(bt);
+                        if (tt > 0)
+                        {
+                            if (track == 0 && tc.tc_tempo_us == 0)
+                                tc.tc_tempo_us = tt;        /* see banner   */
+
+                            if (m_lazy_tracks)
+                                tc.tc_has_tempo = true;
+                            else if (e.append_meta_data(mtype, bt, 3))
+                                seq.append_event(e);    /* new 0.93 */
+                        }
                     }
+                    else
+                        m_pos += len;           /* eat it           */
                     break;
 
-                default:
+                case 0x2F:                      /* End of Track     */
 
-                    errdump("Unsupported MIDI event", midilong(status));
-                    return false;
+                    /*
+                     * "If Delta is 0, then another event happened at
+                     * the same time as track-end.  Class sequence
+                     * discards the last note.  This fixes that.  A
+                     * native Seq24 file will always have a Delta >= 1."
+                     * Not true!  We've fixed the real issue by
+                     * commenting this code:
+                     *
+                     *  if (Delta == 0)
+                     *      ++CurrentTime;
+                     *
+                     * Question:  What if BPM is set *after* this
+                     *            event?
+                     */
+
+                    seq.set_length(CurrentTime, false);
+                    seq.zero_markers();
+                    done = true;
                     break;
-                }
-            }                          /* while not done loading Trk chunk */
 
-            if (buss_override != SEQ64_BAD_BUSS)
-                seq.set_midi_bus(buss_override);
+                case 0x03:                      /* Track name       */
 
-            /*
-             * Sequence has been filled, add it to the performance or SMF 0
-             * splitter.
-             */
+                    if (! checklen(len, mtype))
+                        return false;
 
-            if (is_smf0)
-            {
-                (void) m_smf0_splitter.log_main_sequence(seq, seqnum);
+                    if (len > SEQ64_TRACKNAME_MAX)
+                        len = SEQ64_TRACKNAME_MAX;
+
+                    for (int i = 0; i < int(len); ++i)
+                        TrackName[i] = char(read_byte());
+
+                    TrackName[len] = '\0';
+                    seq.set_name(TrackName);
+                    break;
+
+                case 0x00:                      /* sequence number  */
+
+                    if (! checklen(len, mtype))
+                        return false;
+
+                    tc.tc_seqnum = read_short();
+                    break;
+
+                default:
+
+                    if (! checklen(len, mtype))
+                        return false;
+
+                    for (int i = 0; i < int(len); ++i)
+                        (void) read_byte();     /* ignore the rest  */
+                    break;
+                }
             }
-            else
+            else if (status == EVENT_MIDI_SYSEX)    /* 0xF0 */
             {
                 /*
-                 * If the sequence is shorter than a quarter note, assume it
-                 * needs to be padded to a measure.  This happens anyway if
-                 * the short pattern is opened in the sequence editor
-                 * (seqedit).
+                 * Some files do not properly encode SysEx messages;
+                 * see the function banner for notes.
                  */
 
-                if (seq.get_length() < seq.get_ppqn())
+                midibyte check = read_byte();
+                if (is_sysex_special_id(check))
                 {
-                    seq.set_length
-                    (
-                        seq.get_ppqn() * seq.get_beats_per_bar(), false
-                    );
+                    /*
+                     * TMI: errdump("SysEx ID byte = 7D to 7F");
+                     */
+                }
+                else                            /* handle normally  */
+                {
+                    --m_pos;                    /* put byte back    */
+                    len = read_varinum();       /* sysex            */
+#ifdef USE_SYSEX_PROCESSING
+                    int bcount = 0;
+                    while (len--)
+                    {
+                        midibyte b = read_byte();
+                        ++bcount;
+                        if (! e.append_sysex(b)) /* SysEx end byte? */
+                            break;
+                    }
+                    m_pos += len;               /* skip the rest    */
+#else
+                    m_pos += len;               /* skip it          */
+                    if (m_data[m_pos-1] != 0xF7)
+                        errdump("SysEx terminator byte F7 not found");
+#endif
                 }
+            }
+            else
+            {
+                errdump("Unexpected meta code", midilong(status));
+                return false;
+            }
+            break;
 
-                /*
-                 * Add sorting after reading all the events for the sequence.
-                 * Then add the sequence with it's preferred location as a
-                 * hint.
-                 */
+        default:
+
+            errdump("Unsupported MIDI event", midilong(status));
+            return false;
+            break;
+        }
+    }                          /* while not done loading Trk chunk */
+
+    char buss_override = usr().midi_buss_override();
+    if (buss_override != SEQ64_BAD_BUSS)
+        seq.set_midi_bus(buss_override);
+
+    if (! is_smf0)
+    {
+        /*
+         * If the sequence is shorter than a quarter note, assume it needs to
+         * be padded to a measure.  This happens anyway if the short pattern
+         * is opened in the sequence editor (seqedit).
+         */
+
+        if (seq.get_length() < seq.get_ppqn())
+        {
+            seq.set_length
+            (
+                seq.get_ppqn() * seq.get_beats_per_bar(), false
+            );
+        }
 
-                int preferred_seqnum = seqnum + screenset * usr().seqs_in_set();
-                seq.sort_events();              /* sort the events now      */
+        /*
+         * Add sorting after reading all the events for the sequence.
+         */
+
+        seq.sort_events();                      /* sort the events now  */
 #if USE_NEW_VERSION
-                seq.apply_length(tempo, ppqn, bw, measures);
+        seq.apply_length(tempo, ppqn, bw, measures);
 #else
-                seq.set_length();               /* final verify_and_link    */
+        seq.set_length();                       /* final verify_and_link */
 #endif
-                p.add_sequence(&seq, preferred_seqnum);
-            }
+        if (m_lazy_tracks)
+        {
+            seq.events().defer
+            (
+                new track_loader(*this, track, ppqn, tc.tc_offset, m_pos),
+                tc.tc_has_events || tc.tc_has_tempo ||
+                    tc.tc_has_time_signature,
+                tc.tc_has_tempo, tc.tc_has_time_signature
+            );
+        }
+    }
+    return true;
+}
 
-#ifdef PLATFORM_DEBUG_TMI
-            seq.print();
-#endif
+/**
+ *  The last step of loading a track, always done on the main thread.
+ *  Applies the settings the track made to the perform object, then adds
+ *  the sequence to the performance, with its preferred location as a hint,
+ *  or to the SMF 0 splitter.  A chunk that is not a track is skipped.
+ *
+ * \param p
+ *      The perform object that receives the sequence.
+ *
+ * \param track
+ *      The index of the track in the file.
+ *
+ * \param screenset
+ *      The screen-set offset to be used when loading a sequence (track) from
+ *      the file.
+ *
+ * \param is_smf0
+ *      True if we detected that the MIDI file is in SMF 0 format.
+ *
+ * \param tc
+ *      The decoded track.  Its sequence now belongs to p or the splitter.
+ */
 
-        }
-        else
+void
+midifile::install_track
+(
+    perform & p, int track, int screenset,
+    bool is_smf0, track_chunk & tc
+)
+{
+    if (not_nullptr(m_session_cache))
+    {
+        session_cache::track_info ti;
+        ti.ti_track = track;
+        ti.ti_id = tc.tc_id;
+        ti.ti_offset = tc.tc_offset;
+        ti.ti_length = tc.tc_length;
+        ti.ti_seqnum = tc.tc_seqnum;
+        ti.ti_beats_per_bar = tc.tc_beats_per_bar;
+        ti.ti_beat_width = tc.tc_beat_width;
+        ti.ti_clocks_per_metronome = tc.tc_clocks_per_metronome;
+        ti.ti_32nds_per_quarter = tc.tc_32nds_per_quarter;
+        ti.ti_tempo_us = tc.tc_tempo_us;
+        ti.ti_seq = tc.tc_id == SEQ64_MTRK_TAG ? tc.tc_seq : nullptr ;
+        m_session_cache->log_track(ti);
+    }
+    if (tc.tc_id != SEQ64_MTRK_TAG)
+    {
+        m_pos = tc.tc_offset;                   /* for the error offset */
+        errdump("Unsupported MIDI track ID, skipping...", tc.tc_id);
+        m_pos = tc.tc_offset + tc.tc_length;
+        return;
+    }
+    if (! tc.tc_error.empty())
+        m_error_message = tc.tc_error;          /* as if parsed here    */
+
+    if (tc.tc_beats_per_bar > 0)
+        p.set_beats_per_bar(tc.tc_beats_per_bar);
+
+    if (tc.tc_beat_width > 0)
+        p.set_beat_width(tc.tc_beat_width);
+
+    if (tc.tc_clocks_per_metronome > 0)
+        p.clocks_per_metronome(tc.tc_clocks_per_metronome);
+
+    if (tc.tc_32nds_per_quarter > 0)
+        p.set_32nds_per_quarter(tc.tc_32nds_per_quarter);
+
+    sequence & seq = *tc.tc_seq;
+    seq.set_master_midi_bus(p.master_bus_pointer());    /* null if staging  */
+    if (tc.tc_tempo_us > 0)
+    {
+        /*
+         * The first tempo of the first track sets the song tempo when a file
+         * is loaded, but not when one is imported into another screen-set.
+         * This used to be a static flag, which let only the first file
+         * loaded in a session set the tempo, and which is not safe with a
+         * playlist parsing songs on its own thread.
+         */
+
+        if (track == 0 && screenset == 0)
         {
+            p.set_beats_per_minute(bpm_from_tempo_us(tc.tc_tempo_us));
+            p.us_per_quarter_note(int(tc.tc_tempo_us));
+            seq.us_per_quarter_note(int(tc.tc_tempo_us));
+
             /*
-             * We don't know what kind of chunk it is.  It's not a MTrk, we
-             * don't know how to deal with it, so we just eat it.  If this
-             * happened on the first track, it is a fatal error.
+             * Let's not override the settings in the "usr" file.
+             *
+             * usr().midi_bpm_maximum(2.1 * bpm);
              */
-
-            if (track > 0)                              /* non-fatal later  */
-            {
-                errdump("Unsupported MIDI track ID, skipping...", ID);
-            }
-            else                                        /* fatal in 1st one */
-            {
-                errdump("Unsupported MIDI track ID on first track.", ID);
-                result = false;
-                break;
-            }
-            m_pos += TrackLength;
         }
-    }                                                   /* for each track   */
-    return result;
+    }
+
+    if (is_smf0)
+    {
+        (void) m_smf0_splitter.log_main_sequence(seq, tc.tc_seqnum);
+    }
+    else
+    {
+        int preferred_seqnum = tc.tc_seqnum + screenset * usr().seqs_in_set();
+        p.add_sequence(&seq, preferred_seqnum);
+    }
+    tc.tc_seq = nullptr;                        /* no longer ours       */
+
+#ifdef PLATFORM_DEBUG_TMI
+    seq.print();
+#endif
 }
 
 /**
@@ -1310,8 +1934,11 @@ midifile::parse_proprietary_track (perform & p, int file_size)
             }
             for (int buss = 0; buss < busscount; ++buss)
             {
-                bussbyte clocktype = read_byte();
-                p.master_bus().set_clock(bussbyte(buss), (clock_e)(clocktype));
+                clock_e clocktype = clock_e(read_byte());
+                if (not_nullptr(p.master_bus_pointer()))
+                    p.master_bus().set_clock(bussbyte(buss), clocktype);
+                else
+                    p.add_clock(clocktype);             /* staging perform  */
             }
         }
         seqspec = parse_prop_header(file_size);
@@ -1409,19 +2036,28 @@ midifile::parse_proprietary_track (perform & p, int file_size)
         if (seqspec == c_musickey)
         {
             int key = int(read_byte());
-            usr().seqedit_key(key);
+            if (m_detached)
+                m_musical_key = key;
+            else
+                usr().seqedit_key(key);
         }
         seqspec = parse_prop_header(file_size);
         if (seqspec == c_musicscale)
         {
             int scale = int(read_byte());
-            usr().seqedit_scale(scale);
+            if (m_detached)
+                m_musical_scale = scale;
+            else
+                usr().seqedit_scale(scale);
         }
         seqspec = parse_prop_header(file_size);
         if (seqspec == c_backsequence)
         {
             int seqnum = int(read_long());
-            usr().seqedit_bgsequence(seqnum);
+            if (m_detached)
+                m_background_sequence = seqnum;
+            else
+                usr().seqedit_bgsequence(seqnum);
         }
 
         /*
@@ -1830,6 +2466,17 @@ midifile::write_prop_header
     write_long(control_tag);                /* use legacy output call       */
 }
 
+/**
+ *  Writes a track chunk: the MTrk tag, the length, and the track data.  The
+ *  length is written as a placeholder and patched once the data is in the
+ *  buffer, so it is always the number of bytes actually written.  The
+ *  vector-based container is appended in one operation, rather than a
+ *  virtual get() per byte.
+ *
+ * \param lst
+ *      Provides the filled container of the track data.
+ */
+
 void
 midifile::write_track
 (
@@ -1840,11 +2487,147 @@ midifile::write_track
 #endif
 )
 {
-    midilong tracksize = midilong(lst.size());
     write_long(SEQ64_MTRK_TAG);             /* magic number 'MTrk'          */
-    write_long(tracksize);
+    std::size_t lengthpos = m_char_buffer.size();
+    write_long(0);                          /* back-patched below           */
+
+#if defined SEQ64_USE_MIDI_VECTOR
+    const std::vector<midibyte> & bytes = lst.bytes();
+    m_char_buffer.insert(m_char_buffer.end(), bytes.begin(), bytes.end());
+#else
     while (! lst.done())                    /* write the track data         */
         write_byte(lst.get());
+#endif
+
+    std::size_t datapos = lengthpos + 4;
+    patch_long(lengthpos, midilong(m_char_buffer.size() - datapos));
+}
+
+/**
+ *  Overwrites four bytes already in the output buffer with a long value, in
+ *  the same big-endian order as write_long().
+ *
+ * \param offset
+ *      The position of the first byte to overwrite.
+ *
+ * \param x
+ *      The value to store.
+ */
+
+void
+midifile::patch_long (std::size_t offset, midilong x)
+{
+    m_char_buffer[offset + 0] = midibyte((x & 0xFF000000) >> 24);
+    m_char_buffer[offset + 1] = midibyte((x & 0x00FF0000) >> 16);
+    m_char_buffer[offset + 2] = midibyte((x & 0x0000FF00) >> 8);
+    m_char_buffer[offset + 3] = midibyte((x & 0x000000FF));
+}
+
+/**
+ *  Opens the temporary file that write() and write_song() fill, and
+ *  prepares the output buffer.  The file is in the same directory as the
+ *  destination, so that close_output() can rename it into place.
+ *
+ * \param [out] file
+ *      The stream to open.
+ *
+ * \param tempname
+ *      The name of the temporary file.
+ *
+ * \return
+ *      Returns true if the file could be opened.
+ */
+
+bool
+midifile::open_output (std::ofstream & file, const std::string & tempname)
+{
+    m_char_buffer.clear();
+    m_char_buffer.reserve(SEQ64_MIDI_WRITE_CHUNK * 2);
+    file.open
+    (
+        tempname.c_str(), std::ios::out | std::ios::binary | std::ios::trunc
+    );
+    return file.is_open();
+}
+
+/**
+ *  Hands the output buffer to the file once it holds at least
+ *  SEQ64_MIDI_WRITE_CHUNK bytes, or always if \a force is true, and then
+ *  empties it.  Called between tracks, so that a track is never split
+ *  between the buffer and the file while its length is still to be patched.
+ *
+ * \param file
+ *      The open output stream.
+ *
+ * \param force
+ *      If true, write the buffer out no matter how small it is.
+ *
+ * \return
+ *      Returns false if the stream has failed.
+ */
+
+bool
+midifile::flush_buffer (std::ofstream & file, bool force)
+{
+    if (! m_char_buffer.empty())
+    {
+        if (force || m_char_buffer.size() >= SEQ64_MIDI_WRITE_CHUNK)
+        {
+            file.write
+            (
+                reinterpret_cast<const char *>(&m_char_buffer[0]),
+                std::streamsize(m_char_buffer.size())
+            );
+            m_char_buffer.clear();
+        }
+    }
+    return file.good();
+}
+
+/**
+ *  Writes the rest of the output buffer, closes the temporary file, and, if
+ *  all went well, renames it to the destination file name.  Otherwise the
+ *  temporary file is removed, and the destination is left untouched.
+ *
+ * \param file
+ *      The open output stream.
+ *
+ * \param tempname
+ *      The name of the temporary file.
+ *
+ * \param target
+ *      The destination, m_name with any symbolic link resolved, so that
+ *      the file it points to is replaced rather than the link.
+ *
+ * \return
+ *      Returns true if the destination file now holds the new data.
+ */
+
+bool
+midifile::close_output
+(
+    std::ofstream & file,
+    const std::string & tempname,
+    const std::string & target
+)
+{
+    bool result = flush_buffer(file, true);
+    file.close();
+    if (result)
+        result = ! file.fail();
+
+    if (result)
+        result = file_replace(tempname, target);
+
+    if (! result)
+    {
+        (void) std::remove(tempname.c_str());
+        m_error_message = "Error writing MIDI file '";
+        m_error_message += m_name;
+        m_error_message += "'";
+    }
+    m_char_buffer.clear();
+    return result;
 }
 
 /**
@@ -1882,8 +2665,10 @@ midifile::prop_item_size (long data_length) const
  *  Write the whole MIDI data and Seq24 information out to the file.
  *  Also see the write_song() function, for exporting to standard MIDI.
  *
- *  Seq24 reverses the order of some events, due to popping from its
- *  container.  Not an issue here.
+ *  This is the synchronous save:  it takes a song_snapshot of the
+ *  performance and writes it at once.  A background save (see the
+ *  song_saver class) takes the snapshot on the GUI thread and calls
+ *  write(const song_snapshot &) on its own thread.
  *
  * \param p
  *      Provides the object that will contain and manage the entire
@@ -1895,10 +2680,42 @@ midifile::prop_item_size (long data_length) const
 
 bool
 midifile::write (perform & p)
+{
+    song_snapshot snapshot;
+    if (snapshot.take(p) == 0)
+        return false;
+
+    bool result = write(snapshot);
+    if (result)
+        p.is_modified(false);      /* it worked, tell perform about it */
+
+    return result;
+}
+
+/**
+ *  Writes a snapshot of the song to the file.  The perform object is not
+ *  needed, so this function can run on any thread.
+ *
+ *  The data goes to a temporary file next to the destination, which is
+ *  renamed over it only when everything has been written.  A failed save
+ *  thus leaves the old file intact.
+ *
+ *  Seq24 reverses the order of some events, due to popping from its
+ *  container.  Not an issue here.
+ *
+ * \param snapshot
+ *      Provides the copy of the song to write.
+ *
+ * \return
+ *      Returns true if the write operations succeeded.
+ */
+
+bool
+midifile::write (const song_snapshot & snapshot)
 {
     automutex locker(m_mutex);          /* new ca 2016-08-01 */
     bool result = true;
-    int numtracks = 0;
+    int numtracks = snapshot.count();
     m_error_message.clear();
     if (m_ppqn < SEQ64_MINIMUM_PPQN || m_ppqn > SEQ64_MAXIMUM_PPQN)
     {
@@ -1906,76 +2723,213 @@ midifile::write (perform & p)
         return false;
     }
     printf("[Writing MIDI file, %d ppqn]\n", m_ppqn);
-    for (int i = 0; i < c_max_sequence; ++i) /* get number of active tracks */
+    if (numtracks == 0)
+        return false;
+
+    std::string target = file_real_path(m_name);     /* not the link     */
+    std::string tempname = target + SEQ64_MIDI_TEMP_SUFFIX;
+    std::ofstream file;
+    if (! open_output(file, tempname))
     {
-        if (p.is_active(i))
-            ++numtracks;
-    }
-    if (! write_header(numtracks))
+        m_error_message = "Error opening MIDI file for writing";
         return false;
+    }
+    (void) write_header(numtracks);
 
     /*
-     * Write out the active tracks.  The value of c_max_sequence is 1024.
-     * Note that we don't need to check the sequence pointer.
+     * Write out the active tracks, which are the only ones in the snapshot.
+     * The buffer is handed to the file between tracks, in large chunks.
      */
 
-    for (int track = 0; track < c_max_sequence; ++track)
+    for (int t = 0; t < numtracks && result; ++t)
     {
-        if (p.is_active(track))
-        {
-            sequence & seq = *p.get_sequence(track);
+        sequence & seq = snapshot.track(t);
 
 #if defined SEQ64_USE_MIDI_VECTOR
-            midi_vector lst(seq);
+        midi_vector lst(seq);
 #else
-            midi_list lst(seq);
+        midi_list lst(seq);
 #endif
 
-            /*
-             * midi_container::fill() also handles the time-signature and
-             * tempo meta events, if they are not part of the file's MIDI
-             * data.  All the events are put into the container, and then the
-             * container's bytes are written out below.
-             */
+        /*
+         * midi_container::fill() also handles the time-signature and tempo
+         * meta events, if they are not part of the file's MIDI data.  All
+         * the events are put into the container, and then the container's
+         * bytes are written out below.
+         */
 
-            lst.fill(track, p);
-            write_track(lst);
-        }
+        lst.fill(snapshot.track_number(t), snapshot.timing());
+        write_track(lst);
+        result = flush_buffer(file);
     }
     if (result)
-        result = write_proprietary_track(p);
+        result = write_proprietary_track(snapshot);
 
     if (result)
     {
-        std::ofstream file
+        result = close_output(file, tempname, target);
+    }
+    else
+    {
+        file.close();
+        (void) std::remove(tempname.c_str());
+        m_char_buffer.clear();
+        m_error_message = "Error writing MIDI file";
+    }
+    return result;
+}
+
+#ifdef SEQ64_STAZED_EXPORT_SONG
+
+/**
+ *  The work shared by the threads started by fill_song_tracks().  Each
+ *  thread takes the next unfilled track from ej_next until it reaches
+ *  ej_end.  Each track has its own container, so the threads share nothing
+ *  else.
+ */
+
+struct midifile::export_job
+{
+    const midi_timing * ej_timing;      /**< The song's timing, track 0.    */
+    std::vector<int> ej_tracks;         /**< The exportable track numbers.  */
+    std::vector<sequence *> ej_seqs;    /**< The sequence of each track.    */
+#if defined SEQ64_USE_MIDI_VECTOR
+    std::vector<midi_vector *> ej_lists;    /**< The bytes of each track.   */
+#else
+    std::vector<midi_list *> ej_lists;      /**< The bytes of each track.   */
+#endif
+    std::atomic<int> ej_next;           /**< The next track to take.        */
+    int ej_end;                         /**< One past the last to take.     */
+};
+
+/**
+ *  The body of each track-filling thread, and of the calling thread too.
+ *
+ * \param job
+ *      Points to the export_job.
+ *
+ * \return
+ *      Always returns null.
+ */
+
+void *
+midifile::export_thread_func (void * job)
+{
+    export_job & ej = *static_cast<export_job *>(job);
+    for (;;)
+    {
+        int t = ej.ej_next++;
+        if (t >= ej.ej_end)
+            break;
+
+        fill_song_track
         (
-            m_name.c_str(), std::ios::out | std::ios::binary | std::ios::trunc
+            *ej.ej_lists[t], *ej.ej_seqs[t], ej.ej_tracks[t], *ej.ej_timing
         );
-        if (file.is_open())
-        {
-            char file_buffer[SEQ64_MIDI_LINE_MAX];  /* enable bufferization */
-            file.rdbuf()->pubsetbuf(file_buffer, sizeof file_buffer);
-            std::list<midibyte>::iterator it;
-            for (it = m_char_list.begin(); it != m_char_list.end(); ++it)
-            {
-                char c = *it;
-                file.write(&c, 1);
-            }
-            m_char_list.clear();
-        }
+    }
+    return nullptr;
+}
+
+/**
+ *  Fills the containers of a batch of the exportable tracks, using up to
+ *  SEQ64_EXPORT_THREADS_MAX threads (counting this one).  Only the
+ *  sequences are read; the perform object is not touched.
+ *
+ * \param ej
+ *      The tracks to fill, each with its own empty container.  The tracks
+ *      from ej_next up to ej_end are filled.
+ */
+
+void
+midifile::fill_song_tracks (export_job & ej)
+{
+    int threads = int(std::thread::hardware_concurrency());
+    if (threads > SEQ64_EXPORT_THREADS_MAX)
+        threads = SEQ64_EXPORT_THREADS_MAX;
+
+    if (threads > ej.ej_end - ej.ej_next)
+        threads = ej.ej_end - ej.ej_next;
+
+    std::vector<pthread_t> workers;
+    for (int t = 1; t < threads; ++t)           /* this thread is one, too  */
+    {
+        pthread_t tid;
+        if (pthread_create(&tid, NULL, export_thread_func, &ej) == 0)
+            workers.push_back(tid);
         else
-        {
-            m_error_message = "Error opening MIDI file for writing";
-            result = false;
-        }
+            break;                              /* make do with fewer       */
     }
-    if (result)
-        p.is_modified(false);      /* it worked, tell perform about it */
+    (void) export_thread_func(&ej);
 
-    return result;
+    std::vector<pthread_t>::iterator wi;
+    for (wi = workers.begin(); wi != workers.end(); ++wi)
+        pthread_join(*wi, NULL);
 }
 
-#ifdef SEQ64_STAZED_EXPORT_SONG
+/**
+ *  Fills the container of one exported track:  the sequence number and
+ *  name, the time-signature and tempo for track 0, the events of every
+ *  trigger, one after the other, and a single trigger for the whole track.
+ *  See write_song().
+ *
+ * \param lst
+ *      The empty container for the track.
+ *
+ * \param seq
+ *      The sequence of the track.
+ *
+ * \param track
+ *      The track number.
+ *
+ * \param mt
+ *      The timing of the song, used for track 0 only.
+ */
+
+void
+midifile::fill_song_track
+(
+    midi_container & lst, sequence & seq,
+    int track, const midi_timing & mt
+)
+{
+    lst.fill_seq_number(track);
+    lst.fill_seq_name(seq.name());
+    if (track == 0 && ! rc().legacy_format())
+    {
+        lst.fill_time_sig_and_tempo
+        (
+            mt, seq.events().has_time_signature(), seq.events().has_tempo()
+        );
+    }
+
+    /*
+     * Add each trigger as described in the banner of write_song().
+     */
+
+    midipulse previous_ts = 0;
+    const triggers::List & trigs = seq.get_triggers();
+    triggers::List::const_iterator i;
+    for (i = trigs.begin(); i != trigs.end(); ++i)
+        previous_ts = lst.song_fill_seq_event(*i, previous_ts);
+
+    if (! trigs.empty())                /* adjust the sequence length       */
+    {
+        const trigger & end_trigger = trigs.back();
+
+        /*
+         * This isn't really the trigger length.  It is off by 1.  But
+         * subtracting the tick_start() value can really screw things up.
+         */
+
+        midipulse seqend = end_trigger.tick_end();
+        midipulse measticks = seq.measures_to_ticks();
+        midipulse remainder = seqend % measticks;
+        if (remainder != measticks - 1)
+            seqend += measticks - remainder - 1;
+
+        lst.song_fill_seq_trigger(end_trigger, seqend, previous_ts);
+    }
+}
 
 /**
  *  Write the whole MIDI data and Seq24 information out to a MIDI file, writing
@@ -2045,9 +2999,16 @@ midifile::write_song (perform & p)
             ++numtracks;
     }
     bool result = numtracks > 0;
+    std::string target = file_real_path(m_name);     /* not the link     */
+    std::string tempname = target + SEQ64_MIDI_TEMP_SUFFIX;
+    std::ofstream file;
     if (result)
     {
-        result = write_header(numtracks);
+        result = open_output(file, tempname);
+        if (result)
+            result = write_header(numtracks);
+        else
+            m_error_message = "Error opening MIDI file for exporting";
     }
     else
     {
@@ -2066,87 +3027,69 @@ midifile::write_song (perform & p)
          * incremented only if the track was exportable.  Note that this loop
          * is kind of an elaboration of what goes on in the midi_container ::
          * fill() function for normal Sequencer64 file writing.
+         *
+         * Each track is filled into a container of its own, a batch of
+         * tracks at a time, in parallel, by fill_song_tracks(); then the
+         * containers are written in track order, so the file is the same as
+         * when the tracks were filled one at a time.  Each container is
+         * freed once it is written.
          */
 
+        midi_timing mt = p.timing();
+        export_job ej;
+        ej.ej_timing = &mt;
+        ej.ej_next = 0;
+        ej.ej_end = 0;
         for (int track = 0; track < c_max_sequence; ++track)
         {
             if (p.is_exportable(track))
             {
-                sequence & seq = *p.get_sequence(track);
-
+                sequence * seq = p.get_sequence(track);
+                ej.ej_tracks.push_back(track);
+                ej.ej_seqs.push_back(seq);
 #if defined SEQ64_USE_MIDI_VECTOR
-                midi_vector lst(seq);
+                ej.ej_lists.push_back(new midi_vector(*seq));
 #else
-                midi_list lst(seq);
+                ej.ej_lists.push_back(new midi_list(*seq));
 #endif
+            }
+        }
 
-                lst.fill_seq_number(track);
-                lst.fill_seq_name(seq.name());
-                if (track == 0 && ! rc().legacy_format())
-                {
-                    lst.fill_time_sig_and_tempo
-                    (
-                        p, seq.events().has_time_signature(),
-                        seq.events().has_tempo()
-                    );
-                }
-
-                /*
-                 * Add each trigger as described in the function banner.
-                 */
-
-                midipulse previous_ts = 0;
-                const triggers::List & trigs = seq.get_triggers();
-                triggers::List::const_iterator i;
-                for (i = trigs.begin(); i != trigs.end(); ++i)
-                    previous_ts = lst.song_fill_seq_event(*i, previous_ts);
+        int count = int(ej.ej_lists.size());
+        for (int first = 0; first < count; first += SEQ64_EXPORT_BATCH)
+        {
+            int last = first + SEQ64_EXPORT_BATCH;
+            if (last > count)
+                last = count;
 
-                if (! trigs.empty())        /* adjust the sequence length */
+            if (result)
+            {
+                ej.ej_next = first;
+                ej.ej_end = last;
+                fill_song_tracks(ej);
+            }
+            for (int t = first; t < last; ++t)
+            {
+                if (result)
                 {
-                    const trigger & end_trigger = trigs.back();
-
-                    /*
-                     * This isn't really the trigger length.  It is off by 1.
-                     * But subtracting the tick_start() value can really screw
-                     * things up.
-                     */
-
-                    midipulse seqend = end_trigger.tick_end();
-                    midipulse measticks = seq.measures_to_ticks();
-                    midipulse remainder = seqend % measticks;
-                    if (remainder != measticks - 1)
-                        seqend += measticks - remainder - 1;
-
-                    lst.song_fill_seq_trigger(end_trigger, seqend, previous_ts);
+                    write_track(*ej.ej_lists[t]);
+                    result = flush_buffer(file);
                 }
-                write_track(lst);
+                delete ej.ej_lists[t];
             }
         }
     }
     if (result)
     {
-        std::ofstream file
-        (
-            m_name.c_str(), std::ios::out | std::ios::binary | std::ios::trunc
-        );
-        if (file.is_open())
-        {
-            char file_buffer[SEQ64_MIDI_LINE_MAX];  /* enable bufferization */
-            file.rdbuf()->pubsetbuf(file_buffer, sizeof file_buffer);
-
-            std::list<midibyte>::const_iterator it;
-            for (it = m_char_list.begin(); it != m_char_list.end(); ++it)
-            {
-                const char c = *it;
-                file.write(&c, 1);
-            }
-            m_char_list.clear();
-        }
-        else
-        {
-            m_error_message = "Error opening MIDI file for exporting";
-            result = false;
-        }
+        result = close_output(file, tempname, target);
+    }
+    else if (file.is_open())
+    {
+        file.close();
+        (void) std::remove(tempname.c_str());
+        m_char_buffer.clear();
+        if (m_error_message.empty())
+            m_error_message = "Error writing exported MIDI file";
     }
 
     /*
@@ -2183,9 +3126,9 @@ midifile::write_song (perform & p)
  *          configuration file.
  *      -#  MORE TO COME.
  *
- * \param p
- *      Provides the object that will contain and manage the entire
- *      performance.
+ * \param snapshot
+ *      Provides the copy of the song, including the notepads, mute groups,
+ *      and global settings.
  *
  * \return
  *      Always returns true.  No efficient way to check all of the writes that
@@ -2193,13 +3136,13 @@ midifile::write_song (perform & p)
  */
 
 bool
-midifile::write_proprietary_track (perform & p)
+midifile::write_proprietary_track (const song_snapshot & snapshot)
 {
     long tracklength = 0;
     int cnotesz = 2;                            /* first value is short     */
     for (int s = 0; s < c_max_sets; ++s)
     {
-        const std::string & note = p.get_screen_set_notepad(s);
+        const std::string & note = snapshot.notepad(s);
         cnotesz += 2 + note.length();           /* short + note length      */
     }
 
@@ -2213,7 +3156,7 @@ midifile::write_proprietary_track (perform & p)
     int gmutesz = 4 + groupcount * (4 + seqsinset * 4);
     if (! rc().legacy_format())
     {
-        if (! p.any_group_unmutes())
+        if (! snapshot.any_group_unmutes())
             gmutesz = 0;
     }
     if (m_new_format)                           /* calculate track size     */
@@ -2253,7 +3196,7 @@ midifile::write_proprietary_track (perform & p)
     write_short(c_max_sets);                    /* data, not a tag          */
     for (int s = 0; s < c_max_sets; ++s)        /* see "cnotesz" calc       */
     {
-        const std::string & note = p.get_screen_set_notepad(s);
+        const std::string & note = snapshot.notepad(s);
         write_short(note.length());
         for (unsigned n = 0; n < unsigned(note.length()); ++n)
             write_byte(note[n]);
@@ -2266,7 +3209,10 @@ midifile::write_proprietary_track (perform & p)
      *  We should probably sanity-check the BPM at some point.
      */
 
-    long scaled_bpm = long(p.get_beats_per_minute() * SEQ64_BPM_SCALE_FACTOR);
+    long scaled_bpm = long
+    (
+        snapshot.timing().beats_per_minute() * SEQ64_BPM_SCALE_FACTOR
+    );
     write_long(scaled_bpm);                     /* 4 bytes                  */
     if (gmutesz > 0)
     {
@@ -2279,10 +3225,9 @@ midifile::write_proprietary_track (perform & p)
         write_long(c_max_sequence);                 /* data, not a tag      */
         for (int j = 0; j < seqsinset; ++j)         /* now is optional      */
         {
-            p.select_group_mute(j);
             write_long(j);
             for (int i = 0; i < seqsinset; ++i)
-                write_long(p.get_group_mute_state(i));
+                write_long(snapshot.group_mute_state(j, i));
         }
     }
     if (m_new_format)                           /* write beginning of track */
@@ -2290,18 +3235,18 @@ midifile::write_proprietary_track (perform & p)
         if (m_global_bgsequence)
         {
             write_prop_header(c_musickey, 1);               /* control tag+1 */
-            write_byte(midibyte(usr().seqedit_key()));      /* key change    */
+            write_byte(midibyte(snapshot.musical_key()));   /* key change    */
             write_prop_header(c_musicscale, 1);             /* control tag+1 */
-            write_byte(midibyte(usr().seqedit_scale()));    /* scale change  */
+            write_byte(midibyte(snapshot.musical_scale())); /* scale change  */
             write_prop_header(c_backsequence, 4);           /* control tag+4 */
-            write_long(long(usr().seqedit_bgsequence()));   /* background    */
+            write_long(long(snapshot.background_sequence()));   /* bg seq    */
         }
         write_prop_header(c_perf_bp_mes, 4);                /* control tag+4 */
-        write_long(long(p.get_beats_per_bar()));            /* perfedit BPM  */
+        write_long(long(snapshot.timing().beats_per_measure()));    /* BPM   */
         write_prop_header(c_perf_bw, 4);                    /* control tag+4 */
-        write_long(long(p.get_beat_width()));               /* perfedit BW   */
+        write_long(long(snapshot.timing().beat_width()));   /* perfedit BW   */
         write_prop_header(c_tempo_track, 4);                /* control tag+4 */
-        write_long(long(p.get_tempo_track_number()));       /* perfedit BW   */
+        write_long(long(snapshot.tempo_track()));           /* tempo track   */
         write_track_end();
     }
     return true;
@@ -0,0 +1,868 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          midifile_stream.cpp
+ *
+ *  This module defines a class that reads a MIDI file front to back
+ *  through a small buffer, optionally thinning out controller data.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  The decoding follows midifile::parse_track(), minus the SeqSpec data.
+ *  See midifile_stream.hpp for the filter rules.
+ */
+
+#include <algorithm>                    /* std::fill()                      */
+#include <cstdio>                       /* std::snprintf()                  */
+
+#include "app_limits.h"                 /* SEQ64_MIDI_READ_CHUNK            */
+#include "calculations.hpp"             /* beat_pow2(), tempo_us_from...    */
+#include "event.hpp"                    /* seq64::event                     */
+#include "midifile_stream.hpp"          /* seq64::midifile_stream           */
+#include "perform.hpp"                  /* seq64::perform                   */
+#include "sequence.hpp"                 /* seq64::sequence                  */
+#include "settings.hpp"                 /* seq64::choose_ppqn(), usr()      */
+
+/**
+ *  The maximum length of a track name, and the chunk tags, as used in
+ *  midifile.cpp.
+ */
+
+#define SEQ64_TRACKNAME_MAX          256
+#define SEQ64_MTHD_TAG              0x4D546864      /* magic number 'MThd'  */
+#define SEQ64_MTRK_TAG              0x4D54726B      /* magic number 'MTrk'  */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Principal constructor.  Nothing is read until inspect() or import() is
+ *  called.
+ *
+ * \param name
+ *      Provides the name of the MIDI file.
+ *
+ * \param ppqn
+ *      Provides the PPQN of the imported sequences, with the same meaning
+ *      as in the midifile constructor.
+ */
+
+midifile_stream::midifile_stream (const std::string & name, int ppqn)
+ :
+    m_name              (name),
+    m_ppqn              (0),
+    m_use_default_ppqn  (ppqn == SEQ64_USE_DEFAULT_PPQN),
+    m_smf0_splitter     (ppqn),
+    m_drop_redundant    (false),
+    m_thin_interval     (0),
+    m_file              (),
+    m_buffer            (),
+    m_pos               (0),
+    m_end               (0),
+    m_offset            (0),
+    m_eof               (false),
+    m_format            (-1),
+    m_track_count       (0),
+    m_file_ppqn         (0),
+    m_tempo_us          (0.0),
+    m_beats_per_bar     (0),
+    m_beat_width        (0),
+    m_slots             (),
+    m_stats             (),
+    m_error_message     ()
+{
+    m_ppqn = choose_ppqn(ppqn);
+}
+
+/**
+ *  A rote destructor.
+ */
+
+midifile_stream::~midifile_stream ()
+{
+    // empty body
+}
+
+/**
+ *  Reads the whole file, applying the filter, but stores nothing.  Use
+ *  stats() afterward to see what the file holds, and what the filter would
+ *  drop.
+ *
+ * \return
+ *      Returns true if the file was read without error.
+ */
+
+bool
+midifile_stream::inspect ()
+{
+    return read(nullptr, 0);
+}
+
+/**
+ *  Reads the whole file, adding its tracks to a perform object, much as
+ *  midifile::parse() would.  An SMF 0 file is split by channel.
+ *
+ * \param p
+ *      The perform object that receives the sequences.
+ *
+ * \param screenset
+ *      The screen-set offset to be used when adding the sequences.  If not
+ *      0, the song tempo is left alone, and the perform object is marked
+ *      as modified.
+ *
+ * \return
+ *      Returns true if the file was read without error.  The tracks read
+ *      before an error stay in the perform object.
+ */
+
+bool
+midifile_stream::import (perform & p, int screenset)
+{
+    return read(&p, screenset);
+}
+
+/**
+ *  Does the work of inspect() and import().  Only the buffer, the filter
+ *  state, and the track being read are in memory at any time.
+ *
+ * \param p
+ *      The perform object that receives the sequences, or null to read the
+ *      file without storing anything.
+ *
+ * \param screenset
+ *      The screen-set offset used by import().
+ *
+ * \return
+ *      Returns true if the file was read without error.
+ */
+
+bool
+midifile_stream::read (perform * p, int screenset)
+{
+    m_stats.clear();
+    m_error_message.clear();
+    m_tempo_us = 0.0;
+    m_beats_per_bar = m_beat_width = 0;
+    m_pos = m_end = 0;
+    m_offset = 0;
+    m_eof = false;
+    m_file.open(m_name.c_str(), std::ios::in | std::ios::binary);
+    if (! m_file.is_open())
+        return error("Error opening MIDI file '" + m_name + "'");
+
+    m_buffer.resize(SEQ64_MIDI_READ_CHUNK);
+    m_slots.resize(SEQ64_MIDI_CHANNEL_MAX * c_slots);
+
+    m_smf0_splitter.initialize();
+    bool result = read_header();
+    bool is_smf0 = m_format == 0;
+    for (int track = 0; result && track < m_track_count; ++track)
+    {
+        midilong id = read_long();
+        midilong length = read_long();
+        if (m_eof)
+        {
+            result = error("Unexpected end of file, track missing");
+        }
+        else if (id == SEQ64_MTRK_TAG)
+        {
+            sequence * s = not_nullptr(p) ? new sequence(m_ppqn) : nullptr ;
+            result = read_track(track, length, s);
+            if (! result)
+            {
+                delete s;
+            }
+            else if (not_nullptr(s))
+            {
+                const track_stats & ts = m_stats.back();
+                sequence & seq = *s;
+                seq.set_master_midi_bus(p->master_bus_pointer());
+                if (track == 0 && screenset == 0)
+                {
+                    if (m_beats_per_bar > 0)
+                        p->set_beats_per_bar(m_beats_per_bar);
+
+                    if (m_beat_width > 0)
+                        p->set_beat_width(m_beat_width);
+
+                    if (m_tempo_us > 0)
+                    {
+                        midibpm bpm = bpm_from_tempo_us(m_tempo_us);
+                        p->set_beats_per_minute(bpm);
+                        p->us_per_quarter_note(long(m_tempo_us));
+                        seq.us_per_quarter_note(int(m_tempo_us));
+                    }
+                }
+                if (is_smf0)
+                {
+                    int seqnum = ts.ts_seqnum;
+                    (void) m_smf0_splitter.log_main_sequence(seq, seqnum);
+                }
+                else
+                {
+                    int setsize = usr().seqs_in_set();
+                    p->add_sequence(&seq, ts.ts_seqnum + screenset * setsize);
+                }
+            }
+        }
+        else if (track > 0)
+        {
+            char temp[64];
+            snprintf(temp, sizeof temp, "Skipping unknown chunk 0x%lx", id);
+            (void) error(temp);
+            skip(length);
+        }
+        else
+            result = error("Unsupported MIDI track ID on first track");
+    }
+    if (result && is_smf0 && not_nullptr(p))
+    {
+        result = m_smf0_splitter.split(*p, screenset);
+        if (result)
+            p->modify();
+        else
+            (void) error("No SMF 0 main sequence found, bad MIDI file");
+    }
+    if (result && screenset != 0 && not_nullptr(p))
+        p->modify();
+
+    m_file.close();
+    std::vector<midibyte>().swap(m_buffer);         /* free it all          */
+    std::vector<slot_state>().swap(m_slots);
+    return result;
+}
+
+/**
+ *  Reads the MThd chunk.  Formats 0 and 1 are supported.  Any extra header
+ *  bytes are skipped.
+ *
+ * \return
+ *      Returns true if the header is usable.
+ */
+
+bool
+midifile_stream::read_header ()
+{
+    midilong id = read_long();
+    midilong length = read_long();
+    if (id != SEQ64_MTHD_TAG || length < 6)
+        return error("Invalid MIDI header chunk detected");
+
+    m_format = int(read_short());
+    m_track_count = int(read_short());
+    m_file_ppqn = int(read_short());
+    skip(length - 6);
+    if (m_eof)
+        return error("MIDI header chunk is truncated");
+
+    if (m_format != 0 && m_format != 1)
+        return error("Unsupported MIDI format number");
+
+    if ((m_file_ppqn & 0x8000) != 0 || m_file_ppqn == 0)
+        return error("SMPTE or zero PPQN is not supported");
+
+    return true;
+}
+
+/**
+ *  Decodes one MTrk chunk, event by event, as midifile::parse_track()
+ *  does.  Channel events go to the filter; meta events are stored
+ *  directly.  SeqSpec events, and other metas not needed by a sequence, are
+ *  skipped.  Reading stops at the End of Track event, or at the end of the
+ *  chunk if that event is missing; either way, the file position is left at
+ *  the next chunk.
+ *
+ * \param track
+ *      The index of the track in the file.
+ *
+ * \param length
+ *      The length of the chunk.
+ *
+ * \param seq
+ *      The sequence that receives the events, or null for inspect().
+ *
+ * \return
+ *      Returns true if the track was read without error.
+ */
+
+bool
+midifile_stream::read_track (int track, midilong length, sequence * seq)
+{
+    track_stats ts;
+    ts.ts_track = track;
+    ts.ts_seqnum = 0;
+    ts.ts_channel = -1;
+    ts.ts_length = 0;
+    ts.ts_events = ts.ts_notes = ts.ts_controls = ts.ts_dropped = 0;
+    m_stats.push_back(ts);
+
+    track_stats & stats = m_stats.back();
+    slot_state empty;
+    empty.ss_value = -1;
+    empty.ss_time = 0;
+    empty.ss_held = false;
+    empty.ss_held_time = 0;
+    empty.ss_held_status = empty.ss_held_d0 = empty.ss_held_d1 = 0;
+    std::fill(m_slots.begin(), m_slots.end(), empty);
+
+    long end = offset() + long(length);
+    midipulse runningtime = 0;
+    midipulse currenttime = 0;
+    midibyte status = 0;
+    bool timesig_set = false;
+    bool done = false;
+    while (! done && offset() < end)
+    {
+        runningtime += read_varinum();
+        if (m_use_default_ppqn)
+            currenttime = runningtime * m_ppqn / m_file_ppqn;
+        else
+            currenttime = runningtime;
+
+        midibyte b = read_byte();
+        if ((b & 0x80) != 0)
+            status = b;
+        else if (status == 0 || status >= 0xF0)
+            return error("Data byte without a running status");
+        else
+            --m_pos;                            /* a refill cannot occur    */
+
+        if (m_eof)
+            return error("Unexpected end of file in track");
+
+        ++stats.ts_events;
+        midibyte eventcode = status & EVENT_CLEAR_CHAN_MASK;
+        midibyte channel = status & EVENT_GET_CHAN_MASK;
+        switch (eventcode)
+        {
+        case EVENT_NOTE_OFF:
+        case EVENT_NOTE_ON:
+        case EVENT_AFTERTOUCH:
+        {
+            midibyte d0 = read_byte();
+            midibyte d1 = read_byte();
+            midibyte st = status;
+            if (is_note_off_velocity(eventcode, d1))
+                st = EVENT_NOTE_OFF | channel;  /* velocity 0 is note off   */
+
+            if (eventcode != EVENT_AFTERTOUCH)
+                ++stats.ts_notes;
+
+            stats.ts_channel = int(channel);
+            store(seq, currenttime, st, d0, d1);
+            break;
+        }
+        case EVENT_CONTROL_CHANGE:
+        case EVENT_PITCH_WHEEL:
+        {
+            midibyte d0 = read_byte();
+            midibyte d1 = read_byte();
+            ++stats.ts_controls;
+            stats.ts_channel = int(channel);
+            filter(seq, currenttime, status, d0, d1);
+            break;
+        }
+        case EVENT_PROGRAM_CHANGE:
+            stats.ts_channel = int(channel);
+            store(seq, currenttime, status, read_byte(), 0);
+            break;
+
+        case EVENT_CHANNEL_PRESSURE:
+            ++stats.ts_controls;
+            stats.ts_channel = int(channel);
+            filter(seq, currenttime, status, read_byte(), 0);
+            break;
+
+        case 0xF0:
+
+            if (status == EVENT_MIDI_META)
+            {
+                midibyte mtype = read_byte();
+                midilong len = read_varinum();
+                if (mtype == 0x2F)                      /* End of Track     */
+                {
+                    flush(seq);
+                    stats.ts_length = currenttime;
+                    if (not_nullptr(seq))
+                    {
+                        seq->set_length(currenttime, false);
+                        seq->zero_markers();
+                    }
+                    skip(len);
+                    done = true;
+                }
+                else if (mtype == 0x03)                 /* Track name       */
+                {
+                    std::string name;
+                    for (midilong i = 0; i < len; ++i)
+                    {
+                        char c = char(read_byte());
+                        if (i < SEQ64_TRACKNAME_MAX - 1)
+                            name += c;
+                    }
+                    stats.ts_name = name;
+                    if (not_nullptr(seq))
+                        seq->set_name(name);
+                }
+                else if (mtype == 0x00 && len == 2)     /* Sequence number  */
+                {
+                    stats.ts_seqnum = int(read_short());
+                }
+                else if (mtype == 0x58 && len == 4 && ! timesig_set)
+                {
+                    midibyte bt[4];
+                    for (int i = 0; i < 4; ++i)
+                        bt[i] = read_byte();
+
+                    int bpb = int(bt[0]);
+                    int bw = beat_pow2(int(bt[1]));
+                    timesig_set = true;
+                    if (track == 0)
+                    {
+                        m_beats_per_bar = bpb;
+                        m_beat_width = bw;
+                    }
+                    if (not_nullptr(seq))
+                    {
+                        event e;
+                        e.set_timestamp(currenttime);
+                        e.set_status(status);
+                        seq->set_beats_per_bar(bpb);
+                        seq->set_beat_width(bw);
+                        seq->clocks_per_metronome(int(bt[2]));
+                        seq->set_32nds_per_quarter(int(bt[3]));
+                        if (e.append_meta_data(mtype, bt, 4))
+                            seq->append_event(e);
+                    }
+                }
+                else if (mtype == 0x51 && len == 3)     /* Set Tempo        */
+                {
+                    midibyte bt[4];
+                    bt[0] = read_byte();
+                    bt[1] = read_byte();
+                    bt[2] = read_byte();
+                    bt[3] = 0;
+
+                    double tt = tempo_us_from_bytes(bt);
+                    if (tt > 0)
+                    {
+                        if (track == 0 && m_tempo_us == 0)
+                            m_tempo_us = tt;
+
+                        if (not_nullptr(seq))
+                        {
+                            event e;
+                            e.set_timestamp(currenttime);
+                            e.set_status(status);
+                            if (e.append_meta_data(mtype, bt, 3))
+                                seq->append_event(e);
+                        }
+                    }
+                }
+                else
+                    skip(len);                          /* incl. SeqSpec    */
+            }
+            else if (status == EVENT_MIDI_SYSEX || status == 0xF7)
+            {
+                skip(read_varinum());                   /* not stored       */
+            }
+            else
+                return error("Unexpected meta code");
+            break;
+
+        default:
+
+            return error("Unsupported MIDI event");
+        }
+        if (m_eof)
+            return error("Unexpected end of file in track");
+    }
+    if (! done)
+    {
+        flush(seq);                                     /* no End of Track  */
+        stats.ts_length = currenttime;
+        if (not_nullptr(seq))
+        {
+            seq->set_length(currenttime, false);
+            seq->zero_markers();
+        }
+    }
+    if (offset() < end)
+        skip(midilong(end - offset()));                 /* trailing bytes   */
+
+    if (not_nullptr(seq))
+    {
+        char buss_override = usr().midi_buss_override();
+        if (buss_override != SEQ64_BAD_BUSS)
+            seq->set_midi_bus(buss_override);
+
+        if (m_format != 0)
+        {
+            if (seq->get_length() < seq->get_ppqn())
+            {
+                seq->set_length
+                (
+                    seq->get_ppqn() * seq->get_beats_per_bar(), false
+                );
+            }
+            seq->sort_events();
+            seq->set_length();                          /* verify_and_link  */
+        }
+    }
+    return true;
+}
+
+/**
+ *  Passes a control change, pitch wheel, or channel pressure event through
+ *  the filter.  Each channel and controller has a slot holding the last
+ *  value kept.  With thinning, a value that comes less than the interval
+ *  after the last one kept is held back, replacing any value already held;
+ *  the held value is stored once a later event shows its interval to be
+ *  over, or when the track ends.  With redundant-value dropping, a value
+ *  equal to the last one kept is never stored.
+ *
+ * \param seq
+ *      The sequence that receives the events, or null.
+ *
+ * \param t
+ *      The time of the event.
+ *
+ * \param status
+ *      The status of the event, with its channel.
+ *
+ * \param d0
+ *      The first data byte.
+ *
+ * \param d1
+ *      The second data byte, or 0 for channel pressure.
+ */
+
+void
+midifile_stream::filter
+(
+    sequence * seq, midipulse t, midibyte status, midibyte d0, midibyte d1
+)
+{
+    if (! m_drop_redundant && m_thin_interval == 0)
+    {
+        store(seq, t, status, d0, d1);
+        return;
+    }
+
+    midibyte eventcode = status & EVENT_CLEAR_CHAN_MASK;
+    int channel = int(status & EVENT_GET_CHAN_MASK);
+    int slot = 129;                                     /* channel pressure */
+    int value = int(d0);
+    if (eventcode == EVENT_CONTROL_CHANGE)
+    {
+        slot = int(d0 & 0x7F);
+        value = int(d1);
+    }
+    else if (eventcode == EVENT_PITCH_WHEEL)
+    {
+        slot = 128;
+        value = int(d0) | (int(d1) << 7);
+    }
+
+    slot_state & ss = m_slots[channel * c_slots + slot];
+    track_stats & stats = m_stats.back();
+    if (m_thin_interval > 0)
+    {
+        if (ss.ss_held && t - ss.ss_time >= m_thin_interval)
+        {
+            ss.ss_held = false;                         /* interval is over */
+            midibyte hd0 = ss.ss_held_d0;
+            midibyte hd1 = ss.ss_held_d1;
+            int held = slot == 128 ? int(hd0) | (int(hd1) << 7) :
+                (slot == 129 ? int(hd0) : int(hd1)) ;
+
+            if (m_drop_redundant && held == ss.ss_value)
+            {
+                ++stats.ts_dropped;
+            }
+            else
+            {
+                store(seq, ss.ss_held_time, ss.ss_held_status, hd0, hd1);
+                ss.ss_value = held;
+                ss.ss_time = ss.ss_held_time;
+            }
+        }
+        if (ss.ss_value >= 0 && t - ss.ss_time < m_thin_interval)
+        {
+            if (ss.ss_held)
+                ++stats.ts_dropped;                     /* replaced         */
+
+            ss.ss_held = true;
+            ss.ss_held_time = t;
+            ss.ss_held_status = status;
+            ss.ss_held_d0 = d0;
+            ss.ss_held_d1 = d1;
+            return;
+        }
+    }
+    if (m_drop_redundant && value == ss.ss_value)
+    {
+        ++stats.ts_dropped;
+    }
+    else
+    {
+        store(seq, t, status, d0, d1);
+        ss.ss_value = value;
+        ss.ss_time = t;
+    }
+}
+
+/**
+ *  Stores the values still held back by the filter, at the end of a track.
+ *
+ * \param seq
+ *      The sequence that receives the events, or null.
+ */
+
+void
+midifile_stream::flush (sequence * seq)
+{
+    track_stats & stats = m_stats.back();
+    for (int i = 0; i < int(m_slots.size()); ++i)
+    {
+        slot_state & ss = m_slots[i];
+        if (ss.ss_held)
+        {
+            int slot = i % c_slots;
+            int held = slot == 128 ?
+                int(ss.ss_held_d0) | (int(ss.ss_held_d1) << 7) :
+                (slot == 129 ? int(ss.ss_held_d0) : int(ss.ss_held_d1)) ;
+
+            ss.ss_held = false;
+            if (m_drop_redundant && held == ss.ss_value)
+                ++stats.ts_dropped;
+            else
+                store
+                (
+                    seq, ss.ss_held_time, ss.ss_held_status,
+                    ss.ss_held_d0, ss.ss_held_d1
+                );
+        }
+    }
+}
+
+/**
+ *  Appends a channel event to the sequence, unsorted, as midifile does.
+ *  The sequence is sorted once the track has been read.
+ *
+ * \param seq
+ *      The sequence that receives the event, or null to discard it.
+ *
+ * \param t
+ *      The time of the event.
+ *
+ * \param status
+ *      The status of the event, with its channel.
+ *
+ * \param d0
+ *      The first data byte.
+ *
+ * \param d1
+ *      The second data byte, ignored for one-byte messages.
+ */
+
+void
+midifile_stream::store
+(
+    sequence * seq, midipulse t, midibyte status, midibyte d0, midibyte d1
+)
+{
+    if (not_nullptr(seq))
+    {
+        event e;
+        e.set_timestamp(t);
+        e.set_status(status);
+        midibyte eventcode = status & EVENT_CLEAR_CHAN_MASK;
+        if (eventcode == EVENT_PROGRAM_CHANGE ||
+            eventcode == EVENT_CHANNEL_PRESSURE)
+        {
+            e.set_data(d0);
+        }
+        else
+            e.set_data(d0, d1);
+
+        midibyte channel = status & EVENT_GET_CHAN_MASK;
+        seq->append_event(e);
+        seq->set_midi_channel(channel);
+        if (m_format == 0)
+            m_smf0_splitter.increment(channel);
+    }
+}
+
+/**
+ *  Reads the next buffer-full of the file.  The offset of the buffer in the
+ *  file moves past the bytes already consumed.
+ *
+ * \return
+ *      Returns false, and sets m_eof, if there is nothing left to read.
+ */
+
+bool
+midifile_stream::refill ()
+{
+    m_offset += long(m_end);
+    m_pos = m_end = 0;
+    if (! m_eof)
+    {
+        m_file.read(reinterpret_cast<char *>(&m_buffer[0]), m_buffer.size());
+        m_end = std::size_t(m_file.gcount());
+        if (m_end == 0)
+            m_eof = true;
+    }
+    return ! m_eof;
+}
+
+/**
+ *  Skips over the given number of bytes, seeking past any that are not yet
+ *  in the buffer.
+ *
+ * \param count
+ *      The number of bytes to skip.
+ */
+
+void
+midifile_stream::skip (midilong count)
+{
+    std::size_t avail = m_end - m_pos;
+    if (count <= avail)
+    {
+        m_pos += count;
+    }
+    else
+    {
+        long rest = long(count - avail);
+        m_offset += long(m_end) + rest;
+        m_pos = m_end = 0;
+        m_file.clear();
+        m_file.seekg(rest, std::ios::cur);
+    }
+}
+
+/**
+ *  Reads one byte, refilling the buffer as needed.
+ *
+ * \return
+ *      Returns the byte, or 0 at the end of the file, in which case m_eof
+ *      is set.
+ */
+
+midibyte
+midifile_stream::read_byte ()
+{
+    if (m_pos == m_end && ! refill())
+        return 0;
+
+    return m_buffer[m_pos++];
+}
+
+/**
+ *  Reads 2 bytes of data, most-significant byte first.
+ *
+ * \return
+ *      Returns the short value.
+ */
+
+midishort
+midifile_stream::read_short ()
+{
+    midishort result = midishort(read_byte()) << 8;
+    result |= midishort(read_byte());
+    return result;
+}
+
+/**
+ *  Reads 4 bytes of data, most-significant byte first.
+ *
+ * \return
+ *      Returns the long value.
+ */
+
+midilong
+midifile_stream::read_long ()
+{
+    midilong result = midilong(read_byte()) << 24;
+    result |= midilong(read_byte()) << 16;
+    result |= midilong(read_byte()) << 8;
+    result |= midilong(read_byte());
+    return result;
+}
+
+/**
+ *  Reads a MIDI variable-length value, which is at most 4 bytes long.
+ *
+ * \return
+ *      Returns the value.
+ */
+
+midilong
+midifile_stream::read_varinum ()
+{
+    midilong result = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        midibyte c = read_byte();
+        result = (result << 7) | (c & 0x7F);
+        if ((c & 0x80) == 0)
+            break;
+    }
+    return result;
+}
+
+/**
+ *  Saves an error message, with the file offset, and shows it on the
+ *  console.
+ *
+ * \param msg
+ *      The message.
+ *
+ * \return
+ *      Always returns false, for use in return statements.
+ */
+
+bool
+midifile_stream::error (const std::string & msg)
+{
+    char temp[32];
+    snprintf(temp, sizeof temp, "Near offset 0x%lx: ", offset());
+    m_error_message = temp;
+    m_error_message += msg;
+    fprintf(stderr, "%s\n", m_error_message.c_str());
+    return false;
+}
+
+}           // namespace seq64
+
+/*
+ * midifile_stream.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
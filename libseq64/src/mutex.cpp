@@ -97,6 +97,20 @@ mutex::unlock () const
     pthread_mutex_unlock(&m_mutex_lock);
 }
 
+/**
+ *  Tries to lock the mutex without waiting.
+ *
+ * \return
+ *      Returns true if the mutex is now locked by the caller, who must then
+ *      unlock it.  Returns false if another thread holds it.
+ */
+
+bool
+mutex::try_lock () const
+{
+    return pthread_mutex_trylock(&m_mutex_lock) == 0;
+}
+
 /**
  *  Initialize the condition variable with the global variable.
  */
@@ -0,0 +1,212 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          note_tracker.cpp
+ *
+ *  This module defines the class that remembers which notes are sounding on
+ *  each output buss and channel.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  See the note_tracker.hpp module for the overview.
+ */
+
+#include "event.hpp"                    /* seq64::event                     */
+#include "note_tracker.hpp"             /* seq64::note_tracker              */
+
+/**
+ *  The controller numbers of the channel-mode messages sent by take().
+ */
+
+#define SEQ64_CC_ALL_SOUND_OFF          120
+#define SEQ64_CC_ALL_NOTES_OFF          123
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Default constructor.  No notes are sounding.
+ */
+
+note_tracker::note_tracker ()
+{
+    clear();
+}
+
+/**
+ *  Notes the effect of an outgoing event.  Called by mastermidibase::play()
+ *  for every event played on an active buss.  System messages are ignored.
+ *
+ * \threadsafe
+ *
+ * \param bus
+ *      The buss the event is played on.  Out-of-range values are ignored.
+ *
+ * \param ev
+ *      The event being played.  Its status has no channel nybble.
+ *
+ * \param channel
+ *      The channel the event is played on.
+ */
+
+void
+note_tracker::track (int bus, const event & ev, midibyte channel)
+{
+    midibyte status = ev.get_status();
+    if (bus < 0 || bus >= SEQ64_DEFAULT_BUSS_MAX || status >= EVENT_MIDI_SYSEX)
+        return;
+
+    channel &= EVENT_GET_CHAN_MASK;
+    unsigned chanbit = 1u << channel;
+    if ((m_channels[bus].load(std::memory_order_relaxed) & chanbit) == 0)
+        m_channels[bus].fetch_or(chanbit, std::memory_order_relaxed);
+
+    if (ev.is_note_on() || ev.is_note_off())
+    {
+        midibyte note = ev.get_note();
+        std::atomic<unsigned> & word = m_notes[bus][channel][note / 32];
+        unsigned bit = 1u << (note % 32);
+        if (ev.is_note_on() && ev.get_note_velocity() > 0)
+            word.fetch_or(bit, std::memory_order_relaxed);
+        else
+            word.fetch_and(~bit, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * \getter m_notes
+ *      Returns true if the given note is sounding on the given buss and
+ *      channel.
+ */
+
+bool
+note_tracker::sounding (int bus, midibyte channel, midibyte note) const
+{
+    if (bus < 0 || bus >= SEQ64_DEFAULT_BUSS_MAX)
+        return false;
+
+    channel &= EVENT_GET_CHAN_MASK;
+    note &= 0x7F;
+    unsigned word = m_notes[bus][channel][note / 32].load
+    (
+        std::memory_order_relaxed
+    );
+    return (word & (1u << (note % 32))) != 0;
+}
+
+/**
+ *  Builds the events needed to silence one buss, and forgets the notes they
+ *  silence.  Each bit is taken with an atomic exchange, so a note is never
+ *  turned off twice by concurrent callers, and a Note On that races with
+ *  this call is either included or left for the next call.
+ *
+ * \threadsafe
+ *
+ * \param bus
+ *      The buss to silence.
+ *
+ * \param [out] events
+ *      The Note Off events are appended to this vector, with their channels
+ *      set.  If \a controllers is true, All Notes Off and All Sound Off
+ *      follow for each channel that has been used since the last call
+ *      that sent them.
+ *
+ * \param controllers
+ *      If true, add the channel-mode messages described above.
+ *
+ * \return
+ *      Returns the number of events appended.
+ */
+
+int
+note_tracker::take (int bus, std::vector<event> & events, bool controllers)
+{
+    int result = 0;
+    if (bus < 0 || bus >= SEQ64_DEFAULT_BUSS_MAX)
+        return result;
+
+    event e;
+    unsigned channels = controllers ?
+        m_channels[bus].exchange(0, std::memory_order_relaxed) : 0 ;
+    for (int channel = 0; channel < SEQ64_MIDI_CHANNEL_MAX; ++channel)
+    {
+        for (int w = 0; w < c_words; ++w)
+        {
+            unsigned bits = m_notes[bus][channel][w].exchange
+            (
+                0, std::memory_order_relaxed
+            );
+            for (int b = 0; bits != 0; ++b, bits >>= 1)
+            {
+                if ((bits & 1) != 0)
+                {
+                    e.set_status(EVENT_NOTE_OFF, midibyte(channel));
+                    e.set_data(midibyte(w * 32 + b), 0);
+                    events.push_back(e);
+                    ++result;
+                }
+            }
+        }
+        if (controllers && (channels & (1u << channel)) != 0)
+        {
+            e.set_status(EVENT_CONTROL_CHANGE, midibyte(channel));
+            e.set_data(SEQ64_CC_ALL_NOTES_OFF, 0);
+            events.push_back(e);
+            e.set_data(SEQ64_CC_ALL_SOUND_OFF, 0);
+            events.push_back(e);
+            result += 2;
+        }
+    }
+    return result;
+}
+
+/**
+ *  Forgets all of the sounding notes and used channels, without sending
+ *  anything.
+ */
+
+void
+note_tracker::clear ()
+{
+    for (int bus = 0; bus < SEQ64_DEFAULT_BUSS_MAX; ++bus)
+    {
+        m_channels[bus].store(0, std::memory_order_relaxed);
+        for (int channel = 0; channel < SEQ64_MIDI_CHANNEL_MAX; ++channel)
+        {
+            for (int w = 0; w < c_words; ++w)
+                m_notes[bus][channel][w].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+}           // namespace seq64
+
+/*
+ * note_tracker.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
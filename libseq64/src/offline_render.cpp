@@ -0,0 +1,690 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          offline_render.cpp
+ *
+ *  This module defines the class that plays a performance offline and
+ *  records what it sends.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  The render uses perform::play(), so the patterns, triggers, queuing,
+ *  tempo events, and transposition behave just as they do in the output
+ *  thread.  What the output thread adds, and this class leaves out, is the
+ *  waiting:  each frame here is one step of ticks, and its length at the
+ *  current tempo is added to the virtual time instead of being slept.
+ */
+
+#include <algorithm>                    /* std::stable_sort()               */
+#include <fstream>                      /* std::ifstream, std::ofstream     */
+#include <sstream>                      /* std::istringstream               */
+
+#include "event.hpp"                    /* seq64::event                     */
+#include "mastermidibus.hpp"            /* seq64::mastermidibus             */
+#include "offline_render.hpp"           /* seq64::offline_render            */
+#include "perform.hpp"                  /* seq64::perform                   */
+#include "sequence.hpp"                 /* seq64::sequence                  */
+#include "user_midi_bus.hpp"            /* seq64::c_max_busses              */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  The first four bytes of a binary log written by write_log().
+ */
+
+static const char * const s_log_magic = "S64R";
+
+/**
+ *  The version of the binary log format.
+ */
+
+static const int s_log_version = 1;
+
+/**
+ *  Orders the scripted actions by bar.  Used with a stable sort, so that the
+ *  actions of one bar are applied in the order given.
+ */
+
+static bool
+earlier_bar
+(
+    const offline_render::action & a, const offline_render::action & b
+)
+{
+    return a.ra_bar < b.ra_bar;
+}
+
+/**
+ *  Appends a number as a MIDI variable-length quantity.
+ */
+
+static void
+put_varinum (std::vector<midibyte> & v, unsigned long value)
+{
+    unsigned long buffer = value & 0x7F;
+    while ((value >>= 7) != 0)
+    {
+        buffer <<= 8;
+        buffer |= (value & 0x7F) | 0x80;
+    }
+    for (;;)
+    {
+        v.push_back(midibyte(buffer & 0xFF));
+        if (buffer & 0x80)
+            buffer >>= 8;
+        else
+            break;
+    }
+}
+
+/**
+ *  Appends the low bytes of a number, most significant first, as in a MIDI
+ *  file.
+ */
+
+static void
+put_big_endian (std::vector<midibyte> & v, unsigned long value, int bytes)
+{
+    for (int b = bytes - 1; b >= 0; --b)
+        v.push_back(midibyte((value >> (8 * b)) & 0xFF));
+}
+
+/**
+ *  Appends the low bytes of a number, least significant first, as in the
+ *  binary log.
+ */
+
+static void
+put_little_endian
+(
+    std::vector<midibyte> & v, unsigned long long value, int bytes
+)
+{
+    for (int b = 0; b < bytes; ++b)
+        v.push_back(midibyte((value >> (8 * b)) & 0xFF));
+}
+
+/**
+ *  Writes a track chunk holding the given events.
+ */
+
+static void
+write_track (std::ofstream & file, const std::vector<midibyte> & data)
+{
+    std::vector<midibyte> header;
+    header.push_back('M');
+    header.push_back('T');
+    header.push_back('r');
+    header.push_back('k');
+    put_big_endian(header, (unsigned long)(data.size()), 4);
+    file.write(reinterpret_cast<const char *>(&header[0]), header.size());
+    if (! data.empty())
+        file.write(reinterpret_cast<const char *>(&data[0]), data.size());
+}
+
+/**
+ *  Principal constructor.
+ *
+ * \param p
+ *      The performance to render.  It must have been launched, and must
+ *      outlive this object.
+ *
+ * \param songmode
+ *      True to play the song, and false to play live.
+ */
+
+offline_render::offline_render (perform & p, bool songmode)
+ :
+    m_perform       (p),
+    m_song_mode     (songmode),
+    m_step          (1),
+    m_actions       (),
+    m_messages      (),
+    m_tempos        (),
+    m_clock         (true),
+    m_mutex         (),
+    m_end_tick      (0),
+    m_error         ()
+{
+    // Empty body
+}
+
+/**
+ *  Records an error.
+ *
+ * \return
+ *      Always returns false, for the caller to return.
+ */
+
+bool
+offline_render::fail (const std::string & msg)
+{
+    m_error = msg;
+    return false;
+}
+
+/**
+ *  Parses one scripted action and adds it to the list.
+ *
+ * \param spec
+ *      The action, as "bar action [value]", for example "9 queue 3".  An
+ *      empty line, or one starting with "#", is ignored.
+ *
+ * \return
+ *      Returns false, with an error message, if the action cannot be
+ *      parsed.
+ */
+
+bool
+offline_render::add_action (const std::string & spec)
+{
+    std::istringstream is(spec);
+    std::string verb;
+    int bar = 0;
+    if (! (is >> verb) || verb[0] == '#')
+        return true;
+
+    std::istringstream bs(verb);
+    if (! (bs >> bar) || bar < 1 || ! (is >> verb))
+        return fail("bad action '" + spec + "': need a bar and an action");
+
+    struct verbinfo
+    {
+        const char * vi_name;
+        action_t vi_type;
+        bool vi_has_value;
+    };
+    static const verbinfo s_verbs[] =
+    {
+        { "on",         ACTION_ON,          true    },
+        { "off",        ACTION_OFF,         true    },
+        { "toggle",     ACTION_TOGGLE,      true    },
+        { "queue",      ACTION_QUEUE,       true    },
+        { "oneshot",    ACTION_ONESHOT,     true    },
+        { "group",      ACTION_GROUP,       true    },
+        { "mute-all",   ACTION_MUTE_ALL,    false   },
+        { "unmute-all", ACTION_UNMUTE_ALL,  false   },
+        { "transpose",  ACTION_TRANSPOSE,   true    },
+        { "bpm",        ACTION_BPM,         true    },
+        { "stop",       ACTION_STOP,        false   }
+    };
+    for (const verbinfo & v : s_verbs)
+    {
+        if (verb == v.vi_name)
+        {
+            action a;
+            a.ra_bar = bar;
+            a.ra_type = v.vi_type;
+            a.ra_value = 0.0;
+            if (v.vi_has_value && ! (is >> a.ra_value))
+                return fail("bad action '" + spec + "': need a value");
+
+            m_actions.push_back(a);
+            return true;
+        }
+    }
+    return fail("bad action '" + spec + "': unknown action '" + verb + "'");
+}
+
+/**
+ *  Adds the actions of a script file, one per line.
+ *
+ * \param filename
+ *      The script to read.
+ *
+ * \return
+ *      Returns false if the file cannot be read or a line cannot be
+ *      parsed.
+ */
+
+bool
+offline_render::load_script (const std::string & filename)
+{
+    std::ifstream file(filename.c_str());
+    if (! file.is_open())
+        return fail("cannot open script '" + filename + "'");
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (! add_action(line))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * \return
+ *      Returns the length of a bar, in ticks, from the PPQN and time
+ *      signature of the performance.
+ */
+
+midipulse
+offline_render::bar_ticks () const
+{
+    return midipulse(m_perform.ppqn()) * 4 * m_perform.get_beats_per_bar() /
+        m_perform.get_beat_width();
+}
+
+/**
+ *  Applies a scripted action to the performance.
+ *
+ * \return
+ *      Returns false if the action is to stop the render.
+ */
+
+bool
+offline_render::apply (const action & a)
+{
+    int n = int(a.ra_value);
+    sequence * s = m_perform.get_sequence(n);
+    switch (a.ra_type)
+    {
+    case ACTION_ON:
+        m_perform.sequence_playing_on(n);
+        break;
+
+    case ACTION_OFF:
+        m_perform.sequence_playing_off(n);
+        break;
+
+    case ACTION_TOGGLE:
+        m_perform.sequence_playing_toggle(n);
+        break;
+
+    case ACTION_QUEUE:
+        if (not_nullptr(s))
+            s->toggle_queued();
+        break;
+
+    case ACTION_ONESHOT:
+#ifdef SEQ64_SONG_RECORDING
+        if (not_nullptr(s))
+            s->toggle_one_shot();
+#endif
+        break;
+
+    case ACTION_GROUP:
+        m_perform.select_and_mute_group(n);
+        break;
+
+    case ACTION_MUTE_ALL:
+        m_perform.mute_all_tracks(true);
+        break;
+
+    case ACTION_UNMUTE_ALL:
+        m_perform.mute_all_tracks(false);
+        break;
+
+    case ACTION_TRANSPOSE:
+#ifdef SEQ64_STAZED_TRANSPOSE
+        m_perform.set_transpose(n);
+#endif
+        break;
+
+    case ACTION_BPM:
+        m_perform.set_beats_per_minute(midibpm(a.ra_value));
+        break;
+
+    case ACTION_STOP:
+        return false;
+    }
+    return true;
+}
+
+/**
+ *  Plays the performance from tick 0, as fast as possible, recording every
+ *  event sent to the master buss.  Meanwhile, the ports get nothing.
+ *
+ *  Before each step, the actions due by then are applied.  After the last
+ *  one, the sequences are stopped, so that the notes still sounding get
+ *  their Note Offs, stamped with the end of the render.  The patterns are
+ *  left as the actions and the song made them, as after a live playback.
+ *
+ * \param bars
+ *      The number of bars to play.  If 0, the song mode plays up to the end
+ *      of the last trigger, and the live mode plays until a "stop" action.
+ *
+ * \return
+ *      Returns false, with an error message, if the render cannot start.
+ */
+
+bool
+offline_render::run (int bars)
+{
+    mastermidibus * mmb = m_perform.master_bus_pointer();
+    if (is_nullptr(mmb))
+        return fail("the performance has not been launched");
+
+    if (m_perform.is_running())
+        return fail("the performance is already playing");
+
+    midipulse barticks = bar_ticks();
+    midipulse endtick = 0;
+    if (bars > 0)
+        endtick = bars * barticks;
+    else if (m_song_mode)
+    {
+        midipulse last = m_perform.get_max_trigger();   /* inclusive end    */
+        if (last > 0)
+            endtick = last + 1;
+    }
+    else
+    {
+        for (const action & a : m_actions)
+        {
+            if (a.ra_type == ACTION_STOP)
+            {
+                midipulse t = (a.ra_bar - 1) * barticks;
+                if (endtick == 0 || t < endtick)
+                    endtick = t;
+            }
+        }
+    }
+    if (endtick <= 0)
+        return fail("nothing to render; give the number of bars");
+
+    std::vector<action> actions(m_actions);
+    std::stable_sort(actions.begin(), actions.end(), earlier_bar);
+    m_messages.clear();
+    m_tempos.clear();
+    m_error.clear();
+    m_clock.set(0);
+    m_clock.tick(0);
+
+    double ppqn = double(m_perform.ppqn());
+    midibpm bpm = m_perform.get_beats_per_minute();
+    tempo_change tc;
+    tc.rt_tick = 0;
+    tc.rt_bpm = bpm;
+    m_tempos.push_back(tc);
+
+    m_perform.playback_mode(m_song_mode);
+    if (m_song_mode)
+        m_perform.off_sequences();
+
+    for (int s = 0; s < m_perform.sequence_max(); ++s)
+    {
+        sequence * seq = m_perform.get_sequence(s);
+        if (not_nullptr(seq))
+            seq->events().realize();        /* play() skips deferred ones   */
+    }
+    m_perform.set_orig_ticks(0);
+    mmb->render_to(this);
+
+    double us = 0.0;
+    midipulse tick = 0;
+    std::vector<action>::size_type next = 0;
+    bool playing = true;
+    while (playing && tick < endtick)
+    {
+        while
+        (
+            next < actions.size() &&
+            (actions[next].ra_bar - 1) * barticks <= tick
+        )
+        {
+            if (! apply(actions[next++]))
+                playing = false;
+        }
+        if (! playing)
+            break;
+
+        m_clock.set((long long)(us + 0.5));
+        m_clock.tick(tick);
+        m_perform.play(tick);
+
+        midibpm now = m_perform.get_beats_per_minute();
+        if (now != bpm && now > 0.0)
+        {
+            bpm = now;
+            tc.rt_tick = tick;
+            tc.rt_bpm = bpm;
+            m_tempos.push_back(tc);
+        }
+        us += m_step * 60000000.0 / (bpm * ppqn);
+        tick += m_step;
+    }
+    if (tick > endtick)
+        tick = endtick;
+
+    m_clock.set((long long)(us + 0.5));
+    m_clock.tick(tick);
+    m_perform.reset_sequences();
+    mmb->render_to(nullptr);
+    m_end_tick = tick;
+    return true;
+}
+
+/**
+ *  Records one event played during the render.  Called by
+ *  mastermidibase::play(), on the rendering thread or on a thread that
+ *  previews a note.
+ *
+ * \param bus
+ *      The output buss.
+ *
+ * \param ev
+ *      The event, whose status lacks the channel.
+ *
+ * \param channel
+ *      The channel it is played on.
+ */
+
+void
+offline_render::capture (bussbyte bus, const event & ev, midibyte channel)
+{
+    midibyte d0, d1;
+    ev.get_data(d0, d1);
+
+    message msg;
+    msg.rm_time_us = m_clock.now_us();
+    msg.rm_tick = m_clock.tick();
+    msg.rm_bus = bus;
+    msg.rm_status = ev.get_status() + (channel & 0x0F);
+    msg.rm_d0 = d0;
+    msg.rm_d1 = d1;
+
+    automutex locker(m_mutex);
+    m_messages.push_back(msg);
+}
+
+/**
+ *  Writes the recorded events as a type 1 MIDI file.  The first track holds
+ *  the time signature and the tempo changes, and each buss that was played
+ *  gets a track of its own, marked with a MIDI Port meta event.  The events
+ *  are placed at the ticks they were played.
+ *
+ * \param filename
+ *      The file to write.
+ *
+ * \return
+ *      Returns false if the file cannot be written.
+ */
+
+bool
+offline_render::write_midi (const std::string & filename) const
+{
+    std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary);
+    if (! file.is_open())
+        return false;
+
+    automutex locker(m_mutex);
+    std::vector<bool> used(c_max_busses, false);
+    for (const message & m : m_messages)
+    {
+        if (m.rm_bus < used.size())
+            used[m.rm_bus] = true;
+    }
+
+    int tracks = 1 + int(std::count(used.begin(), used.end(), true));
+    std::vector<midibyte> data;
+    data.push_back('M');
+    data.push_back('T');
+    data.push_back('h');
+    data.push_back('d');
+    put_big_endian(data, 6, 4);
+    put_big_endian(data, 1, 2);                         /* SMF type 1       */
+    put_big_endian(data, (unsigned long)(tracks), 2);
+    put_big_endian(data, (unsigned long)(m_perform.ppqn()), 2);
+    file.write(reinterpret_cast<const char *>(&data[0]), data.size());
+
+    int bw = m_perform.get_beat_width();
+    int bwlog = 0;
+    while ((1 << bwlog) < bw)
+        ++bwlog;
+
+    data.clear();
+    put_varinum(data, 0);
+    data.push_back(0xFF);
+    data.push_back(0x58);                               /* Time Signature   */
+    data.push_back(4);
+    data.push_back(midibyte(m_perform.get_beats_per_bar()));
+    data.push_back(midibyte(bwlog));
+    data.push_back(24);
+    data.push_back(8);
+
+    midipulse last = 0;
+    for (const tempo_change & tc : m_tempos)
+    {
+        put_varinum(data, (unsigned long)(tc.rt_tick - last));
+        data.push_back(0xFF);
+        data.push_back(0x51);                           /* Set Tempo        */
+        data.push_back(3);
+        put_big_endian(data, (unsigned long)(60000000.0 / tc.rt_bpm + 0.5), 3);
+        last = tc.rt_tick;
+    }
+    put_varinum(data, (unsigned long)(m_end_tick - last));
+    data.push_back(0xFF);
+    data.push_back(0x2F);                               /* End of Track     */
+    data.push_back(0);
+    write_track(file, data);
+
+    for (int bus = 0; bus < int(used.size()); ++bus)
+    {
+        if (! used[bus])
+            continue;
+
+        data.clear();
+        put_varinum(data, 0);
+        data.push_back(0xFF);
+        data.push_back(0x21);                           /* MIDI Port        */
+        data.push_back(1);
+        data.push_back(midibyte(bus));
+        last = 0;
+        for (const message & m : m_messages)
+        {
+            midibyte status = m.rm_status & EVENT_CLEAR_CHAN_MASK;
+            if (m.rm_bus != bus || status >= EVENT_MIDI_SYSEX)
+                continue;
+
+            put_varinum(data, (unsigned long)(m.rm_tick - last));
+            data.push_back(m.rm_status);
+            data.push_back(m.rm_d0);
+            if (! event::is_one_byte_msg(status))
+                data.push_back(m.rm_d1);
+
+            last = m.rm_tick;
+        }
+        put_varinum(data, (unsigned long)(m_end_tick - last));
+        data.push_back(0xFF);
+        data.push_back(0x2F);
+        data.push_back(0);
+        write_track(file, data);
+    }
+    return file.good();
+}
+
+/**
+ *  Writes the recorded events as a binary log, which keeps the virtual
+ *  times as well as the ticks.  All numbers are little-endian.  The log
+ *  starts with a 16-byte header:
+ *
+\verbatim
+        4 bytes     "S64R"
+        2 bytes     version (1)
+        2 bytes     PPQN
+        4 bytes     number of records
+        4 bytes     reserved (0)
+\endverbatim
+ *
+ *  and each event is a 16-byte record, in the order played:
+ *
+\verbatim
+        8 bytes     time, in microseconds
+        4 bytes     tick
+        1 byte      buss
+        1 byte      status, with channel
+        1 byte      first data byte
+        1 byte      second data byte (0 if unused)
+\endverbatim
+ *
+ * \param filename
+ *      The file to write.
+ *
+ * \return
+ *      Returns false if the file cannot be written.
+ */
+
+bool
+offline_render::write_log (const std::string & filename) const
+{
+    std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary);
+    if (! file.is_open())
+        return false;
+
+    automutex locker(m_mutex);
+    std::vector<midibyte> data;
+    data.reserve(16 * (m_messages.size() + 1));
+    for (const char * c = s_log_magic; *c != 0; ++c)
+        data.push_back(midibyte(*c));
+
+    put_little_endian(data, s_log_version, 2);
+    put_little_endian(data, (unsigned long long)(m_perform.ppqn()), 2);
+    put_little_endian(data, m_messages.size(), 4);
+    put_little_endian(data, 0, 4);
+    for (const message & m : m_messages)
+    {
+        put_little_endian(data, (unsigned long long)(m.rm_time_us), 8);
+        put_little_endian(data, (unsigned long long)(m.rm_tick), 4);
+        data.push_back(m.rm_bus);
+        data.push_back(m.rm_status);
+        data.push_back(m.rm_d0);
+        data.push_back(m.rm_d1);
+    }
+    file.write(reinterpret_cast<const char *>(&data[0]), data.size());
+    return file.good();
+}
+
+}           // namespace seq64
+
+/*
+ * offline_render.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -556,6 +556,18 @@ optionsfile::parse (perform & p)
             sscanf(m_line, "%u", &ktx.kpt_oneshot_queue);
             next_data_line(file);
 #endif
+
+            /*
+             * Older files end the section here, so that m_line holds the
+             * next section's tag, the scan fails, and keyval_normalize()
+             * supplies the defaults.
+             */
+
+            if (sscanf(m_line, "%u", &ktx.kpt_playlist_prev) == 1)
+            {
+                next_data_line(file);
+                sscanf(m_line, "%u", &ktx.kpt_playlist_next);
+            }
         }
         else
         {
@@ -741,6 +753,51 @@ optionsfile::parse (perform & p)
         line_after(file, "[auto-option-save]");
         sscanf(m_line, "%ld", &method);
         rc().auto_option_save(method != 0);
+
+        method = 0;         /* no song backups if not present               */
+        if (line_after(file, "[auto-song-save]"))
+        {
+            sscanf(m_line, "%ld", &method);
+            rc().auto_song_save(int(method));
+        }
+
+        method = 0;         /* no session cache if not present              */
+        if (line_after(file, "[session-cache]"))
+        {
+            sscanf(m_line, "%ld", &method);
+            rc().session_cache(method != 0);
+        }
+
+        method = 0;         /* decode every track at load if not present    */
+        if (line_after(file, "[lazy-loading]"))
+        {
+            sscanf(m_line, "%ld", &method);
+            rc().lazy_loading(method != 0);
+        }
+
+        if (line_after(file, "[playlist]"))     /* no playlist if missing   */
+        {
+            method = 2;
+            sscanf(m_line, "%ld", &method);
+            rc().playlist_preload(int(method));
+            if (next_data_line(file))
+            {
+                method = 0;
+                sscanf(m_line, "%ld", &method);
+                rc().playlist_bars(int(method));
+            }
+            if (next_data_line(file))           /* the quoted file-name     */
+            {
+                std::string line = m_line;
+                std::string::size_type first = line.find_first_of('"');
+                std::string::size_type last = line.find_last_of('"');
+                if (first != std::string::npos && last > first)
+                {
+                    ++first;
+                    rc().playlist_filename(line.substr(first, last - first));
+                }
+            }
+        }
     }
     file.close();           /* done parsing the "rc" configuration file */
     return true;
@@ -1028,7 +1085,10 @@ optionsfile::write (const perform & p)
             file << "# screen set by number:\n";
             break;
 
-        case c_midi_control_17:             // 81
+        case c_midi_control_playlist:       // 81
+            file << "# playlist song (by number, next, previous):\n";
+            break;
+
         case c_midi_control_18:             // 82
         case c_midi_control_19:             // 83
             file << "# reserved for expansion:\n";
@@ -1511,6 +1571,12 @@ optionsfile::write (const perform & p)
             << ucperf.key_name(ktx.kpt_oneshot_queue)
             << " toggles the one-shot queue function\n"
 #endif
+            << ktx.kpt_playlist_prev << "    # "
+            << ucperf.key_name(ktx.kpt_playlist_prev)
+            << " loads the previous song of the playlist\n"
+            << ktx.kpt_playlist_next << "    # "
+            << ucperf.key_name(ktx.kpt_playlist_next)
+            << " loads the next song of the playlist\n"
             ;
     }
 
@@ -1575,6 +1641,63 @@ optionsfile::write (const perform & p)
         << "     # auto-save-options-on-exit support flag\n"
         ;
 
+    file << "\n"
+        "[auto-song-save]\n\n"
+        "# Set the following value to the number of seconds between backups of\n"
+        "# a modified song, or 0 to disable them.  The backup is written in the\n"
+        "# background, next to the song file, with '.autosave.midi' appended to\n"
+        "# its name; an unnamed song is backed up to 'autosave.midi' in the\n"
+        "# configuration directory.  The song file itself is not touched.\n"
+        "\n"
+        << rc().auto_song_save()
+        << "     # auto-save-song interval, in seconds\n"
+        ;
+
+    file << "\n"
+        "[session-cache]\n\n"
+        "# Set the following value to 1 to keep a binary copy of the tracks of\n"
+        "# each MIDI file loaded, in the 'session-cache' subdirectory of the\n"
+        "# configuration directory.  The next load of an unchanged file then\n"
+        "# skips decoding its tracks, which helps with very large sets.  The\n"
+        "# MIDI file is always the master copy; a cache that does not match it\n"
+        "# is ignored and rewritten.  Set it to 0 to disable the cache.\n"
+        "\n"
+        << (rc().session_cache() ? "1" : "0")
+        << "     # session-cache support flag\n"
+        ;
+
+    file << "\n"
+        "[lazy-loading]\n\n"
+        "# Set the following value to 1 to load only the names, lengths,\n"
+        "# busses, channels, and triggers of the patterns of a MIDI file, and\n"
+        "# decode the events of each pattern when it is first played, edited,\n"
+        "# or shown.  The patterns of the current and next screen-sets are\n"
+        "# decoded in the background.  This makes very large sets load\n"
+        "# quickly, and use memory only for the patterns in use.  It applies\n"
+        "# to SMF 1 files, and overrides the session cache.  Set it to 0 to\n"
+        "# decode every pattern when the file is loaded.\n"
+        "\n"
+        << (rc().lazy_loading() ? "1" : "0")
+        << "     # lazy-loading support flag\n"
+        ;
+
+    file << "\n"
+        "[playlist]\n\n"
+        "# A playlist is a text file that lists MIDI files to play live,\n"
+        "# one per line; blank lines and lines starting with '#' are\n"
+        "# ignored, and relative names are relative to the playlist file.\n"
+        "# The next few songs are parsed in the background, so that\n"
+        "# changing songs (with the playlist keys or MIDI control) takes no\n"
+        "# time.  The first value is the number of songs parsed ahead.  The\n"
+        "# second is 0 to change songs only while stopped, or N to change at\n"
+        "# the next multiple of N bars during playback.  The last is the\n"
+        "# playlist file, in quotes; \"\" means there is no playlist.\n"
+        "\n"
+        << rc().playlist_preload() << "     # number of songs parsed ahead\n"
+        << rc().playlist_bars() << "     # bar interval for changing songs\n"
+        << "\"" << rc().playlist_filename() << "\"     # playlist file\n"
+        ;
+
 
     file << "\n"
         "[last-used-dir]\n\n"
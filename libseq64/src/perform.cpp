@@ -62,14 +62,9 @@
  *      -   m_seqs_active[c_max_sequence] (seq24).
  *          Indicates if a pattern has any data in it, i.e. it is not empty,
  *          whether it is muted or not.
- *      -   m_was_active_main[c_max_sequence] (seq24).
- *          Used in perform::is_dirty_main().
- *      -   m_was_active_edit[c_max_sequence] (seq24).
- *          Used in perform::is_dirty_edit().
- *      -   m_was_active_perf[c_max_sequence] (seq24).
- *          Used in perform::is_dirty_perf().
- *      -   m_was_active_names[c_max_sequence] (seq24).
- *          Used in perform::is_dirty_names().
+ *      -   m_dirty_main, m_dirty_edit, m_dirty_perf, m_dirty_names.
+ *          Replace the seq24 m_was_active_xxx[] arrays.  Bitmaps of the
+ *          patterns to redraw, used in perform::is_dirty_main() etc.
  *      -   m_sequence_state[c_max_sequence] (seq24).
  *          Used in unsetting the snapshot status (c_status_snapshot).
  *          perform::save_playing_state() uses this to preserve the playing
@@ -128,6 +123,7 @@
 #include <string.h>                     /* memset()                         */
 
 #include "calculations.hpp"
+#include "clock_generator.hpp"          /* seq64::clock_generator           */
 #include "cmdlineopts.hpp"              /* seq64::parse_mute_groups()       */
 #include "event.hpp"
 #include "keystroke.hpp"
@@ -308,10 +304,10 @@ perform::perform (gui_assistant & mygui, int ppqn)
     m_midi_mute_group_present   (false),
     m_seqs                      (),         // pointer array [c_max_sequence]
     m_seqs_active               (),         // boolean array [c_max_sequence]
-    m_was_active_main           (),         // boolean array [c_max_sequence]
-    m_was_active_edit           (),         // boolean array [c_max_sequence]
-    m_was_active_perf           (),         // boolean array [c_max_sequence]
-    m_was_active_names          (),         // boolean array [c_max_sequence]
+    m_dirty_main                (),         // bitmap [c_max_sequence]
+    m_dirty_edit                (),         // bitmap [c_max_sequence]
+    m_dirty_perf                (),         // bitmap [c_max_sequence]
+    m_dirty_names               (),         // bitmap [c_max_sequence]
     m_sequence_state            (),         // boolean array [c_max_sequence]
     m_screenset_state           (m_seqs_in_set, false),    // boolean vector
     m_queued_replace_slot       (SEQ64_NO_QUEUED_SOLO),
@@ -342,6 +338,7 @@ perform::perform (gui_assistant & mygui, int ppqn)
     m_32nds_per_quarter         (8),
     m_us_per_quarter_note       (tempo_us_from_bpm(SEQ64_DEFAULT_BPM)),
     m_master_bus                (nullptr),
+    m_clock_generator           (nullptr),
     m_filter_by_channel         (false),                /* "rc" option      */
     m_master_clocks             (),                     /* vector<clock_e>  */
     m_master_inputs             (),                     /* vector<bool>     */
@@ -350,6 +347,7 @@ perform::perform (gui_assistant & mygui, int ppqn)
     m_right_tick                (m_one_measure * 4),    /* m_ppqn * 16      */
     m_starting_tick             (0),
     m_tick                      (0),
+    m_transport                 (),
     m_jack_tick                 (0),
     m_usemidiclock              (false),
     m_midiclockrunning          (false),
@@ -376,10 +374,18 @@ perform::perform (gui_assistant & mygui, int ppqn)
     m_edit_sequence             (-1),
 #endif
     m_is_modified               (false),
+    m_song_saver                (),
+    m_event_prefetcher          (),
+    m_playlist                  (*this),
 #ifdef SEQ64_SONG_BOX_SELECT
     m_selected_seqs             (),                     // Selection, std::set
 #endif
     m_condition_var             (),
+    m_output_idle               (true),
+    m_song_queued               (nullptr),
+    m_song_swap_tick            (0),
+    m_song_swap                 (SONG_SWAP_NONE),
+    m_retired_seqs              (),
 #ifdef SEQ64_JACK_SUPPORT
     m_jack_asst
     (
@@ -402,9 +408,7 @@ perform::perform (gui_assistant & mygui, int ppqn)
     {
         m_seqs[i] = nullptr;
         m_seqs_active[i] =                      /* seq24 0.9.3 addition     */
-            m_sequence_state[i] =               /* ca 2016-11-27            */
-            m_was_active_main[i] = m_was_active_edit[i] =
-            m_was_active_perf[i] = m_was_active_names[i] = false;
+            m_sequence_state[i] = false;        /* ca 2016-11-27            */
     }
     for (int i = 0; i < c_max_sequence; ++i)    /* not c_gmute_tracks now   */
     {
@@ -428,10 +432,10 @@ perform::perform (gui_assistant & mygui, int ppqn)
 }
 
 /**
- *  The destructor sets some running flags to false, signals this condition,
- *  then joins the input and output threads if the were launched. Finally, any
- *  active or inactive (but allocated) patterns/sequences are deleted, and
- *  their pointers nullified.
+ *  The destructor lets any background save finish, sets some running flags
+ *  to false, signals this condition, then joins the input and output
+ *  threads if they were launched.  Finally, any active or inactive (but
+ *  allocated) patterns/sequences are deleted, and their pointers nullified.
  *
  *  Note that we could use m_sequence_high to replace m_sequence_max in the
  *  for-loop, but who cares, we are exiting!
@@ -439,14 +443,23 @@ perform::perform (gui_assistant & mygui, int ppqn)
 
 perform::~perform ()
 {
+    (void) m_song_saver.wait();                     /* finish any save      */
+    m_event_prefetcher.stop();                      /* before the deletes   */
+    m_playlist.stop();                              /* no more parsing      */
     m_inputing = m_outputing = m_is_running = false;
     m_condition_var.signal();                       /* signal end of play   */
+    if (not_nullptr(m_master_bus))
+        m_master_bus->wake_input();                 /* end the input wait   */
+
     if (m_out_thread_launched)
         pthread_join(m_out_thread, NULL);
 
     if (m_in_thread_launched)
         pthread_join(m_in_thread, NULL);
 
+    if (not_nullptr(m_clock_generator))
+        delete m_clock_generator;                   /* joins clock thread   */
+
     for (int seq = 0; seq < m_sequence_high; ++seq) /* m_sequence_max       */
     {
         if (not_nullptr(m_seqs[seq]))
@@ -455,6 +468,8 @@ perform::~perform ()
             m_seqs[seq] = nullptr;                  /* not really necessary */
         }
     }
+    for (size_t i = 0; i < m_retired_seqs.size(); ++i)
+        delete m_retired_seqs[i];               /* swapped out, not deleted */
 
     if (not_nullptr(m_master_bus))
         delete(m_master_bus);
@@ -530,6 +545,15 @@ perform::launch (int ppqn)
 
         if (activate())
         {
+            if (rc().clock_thread())
+            {
+                m_clock_generator = new clock_generator(*m_master_bus);
+                if (! m_clock_generator->launch())
+                {
+                    delete m_clock_generator;       /* output_func() clocks */
+                    m_clock_generator = nullptr;
+                }
+            }
             launch_input_thread();
             launch_output_thread();
         }
@@ -747,15 +771,7 @@ perform::selected_trigger
 bool
 perform::clear_all ()
 {
-    bool result = true;
-    for (int s = 0; s < m_sequence_high; ++s)           /* m_sequence_max   */
-    {
-        if (is_active(s) && m_seqs[s]->get_editing())   /* stazed check     */
-        {
-            result = false;
-            break;
-        }
-    }
+    bool result = ! any_sequence_in_edit();             /* stazed check     */
     if (result)
     {
         reset_sequences();
@@ -1664,6 +1680,7 @@ perform::install_sequence (sequence * seq, int seqnum)
     if (not_nullptr(m_seqs[seqnum]))
     {
         errprintf("m_seqs[%d] not null, deleting old sequence\n", seqnum);
+        m_event_prefetcher.forget(m_seqs[seqnum]);
         delete m_seqs[seqnum];
         m_seqs[seqnum] = nullptr;
         if (m_sequence_count > 0)
@@ -1681,6 +1698,7 @@ perform::install_sequence (sequence * seq, int seqnum)
     {
         set_active(seqnum, true);
         seq->set_parent(this);
+        mark_dirty(seqnum, true);               /* draw it in every view    */
         ++m_sequence_count;
         if (seqnum >= m_sequence_high)
             m_sequence_high = seqnum + 1;
@@ -1821,6 +1839,7 @@ perform::delete_sequence (int seq)
         if (! m_seqs[seq]->get_editing())           /* clarify this!        */
         {
             m_seqs[seq]->set_playing(false);
+            m_event_prefetcher.forget(m_seqs[seq]);
             delete m_seqs[seq];
             m_seqs[seq] = nullptr;
             modify();                               /* it is dirty, man     */
@@ -1860,8 +1879,8 @@ perform::set_active (int seq, bool active)
 }
 
 /**
- *  Sets was-active flags:  main, edit, perf, and names.
- *  Why do we need this routine?
+ *  Marks a pattern that has just been made inactive, so that each view
+ *  clears its slot.  Replaces the seq24 was-active flags.
  *
  * \param seq
  *      The pattern number.  It is checked for validity.
@@ -1869,43 +1888,82 @@ perform::set_active (int seq, bool active)
 
 void
 perform::set_was_active (int seq)
+{
+    mark_dirty(seq, true);
+}
+
+/**
+ *  Folds the events recorded by the MIDI input thread into their sequences.
+ *  See sequence::merge_recorded_events().  This is the deferred half of
+ *  recording, called by the output thread after each frame it plays, and
+ *  once more when playback stops, so that the input thread never waits on
+ *  a pattern's lock, and so that it works without a user interface.  The
+ *  merge comes after the frame's events and clock have gone out.
+ *  Sequences that are not recording return immediately, without locking.
+ *
+ * \param wait
+ *      If false, as during playback, a sequence whose lock is held by
+ *      another thread (an editor, say) is skipped until the next frame,
+ *      so that the output thread never blocks.
+ *
+ * \return
+ *      Returns the total number of events merged.
+ */
+
+int
+perform::merge_recorded_events (bool wait)
+{
+    int result = 0;
+    for (int s = 0; s < m_sequence_high; ++s)
+    {
+        if (is_active(s))
+            result += m_seqs[s]->merge_recorded_events(wait);
+    }
+    return result;
+}
+
+/**
+ *  Marks a pattern for redrawing in the main window, the song editor, and
+ *  its names column, and optionally in the pattern editor.  Called by
+ *  sequence::set_dirty_mp() and sequence::set_dirty(), from any thread.
+ *  It is lock-free; see the dirty_set class.
+ *
+ * \param seq
+ *      The pattern number.  It is checked for validity.
+ *
+ * \param edit
+ *      If true, the pattern editor is marked as well.
+ */
+
+void
+perform::mark_dirty (int seq, bool edit)
 {
     if (is_seq_valid(seq))
     {
-        m_was_active_main[seq] = m_was_active_edit[seq] =
-            m_was_active_perf[seq] = m_was_active_names[seq] = true;
+        m_dirty_main.mark(seq);
+        m_dirty_perf.mark(seq);
+        m_dirty_names.mark(seq);
+        if (edit)
+            m_dirty_edit.mark(seq);
     }
 }
 
 /**
- *  Checks the pattern/sequence for main-dirtiness.  See the
- *  sequence::is_dirty_main() function.
+ *  Checks the pattern/sequence for main-dirtiness.  The sequence itself is
+ *  not touched (or locked); the mark was published by mark_dirty().
  *
  * \param seq
  *      The pattern number.  It is checked for validity.
  *
  * \return
- *      Returns the was-active-main flag value, before setting it to
- *      false.  Returns false if the pattern was invalid.
+ *      Returns true if the pattern was marked since the last call, and
+ *      unmarks it.  Returns false if the pattern was invalid.
  */
 
 bool
 perform::is_dirty_main (int seq)
 {
-    bool was_active = false;
-    if (sequence_count() > 0)
-    {
-        if (is_active(seq))
-        {
-            was_active = m_seqs[seq]->is_dirty_main();
-        }
-        else
-        {
-            was_active = m_was_active_main[seq];
-            m_was_active_main[seq] = false;
-        }
-    }
-    return was_active;
+    return is_seq_valid(seq) && m_dirty_main.take(seq);
 }
 
 /**
@@ -1915,27 +1973,14 @@ perform::is_dirty_main (int seq)
  *      The pattern number.  It is checked for validity.
  *
  * \return
- *      Returns the was-active-edit flag value, before setting it to
- *      false. Returns false if the pattern was invalid.
+ *      Returns true if the pattern was marked since the last call, and
+ *      unmarks it.  Returns false if the pattern was invalid.
  */
 
 bool
 perform::is_dirty_edit (int seq)
 {
-    bool was_active = false;
-    if (sequence_count() > 0)
-    {
-        if (is_active(seq))
-        {
-            was_active = m_seqs[seq]->is_dirty_edit();
-        }
-        else
-        {
-            was_active = m_was_active_edit[seq];
-            m_was_active_edit[seq] = false;
-        }
-    }
-    return was_active;
+    return is_seq_valid(seq) && m_dirty_edit.take(seq);
 }
 
 /**
@@ -1945,27 +1990,14 @@ perform::is_dirty_edit (int seq)
  *      The pattern number.  It is checked for validity.
  *
  * \return
- *      Returns the was-active-perf flag value, before setting it to
- *      false.  Returns false if the pattern/sequence number was invalid.
+ *      Returns true if the pattern was marked since the last call, and
+ *      unmarks it.  Returns false if the pattern was invalid.
  */
 
 bool
 perform::is_dirty_perf (int seq)
 {
-    bool was_active = false;
-    if (sequence_count() > 0)
-    {
-        if (is_active(seq))
-        {
-            was_active = m_seqs[seq]->is_dirty_perf();
-        }
-        else
-        {
-            was_active = m_was_active_perf[seq];
-            m_was_active_perf[seq] = false;
-        }
-    }
-    return was_active;
+    return is_seq_valid(seq) && m_dirty_perf.take(seq);
 }
 
 /**
@@ -1975,27 +2007,14 @@ perform::is_dirty_perf (int seq)
  *      The pattern number.  It is checked for validity.
  *
  * \return
- *      Returns the was-active-names flag value, before setting it to
- *      false.  Returns false if the pattern/sequence number was invalid.
+ *      Returns true if the pattern was marked since the last call, and
+ *      unmarks it.  Returns false if the pattern was invalid.
  */
 
 bool
 perform::is_dirty_names (int seq)
 {
-    bool was_active = false;
-    if (sequence_count() > 0)
-    {
-        if (is_active(seq))
-        {
-            was_active = m_seqs[seq]->is_dirty_names();
-        }
-        else
-        {
-            was_active = m_was_active_names[seq];
-            m_was_active_names[seq] = false;
-        }
-    }
-    return was_active;
+    return is_seq_valid(seq) && m_dirty_names.take(seq);
 }
 
 /**
@@ -2041,7 +2060,12 @@ perform::set_beats_per_minute (midibpm bpm)
 
 #endif
 
-        m_master_bus->set_beats_per_minute(bpm);
+        if (not_nullptr(m_master_bus))              /* null if staging      */
+            m_master_bus->set_beats_per_minute(bpm);
+
+        if (not_nullptr(m_clock_generator))
+            m_clock_generator->tempo(bpm);
+
         m_us_per_quarter_note = tempo_us_from_bpm(bpm);
         m_bpm = bpm;
 
@@ -2055,6 +2079,28 @@ perform::set_beats_per_minute (midibpm bpm)
     }
 }
 
+/**
+ *  Gathers the song's tempo and time-signature values into one object, as
+ *  needed by midi_container::fill() for the first track of a saved or
+ *  exported song.
+ *
+ * \return
+ *      Returns a copy of the timing values.
+ */
+
+midi_timing
+perform::timing ()
+{
+    midi_timing result
+    (
+        get_beats_per_minute(), get_beats_per_bar(), get_beat_width(), ppqn()
+    );
+    result.clocks_per_metronome(clocks_per_metronome());
+    result.thirtyseconds_per_quarter(get_32nds_per_quarter());
+    result.us_per_quarter_note(int(us_per_quarter_note()));
+    return result;
+}
+
 /**
  *  Encapsulates some calls used in mainwnd.  Actually does a lot of
  *  work in those function calls.
@@ -2310,6 +2356,25 @@ perform::is_sequence_in_edit (int seq)
         return false;
 }
 
+/**
+ *  Checks all of the patterns for an edit in progress.  A song cannot be
+ *  cleared or swapped out while one of its patterns is being edited.
+ *
+ * \return
+ *      Returns true if any active sequence's get_editing() call returns true.
+ */
+
+bool
+perform::any_sequence_in_edit () const
+{
+    for (int s = 0; s < m_sequence_high; ++s)           /* m_sequence_max   */
+    {
+        if (is_active(s) && m_seqs[s]->get_editing())
+            return true;
+    }
+    return false;
+}
+
 /**
  *  Retrieves a reference to a value from m_midi_cc_toggle[].  Recall that the
  *  midi_control object specifies if a control is active, inversely-active,
@@ -2474,9 +2539,324 @@ perform::set_screenset (int ss)
 #endif
         m_screenset_offset = screenset_offset(ss);
         unset_queued_replace();                 /* clear this new feature   */
+        prefetch_events();
     }
 }
 
+/**
+ *  Queues the sequences whose events have not been decoded yet (see the
+ *  [lazy-loading] option) for decoding in the background:  first those of
+ *  the current screen-set, then those of the next one, and, when Song mode
+ *  is starting, every sequence that has triggers.  A sequence that is used
+ *  before its turn comes is simply decoded at that point.  If lazy loading
+ *  is off, there is nothing to queue, and nothing is started.
+ *
+ * \param songmode
+ *      If true, playback is starting in Song mode.
+ */
+
+void
+perform::prefetch_events (bool songmode)
+{
+    std::vector<sequence *> seqs;
+    int next = m_screenset + 1 < m_max_sets ? m_screenset + 1 : 0 ;
+    int sets[2] = { m_screenset, next };
+    for (int i = 0; i < 2; ++i)
+    {
+        int first = screenset_offset(sets[i]);
+        for (int s = first; s < first + m_seqs_in_set; ++s)
+        {
+            if (is_active(s) && m_seqs[s]->events().deferred())
+                seqs.push_back(m_seqs[s]);
+        }
+    }
+    if (songmode)
+    {
+        for (int s = 0; s < m_sequence_high; ++s)
+        {
+            if (is_active(s) && m_seqs[s]->events().deferred())
+            {
+                if (m_seqs[s]->trigger_count() > 0)
+                    seqs.push_back(m_seqs[s]);
+            }
+        }
+    }
+    if (! seqs.empty())
+        m_event_prefetcher.request(seqs);
+}
+
+/**
+ *  Copies the settings that midifile::parse() can change, other than the
+ *  sequences themselves, from another perform object:  the timing values,
+ *  the tempo track, the screen-set notepads, the MIDI controls, and the
+ *  mute groups.  The playlist class uses this function to give a staging
+ *  perform object the settings of this one before a song is parsed into it
+ *  (so that what the song does not set stays as it is, as with a normal
+ *  load), and adopt_song() and finish_song_swap() use it to bring the result
+ *  back.
+ *
+ * \param source
+ *      The perform object to copy from.
+ */
+
+void
+perform::copy_song_settings (const perform & source)
+{
+    set_beats_per_minute(source.m_bpm);
+    us_per_quarter_note(source.m_us_per_quarter_note);
+    set_beats_per_bar(source.m_beats_per_bar);
+    set_beat_width(source.m_beat_width);
+    clocks_per_metronome(source.m_clocks_per_metronome);
+    set_32nds_per_quarter(source.m_32nds_per_quarter);
+    set_tempo_track_number(source.m_tempo_track_number);
+    for (int s = 0; s < c_max_sets; ++s)
+        m_screenset_notepad[s] = source.m_screenset_notepad[s];
+
+    for (int i = 0; i < c_midi_controls_extended; ++i)
+    {
+        m_midi_cc_toggle[i] = source.m_midi_cc_toggle[i];
+        m_midi_cc_on[i] = source.m_midi_cc_on[i];
+        m_midi_cc_off[i] = source.m_midi_cc_off[i];
+    }
+    for (int i = 0; i < c_max_sequence; ++i)
+        m_mute_group[i] = source.m_mute_group[i];
+
+    m_mute_group_selected = source.m_mute_group_selected;
+    m_midi_mute_group_present = source.m_midi_mute_group_present;
+}
+
+/**
+ *  Replaces the song with one that a playlist has parsed into a staging
+ *  perform object.  This is the equivalent of clear_all() followed by
+ *  midifile::parse(), except that no file is read (see install_song()).
+ *  Must be called on the thread that owns this object, with playback
+ *  stopped.  The output thread keeps running for a moment after playback
+ *  is stopped, so the swap is made only once it waits for the next start,
+ *  and m_condition_var is held so that it waits until the swap is done.
+ *
+ * \param staged
+ *      The staging perform object.  It is left without sequences.
+ *
+ * \return
+ *      Returns false, and changes nothing, if playback is running, if the
+ *      output thread has not finished playing yet, or if clear_all() fails
+ *      because a sequence is being edited.
+ */
+
+bool
+perform::adopt_song (perform & staged)
+{
+    automutex locker(m_condition_var);
+    bool result = m_output_idle && ! is_running() &&
+        song_swap() == SONG_SWAP_NONE;
+
+    if (result)
+        result = clear_all();
+
+    if (result)
+    {
+        staged.m_event_prefetcher.stop();       /* it decodes staged seqs   */
+        install_song(staged);
+        copy_song_settings(staged);
+        prefetch_events();
+    }
+    return result;
+}
+
+/**
+ *  Hands a song that a playlist has parsed to the output thread, which
+ *  swaps it in when play() reaches the given tick, normally a bar boundary.
+ *  Playback goes on without a stop:  the patterns of the old song play up
+ *  to the tick, and those of the new one from it, at the same position.
+ *  If playback loops back, or is restarted, before the tick, the song is
+ *  swapped in at that point.  The output thread does not delete the old
+ *  sequences, since the user interface can still be drawing them; once
+ *  song_swap() returns SONG_SWAP_DONE, finish_song_swap() must be called on
+ *  the main thread.
+ *
+ * \param staged
+ *      The staging perform object.  It must not be touched or deleted until
+ *      the swap is done, or cancel_song() has taken it back.
+ *
+ * \param tick
+ *      The tick at which to swap it in.
+ *
+ * \return
+ *      Returns false if another song is already queued, or if a pattern is
+ *      being edited.
+ */
+
+bool
+perform::queue_song (perform & staged, midipulse tick)
+{
+    bool result = song_swap() == SONG_SWAP_NONE && ! any_sequence_in_edit();
+    if (result)
+    {
+        staged.m_event_prefetcher.stop();       /* it decodes staged seqs   */
+        m_song_queued = &staged;
+        m_song_swap_tick = tick;
+        m_song_swap.store(SONG_SWAP_QUEUED, std::memory_order_release);
+    }
+    return result;
+}
+
+/**
+ *  Takes back a song queued by queue_song(), if the output thread has not
+ *  started to swap it in, or has refused to.
+ *
+ * \return
+ *      Returns true if the song was taken back, so that the caller owns its
+ *      staging perform object again.  Returns false if it has been swapped
+ *      in, or is being swapped in (then finish_song_swap() is soon due), or
+ *      if no song was queued.
+ */
+
+bool
+perform::cancel_song ()
+{
+    int state = SONG_SWAP_QUEUED;
+    bool result = m_song_swap.compare_exchange_strong(state, SONG_SWAP_NONE);
+    if (! result && state == SONG_SWAP_REFUSED)
+    {
+        m_song_swap.store(SONG_SWAP_NONE, std::memory_order_release);
+        result = true;
+    }
+    return result;
+}
+
+/**
+ *  Completes a swap made by the output thread, on the main thread:  deletes
+ *  the sequences of the old song, except any that has had an editor opened
+ *  on it in the meantime (those are kept for a later call, or for the
+ *  destructor), drops the undo history, and starts the decoding of the new
+ *  sequences.  The settings of the song are copied here, other than the
+ *  timing values, which the output thread has already set, so the staging
+ *  perform object must not be deleted until this function returns.  Does
+ *  nothing unless song_swap() returns SONG_SWAP_DONE.
+ */
+
+void
+perform::finish_song_swap ()
+{
+    if (song_swap() == SONG_SWAP_DONE)
+    {
+        std::vector<sequence *> kept;
+        for (size_t i = 0; i < m_retired_seqs.size(); ++i)
+        {
+            sequence * seq = m_retired_seqs[i];
+            if (seq->get_editing())
+            {
+                kept.push_back(seq);
+            }
+            else
+            {
+                m_event_prefetcher.forget(seq);
+                delete seq;
+            }
+        }
+        m_retired_seqs.swap(kept);
+        copy_song_settings(*m_song_queued);
+        set_have_undo(false);
+        m_undo_vect.clear();
+        set_have_redo(false);
+        m_redo_vect.clear();
+        m_song_queued = nullptr;
+        m_song_swap.store(SONG_SWAP_NONE, std::memory_order_release);
+        prefetch_events(playback_mode());
+    }
+}
+
+/**
+ *  Moves the sequences of a staging perform object into the same slots
+ *  here, and gives them the master buss.  The MIDI clocks that the song
+ *  sets, which the staging object could only save, are passed to the master
+ *  buss.  The slots must be empty, and the other settings are left to the
+ *  caller.
+ *
+ *  Each sequence still points to the staging object as its parent, and
+ *  sequence::set_parent() does not replace a parent already set, so the
+ *  pointer is cleared first.  Otherwise the sequence would keep calling the
+ *  staging object, which is deleted once the song is swapped in.
+ *
+ * \param staged
+ *      The staging perform object.  It is left without sequences.
+ */
+
+void
+perform::install_song (perform & staged)
+{
+    for (int s = 0; s < staged.m_sequence_high; ++s)
+    {
+        if (staged.is_active(s))
+        {
+            sequence * seq = staged.m_seqs[s];
+            staged.m_seqs[s] = nullptr;
+            staged.m_seqs_active[s] = false;
+            --staged.m_sequence_count;
+            seq->set_master_midi_bus(m_master_bus);
+            seq->m_parent = nullptr;            /* install sets it to us    */
+            (void) install_sequence(seq, s);
+        }
+    }
+    if (not_nullptr(m_master_bus))
+    {
+        int buses = int(staged.m_master_clocks.size());
+        for (int bus = 0; bus < buses; ++bus)
+        {
+            bussbyte b = bussbyte(bus);
+            m_master_bus->set_clock(b, staged.m_master_clocks[bus]);
+        }
+    }
+    m_is_modified = staged.m_is_modified;       /* an SMF 0 split sets it   */
+}
+
+/**
+ *  Swaps in the song queued by queue_song(), on the output thread, from
+ *  play().  The notes of the old sequences are turned off, and the
+ *  sequences are moved to m_retired_seqs; the new ones start from the given
+ *  tick, at the tempo and time signature of the song.  If a pattern is
+ *  being edited, nothing is swapped, and the state becomes
+ *  SONG_SWAP_REFUSED.
+ *
+ * \param tick
+ *      The tick from which the new sequences play.
+ */
+
+void
+perform::swap_queued_song (midipulse tick)
+{
+    int state = SONG_SWAP_QUEUED;
+    if (! m_song_swap.compare_exchange_strong(state, SONG_SWAP_BUSY))
+        return;                                 /* taken back meanwhile     */
+
+    if (any_sequence_in_edit())
+    {
+        m_song_swap.store(SONG_SWAP_REFUSED, std::memory_order_release);
+        return;
+    }
+    for (int s = 0; s < m_sequence_high; ++s)
+    {
+        if (is_active(s))
+        {
+            sequence * seq = m_seqs[s];
+            seq->stop(true);                    /* notes off, and disarmed  */
+            set_active(s, false);
+            m_seqs[s] = nullptr;
+            m_retired_seqs.push_back(seq);
+        }
+    }
+    perform & staged = *m_song_queued;
+    install_song(staged);
+    set_beats_per_minute(staged.m_bpm);
+    set_beats_per_bar(staged.m_beats_per_bar);
+    set_beat_width(staged.m_beat_width);
+    set_orig_ticks(tick);
+    if (not_nullptr(m_master_bus))
+        m_master_bus->flush();
+
+    m_song_swap.store(SONG_SWAP_DONE, std::memory_order_release);
+}
+
 #ifdef SEQ64_USE_AUTO_SCREENSET_QUEUE
 
 /**
@@ -2584,6 +2964,17 @@ perform::set_playing_screenset ()
  *  Finally, we stop the looping at m_sequence_high rather than
  *  m_sequence_max, to save a little time.
  *
+ *  A lazily-loaded sequence that is playing but not decoded yet is skipped
+ *  by sequence::play(), and handed to the prefetcher to decode next.  The
+ *  prefetcher is not waited for; if it is busy, the next frame asks again.
+ *
+ *  If a song has been queued (see queue_song()) and this tick reaches the
+ *  tick of the swap, the old song is played up to that tick, and the new
+ *  one swapped in, so that the change falls on the boundary, however late
+ *  this frame is.  If the tick has gone back (playback looped, or was
+ *  restarted), the swap is made at once, from the left marker if it is
+ *  not past this tick.
+ *
  * \param tick
  *      Provides the tick at which to start playing.  This value is also
  *      copied to m_tick.
@@ -2592,16 +2983,38 @@ perform::set_playing_screenset ()
 void
 perform::play (midipulse tick)
 {
+    if (m_song_swap.load(std::memory_order_acquire) == SONG_SWAP_QUEUED)
+    {
+        if (tick < get_tick())                      /* looped back      */
+        {
+            midipulse left = get_left_tick();
+            swap_queued_song(left <= tick ? left : tick);
+        }
+        else if (tick >= m_song_swap_tick)
+        {
+            if (m_song_swap_tick > get_tick())
+                play(m_song_swap_tick - 1);         /* finish old song  */
+
+            swap_queued_song(m_song_swap_tick);
+        }
+    }
     set_tick(tick);
+    if (not_nullptr(m_master_bus))
+        m_master_bus->play_position(tick);          /* stamps loop-back */
+
     for (int s = 0; s < m_sequence_high; ++s)       /* modest speed up  */
     {
         sequence * sp = get_sequence(s);
         if (not_nullptr(sp))
+        {
 #ifdef SEQ64_SONG_RECORDING
             sp->play_queue(tick, m_playback_mode, m_resume_note_ons);
 #else
             sp->play_queue(tick, m_playback_mode);
 #endif
+            if (sp->get_playing() && sp->events().deferred())
+                m_event_prefetcher.hurry(sp);       /* it was skipped   */
+        }
     }
     if (not_nullptr(m_master_bus))
         m_master_bus->flush();                      /* flush MIDI buss  */
@@ -2875,6 +3288,7 @@ perform::start_playing (bool songmode)
         if (is_jack_master())
             position_jack(false);
     }
+    prefetch_events(songmode);                          /* lazy loading    */
     start_jack();
     start(songmode);                                    /* song mode       */
 }
@@ -3198,8 +3612,9 @@ perform::unqueue_sequences (int current_seq)
 }
 
 /**
- *  For all active patterns/sequences, turn off its playing notes.
- *  Then flush the master MIDI buss.
+ *  For all active patterns/sequences, turn off its playing notes.  Then turn
+ *  off any notes that the master buss still sees sounding (MIDI thru, note
+ *  previews), and flush the master MIDI buss.
  */
 
 void
@@ -3212,13 +3627,14 @@ perform::all_notes_off ()
     }
     if (not_nullptr(m_master_bus))
     {
-        m_master_bus->flush();                  /* flush the MIDI buss  */
+        m_master_bus->panic();                  /* leftovers and flush  */
     }
 }
 
 /**
- *  Similar to all_notes_off(), but also sends Note Off events directly to the
- *  active busses.  Adapted from Oli Kester's Kepler34 project.
+ *  Similar to all_notes_off(), but also stops playback, and sends All Notes
+ *  Off and All Sound Off to each channel in use.  Adapted from Oli Kester's
+ *  Kepler34 project.
  */
 
 void
@@ -3232,7 +3648,7 @@ perform::panic ()
     }
     if (not_nullptr(m_master_bus))
     {
-        m_master_bus->panic();                  /* flush the MIDI buss  */
+        m_master_bus->panic(true);              /* plus CC 123 and 120  */
     }
 }
 
@@ -3654,12 +4070,14 @@ perform::output_func ()
     while (m_outputing)         /* PERHAPS we should LOCK this variable */
     {
         m_condition_var.lock();
+        m_output_idle = true;               /* see adopt_song()         */
         while (! is_running())
         {
             m_condition_var.wait();
             if (! m_outputing)              /* if stopping, kill thread */
                 break;
         }
+        m_output_idle = false;
         m_condition_var.unlock();
 
 #ifdef PLATFORM_WINDOWS
@@ -3765,6 +4183,7 @@ perform::output_func ()
         }
 
         int ppqn = m_master_bus->get_ppqn();
+        bool clock_thread = false;          /* clock_generator started?     */
 
 #ifdef SEQ64_STATISTICS_SUPPORT
 
@@ -3932,6 +4351,26 @@ perform::output_func ()
             {
                 m_master_bus->init_clock(midipulse(pad.js_clock_tick));
                 pad.js_init_clock = false;
+
+                /*
+                 * The clock thread runs on its own timeline, so it is used
+                 * only when we are that timeline's source.  Under JACK
+                 * transport or incoming MIDI clock, the ticks come from
+                 * outside, and this thread keeps clocking the busses.
+                 */
+
+                clock_thread = not_nullptr(m_clock_generator) &&
+                    ! is_jack_running() && ! m_usemidiclock;
+
+                if (clock_thread)
+                {
+                    m_clock_generator->start
+                    (
+                        midipulse(pad.js_clock_tick), m_bpm, ppqn
+                    );
+                }
+                else if (not_nullptr(m_clock_generator))
+                    m_clock_generator->stop();
             }
             if (pad.js_dumping)
             {
@@ -4021,7 +4460,10 @@ perform::output_func ()
                  * m_master_bus->clock(midipulse(pad.js_clock_tick));
                  */
 
-                m_master_bus->emit_clock(midipulse(pad.js_clock_tick));
+                if (! clock_thread)
+                    m_master_bus->emit_clock(midipulse(pad.js_clock_tick));
+
+                (void) merge_recorded_events(false);    /* never blocks     */
 
 #ifdef SEQ64_STATISTICS_SUPPORT
                 if (rc().stats())
@@ -4163,6 +4605,7 @@ perform::output_func ()
             if (pad.js_jack_stopped)
                 inner_stop();
         }
+        (void) merge_recorded_events();             /* the end of the take  */
 #ifdef SEQ64_STATISTICS_SUPPORT
         if (rc().stats())
         {
@@ -4216,9 +4659,16 @@ perform::output_func ()
 
         /*
          * This means we leave m_tick at stopped location if in slave mode or
-         * if m_usemidiclock == true.
+         * if m_usemidiclock == true.  The clock thread must be stopped
+         * before the MIDI Stop goes out.
          */
 
+        if (clock_thread)
+        {
+            m_clock_generator->stop();
+            if (rc().stats())
+                m_clock_generator->show_stats();
+        }
         m_master_bus->flush();
         m_master_bus->stop();
 
@@ -4318,7 +4768,8 @@ input_thread_func (void * myperf)
         c_midi_control_bpm_page_up
         c_midi_control_bpm_page_dn
         c_midi_control_ss_set
-        c_midi_control_17 to _19    (reserved for expansion)
+        c_midi_control_playlist     (song by number, next, or previous)
+        c_midi_control_18 to _19    (reserved for expansion)
 \endverbatim
  *
  *  The extended values will actually be handled by a new function,
@@ -4526,6 +4977,18 @@ perform::handle_midi_control_ex (int ctl, midi_control::action a, int v)
         result = true;
         break;
 
+    case c_midi_control_playlist:
+
+        if (a == midi_control::action_toggle)
+            m_playlist.select(v);
+        else if (a == midi_control::action_on)
+            m_playlist.next();
+        else
+            m_playlist.previous();
+
+        result = true;
+        break;
+
     default:
 
         break;
@@ -6255,6 +6718,7 @@ perform::set_tick (midipulse tick)
 #endif  // PLATFORM_DEBUG_TMI
 
     m_tick = tick;
+    m_transport.tick(tick);                     /* publish for the GUI      */
 
     /*
      * \change ca 2017-12-30 Issue #123
@@ -0,0 +1,676 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          playlist.cpp
+ *
+ *  This module defines the class that plays a list of MIDI files live,
+ *  parsing the next songs in the background.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  See the playlist.hpp module for the overview.
+ */
+
+#include <fstream>                      /* std::ifstream                    */
+
+#include "easy_macros.h"                /* nullptr, errprint()              */
+#include "midifile.hpp"                 /* seq64::midifile                  */
+#include "perform.hpp"                  /* seq64::perform                   */
+#include "playlist.hpp"                 /* seq64::playlist                  */
+#include "settings.hpp"                 /* seq64::rc() and seq64::usr()     */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Principal constructor.  The playlist is empty until open() is called,
+ *  and the thread is not started until there is a song to parse.
+ *
+ * \param p
+ *      The live perform object, into which the songs are swapped.
+ */
+
+playlist::playlist (perform & p)
+ :
+    m_perform           (p),
+    m_condition         (),
+    m_thread            (),
+    m_thread_launched   (false),
+    m_stop              (false),
+    m_files             (),
+    m_songs             (),
+    m_queue             (),
+    m_parsing           (nullptr),
+    m_current           (-1),
+    m_current_ppqn      (0),
+    m_selected          (-1),
+    m_queued            (nullptr),
+    m_queued_index      (-1),
+    m_refused           (false)
+{
+    // Empty body
+}
+
+/**
+ *  Stops the thread and deletes the staged songs.  The perform object has
+ *  joined its output thread by now, so a queued song is no longer in use.
+ */
+
+playlist::~playlist ()
+{
+    stop();
+    for (int i = 0; i < count(); ++i)
+        discard(i);
+
+    if (not_nullptr(m_queued))
+    {
+        delete m_queued->s_perform;
+        delete m_queued;
+    }
+}
+
+/**
+ *  Reads a playlist file, replacing the current list, and selects its first
+ *  song, which is swapped in by poll() as soon as it has been parsed.  Each
+ *  line of the file names one MIDI file.  Blank lines and lines starting
+ *  with '#' are skipped, and a name that does not start with '/' is
+ *  relative to the directory of the playlist file.
+ *
+ * \param filename
+ *      The name of the playlist file.
+ *
+ * \return
+ *      Returns true if the file could be read and listed at least one song.
+ */
+
+bool
+playlist::open (const std::string & filename)
+{
+    std::ifstream file(filename.c_str(), std::ios::in);
+    if (! file.is_open())
+    {
+        errprintf("cannot open playlist '%s'\n", filename.c_str());
+        return false;
+    }
+
+    std::string directory;
+    std::string::size_type slash = filename.find_last_of('/');
+    if (slash != std::string::npos)
+        directory = filename.substr(0, slash + 1);
+
+    std::vector<std::string> files;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::string::size_type first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#')
+            continue;
+
+        std::string::size_type last = line.find_last_not_of(" \t\r");
+        std::string name = line.substr(first, last - first + 1);
+        if (name[0] != '/')
+            name = directory + name;
+
+        files.push_back(name);
+    }
+
+    automutex locker(m_condition);
+    for (int i = 0; i < count(); ++i)
+        discard(i);
+
+    m_files = files;
+    m_songs.assign(files.size(), nullptr);
+    m_queue.clear();
+    m_current = -1;
+    m_selected = files.empty() ? -1 : 0 ;
+    m_queued_index = -1;                        /* not in the new list      */
+    m_refused = false;
+    return ! files.empty();
+}
+
+/**
+ *  Selects the song to be swapped in next.  Only records the request, so
+ *  it can be called from any thread, such as the MIDI input thread.
+ *
+ * \param index
+ *      The index of the song in the playlist.  Ignored if out of range.
+ */
+
+void
+playlist::select (int index)
+{
+    automutex locker(m_condition);
+    if (index >= 0 && index < count())
+    {
+        m_selected = index;
+        m_refused = false;
+    }
+}
+
+/**
+ *  Selects the song after the one already selected, or after the current
+ *  song.
+ */
+
+void
+playlist::next ()
+{
+    automutex locker(m_condition);
+    int index = m_selected >= 0 ? m_selected : m_current ;
+    if (index + 1 < count())
+    {
+        m_selected = index + 1;
+        m_refused = false;
+    }
+}
+
+/**
+ *  Selects the song before the one already selected, or before the current
+ *  song.  That song is normally not parsed ahead, so it is parsed first.
+ */
+
+void
+playlist::previous ()
+{
+    automutex locker(m_condition);
+    int index = m_selected >= 0 ? m_selected : m_current ;
+    if (index > 0)
+    {
+        m_selected = index - 1;
+        m_refused = false;
+    }
+}
+
+/**
+ *  Does the work of the playlist on the main thread.  Called regularly by
+ *  the main window's timer.  Stages the songs that are wanted.  If the
+ *  selected song is ready, it is swapped in at once when playback is
+ *  stopped, and otherwise queued for the output thread to swap in at the
+ *  next bar boundary (see swap_tick()).  A queued song is taken back if
+ *  playback stops, or another song is selected, before the swap.
+ *
+ * \return
+ *      Returns true if a song was swapped in, so that the caller can update
+ *      the file name, PPQN, and other displays.
+ */
+
+bool
+playlist::poll ()
+{
+    song * s = nullptr;
+    int index = -1;
+    bool swapped = false;                       /* by the output thread     */
+    {
+        automutex locker(m_condition);
+        if (m_files.empty() || m_stop)
+            return false;
+
+        if (not_nullptr(m_queued))
+        {
+            perform::song_swap_t state = m_perform.song_swap();
+            if (state == perform::SONG_SWAP_DONE)
+            {
+                s = m_queued;
+                index = m_queued_index;
+                m_queued = nullptr;
+                swapped = true;
+            }
+            else
+            {
+                bool drop = state == perform::SONG_SWAP_REFUSED ||
+                    ! m_perform.is_running() ||
+                    (m_selected >= 0 && m_selected != m_queued_index);
+
+                if (drop && m_perform.cancel_song())
+                {
+                    if (state == perform::SONG_SWAP_REFUSED)
+                        refuse();
+
+                    requeue();
+                }
+                return false;
+            }
+        }
+        else
+        {
+            schedule();
+            if (m_selected < 0)
+                return false;
+
+            index = m_selected;
+            s = m_songs[index];
+            if (is_nullptr(s) || ! s->s_ready)
+                return false;
+
+            if (! s->s_ok)
+            {
+                errprint(s->s_error.c_str());
+                discard(index);
+                m_selected = -1;
+                return false;
+            }
+            if (m_perform.is_running())
+            {
+                midipulse tick = swap_tick();
+                if (tick >= 0)
+                {
+                    if (m_perform.queue_song(*s->s_perform, tick))
+                    {
+                        m_queued = s;
+                        m_queued_index = index;
+                        m_songs[index] = nullptr;
+                        m_selected = -1;
+                    }
+                    else if (m_perform.any_sequence_in_edit())
+                        refuse();
+                }
+                return false;
+            }
+        }
+    }
+
+    bool result = true;
+    if (swapped)
+    {
+        m_perform.finish_song_swap();
+        apply(*s);
+    }
+    else
+        result = install(*s);
+
+    automutex locker(m_condition);
+    if (result)
+    {
+        if (! swapped)
+        {
+            if (m_songs[index] == s)
+                m_songs[index] = nullptr;
+
+            if (m_selected == index)
+                m_selected = -1;
+        }
+        m_current = index;
+        m_current_ppqn = s->s_ppqn;
+        m_refused = false;
+        schedule();                             /* stage the songs after it */
+        delete s->s_perform;
+        delete s;
+    }
+    return result;
+}
+
+/**
+ *  Drops any remaining work and joins the thread.  No further songs are
+ *  parsed or swapped in.
+ */
+
+void
+playlist::stop ()
+{
+    {
+        automutex locker(m_condition);
+        m_stop = true;
+        m_queue.clear();
+        m_condition.signal();
+    }
+    if (m_thread_launched)
+    {
+        pthread_join(m_thread, NULL);
+        m_thread_launched = false;
+    }
+}
+
+/**
+ * \getter m_files[m_current]
+ *
+ * \return
+ *      Returns the full path of the current song, or an empty string if no
+ *      song of the playlist has been swapped in.
+ */
+
+const std::string &
+playlist::current_name () const
+{
+    static std::string s_empty;
+    return m_current >= 0 ? m_files[m_current] : s_empty ;
+}
+
+/**
+ *  Drops the staged songs that are no longer wanted, creates a staging
+ *  perform object for each wanted song that has none, and queues those
+ *  still to be parsed:  the selected song first, then the songs after the
+ *  current one.  A staging object starts with the settings of the live
+ *  object, so that a song that does not set (for example) the MIDI
+ *  controls or the tempo keeps them, as with a normal load.  The lock must
+ *  be held.
+ */
+
+void
+playlist::schedule ()
+{
+    for (int i = 0; i < count(); ++i)
+    {
+        if (not_nullptr(m_songs[i]) && ! wanted(i))
+            discard(i);
+    }
+
+    std::vector<int> order;
+    if (m_selected >= 0)
+        order.push_back(m_selected);
+
+    int first = m_current + 1;
+    int limit = first + rc().playlist_preload();
+    for (int i = first; i < limit && i < count(); ++i)
+    {
+        if (i != m_selected)
+            order.push_back(i);
+    }
+
+    m_queue.clear();
+    std::vector<int>::const_iterator oi;
+    for (oi = order.begin(); oi != order.end(); ++oi)
+    {
+        song * s = m_songs[*oi];
+        if (is_nullptr(s))
+        {
+            s = new song;
+            s->s_perform = new perform(m_perform.gui(), m_perform.ppqn());
+            s->s_perform->copy_song_settings(m_perform);
+            s->s_ready = s->s_ok = false;
+            s->s_ppqn = 0;
+            s->s_musical_key = -1;
+            s->s_musical_scale = -1;
+            s->s_background_sequence = -1;
+            m_songs[*oi] = s;
+        }
+        if (! s->s_ready && s != m_parsing)
+            m_queue.push_back(*oi);
+    }
+    if (! m_thread_launched && ! m_queue.empty())
+    {
+        int err = pthread_create(&m_thread, NULL, playlist_thread_func, this);
+        if (err == 0)
+        {
+            m_thread_launched = true;
+        }
+        else
+        {
+            errprint("could not start the playlist thread");
+        }
+    }
+    if (! m_queue.empty())
+        m_condition.signal();
+}
+
+/**
+ *  Tells if a song should be kept staged:  the selected song, and the songs
+ *  that follow the current one, up to the [playlist] preload count.
+ *
+ * \param index
+ *      The index of the song.
+ */
+
+bool
+playlist::wanted (int index) const
+{
+    if (index == m_selected)
+        return true;
+
+    return index > m_current && index <= m_current + rc().playlist_preload();
+}
+
+/**
+ *  Works out the tick at which a song selected during playback is swapped
+ *  in:  the next multiple of the [playlist] bar interval, as counted from
+ *  the start of the song.
+ *
+ * \return
+ *      Returns the tick, or -1 if the bar interval is 0, so that the swap
+ *      waits for playback to stop.
+ */
+
+midipulse
+playlist::swap_tick () const
+{
+    int bars = rc().playlist_bars();
+    if (bars == 0)
+        return -1;
+
+    midipulse tick = m_perform.get_tick();
+    midipulse span = midipulse(bars) * m_perform.ppqn() * 4 *
+        m_perform.get_beats_per_bar() / m_perform.get_beat_width();
+
+    return span > 0 ? (tick / span + 1) * span : tick ;
+}
+
+/**
+ *  Puts back a song that perform::cancel_song() has taken back from the
+ *  output thread, so that it stays staged, and, if no other song has been
+ *  selected, selects it again.  It is deleted if its slot has been reused
+ *  or the playlist replaced.  The lock must be held.
+ */
+
+void
+playlist::requeue ()
+{
+    song * s = m_queued;
+    int index = m_queued_index;
+    m_queued = nullptr;
+    if (index >= 0 && index < count() && is_nullptr(m_songs[index]))
+    {
+        m_songs[index] = s;
+        if (m_selected < 0)
+            m_selected = index;
+    }
+    else
+    {
+        delete s->s_perform;
+        delete s;
+    }
+}
+
+/**
+ *  Reports, once per selection, that the selected song cannot be swapped in
+ *  while a pattern is being edited.  The song stays staged, and poll()
+ *  tries again until the editors are closed.
+ */
+
+void
+playlist::refuse ()
+{
+    if (! m_refused)
+    {
+        m_refused = true;
+        errprint("close the pattern editors to change songs");
+    }
+}
+
+/**
+ *  Swaps a parsed song into the live perform object, on the main thread,
+ *  with playback stopped.  See apply().
+ *
+ * \param s
+ *      The song.  Its staging object is left without sequences.
+ *
+ * \return
+ *      Returns false if the swap could not be made yet, because the output
+ *      thread is still finishing, or because a pattern is being edited.
+ *      The song is then left staged, to be tried again.
+ */
+
+bool
+playlist::install (song & s)
+{
+    bool result = m_perform.adopt_song(*s.s_perform);
+    if (result)
+    {
+        apply(s);
+    }
+    else if (m_perform.any_sequence_in_edit())
+    {
+        automutex locker(m_condition);
+        refuse();
+    }
+    return result;
+}
+
+/**
+ *  Applies the global key, scale, and background sequence that a song that
+ *  has been swapped in sets, as midifile::parse() would.
+ *
+ * \param s
+ *      The song.
+ */
+
+void
+playlist::apply (const song & s)
+{
+    if (s.s_musical_key >= 0)
+        usr().seqedit_key(s.s_musical_key);
+
+    if (s.s_musical_scale >= 0)
+        usr().seqedit_scale(s.s_musical_scale);
+
+    if (s.s_background_sequence >= 0)
+        usr().seqedit_bgsequence(s.s_background_sequence);
+
+    if (! s.s_error.empty())
+    {
+        errprint(s.s_error.c_str());            /* not fatal, as in a load  */
+    }
+}
+
+/**
+ *  Parses one song into its staging perform object.  Called by the thread
+ *  without the lock; it touches nothing but the song.
+ *
+ * \param filename
+ *      The MIDI file of the song.
+ *
+ * \param s
+ *      The song to fill.
+ */
+
+void
+playlist::parse (const std::string & filename, song & s)
+{
+    midifile f(filename);
+    f.detached(true);
+    bool ok = f.parse(*s.s_perform);
+    s.s_ok = ok || ! f.error_is_fatal();
+    s.s_error = f.error_message();
+    s.s_ppqn = f.ppqn();
+    s.s_musical_key = f.musical_key();
+    s.s_musical_scale = f.musical_scale();
+    s.s_background_sequence = f.background_sequence();
+}
+
+/**
+ *  Removes a staged song.  If the thread is parsing it, the thread deletes
+ *  it when done.  The lock must be held, or the thread stopped.
+ *
+ * \param index
+ *      The index of the song.
+ */
+
+void
+playlist::discard (int index)
+{
+    song * s = m_songs[index];
+    m_songs[index] = nullptr;
+    if (not_nullptr(s) && s != m_parsing)
+    {
+        delete s->s_perform;
+        delete s;
+    }
+}
+
+/**
+ *  The body of the playlist thread.  Waits for work, and parses the queued
+ *  songs one at a time, until stop() is called.  The lock is released
+ *  during each parse, so that the main thread can keep selecting songs.
+ */
+
+void
+playlist::run ()
+{
+    automutex locker(m_condition);
+    for (;;)
+    {
+        while (m_queue.empty() && ! m_stop)
+            m_condition.wait();
+
+        if (m_stop)
+            break;
+
+        int index = m_queue.front();
+        m_queue.pop_front();
+
+        song * s = m_songs[index];
+        if (is_nullptr(s) || s->s_ready)
+            continue;
+
+        std::string filename = m_files[index];
+        m_parsing = s;
+        m_condition.unlock();
+        parse(filename, *s);
+        m_condition.lock();
+        m_parsing = nullptr;
+        s->s_ready = true;
+        if (index >= count() || m_songs[index] != s)
+        {
+            delete s->s_perform;                /* dropped while parsing    */
+            delete s;
+        }
+    }
+}
+
+/**
+ *  The playlist thread's function.
+ *
+ * \param myplaylist
+ *      The playlist object, cast to void.
+ *
+ * \return
+ *      Always returns nullptr.
+ */
+
+void *
+playlist::playlist_thread_func (void * myplaylist)
+{
+    playlist * p = static_cast<playlist *>(myplaylist);
+    p->run();
+    return nullptr;
+}
+
+}           // namespace seq64
+
+/*
+ * playlist.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
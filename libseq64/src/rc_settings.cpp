@@ -85,6 +85,11 @@ rc_settings::rc_settings ()
  :
     m_verbose_option            (false),
     m_auto_option_save          (true),     /* legacy seq24 behavior */
+    m_auto_song_save            (0),        /* no song backups       */
+    m_session_cache             (false),
+    m_lazy_loading              (false),
+    m_playlist_preload          (2),
+    m_playlist_bars             (0),        /* swap songs at stop    */
     m_legacy_format             (false),
     m_lash_support              (false),
     m_allow_mod4_mode           (false),
@@ -93,6 +98,7 @@ rc_settings::rc_settings ()
     m_show_midi                 (false),
     m_priority                  (false),
     m_stats                     (false),
+    m_clock_thread              (false),
     m_pass_sysex                (false),
     m_with_jack_transport       (false),
     m_with_jack_master          (false),
@@ -112,6 +118,7 @@ rc_settings::rc_settings ()
     m_filename                  (),
     m_jack_session_uuid         (),
     m_last_used_dir             (),
+    m_playlist_filename         (),
     m_config_directory          (),
     m_config_filename           (),
     m_user_filename             (),
@@ -136,6 +143,11 @@ rc_settings::rc_settings (const rc_settings & rhs)
  :
     m_verbose_option            (rhs.m_verbose_option),
     m_auto_option_save          (rhs.m_auto_option_save),
+    m_auto_song_save            (rhs.m_auto_song_save),
+    m_session_cache             (rhs.m_session_cache),
+    m_lazy_loading              (rhs.m_lazy_loading),
+    m_playlist_preload          (rhs.m_playlist_preload),
+    m_playlist_bars             (rhs.m_playlist_bars),
     m_legacy_format             (rhs.m_legacy_format),
     m_lash_support              (rhs.m_lash_support),
     m_allow_mod4_mode           (rhs.m_allow_mod4_mode),
@@ -144,6 +156,7 @@ rc_settings::rc_settings (const rc_settings & rhs)
     m_show_midi                 (rhs.m_show_midi),
     m_priority                  (rhs.m_priority),
     m_stats                     (rhs.m_stats),
+    m_clock_thread              (rhs.m_clock_thread),
     m_pass_sysex                (rhs.m_pass_sysex),
     m_with_jack_transport       (rhs.m_with_jack_transport),
     m_with_jack_master          (rhs.m_with_jack_master),
@@ -159,6 +172,7 @@ rc_settings::rc_settings (const rc_settings & rhs)
     m_filename                  (rhs.m_filename),
     m_jack_session_uuid         (rhs.m_jack_session_uuid),
     m_last_used_dir             (rhs.m_last_used_dir),
+    m_playlist_filename         (rhs.m_playlist_filename),
     m_config_directory          (rhs.m_config_directory),
     m_config_filename           (rhs.m_config_filename),
     m_user_filename             (rhs.m_user_filename),
@@ -189,6 +203,11 @@ rc_settings::operator = (const rc_settings & rhs)
     {
         m_verbose_option            = rhs.m_verbose_option;
         m_auto_option_save          = rhs.m_auto_option_save;
+        m_auto_song_save            = rhs.m_auto_song_save;
+        m_session_cache             = rhs.m_session_cache;
+        m_lazy_loading              = rhs.m_lazy_loading;
+        m_playlist_preload          = rhs.m_playlist_preload;
+        m_playlist_bars             = rhs.m_playlist_bars;
         m_legacy_format             = rhs.m_legacy_format;
         m_lash_support              = rhs.m_lash_support;
         m_allow_mod4_mode           = rhs.m_allow_mod4_mode;
@@ -197,6 +216,7 @@ rc_settings::operator = (const rc_settings & rhs)
         m_show_midi                 = rhs.m_show_midi;
         m_priority                  = rhs.m_priority;
         m_stats                     = rhs.m_stats;
+        m_clock_thread              = rhs.m_clock_thread;
         m_pass_sysex                = rhs.m_pass_sysex;
         m_with_jack_transport       = rhs.m_with_jack_transport;
         m_with_jack_master          = rhs.m_with_jack_master;
@@ -211,6 +231,7 @@ rc_settings::operator = (const rc_settings & rhs)
         m_filename                  = rhs.m_filename;
         m_jack_session_uuid         = rhs.m_jack_session_uuid;
         m_last_used_dir             = rhs.m_last_used_dir;
+        m_playlist_filename         = rhs.m_playlist_filename;
         m_config_directory          = rhs.m_config_directory;
         m_config_filename           = rhs.m_config_filename;
         m_user_filename             = rhs.m_user_filename;
@@ -237,6 +258,11 @@ rc_settings::set_defaults ()
 {
     m_verbose_option            = false;
     m_auto_option_save          = true;     /* legacy seq224 setting */
+    m_auto_song_save            = 0;
+    m_session_cache             = false;
+    m_lazy_loading              = false;
+    m_playlist_preload          = 2;
+    m_playlist_bars             = 0;
     m_legacy_format             = false;
     m_lash_support              = false;
     m_allow_mod4_mode           = false;
@@ -245,6 +271,7 @@ rc_settings::set_defaults ()
     m_show_midi                 = false;
     m_priority                  = false;
     m_stats                     = false;
+    m_clock_thread              = false;
     m_pass_sysex                = false;
 #ifdef SEQ64_RTMIDI_SUPPORT
     m_with_jack_midi            = true;
@@ -262,6 +289,7 @@ rc_settings::set_defaults ()
     m_device_ignore_num         = e_seq24_interaction;
     m_filename.clear();
     m_jack_session_uuid.clear();
+    m_playlist_filename.clear();
 #if defined PLATFORM_WINDOWS            /* but see home_config_directory()  */
     m_last_used_dir             = "C:\\Users\\$USER";
     m_config_directory          = "C:\\Users\\$USER";
@@ -556,6 +584,39 @@ rc_settings::last_used_dir (const std::string & value)
         m_last_used_dir = value;
 }
 
+/**
+ * \setter m_playlist_preload
+ *
+ * \param count
+ *      The number of songs to parse ahead, clamped to 1 through 8.  Each one
+ *      holds a whole song in memory.
+ */
+
+void
+rc_settings::playlist_preload (int count)
+{
+    if (count < 1)
+        count = 1;
+    else if (count > 8)
+        count = 8;
+
+    m_playlist_preload = count;
+}
+
+/**
+ * \setter m_playlist_bars
+ *
+ * \param bars
+ *      The bar interval at which songs are swapped during playback, or 0 to
+ *      swap them only while stopped.  Negative values are treated as 0.
+ */
+
+void
+rc_settings::playlist_bars (int bars)
+{
+    m_playlist_bars = bars > 0 ? bars : 0 ;
+}
+
 /**
  * \setter m_config_directory
  *
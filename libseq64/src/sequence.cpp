@@ -78,6 +78,12 @@ namespace seq64
 
 event_list sequence::m_events_clipboard;
 
+/**
+ *  The source of the edit versions of all sequences.  See bump_edit_version().
+ */
+
+std::atomic<unsigned> sequence::m_edit_counter(0);
+
 /**
  *  Principal constructor.
  *
@@ -96,7 +102,6 @@ sequence::sequence (int ppqn)
     m_have_redo                 (false),        // stazed
     m_events_undo               (),
     m_events_redo               (),
-    m_iterator_draw             (m_events.begin()),
     m_channel_match             (false),        // a future stazed feature
     m_midi_channel              (0),
     m_bus                       (0),
@@ -107,6 +112,10 @@ sequence::sequence (int ppqn)
     m_notes_on                  (0),
     m_masterbus                 (nullptr),
     m_playing_notes             (),             // an array
+    m_record_queue              (nullptr),      // allocated when recording
+    m_record_overflow           (),
+    m_record_overflowing        (false),
+    m_record_discard            (0),
     m_was_playing               (false),
     m_playing                   (false),
     m_recording                 (false),
@@ -131,6 +140,7 @@ sequence::sequence (int ppqn)
     m_dirty_edit                (true),
     m_dirty_perf                (true),
     m_dirty_names               (true),
+    m_edit_version              (++m_edit_counter),
     m_editing                   (false),
     m_raise                     (false),
     m_name                      (),
@@ -172,12 +182,13 @@ sequence::sequence (int ppqn)
 }
 
 /**
- *  A rote destructor.
+ *  A rote destructor.  Frees the recording queue, if recording was ever
+ *  enabled.
  */
 
 sequence::~sequence ()
 {
-    // Empty body
+    delete m_record_queue.load();
 }
 
 /**
@@ -239,6 +250,57 @@ sequence::partial_assign (const sequence & rhs)
     }
 }
 
+/**
+ *  Copies everything that midifile writes for a sequence: the events,
+ *  triggers, name, length, channel, buss, time signature, musical key,
+ *  musical scale, and background sequence.  Used to take a snapshot of a
+ *  sequence for a background save; the copy is detached, and nothing in it is
+ *  shared with rhs.
+ *
+ *  Unlike partial_assign(), this function does not call verify_and_link().
+ *  The note links are simply cleared, since they would point into rhs, and
+ *  the writer does not need them.  Relinking costs far more than the copy on
+ *  long sequences, and would also prune events, so that the file would no
+ *  longer hold exactly what the song holds.
+ *
+ * \threadsafe
+ *      Both sequences are locked, rhs first.  This sequence must not be
+ *      visible to any other thread yet.
+ *
+ * \param rhs
+ *      Provides the source of the new member values.
+ */
+
+void
+sequence::snapshot_assign (const sequence & rhs)
+{
+    if (this != &rhs)
+    {
+        automutex rlocker(rhs.m_mutex);
+        automutex locker(m_mutex);
+        m_parent                = nullptr;          /* detached copy        */
+        m_masterbus             = nullptr;
+        m_events                = rhs.m_events;     /* may stay deferred    */
+        if (! m_events.deferred())
+            m_events.clear_links();                 /* they point into rhs  */
+        m_triggers              = rhs.m_triggers;
+        m_midi_channel          = rhs.m_midi_channel;
+#ifdef SEQ64_STAZED_TRANSPOSE
+        m_transposable          = rhs.m_transposable;
+#endif
+        m_bus                   = rhs.m_bus;
+        m_playing               = false;
+        m_name                  = rhs.m_name;
+        m_ppqn                  = rhs.m_ppqn;
+        m_length                = rhs.m_length;
+        m_time_beats_per_measure = rhs.m_time_beats_per_measure;
+        m_time_beat_width       = rhs.m_time_beat_width;
+        m_musical_key           = rhs.m_musical_key;
+        m_musical_scale         = rhs.m_musical_scale;
+        m_background_sequence   = rhs.m_background_sequence;
+    }
+}
+
 /**
  *  Modifies the undo-hold container.
  *
@@ -680,7 +742,6 @@ sequence::select_note_events
                     {
                         remove(i);
                         remove(e);
-                        reset_draw_marker();
                         ++result;
                         break;
                     }
@@ -741,7 +802,6 @@ sequence::select_note_events
                     if (action == e_remove_one)
                     {
                         remove(i);
-                        reset_draw_marker();
                         ++result;
                         break;
                     }
@@ -1093,6 +1153,11 @@ sequence::on_queued ()
  *  function.  Its return value and side-effects tell if there's a change in
  *  playing based on triggers, and provides the ticks that bracket it.
  *
+ *  The events of a lazily-loaded sequence that has not been decoded yet
+ *  are not played:  decoding them here would stall the output thread.  The
+ *  triggers and the queue still work, and perform::play() asks the
+ *  prefetcher to decode the sequence next.
+ *
  * \param tick
  *      Provides the current end-tick value.  The tick comes in as a global
  *      tick.
@@ -1145,7 +1210,7 @@ sequence::play
             trigger_turning_off = m_triggers.play(start_tick, end_tick);
         }
     }
-    if (m_playing)                          /* play notes in frame          */
+    if (m_playing && ! m_events.deferred()) /* play notes in frame          */
     {
         midipulse offset = m_length - m_trigger_offset;
         midipulse start_tick_offset = start_tick + offset;
@@ -1155,7 +1220,21 @@ sequence::play
 #ifdef SEQ64_STAZED_TRANSPOSE
         int transpose = get_transposable() ? m_parent->get_transpose() : 0 ;
 #endif
-        event_list::iterator e = m_events.begin();
+
+        /*
+         *  Start at the first event that can fall in the frame, rather than
+         *  walking the whole list each frame.  A pass that holds no such
+         *  event is skipped, just as the walk would wrap past it.
+         */
+
+        midipulse first = start_tick_offset - offset_base;
+        event_list::iterator e = m_events.seek(first);
+        while (e == m_events.end() && ! m_events.empty())
+        {
+            offset_base += m_length;
+            first -= m_length;
+            e = m_events.seek(first);
+        }
         while (e != m_events.end())
         {
             event & er = DREF(e);
@@ -1213,6 +1292,7 @@ sequence::verify_and_link ()
 {
     automutex locker(m_mutex);
     m_events.verify_and_link(m_length);
+    bump_edit_version();
 }
 
 /**
@@ -1251,6 +1331,7 @@ sequence::remove (event_list::iterator i)
         --m_playing_notes[er.get_note()];                   // ugh
     }
     m_events.remove(i);                                     // erase(i)
+    bump_edit_version();
 }
 
 /**
@@ -1276,6 +1357,7 @@ sequence::remove (event & e)
         if (&e == &er)                  /* comparing pointers, not values */
         {
             m_events.remove(i);
+            bump_edit_version();
             break;
         }
     }
@@ -1319,7 +1401,7 @@ sequence::remove_marked ()
 #endif
 
     bool result = m_events.remove_marked();
-    reset_draw_marker();
+    bump_edit_version();
     return result;
 }
 
@@ -1337,7 +1419,6 @@ sequence::mark_selected ()
 {
     automutex locker(m_mutex);
     bool result = m_events.mark_selected();
-    reset_draw_marker();
     return result;
 }
 
@@ -1358,7 +1439,7 @@ sequence::remove_selected ()
     {
         m_events_undo.push(m_events);           /* push_undo() without lock */
         (void) m_events.remove_marked();
-        reset_draw_marker();
+        bump_edit_version();
     }
 }
 
@@ -1635,7 +1716,6 @@ sequence::select_note_events
                     {
                         remove(er);
                         remove(*ev);
-                        reset_draw_marker();
                         ++result;
                         break;
                     }
@@ -1682,7 +1762,6 @@ sequence::select_note_events
                     if (action == e_remove_one)
                     {
                         remove(er);
-                        reset_draw_marker();
                         ++result;
                         break;
                     }
@@ -1813,7 +1892,6 @@ sequence::select_events
                 if (action == e_remove_one)
                 {
                     remove(er);
-                    reset_draw_marker();
                     ++result;
                     break;
                 }
@@ -2565,7 +2643,6 @@ sequence::paste_selected (midipulse tick, int note)
 #endif      // SEQ64_USE_EVENT_MAP
 
         verify_and_link();
-        reset_draw_marker();
         modify();
     }
 }
@@ -2687,6 +2764,7 @@ sequence::change_event_data_range
             {
                 midibpm tempo = note_value_to_tempo(midibyte(newdata));
                 er.set_tempo(tempo);
+                bump_edit_version();
             }
             else
             {
@@ -3016,9 +3094,9 @@ sequence::add_event (const event & er)
 {
     automutex locker(m_mutex);
     bool result = m_events.add(er);     /* post/auto-sorts by time & rank   */
+    bump_edit_version();
     if (result)
     {
-        reset_draw_marker();
         set_dirty();
     }
     else
@@ -3045,9 +3123,28 @@ bool
 sequence::append_event (const event & er)
 {
     automutex locker(m_mutex);
+    bump_edit_version();
     return m_events.append(er);     /* does *not* sort, too time-consuming */
 }
 
+/**
+ *  Moves all of the events of a sorted list into this sequence, which has no
+ *  events yet, without copying or sorting them.  Used in splitting an SMF 0
+ *  track, which fills the lists of all of the channels in one pass.
+ *
+ * \param evl
+ *      Provides the events, which must not be deferred.  It is emptied.
+ */
+
+void
+sequence::take_events (event_list & evl)
+{
+    automutex locker(m_mutex);
+    m_events.take(evl);
+    bump_edit_version();
+    set_dirty();
+}
+
 /**
  *  Adds a event of a given status value and data values, at a given tick
  *  location.
@@ -3121,9 +3218,12 @@ sequence::add_event
  *  Streams the given event.  The event's timestamp is adjusted, if needed.
  *  If recording:
  *
- *      -   If the pattern is playing, the event is added.
+ *      -   If the pattern is playing, the event is pushed onto the
+ *          recording queue, without locking, and is added to the event list
+ *          later by merge_recorded_events().  This keeps the MIDI input
+ *          thread from contending with play() for the sequence mutex.
  *      -   If the pattern is playing and quantized record is in force, the
- *          note's timestamp is altered.
+ *          note's timestamp is altered when it is merged.
  *      -   If not playing, but the event is a Note On or Note Off, we add it
  *          and keep track of it.
  *
@@ -3160,7 +3260,6 @@ sequence::add_event
 bool
 sequence::stream_event (event & ev)
 {
-    automutex locker(m_mutex);
     bool result = channels_match(ev);           /* set if channel matches   */
     if (result)
     {
@@ -3168,7 +3267,9 @@ sequence::stream_event (event & ev)
 
         /*
          * If in overwrite record more, any events after reset should clear
-         * the old items from the previous pass through the loop.
+         * the old items from the previous pass through the loop.  Events
+         * still waiting in the recording queue belong to that previous pass
+         * as well, so they are dropped.
          *
          * TODO:  If the last event was a Note Off, we should clear it here.
          *        How?
@@ -3176,7 +3277,15 @@ sequence::stream_event (event & ev)
 
         if (get_overwrite_rec() && get_loop_reset())
         {
+            automutex locker(m_mutex);
             set_loop_reset(false);
+            spsc_queue<event> * q = m_record_queue.load();
+            if (not_nullptr(q))
+                m_record_discard = q->size();   /* no pops while we lock    */
+
+            m_record_overflow.clear();
+            m_record_overflowing = false;
+
             remove_all();                       /* clear old items          */
         }
 
@@ -3190,8 +3299,31 @@ sequence::stream_event (event & ev)
                 if (ev.is_note_on() && m_rec_vol > SEQ64_PRESERVE_VELOCITY)
                     ev.set_note_velocity(m_rec_vol);    /* modify incoming  */
 
-                add_event(ev);                          /* more locking     */
-                set_dirty();
+                /*
+                 * Hand the event to the recording queue without locking; it
+                 * is folded into the event list later, in a batch, by
+                 * merge_recorded_events().  If the queue is full, the event
+                 * goes to the overflow list, under the lock, as do the ones
+                 * after it until the overflow has been merged.  This thread
+                 * never pops from the queue.
+                 */
+
+                spsc_queue<event> * q =
+                    m_record_queue.load(std::memory_order_acquire);
+
+                if (not_nullptr(q))
+                {
+                    if
+                    (
+                        m_record_overflowing.load(std::memory_order_acquire) ||
+                        ! q->push(ev)
+                    )
+                    {
+                        automutex locker(m_mutex);
+                        m_record_overflow.push_back(ev);
+                        m_record_overflowing = true;
+                    }
+                }
             }
             else
             {
@@ -3200,9 +3332,11 @@ sequence::stream_event (event & ev)
                  * without playback occurring, so we set the generic default
                  * note length and volume to the snap.  If the
                  * recording-volume is SEQ64_DEFAULT_NOTE_ON_VELOCITY, then we
-                 * have to set a default value, 100.
+                 * have to set a default value, 100.  The pattern is not
+                 * playing, so locking here does not hold up the output.
                  */
 
+                automutex locker(m_mutex);
                 if (ev.is_note_on())
                 {
                     bool keepvelocity = m_rec_vol == SEQ64_PRESERVE_VELOCITY;
@@ -3227,46 +3361,215 @@ sequence::stream_event (event & ev)
 
                 if (m_notes_on <= 0)
                     m_last_tick += m_snap_tick;
+
+                link_new();                             /* more locking     */
             }
         }
         if (m_thru)
             put_event_on_bus(ev);                       /* more locking     */
+    }
+    return result;
+}
 
-        link_new();                                     /* more locking     */
-        if (m_quantized_rec && m_parent->is_pattern_playing())
+/**
+ *  Folds the events waiting in the recording queue, and then those in the
+ *  overflow list, into the event list.  This is the deferred half of
+ *  stream_event().  The output thread calls it after each frame it plays
+ *  (see perform::merge_recorded_events()), without waiting for m_mutex:  if
+ *  another thread has the pattern, the events wait for the next frame.  It
+ *  is also called, waiting, when playback stops and whenever recording is
+ *  turned off.  Whoever holds m_mutex is the consumer of the queue.
+ *
+ *  The whole batch is merged in one pass, and only the new events are
+ *  linked, rather than relinking the whole pattern.  In quantized-recording
+ *  mode, only the new notes are quantized; the old code selected the notes
+ *  at each incoming Note Off and then ran quantize_events() over the whole
+ *  pattern.
+ *
+ * \threadsafe
+ *
+ * \param wait
+ *      If false, and another thread holds m_mutex, nothing is merged.  The
+ *      output thread passes false, so that it never blocks on a pattern.
+ *
+ * \return
+ *      Returns the number of events merged.
+ */
+
+int
+sequence::merge_recorded_events (bool wait)
+{
+    int result = 0;
+    spsc_queue<event> * q = m_record_queue.load(std::memory_order_acquire);
+    if (is_nullptr(q))
+        return result;
+
+    if (q->empty() && ! m_record_overflowing.load(std::memory_order_acquire))
+        return result;                          /* the usual case, no lock  */
+
+    if (wait)
+    {
+        automutex locker(m_mutex);
+        result = merge_recorded_locked(*q);
+    }
+    else if (m_mutex.try_lock())
+    {
+        result = merge_recorded_locked(*q);
+        m_mutex.unlock();
+    }
+    return result;
+}
+
+/**
+ *  The body of merge_recorded_events().
+ *
+ * \threadunsafe
+ *      The caller must hold m_mutex.
+ *
+ * \param q
+ *      The recording queue.
+ *
+ * \return
+ *      Returns the number of events merged.
+ */
+
+int
+sequence::merge_recorded_locked (spsc_queue<event> & q)
+{
+    int result = 0;
+    event ev;
+    while (m_record_discard > 0 && q.pop(ev))  /* stale, see stream_event  */
+        --m_record_discard;
+
+    event_list incoming;
+    while (q.pop(ev))
+    {
+        (void) incoming.append(ev);
+        ++result;
+    }
+    for (size_t i = 0; i < m_record_overflow.size(); ++i)
+    {
+        (void) incoming.append(m_record_overflow[i]);
+        ++result;
+    }
+    m_record_overflow.clear();
+    m_record_overflowing = false;
+    if (result > 0)
+    {
+
+        event_list::Iterators added;
+        event_list::Iterators notes;            /* (on, off) pairs          */
+        m_events.merge_new(incoming, added);
+        for (size_t i = 0; i < added.size(); ++i)
         {
-            if (ev.is_note_off())
+            event_list::iterator partner;
+            if (m_events.link_new_event(added[i], partner))
             {
-                midipulse timestamp = ev.get_timestamp();
-                midibyte note = ev.get_note();
-                select_note_events(timestamp, note, timestamp, note, e_select);
-                quantize_events(EVENT_NOTE_ON, 0, m_snap_tick, 1, true);
+                if (m_quantized_rec)
+                {
+                    bool isnoteon = DREF(added[i]).is_note_on();
+                    notes.push_back(isnoteon ? added[i] : partner);
+                    notes.push_back(isnoteon ? partner : added[i]);
+                }
             }
         }
+        for (size_t n = 0; n < notes.size(); n += 2)
+            quantize_recorded_note(notes[n], notes[n + 1]);
+
+        bump_edit_version();
+        set_dirty();
     }
     return result;
 }
 
+/**
+ *  Quantizes one newly-recorded, linked note against the snap value.  The
+ *  arithmetic is that of quantize_events() with a divide value of 1,
+ *  including the Seq32 wrap-around handling of the Note Off.  The original
+ *  events are replaced by their adjusted copies, which are reinserted at
+ *  their sorted positions and relinked.
+ *
+ * \threadunsafe
+ *      The caller must hold m_mutex.
+ *
+ * \param on
+ *      The position of the Note On.
+ *
+ * \param off
+ *      The position of the linked Note Off.
+ */
+
+void
+sequence::quantize_recorded_note
+(
+    event_list::iterator on, event_list::iterator off
+)
+{
+    if (m_snap_tick <= 0)
+        return;
+
+    event eon = DREF(on);
+    event eoff = DREF(off);
+    midipulse t = eon.get_timestamp();
+    midipulse t_remainder = t % m_snap_tick;
+    midipulse t_delta = 0;
+    if (t_remainder < m_snap_tick / 2)
+        t_delta = -t_remainder;
+    else
+        t_delta = m_snap_tick - t_remainder;
+
+    if ((t_delta + t) >= m_length)              /* wrap-around Note On      */
+        t_delta = -t;
+
+    if (t_delta != 0)
+    {
+        midipulse ft = eoff.get_timestamp() + t_delta;
+        if (ft < 0)                             /* unwrap Note Off          */
+            ft += m_length;
+
+        if (ft == m_length)                     /* trim it a little         */
+            ft -= m_note_off_margin;
+
+        if (ft > m_length)                      /* wrap it around           */
+            ft -= m_length;
+
+        eon.set_timestamp(t + t_delta);
+        eoff.set_timestamp(ft);
+        m_events.remove(on);
+        m_events.remove(off);
+
+        event & newon = DREF(m_events.insert_sorted(eon));
+        event & newoff = DREF(m_events.insert_sorted(eoff));
+        newon.link(&newoff);
+        newoff.link(&newon);
+    }
+}
+
 /**
  *  Sets the dirty flags for names, main, and performance.  These flags are
  *  meant for causing user-interface refreshes, not for performance
- *  modification.
+ *  modification.  The change is also published to the parent perform
+ *  object, where the main window and song editor pick it up.
  *
- *  m_dirty_names is set to false in is_dirty_names(); m_dirty_names is set to
- *  false in is_dirty_main(); m_dirty_names is set to false in
+ *  m_dirty_names is set to false in is_dirty_names(); m_dirty_main is set to
+ *  false in is_dirty_main(); m_dirty_perf is set to false in
  *  is_dirty_perf().
  *
- * \threadunsafe
+ * \threadsafe
+ *      Lock-free, so that the output thread can call it.
  */
 
 void
 sequence::set_dirty_mp ()
 {
     m_dirty_names = m_dirty_main = m_dirty_perf = true;
+    if (not_nullptr(m_parent) && m_seq_number >= 0)
+        m_parent->mark_dirty(int(m_seq_number), false);
 }
 
 /**
- *  Call set_dirty_mp() and then sets the dirty flag for editing.
+ *  Sets the dirty flags for names, main, and performance, and the dirty
+ *  flag for editing.
  *
  * \threadsafe
  */
@@ -3274,16 +3577,17 @@ sequence::set_dirty_mp ()
 void
 sequence::set_dirty ()
 {
-    set_dirty_mp();
-    m_dirty_edit = true;
+    m_dirty_names = m_dirty_main = m_dirty_perf = m_dirty_edit = true;
+    if (not_nullptr(m_parent) && m_seq_number >= 0)
+        m_parent->mark_dirty(int(m_seq_number), true);
 }
 
 /**
  *  Returns the value of the dirty names (heh heh) flag, and sets that
- *  flag to false.  Not sure that we need to lock a boolean on modern
- *  processors.
+ *  flag to false.
  *
  * \threadsafe
+ *      Lock-free.
  *
  * \return
  *      Returns the dirty status.
@@ -3292,10 +3596,7 @@ sequence::set_dirty ()
 bool
 sequence::is_dirty_names ()
 {
-    automutex locker(m_mutex);
-    bool result = m_dirty_names;
-    m_dirty_names = false;
-    return result;
+    return m_dirty_names.exchange(false);
 }
 
 /**
@@ -3304,6 +3605,7 @@ sequence::is_dirty_names ()
  *  recording.
  *
  * \threadsafe
+ *      Lock-free.
  *
  * \return
  *      Returns the dirty status.
@@ -3312,10 +3614,7 @@ sequence::is_dirty_names ()
 bool
 sequence::is_dirty_main ()
 {
-    automutex locker(m_mutex);
-    bool result = m_dirty_main;
-    m_dirty_main = false;
-    return result;
+    return m_dirty_main.exchange(false);
 }
 
 /**
@@ -3323,6 +3622,7 @@ sequence::is_dirty_main ()
  *  flag to false.
  *
  * \threadsafe
+ *      Lock-free.
  *
  * \return
  *      Returns the dirty status.
@@ -3331,17 +3631,17 @@ sequence::is_dirty_main ()
 bool
 sequence::is_dirty_perf ()
 {
-    automutex locker(m_mutex);
-    bool result = m_dirty_perf;
-    m_dirty_perf = false;
-    return result;
+    return m_dirty_perf.exchange(false);
 }
 
 /**
  *  Returns the value of the dirty edit flag, and sets that flag to false.
- *  The m_dirty_edit flag is set by the function set_dirty().
+ *  The m_dirty_edit flag is set by the function set_dirty().  The pattern
+ *  editor calls this every timer tick, and it no longer locks the sequence,
+ *  so it never waits on the output thread.
  *
  * \threadsafe
+ *      Lock-free.
  *
  * \return
  *      Returns the dirty status.
@@ -3350,10 +3650,7 @@ sequence::is_dirty_perf ()
 bool
 sequence::is_dirty_edit ()
 {
-    automutex locker(m_mutex);
-    bool result = m_dirty_edit;
-    m_dirty_edit = false;
-    return result;
+    return m_dirty_edit.exchange(false);
 }
 
 /**
@@ -4088,54 +4385,6 @@ sequence::pause (bool song_mode)
         set_playing(state);
 }
 
-/**
- *  This refreshes the draw marker to the first event. It resets the draw marker
- *  so that calls to get_next_note_event() will start from the first event.
- *
- * \warning
- *      This iterator is shared by about four GUI object, and they might
- *      interfere with each other!
- *
- * \threadsafe
- */
-
-void
-sequence::reset_draw_marker ()
-{
-    automutex locker(m_mutex);
-    m_iterator_draw = m_events.begin();
-}
-
-/**
- *  This increments the draw marker.
- *
- * \warning
- *      This iterator is shared by about four GUI object, and they might
- *      interfere with each other!
- *
- * \threadsafe
- */
-
-void
-sequence::inc_draw_marker ()
-{
-    automutex locker(m_mutex);
-    ++m_iterator_draw;
-}
-
-/**
- *  Sets the draw-trigger iterator to the beginning of the trigger list.
- *
- * \threadsafe
- */
-
-void
-sequence::reset_draw_trigger_marker ()
-{
-    automutex locker(m_mutex);
-    m_triggers.reset_draw_trigger_marker();
-}
-
 /**
  *  A new function provided so that we can find the minimum and maximum notes
  *  with only one (not two) traversal of the event list.
@@ -4162,15 +4411,16 @@ sequence::reset_draw_trigger_marker ()
  */
 
 bool
-sequence::get_minmax_note_events (int & lowest, int & highest)
+sequence::get_minmax_note_events (int & lowest, int & highest) const
 {
     automutex locker(m_mutex);
     bool result = false;
     int low = SEQ64_MAX_DATA_VALUE;
     int high = -1;
-    for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
+    event_list::const_iterator i;
+    for (i = m_events.begin(); i != m_events.end(); ++i)
     {
-        event & er = DREF(i);
+        const event & er = DREF(i);
         if (er.is_note_on() || er.is_note_off())
         {
             if (er.get_note() < low)
@@ -4201,132 +4451,199 @@ sequence::get_minmax_note_events (int & lowest, int & highest)
 }
 
 /**
- *  Each call to seqdata() fills the passed references with a events
- *  elements, and returns true.  When it has no more events, returns a
- *  false.
- *
- *  Note that, before the first call to draw a sequence, the
- *  reset_draw_marker() function must be called, to reset m_iterator_draw.
- *
- * \param [out] tick_s
- *      Provides a pointer destination for the start time.
+ *  Hands each drawable item in a time window to a visitor:  linked notes,
+ *  unlinked note-ons and note-offs, and tempos, as the old
+ *  get_next_note_event() function returned them.  This replaces that
+ *  function and the shared draw marker it used, which two views drawing
+ *  the same sequence would corrupt for each other (the tempo track in
+ *  perfroll being the classic victim).  All state is on the stack, so any
+ *  number of views, on any thread, can walk the same sequence.
  *
- * \param [out] tick_f
- *      Provides a pointer destination for the finish time.
+ *  An item is visited if its extent overlaps the window.  The extent of a
+ *  linked note or tempo runs to its linked event, that of a wrapped-around
+ *  note also covers the start of the pattern, that of an unlinked tempo
+ *  runs to the end of the pattern, and that of an unlinked note event is
+ *  just its time.  Rather than walking the whole list, the walk starts at
+ *  tick_s less the longest extent in the list (see event_list::seek()),
+ *  and ends at tick_f.  Items are visited in time order, except for the
+ *  few that the walk cannot reach (see below), which come first.
  *
- * \param [out] note
- *      Provides a pointer destination for the note pitch value
- *      Probably should be a midibyte value.  If the event is the special case
- *      of a tempo event, then this value is the tempo value scaled to 0 to
- *      127 for display purposes.
+ *  The visitor is called with the sequence locked.
  *
- * \param [out] selected
- *      Provides a pointer destination for the selection status of the note.
+ * \param tick_s
+ *      The start of the window.  Use 0 for the whole sequence.
  *
- * \param [out] velocity
- *      Provides a pointer destination for the note velocity.
- *      Probably should be a midibyte value.
+ * \param tick_f
+ *      The end of the window, inclusive.  Use get_length() for the whole
+ *      sequence.
  *
- * \return
- *      Returns a draw_type_t value:  DRAW_NORMAL_LINKED, DRAW_NOTE_ON,
- *      DRAW_NOTE_OFF, or DRAW_FIN.  Note that the new value DRAW_TEMPO could
- *      be returned, as well.
+ * \param visitor
+ *      The function to call for each item.
  */
 
-draw_type_t
-sequence::get_next_note_event
+void
+sequence::visit_notes
 (
-    midipulse & tick_s, midipulse & tick_f,
-    int & note, bool & selected, int & velocity
-)
+    midipulse tick_s, midipulse tick_f, const note_visitor & visitor
+) const
 {
-    tick_f = 0;
-    while (m_iterator_draw != m_events.end())   /* not threadsafe           */
+    automutex locker(m_mutex);
+    midipulse longest = m_events.longest_span();
+    midipulse walkstart = tick_s > longest ? tick_s - longest : 0 ;
+    note_info ni;
+
+    /*
+     * The strays (wrapped notes and unlinked tempos) that the walk will not
+     * reach can still overlap the window:  any that start before the walk,
+     * and wrapped notes that start after the window but end in it.  These
+     * are visited first.
+     */
+
+    const event_list::ConstIterators & strays = m_events.strays();
+    for (std::size_t k = 0; k < strays.size(); ++k)
     {
-        event & drawevent = DREF(m_iterator_draw);
-        bool isnoteon = drawevent.is_note_on();
-        bool islinked = drawevent.is_linked();  /* not get_linked(), idiot! */
-        tick_s   = drawevent.get_timestamp();
-        note     = drawevent.get_note();
-        selected = drawevent.is_selected();
-        velocity = drawevent.get_note_velocity();
-        inc_draw_marker();                      /* go until null or Note-On */
-        if (isnoteon && islinked)
+        const event & e = DREF(strays[k]);
+        midipulse start = e.get_timestamp();
+        if (start >= walkstart && start <= tick_f)
+            continue;                       /* the walk will visit it   */
+
+        bool istempo = e.is_tempo();
+        midipulse finish = istempo ?
+            get_length() : e.get_linked()->get_timestamp() ;
+
+        bool overlaps = istempo ?
+            start < walkstart && finish >= tick_s :
+            start < walkstart || finish >= tick_s ;
+
+        if (overlaps)
         {
-            tick_f = drawevent.get_linked()->get_timestamp();
-            return DRAW_NORMAL_LINKED;
+            ni.ni_type = istempo ? DRAW_TEMPO : DRAW_NORMAL_LINKED;
+            ni.ni_start = start;
+            ni.ni_finish = finish;
+            ni.ni_note = istempo ?
+                int(tempo_to_note_value(e.tempo())) : int(e.get_note()) ;
+
+            ni.ni_selected = e.is_selected();
+            ni.ni_velocity = e.get_note_velocity();
+            visitor(ni);
         }
-        else if (isnoteon && ! islinked)
+    }
+
+    event_list::const_iterator i = m_events.seek(walkstart);
+    for ( ; i != m_events.end(); ++i)
+    {
+        const event & e = DREF(i);
+        midipulse start = e.get_timestamp();
+        if (start > tick_f)
+            break;
+
+        bool isnoteon = e.is_note_on();
+        bool islinked = e.is_linked();
+        midipulse end = start;
+        ni.ni_finish = 0;
+        if (isnoteon && islinked)
         {
-            return DRAW_NOTE_ON;
+            ni.ni_type = DRAW_NORMAL_LINKED;
+            ni.ni_finish = e.get_linked()->get_timestamp();
+            end = ni.ni_finish < start ? get_length() : ni.ni_finish ;
         }
-        else if (drawevent.is_note_off() && ! islinked)
+        else if (isnoteon)
+            ni.ni_type = DRAW_NOTE_ON;
+        else if (e.is_note_off() && ! islinked)
+            ni.ni_type = DRAW_NOTE_OFF;
+        else if (e.is_tempo())
         {
-            return DRAW_NOTE_OFF;
+            ni.ni_type = DRAW_TEMPO;
+            ni.ni_finish = islinked ?
+                e.get_linked()->get_timestamp() : get_length() ;
+
+            end = ni.ni_finish;
         }
-        else if (drawevent.is_tempo())
-        {
-            midibpm bpm = drawevent.tempo();
-            midibyte notebyte = tempo_to_note_value(bpm);
-            note = int(notebyte);
-            if (islinked)
-                tick_f = drawevent.get_linked()->get_timestamp();
-            else
-                tick_f = get_length();
+        else
+            continue;                       /* linked Note Off, etc.    */
 
-            /*
-             * Tempo needs to be attained.  This is good only for drawing a
-             * horizontal tempo line; we need a way to return both a starting
-             * tempo and ending tempo.  Return the latter in velocity?
-             */
+        if (end < tick_s)
+            continue;                       /* ends before the window   */
 
-            return DRAW_TEMPO;
-        }
+        ni.ni_start = start;
+        ni.ni_selected = e.is_selected();
+        ni.ni_velocity = e.get_note_velocity();
+        ni.ni_note = ni.ni_type == DRAW_TEMPO ?
+            int(tempo_to_note_value(e.tempo())) : int(e.get_note()) ;
+
+        visitor(ni);
     }
-    return DRAW_FIN;
 }
 
 /**
- *  Get the next event in the event list.  Then set the status and control
- *  character parameters using that event.  This overload is used only in
- *  seqedit::popup_event_menu().
+ *  Hands each event in a time window that matches the given status (and
+ *  controller) to a visitor, in time order.  Tempo events always match, as
+ *  in get_next_event_ex().  The walk starts with a binary search, and the
+ *  visitor is called with the sequence locked.
+ *
+ * \param tick_s
+ *      The start of the window.
+ *
+ * \param tick_f
+ *      The end of the window, inclusive.
  *
  * \param status
- *      Provides a pointer to the MIDI status byte to be set, as a way to
- *      retrieve the event.
+ *      The type of event to visit.  The special value EVENT_ANY can be
+ *      provided so that no event statuses are filtered.
  *
  * \param cc
- *      The return pointer for the control value.
+ *      The continuous controller value that might be desired.
  *
- * \return
- *      Returns true if the data is useable, and false if there are no more
- *      events.
+ * \param visitor
+ *      The function to call for each event.
  */
 
-bool
-sequence::get_next_event (midibyte & status, midibyte & cc)
+void
+sequence::visit_events
+(
+    midipulse tick_s, midipulse tick_f, midibyte status, midibyte cc,
+    const event_visitor & visitor
+) const
 {
-    // automutex locker(m_mutex);                   // WILL IT HELP?? No.
-    while (m_iterator_draw != m_events.end())       /* NOT THREADSAFE!!!    */
+    automutex locker(m_mutex);
+    event_list::const_iterator i = m_events.seek(tick_s);
+    for ( ; i != m_events.end(); ++i)
     {
-        midibyte j;
-        event & drawevent = DREF(m_iterator_draw);
-        status = drawevent.get_status();
-        drawevent.get_data(cc, j);
-        inc_draw_marker();
-        return true;                /* we have a good one; update and return */
+        const event & e = DREF(i);
+        if (e.get_timestamp() > tick_f)
+            break;
+
+        bool ok = e.is_tempo() || status == EVENT_ANY;
+        if (! ok && e.get_status() == status)
+        {
+            midibyte d0;
+            e.get_data(d0);
+            ok = event::is_desired_cc_or_not_cc(status, cc, d0);
+        }
+        if (ok)
+            visitor(e);
     }
-    return false;
 }
 
 /**
- *  Reset the caller's iterator.
+ *  Sets the caller's iterator, for get_next_event_ex(), to the first event
+ *  at or after the given time.  A view that draws only point events (data,
+ *  not notes) can start at the left edge of its window this way, instead
+ *  of at the start of the sequence.
+ *
+ * \param [out] evi
+ *      The iterator to set.
+ *
+ * \param tick
+ *      The time to start at.  Defaults to 0.
  */
 
 void
-sequence::reset_ex_iterator (event_list::const_iterator & evi)
+sequence::reset_ex_iterator (event_list::const_iterator & evi, midipulse tick)
+    const
 {
-    evi = m_events.begin();
+    automutex locker(m_mutex);
+    evi = tick > 0 ? m_events.seek(tick) : m_events.begin() ;
 }
 
 /**
@@ -4424,18 +4741,36 @@ sequence::get_next_event_ex
 }
 
 /**
- *  Get the next trigger in the trigger list, and set the parameters based
- *  on that trigger.
+ *  Hands each trigger that overlaps a time window to a visitor, in time
+ *  order.  This replaces the shared draw-trigger iterator.  The visitor is
+ *  called with the sequence locked.
+ *
+ * \param tick_s
+ *      The start of the window.
+ *
+ * \param tick_f
+ *      The end of the window, inclusive.
+ *
+ * \param visitor
+ *      The function to call for each trigger.
  */
 
-bool
-sequence::get_next_trigger
+void
+sequence::visit_triggers
 (
-    midipulse & tick_on, midipulse & tick_off, bool & selected,
-    midipulse & offset
-)
+    midipulse tick_s, midipulse tick_f, const trigger_visitor & visitor
+) const
 {
-    return m_triggers.next(tick_on, tick_off, selected, offset);
+    automutex locker(m_mutex);
+    const triggers::List & tl = m_triggers.triggerlist();
+    for (triggers::List::const_iterator t = tl.begin(); t != tl.end(); ++t)
+    {
+        if (t->tick_start() > tick_f)
+            break;
+
+        if (t->tick_end() >= tick_s)
+            visitor(*t);
+    }
 }
 
 /**
@@ -4449,6 +4784,7 @@ sequence::remove_all ()
     automutex locker(m_mutex);
     m_events.clear();
     m_events.unmodify();
+    bump_edit_version();
 }
 
 /**
@@ -4592,10 +4928,8 @@ sequence::set_length (midipulse len, bool adjust_triggers, bool verify)
         m_triggers.adjust_offsets_to_length(len);
 
     if (verify)
-    {
         verify_and_link();
-        reset_draw_marker();
-    }
+
     if (was_playing)                    /* start up and refresh             */
         set_playing(true);
 }
@@ -4690,8 +5024,19 @@ void
 sequence::set_recording (bool r)
 {
     automutex locker(m_mutex);
+    if (r && is_nullptr(m_record_queue.load()))
+    {
+        m_record_queue.store
+        (
+            new spsc_queue<event>(SEQ64_RECORD_QUEUE_SIZE),
+            std::memory_order_release
+        );
+    }
+
     m_recording = r;
     m_notes_on = 0;
+    if (! r)
+        (void) merge_recorded_events();         /* flush the stragglers     */
 }
 
 /**
@@ -4922,8 +5267,10 @@ sequence::put_event_on_bus (event & ev)
 }
 
 /**
- *  Sends a note-off event for all active notes.  This function does not
- *  bother checking if m_masterbus is a null pointer.
+ *  Sends a note-off event for all active notes.  Does nothing if
+ *  m_masterbus is a null pointer, as it is while midifile decodes a track
+ *  into a sequence that is not yet installed; such a sequence has no
+ *  playing notes anyway.
  *
  * \threadsafe
  */
@@ -4932,6 +5279,9 @@ void
 sequence::off_playing_notes ()
 {
     automutex locker(m_mutex);
+    if (is_nullptr(m_masterbus))
+        return;
+
     event e;
     for (int x = 0; x < c_midi_notes; ++x)
     {
@@ -5143,6 +5493,7 @@ sequence::apply_song_transpose ()
             if (er.is_note())                       /* also aftertouch      */
                 er.transpose_note(transpose);
         }
+        bump_edit_version();
         set_dirty();
     }
 }
@@ -5421,7 +5772,6 @@ sequence::copy_events (const event_list & newevents)
         // WTF?
     }
 
-    m_iterator_draw = m_events.begin();     /* same as in reset_draw_marker */
     if (! m_events.empty())                 /* need at least 1 (2?) events  */
     {
         /*
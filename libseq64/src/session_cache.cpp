@@ -0,0 +1,664 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          session_cache.cpp
+ *
+ *  This module defines the class that keeps a binary copy of the tracks of a
+ *  loaded MIDI file.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  The cache file is written in the native byte order, since it never
+ *  leaves the machine; a byte-order mark in the header rejects a cache
+ *  copied from a different kind of machine.  The layout, all integers
+ *  fixed-size:
+ *
+\verbatim
+    Header:     magic, version, byte-order mark,
+                MIDI file size, modification time, content hash,
+                PPQN, default-PPQN flag, buss override,
+                offset of the proprietary track, track count
+    Track:      track index, chunk ID, offset, length, sequence number,
+                beats/bar, beat width, clocks/metronome, 32nds/quarter,
+                tempo, has-sequence flag
+    Sequence:   PPQN, name, length, buss, channel, beats/bar, beat width,
+                clocks/metronome, us/quarter-note, key, scale, background
+                sequence, transposable flag, triggers (start, end, offset),
+                events (timestamp, status, channel, data bytes, index of
+                the linked event, SysEx/Meta data)
+    Trailer:    hash of everything above, magic
+\endverbatim
+ */
+
+#include <cstdio>                       /* std::rename(), std::remove()     */
+#include <cstring>                      /* std::memcpy()                    */
+#include <fstream>                      /* std::ofstream                    */
+#include <unordered_map>                /* std::unordered_map<>             */
+#include <stdint.h>                     /* uint32_t, uint64_t, int64_t      */
+#include <sys/stat.h>                   /* stat()                           */
+
+#include "easy_macros.h"                /* nullptr, errprint()              */
+#include "event_list.hpp"               /* seq64::event_list                */
+#include "file_functions.hpp"           /* make_directory()                 */
+#include "mapped_file.hpp"              /* seq64::mapped_file               */
+#include "sequence.hpp"                 /* seq64::sequence                  */
+#include "session_cache.hpp"            /* seq64::session_cache             */
+#include "settings.hpp"                 /* seq64::rc(), seq64::usr()        */
+
+/**
+ *  The file-format values.  Bump the version whenever the layout, or the
+ *  meaning of anything in it, changes.
+ */
+
+#define SEQ64_SESSION_CACHE_MAGIC       0x43343653u     /* "S64C"       */
+#define SEQ64_SESSION_CACHE_VERSION     1u
+#define SEQ64_SESSION_CACHE_BOM         0x01020304u
+
+/**
+ *  The subdirectory of the configuration directory that holds the caches,
+ *  and the extension of a cache file.
+ */
+
+#define SEQ64_SESSION_CACHE_DIR         "session-cache"
+#define SEQ64_SESSION_CACHE_EXT         ".s64cache"
+
+/**
+ *  Marks an event that has no link.
+ */
+
+#define SEQ64_SESSION_CACHE_NO_LINK     0xFFFFFFFFu
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  A 64-bit FNV-1a hash, taken a word at a time for speed.  It only needs
+ *  to notice that the file has changed, not resist an adversary.
+ *
+ * \param data
+ *      The bytes to hash.
+ *
+ * \param size
+ *      The number of bytes.
+ *
+ * \return
+ *      Returns the hash value.
+ */
+
+static uint64_t
+content_hash (const midibyte * data, std::size_t size)
+{
+    const uint64_t prime = 0x100000001b3ull;
+    uint64_t result = 0xcbf29ce484222325ull;
+    std::size_t words = size / sizeof(uint64_t);
+    for (std::size_t w = 0; w < words; ++w)
+    {
+        uint64_t word;
+        std::memcpy(&word, data + w * sizeof word, sizeof word);
+        result = (result ^ word) * prime;
+    }
+    for (std::size_t i = words * sizeof(uint64_t); i < size; ++i)
+        result = (result ^ data[i]) * prime;
+
+    return result;
+}
+
+/**
+ *  Appends the bytes of a value to the output buffer.
+ */
+
+template <typename T>
+static void
+put (std::vector<char> & buffer, T value)
+{
+    const char * p = reinterpret_cast<const char *>(&value);
+    buffer.insert(buffer.end(), p, p + sizeof value);
+}
+
+/**
+ *  Reads values from the mapped cache file, refusing to run past its end.
+ *  Once a read fails, ok() stays false and every later read returns zero.
+ */
+
+class cache_reader
+{
+
+private:
+
+    const midibyte * m_data;
+    std::size_t m_size;
+    std::size_t m_pos;
+    bool m_ok;
+
+public:
+
+    cache_reader (const midibyte * data, std::size_t size)
+     :
+        m_data  (data),
+        m_size  (size),
+        m_pos   (0),
+        m_ok    (data != nullptr)
+    {
+        // Empty body
+    }
+
+    bool ok () const
+    {
+        return m_ok;
+    }
+
+    const midibyte * take (std::size_t len)
+    {
+        if (m_ok && len <= m_size - m_pos)
+        {
+            const midibyte * result = m_data + m_pos;
+            m_pos += len;
+            return result;
+        }
+        m_ok = false;
+        return nullptr;
+    }
+
+    template <typename T>
+    T get ()
+    {
+        T result = T(0);
+        const midibyte * p = take(sizeof result);
+        if (not_nullptr(p))
+            std::memcpy(&result, p, sizeof result);
+
+        return result;
+    }
+
+};          // class cache_reader
+
+/**
+ *  Gets the size and modification time of a file.
+ *
+ * \return
+ *      Returns true if the file exists.
+ */
+
+static bool
+file_stamp (const std::string & filename, uint64_t & size, int64_t & mtime)
+{
+    struct stat st;
+    bool result = stat(filename.c_str(), &st) == 0;
+    if (result)
+    {
+        size = uint64_t(st.st_size);
+        mtime = int64_t(st.st_mtime);
+    }
+    return result;
+}
+
+/**
+ *  Builds the cache-file name for a MIDI file: the base name of the file,
+ *  plus a hash of its full path, so that files with the same name in
+ *  different directories do not collide.
+ *
+ * \param midifilename
+ *      The full path to the MIDI file.
+ *
+ * \return
+ *      Returns the full path to the cache file, or an empty string if the
+ *      cache directory cannot be created.
+ */
+
+static std::string
+cache_file_name (const std::string & midifilename)
+{
+    std::string result;
+    std::string dir = rc().home_config_directory();
+    if (! dir.empty())
+    {
+        dir += SEQ64_SESSION_CACHE_DIR;
+        if (make_directory(dir))
+        {
+            const midibyte * name =
+                reinterpret_cast<const midibyte *>(midifilename.data());
+
+            char hash[24];
+            snprintf
+            (
+                hash, sizeof hash, "-%016llx",
+                (unsigned long long) content_hash(name, midifilename.size())
+            );
+            std::string::size_type slash = midifilename.find_last_of("/\\");
+            std::string base = slash == std::string::npos ?
+                midifilename : midifilename.substr(slash + 1) ;
+
+            result = dir + "/" + base + hash + SEQ64_SESSION_CACHE_EXT;
+        }
+    }
+    return result;
+}
+
+/**
+ *  Principal constructor.
+ *
+ * \param midifilename
+ *      The full path to the MIDI file being loaded.
+ *
+ * \param ppqn
+ *      The PPQN that the events are scaled to, midifile::m_ppqn.
+ *
+ * \param use_default_ppqn
+ *      The midifile::m_use_default_ppqn flag, which affects trigger scaling.
+ */
+
+session_cache::session_cache
+(
+    const std::string & midifilename,
+    int ppqn,
+    bool use_default_ppqn
+) :
+    m_midi_name         (midifilename),
+    m_cache_name        (cache_file_name(midifilename)),
+    m_ppqn              (ppqn),
+    m_use_default_ppqn  (use_default_ppqn),
+    m_buss_override     (int(usr().midi_buss_override())),
+    m_tracks            (),
+    m_owns_sequences    (false)
+{
+    // Empty body
+}
+
+/**
+ *  Deletes any sequences rebuilt by load() that the caller did not take.
+ */
+
+session_cache::~session_cache ()
+{
+    clear();
+}
+
+/**
+ *  Empties the track list, deleting the sequences that this object owns.
+ */
+
+void
+session_cache::clear ()
+{
+    if (m_owns_sequences)
+    {
+        std::vector<track_info>::iterator ti;
+        for (ti = m_tracks.begin(); ti != m_tracks.end(); ++ti)
+            delete ti->ti_seq;
+    }
+    m_tracks.clear();
+    m_owns_sequences = false;
+}
+
+/**
+ *  Writes the logged tracks to the cache file.  The file is written under a
+ *  temporary name and renamed into place, so that a reader never sees a
+ *  partial cache.
+ *
+ * \param data
+ *      The contents of the MIDI file, for the content hash.
+ *
+ * \param size
+ *      The size of the MIDI file.
+ *
+ * \param propoffset
+ *      The offset of the proprietary track in the MIDI file, which is where
+ *      the track parsing stopped.
+ *
+ * \return
+ *      Returns true if the cache file was written.
+ */
+
+bool
+session_cache::store (const midibyte * data, std::size_t size, int propoffset)
+{
+    uint64_t filesize;
+    int64_t mtime;
+    if (m_cache_name.empty() || ! file_stamp(m_midi_name, filesize, mtime))
+        return false;
+
+    if (filesize != uint64_t(size))
+        return false;
+
+    std::vector<char> buffer;
+    buffer.reserve(size * 2);
+    put(buffer, uint32_t(SEQ64_SESSION_CACHE_MAGIC));
+    put(buffer, uint32_t(SEQ64_SESSION_CACHE_VERSION));
+    put(buffer, uint32_t(SEQ64_SESSION_CACHE_BOM));
+    put(buffer, filesize);
+    put(buffer, mtime);
+    put(buffer, content_hash(data, size));
+    put(buffer, int32_t(m_ppqn));
+    put(buffer, uint8_t(m_use_default_ppqn));
+    put(buffer, int32_t(m_buss_override));
+    put(buffer, int64_t(propoffset));
+    put(buffer, uint32_t(m_tracks.size()));
+
+    std::unordered_map<const event *, uint32_t> indices;
+    std::vector<track_info>::const_iterator ti;
+    for (ti = m_tracks.begin(); ti != m_tracks.end(); ++ti)
+    {
+        put(buffer, int32_t(ti->ti_track));
+        put(buffer, uint32_t(ti->ti_id));
+        put(buffer, int32_t(ti->ti_offset));
+        put(buffer, int32_t(ti->ti_length));
+        put(buffer, int32_t(ti->ti_seqnum));
+        put(buffer, int32_t(ti->ti_beats_per_bar));
+        put(buffer, int32_t(ti->ti_beat_width));
+        put(buffer, int32_t(ti->ti_clocks_per_metronome));
+        put(buffer, int32_t(ti->ti_32nds_per_quarter));
+        put(buffer, ti->ti_tempo_us);
+        put(buffer, uint8_t(not_nullptr(ti->ti_seq)));
+        if (is_nullptr(ti->ti_seq))
+            continue;
+
+        const sequence & seq = *ti->ti_seq;
+        const std::string & name = seq.name();
+        put(buffer, int32_t(seq.get_ppqn()));
+        put(buffer, uint32_t(name.size()));
+        buffer.insert(buffer.end(), name.begin(), name.end());
+        put(buffer, int64_t(seq.get_length()));
+        put(buffer, int32_t(seq.get_midi_bus()));
+        put(buffer, uint8_t(seq.get_midi_channel()));
+        put(buffer, int32_t(seq.get_beats_per_bar()));
+        put(buffer, int32_t(seq.get_beat_width()));
+        put(buffer, int32_t(seq.clocks_per_metronome()));
+        put(buffer, int64_t(seq.us_per_quarter_note()));
+        put(buffer, uint8_t(seq.musical_key()));
+        put(buffer, uint8_t(seq.musical_scale()));
+        put(buffer, int32_t(seq.background_sequence()));
+#ifdef SEQ64_STAZED_TRANSPOSE
+        put(buffer, uint8_t(seq.get_transposable()));
+#else
+        put(buffer, uint8_t(0));
+#endif
+
+        const triggers::List & trigs = seq.triggerlist();
+        put(buffer, uint32_t(trigs.size()));
+        triggers::List::const_iterator tr;
+        for (tr = trigs.begin(); tr != trigs.end(); ++tr)
+        {
+            put(buffer, int64_t(tr->tick_start()));
+            put(buffer, int64_t(tr->tick_end()));
+            put(buffer, int64_t(tr->offset()));
+        }
+
+        const event_list & evl = seq.events();
+        uint32_t index = 0;
+        indices.clear();
+        event_list::const_iterator ei;
+        for (ei = evl.begin(); ei != evl.end(); ++ei)
+            indices[&DREF(ei)] = index++;
+
+        put(buffer, uint32_t(index));
+        for (ei = evl.begin(); ei != evl.end(); ++ei)
+        {
+            const event & e = DREF(ei);
+            midibyte d0, d1;
+            e.get_data(d0, d1);
+            uint32_t link = SEQ64_SESSION_CACHE_NO_LINK;
+            if (e.is_linked())
+            {
+                std::unordered_map<const event *, uint32_t>::const_iterator li =
+                    indices.find(e.get_linked());
+
+                if (li != indices.end())
+                    link = li->second;
+            }
+            put(buffer, int64_t(e.get_timestamp()));
+            put(buffer, uint8_t(e.get_status()));
+            put(buffer, uint8_t(e.get_channel()));
+            put(buffer, uint8_t(d0));
+            put(buffer, uint8_t(d1));
+            put(buffer, link);
+
+            const event::SysexContainer & sysex = e.get_sysex();
+            put(buffer, uint32_t(sysex.size()));
+            if (! sysex.empty())
+                buffer.insert(buffer.end(), sysex.begin(), sysex.end());
+        }
+    }
+    put
+    (
+        buffer,
+        content_hash
+        (
+            reinterpret_cast<const midibyte *>(&buffer[0]), buffer.size()
+        )
+    );
+    put(buffer, uint32_t(SEQ64_SESSION_CACHE_MAGIC));
+
+    std::string tempname = m_cache_name + ".tmp";
+    std::ofstream file
+    (
+        tempname.c_str(), std::ios::out | std::ios::binary | std::ios::trunc
+    );
+    bool result = file.is_open();
+    if (result)
+    {
+        file.write(&buffer[0], std::streamsize(buffer.size()));
+        file.close();
+        result = ! file.fail();
+    }
+    if (result)
+        result = std::rename(tempname.c_str(), m_cache_name.c_str()) == 0;
+
+    if (! result)
+    {
+        (void) std::remove(tempname.c_str());
+        errprint("could not write the session cache");
+    }
+    return result;
+}
+
+/**
+ *  Rebuilds the tracks from the cache file, if it is valid for the MIDI
+ *  file.  The events are added in their stored order, and their links are
+ *  restored from the stored indices, so that no sorting or linking is
+ *  needed.
+ *
+ * \param data
+ *      The contents of the MIDI file, for the content hash.
+ *
+ * \param size
+ *      The size of the MIDI file.
+ *
+ * \param [out] propoffset
+ *      Set to the offset of the proprietary track in the MIDI file.
+ *
+ * \return
+ *      Returns true if the cache was valid and the tracks were rebuilt.
+ *      They are then available from tracks(); the caller takes each
+ *      sequence by nulling its ti_seq pointer.
+ */
+
+bool
+session_cache::load (const midibyte * data, std::size_t size, int & propoffset)
+{
+    uint64_t filesize;
+    int64_t mtime;
+    clear();
+    if (m_cache_name.empty() || ! file_stamp(m_midi_name, filesize, mtime))
+        return false;
+
+    mapped_file cachefile;
+    if (! cachefile.open(m_cache_name))
+        return false;
+
+    cache_reader in(cachefile.data(), cachefile.size());
+    bool result =
+        in.get<uint32_t>() == SEQ64_SESSION_CACHE_MAGIC &&
+        in.get<uint32_t>() == SEQ64_SESSION_CACHE_VERSION &&
+        in.get<uint32_t>() == SEQ64_SESSION_CACHE_BOM &&
+        in.get<uint64_t>() == filesize && filesize == uint64_t(size) &&
+        in.get<int64_t>() == mtime &&
+        in.get<uint64_t>() == content_hash(data, size) &&
+        in.get<int32_t>() == m_ppqn &&
+        in.get<uint8_t>() == uint8_t(m_use_default_ppqn) &&
+        in.get<int32_t>() == m_buss_override;
+
+    if (! result)
+        return false;
+
+    /*
+     * The checksum of the cache itself precedes the trailing magic number.
+     * Check it before building anything, so that a damaged cache is just
+     * ignored.
+     */
+
+    const std::size_t trailer = sizeof(uint64_t) + sizeof(uint32_t);
+    std::size_t payload = cachefile.size() - trailer;
+    cache_reader check(cachefile.data() + payload, trailer);
+    if (check.get<uint64_t>() != content_hash(cachefile.data(), payload))
+        return false;
+
+    int64_t offset = in.get<int64_t>();
+    uint32_t trackcount = in.get<uint32_t>();
+    if (offset < 0 || uint64_t(offset) > filesize)
+        return false;
+
+    propoffset = int(offset);
+    m_owns_sequences = true;
+    std::vector<event *> events;
+    for (uint32_t t = 0; t < trackcount && in.ok(); ++t)
+    {
+        track_info ti;
+        ti.ti_track = in.get<int32_t>();
+        ti.ti_id = midilong(in.get<uint32_t>());
+        ti.ti_offset = in.get<int32_t>();
+        ti.ti_length = in.get<int32_t>();
+        ti.ti_seqnum = in.get<int32_t>();
+        ti.ti_beats_per_bar = in.get<int32_t>();
+        ti.ti_beat_width = in.get<int32_t>();
+        ti.ti_clocks_per_metronome = in.get<int32_t>();
+        ti.ti_32nds_per_quarter = in.get<int32_t>();
+        ti.ti_tempo_us = in.get<double>();
+        ti.ti_seq = nullptr;
+        bool hasseq = in.get<uint8_t>() != 0;
+        if (! hasseq)
+        {
+            m_tracks.push_back(ti);
+            continue;
+        }
+
+        sequence * s = new sequence(in.get<int32_t>());
+        ti.ti_seq = s;
+        m_tracks.push_back(ti);                 /* owned; freed if bad  */
+
+        sequence & seq = *s;
+        uint32_t namelen = in.get<uint32_t>();
+        const midibyte * name = in.take(namelen);
+        if (not_nullptr(name))
+            seq.set_name(std::string(reinterpret_cast<const char *>(name), namelen));
+
+        midipulse length = midipulse(in.get<int64_t>());
+        seq.set_midi_bus(char(in.get<int32_t>()));
+        seq.set_midi_channel(in.get<uint8_t>());
+        seq.set_beats_per_bar(in.get<int32_t>());
+        seq.set_beat_width(in.get<int32_t>());
+        seq.clocks_per_metronome(in.get<int32_t>());
+        seq.us_per_quarter_note(long(in.get<int64_t>()));
+        seq.musical_key(in.get<uint8_t>());
+        seq.musical_scale(in.get<uint8_t>());
+        seq.background_sequence(in.get<int32_t>());
+#ifdef SEQ64_STAZED_TRANSPOSE
+        seq.set_transposable(in.get<uint8_t>() != 0);
+#else
+        (void) in.get<uint8_t>();
+#endif
+        seq.set_length(length, false, false);   /* no relinking         */
+
+        uint32_t trigcount = in.get<uint32_t>();
+        for (uint32_t i = 0; i < trigcount && in.ok(); ++i)
+        {
+            midipulse start = midipulse(in.get<int64_t>());
+            midipulse end = midipulse(in.get<int64_t>());
+            midipulse offset = midipulse(in.get<int64_t>());
+            seq.add_trigger(start, end - start + 1, offset, false);
+        }
+
+        uint32_t eventcount = in.get<uint32_t>();
+        if (! in.ok())
+            break;
+
+        event_list & evl = seq.events();
+        std::vector<uint32_t> links;
+        events.clear();
+        events.reserve(eventcount);
+        links.reserve(eventcount);
+        for (uint32_t i = 0; i < eventcount && in.ok(); ++i)
+        {
+            event e;
+            e.set_timestamp(midipulse(in.get<int64_t>()));
+            midibyte status = in.get<uint8_t>();
+            midibyte channel = in.get<uint8_t>();
+            e.set_status(status, channel);
+
+            midibyte d0 = in.get<uint8_t>();
+            midibyte d1 = in.get<uint8_t>();
+            e.set_data(d0, d1);
+            links.push_back(in.get<uint32_t>());
+
+            uint32_t sysexlen = in.get<uint32_t>();
+            if (sysexlen > 0)
+            {
+                const midibyte * sx = in.take(sysexlen);
+                if (not_nullptr(sx))
+                    e.set_sysex(const_cast<midibyte *>(sx), int(sysexlen));
+            }
+            events.push_back(&evl.append_in_order(e));
+        }
+        for (std::size_t i = 0; i < events.size() && in.ok(); ++i)
+        {
+            if (links[i] != SEQ64_SESSION_CACHE_NO_LINK)
+            {
+                if (links[i] < events.size())
+                    events[i]->link(events[links[i]]);
+                else
+                    result = false;
+            }
+        }
+    }
+    if (result)
+    {
+        (void) in.get<uint64_t>();              /* checked above        */
+        result = in.ok() && in.get<uint32_t>() == SEQ64_SESSION_CACHE_MAGIC;
+    }
+
+    if (! result)
+        clear();                                /* parse the MIDI file  */
+
+    return result;
+}
+
+}           // namespace seq64
+
+/*
+ * session_cache.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
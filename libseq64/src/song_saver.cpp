@@ -0,0 +1,270 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          song_saver.cpp
+ *
+ *  This module defines the class that saves a song on a background thread.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  See the song_saver.hpp module for the overview.
+ */
+
+#include "easy_macros.h"                /* nullptr, not_nullptr()           */
+#include "midifile.hpp"                 /* seq64::midifile                  */
+#include "perform.hpp"                  /* seq64::perform                   */
+#include "song_saver.hpp"               /* seq64::song_saver                */
+#include "song_snapshot.hpp"            /* seq64::song_snapshot             */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Default constructor.  No save is running.
+ */
+
+song_saver::song_saver ()
+ :
+    m_perform           (nullptr),
+    m_thread            (),
+    m_thread_launched   (false),
+    m_status            (SAVE_IDLE),
+    m_snapshot          (nullptr),
+    m_filename          (),
+    m_ppqn              (0),
+    m_oldformat         (false),
+    m_globalbgs         (true),
+    m_autosave          (false),
+    m_result            (false),
+    m_error_message     ()
+{
+    // Empty body
+}
+
+/**
+ *  Lets any running save finish, so that the file is not left half-written.
+ */
+
+song_saver::~song_saver ()
+{
+    (void) wait();
+}
+
+/**
+ *  Starts saving the song.  The snapshot is taken here, on the caller's
+ *  thread, which must be the thread that edits the song.  Everything else
+ *  happens on the save thread.
+ *
+ *  For a normal save, the "modified" flag is cleared at once, so that edits
+ *  made during the save mark the song as modified again.  If the save fails,
+ *  finished() sets the flag again.
+ *
+ * \param p
+ *      The performance to save.
+ *
+ * \param filename
+ *      The full path to the destination file.
+ *
+ * \param ppqn
+ *      The PPQN to write; see the midifile constructor.
+ *
+ * \param oldformat
+ *      If true, write the legacy Seq24 format.
+ *
+ * \param globalbgs
+ *      If true, write the global key, scale, and background sequence.
+ *
+ * \param autosave
+ *      If true, this is a backup copy, and the "modified" flag is left
+ *      alone.
+ *
+ * \return
+ *      Returns true if the save was started.  It is refused if another save
+ *      is running, or if the song has no active sequences.
+ */
+
+bool
+song_saver::start
+(
+    perform & p,
+    const std::string & filename,
+    int ppqn,
+    bool oldformat,
+    bool globalbgs,
+    bool autosave
+)
+{
+    if (busy())
+        return false;
+
+    song_snapshot * snapshot = new song_snapshot();
+    if (snapshot->take(p) == 0)
+    {
+        delete snapshot;
+        return false;
+    }
+
+    m_perform = &p;
+    m_snapshot = snapshot;
+    m_filename = filename;
+    m_ppqn = ppqn;
+    m_oldformat = oldformat;
+    m_globalbgs = globalbgs;
+    m_autosave = autosave;
+    m_result = false;
+    m_error_message.clear();
+    if (! autosave)
+        p.is_modified(false);
+
+    m_status = SAVE_RUNNING;
+    int err = pthread_create(&m_thread, NULL, save_thread_func, this);
+    if (err == 0)
+        m_thread_launched = true;
+    else
+        write();                        /* no thread, save right here   */
+
+    return true;
+}
+
+/**
+ *  Writes the snapshot to the file, then marks the save as done.  Runs on
+ *  the save thread.
+ */
+
+void
+song_saver::write ()
+{
+    midifile f(m_filename, m_ppqn, m_oldformat, m_globalbgs);
+    m_result = f.write(*m_snapshot);
+    if (! m_result)
+    {
+        m_error_message = f.error_message();
+        if (m_error_message.empty())
+            m_error_message = "Error writing MIDI file";
+    }
+    m_status = SAVE_DONE;               /* publishes the results        */
+}
+
+/**
+ *  The save thread's function.
+ *
+ * \param mysaver
+ *      The song_saver object, cast to void.
+ *
+ * \return
+ *      Always returns nullptr.
+ */
+
+void *
+song_saver::save_thread_func (void * mysaver)
+{
+    song_saver * s = static_cast<song_saver *>(mysaver);
+    s->write();
+    return nullptr;
+}
+
+/**
+ *  Joins the save thread, frees the snapshot, and hands out the outcome.
+ *  On the failure of a normal save, marks the song as modified again.  The
+ *  saver is then idle.
+ */
+
+void
+song_saver::collect (bool & ok, std::string & filename, std::string & errmsg)
+{
+    if (m_thread_launched)
+    {
+        pthread_join(m_thread, NULL);
+        m_thread_launched = false;
+    }
+    delete m_snapshot;
+    m_snapshot = nullptr;
+    ok = m_result;
+    filename = m_filename;
+    errmsg = m_error_message;
+    if (! m_result && ! m_autosave && not_nullptr(m_perform))
+        m_perform->is_modified(true);
+
+    m_status = SAVE_IDLE;
+}
+
+/**
+ *  Checks, without blocking, whether the save has finished.  Meant to be
+ *  polled from the GUI timer.  Each save is reported once.
+ *
+ * \param [out] ok
+ *      Set to true if the file was written.
+ *
+ * \param [out] filename
+ *      Set to the name of the file.
+ *
+ * \param [out] errmsg
+ *      Set to the error message, if the save failed.
+ *
+ * \return
+ *      Returns true if a save has finished since the last call, in which
+ *      case the output parameters are set.
+ */
+
+bool
+song_saver::finished (bool & ok, std::string & filename, std::string & errmsg)
+{
+    bool result = m_status.load() == SAVE_DONE;
+    if (result)
+        collect(ok, filename, errmsg);
+
+    return result;
+}
+
+/**
+ *  Blocks until any running save has finished.  Used before a synchronous
+ *  save, and at exit.  The outcome is not reported by finished().
+ *
+ * \return
+ *      Returns false only if a save was running and failed.
+ */
+
+bool
+song_saver::wait ()
+{
+    bool ok = true;
+    if (busy())
+    {
+        std::string filename;
+        std::string errmsg;
+        collect(ok, filename, errmsg);  /* pthread_join() does the wait */
+    }
+    return ok;
+}
+
+}           // namespace seq64
+
+/*
+ * song_saver.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -0,0 +1,173 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          song_snapshot.cpp
+ *
+ *  This module defines the class holding a detached copy of everything
+ *  midifile writes when saving a song.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  See the song_snapshot.hpp module for the overview.
+ */
+
+#include "globals.h"                    /* c_max_sequence, c_max_sets       */
+#include "perform.hpp"                  /* seq64::perform                   */
+#include "sequence.hpp"                 /* seq64::sequence                  */
+#include "settings.hpp"                 /* seq64::usr()                     */
+#include "song_snapshot.hpp"            /* seq64::song_snapshot             */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Default constructor.  The snapshot is empty until take() is called.
+ */
+
+song_snapshot::song_snapshot ()
+ :
+    m_sequences             (),
+    m_track_numbers         (),
+    m_timing                (),
+    m_tempo_track           (0),
+    m_notepads              (),
+    m_any_group_unmutes     (false),
+    m_group_mutes           (),
+    m_musical_key           (0),
+    m_musical_scale         (0),
+    m_background_sequence   (0)
+{
+    // Empty body
+}
+
+/**
+ *  Deletes the copied sequences.
+ */
+
+song_snapshot::~song_snapshot ()
+{
+    clear();
+}
+
+/**
+ *  Deletes the copied sequences, leaving an empty snapshot.
+ */
+
+void
+song_snapshot::clear ()
+{
+    std::vector<sequence *>::iterator si;
+    for (si = m_sequences.begin(); si != m_sequences.end(); ++si)
+        delete *si;
+
+    m_sequences.clear();
+    m_track_numbers.clear();
+}
+
+/**
+ *  Copies the song from the perform object.  This must be called on the
+ *  thread that edits the song, normally the GUI thread, so that nothing
+ *  changes while the copy is taken.  The sequence copies are the only real
+ *  work: one copy of each event list and trigger list, which the writer
+ *  used to make anyway.
+ *
+ *  Reading the mute groups selects each group in turn, as the writer always
+ *  did.
+ *
+ * \param p
+ *      The performance to copy.
+ *
+ * \return
+ *      Returns the number of sequences copied.  If 0, there is nothing to
+ *      save.
+ */
+
+int
+song_snapshot::take (perform & p)
+{
+    clear();
+    for (int track = 0; track < c_max_sequence; ++track)
+    {
+        if (p.is_active(track))
+        {
+            const sequence & seq = *p.get_sequence(track);
+            sequence * s = new sequence(seq.get_ppqn());
+            s->snapshot_assign(seq);
+            m_sequences.push_back(s);
+            m_track_numbers.push_back(track);
+        }
+    }
+
+    m_timing = p.timing();
+    m_tempo_track = p.get_tempo_track_number();
+
+    m_notepads.clear();
+    for (int s = 0; s < c_max_sets; ++s)
+        m_notepads.push_back(p.get_screen_set_notepad(s));
+
+    m_any_group_unmutes = p.any_group_unmutes();
+    m_group_mutes.assign(c_seqs_in_set * c_seqs_in_set, false);
+    for (int g = 0; g < c_seqs_in_set; ++g)
+    {
+        p.select_group_mute(g);
+        for (int i = 0; i < c_seqs_in_set; ++i)
+            m_group_mutes[g * c_seqs_in_set + i] = p.get_group_mute_state(i);
+    }
+
+    m_musical_key = usr().seqedit_key();
+    m_musical_scale = usr().seqedit_scale();
+    m_background_sequence = usr().seqedit_bgsequence();
+    return count();
+}
+
+/**
+ *  Looks up a saved mute-group state.
+ *
+ * \param group
+ *      The mute group, 0 to c_seqs_in_set - 1.
+ *
+ * \param seq
+ *      The sequence within the group, 0 to c_seqs_in_set - 1.
+ *
+ * \return
+ *      Returns true if the sequence is unmuted in the group.
+ */
+
+bool
+song_snapshot::group_mute_state (int group, int seq) const
+{
+    std::size_t index = std::size_t(group * c_seqs_in_set + seq);
+    return index < m_group_mutes.size() ? bool(m_group_mutes[index]) : false ;
+}
+
+}           // namespace seq64
+
+/*
+ * song_snapshot.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -0,0 +1,204 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          thumbnail.cpp
+ *
+ *  This module defines a class that holds the miniature piano roll of a
+ *  pattern, as drawn in the main window.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  The scaling is the one mainwid::draw_sequence_on_pixmap() has always
+ *  used, so the picture is unchanged.
+ */
+
+#include <algorithm>                    /* std::sort()                      */
+
+#include "app_limits.h"                 /* SEQ64_MAX_DATA_VALUE             */
+#include "sequence.hpp"                 /* seq64::sequence                  */
+#include "thumbnail.hpp"                /* seq64::thumbnail                 */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Orders note runs by row, then by first column, for merging.
+ */
+
+static bool
+span_before (const thumbnail::span & a, const thumbnail::span & b)
+{
+    return a.s_y < b.s_y || (a.s_y == b.s_y && a.s_x0 < b.s_x0);
+}
+
+/**
+ *  Default constructor.  The thumbnail is not current for any sequence.
+ */
+
+thumbnail::thumbnail ()
+ :
+    m_seq       (nullptr),
+    m_version   (0),
+    m_length    (0),
+    m_width     (0),
+    m_height    (0),
+    m_notes     (),
+    m_tempos    ()
+{
+    // no code
+}
+
+/**
+ *  Tells if the thumbnail shows the sequence as it is now, at the given
+ *  size.  This is cheap, and is checked every time a slot is drawn.
+ *
+ * \param seq
+ *      The sequence shown in the slot.
+ *
+ * \param width
+ *      The width of the note area of the slot.
+ *
+ * \param height
+ *      The height of the note area of the slot.
+ *
+ * \return
+ *      Returns true if render() need not be called.
+ */
+
+bool
+thumbnail::current (const sequence & seq, int width, int height) const
+{
+    return m_seq == &seq && m_version == seq.edit_version() &&
+        m_length == seq.get_length() &&
+        m_width == width && m_height == height;
+}
+
+/**
+ *  Walks the events of the sequence, scaling each note and tempo event to
+ *  the note area of the slot.  Notes are scaled by their range, and tempos
+ *  by the full data range.  The note runs are then sorted and merged, which
+ *  leaves at most about half a run per pixel.
+ *
+ * \param seq
+ *      The sequence to render.  It is only read, so rendering can be done
+ *      on any thread.
+ *
+ * \param width
+ *      The width of the note area of the slot.
+ *
+ * \param height
+ *      The height of the note area of the slot.
+ */
+
+void
+thumbnail::render (const sequence & seq, int width, int height)
+{
+    m_seq = &seq;
+    m_version = seq.edit_version();         /* before reading the events    */
+    m_length = seq.get_length();
+    m_width = width;
+    m_height = height;
+    m_notes.clear();
+    m_tempos.clear();
+
+    int low_note;
+    int high_note;
+    int len = int(m_length);
+    if (len <= 0 || ! seq.get_minmax_note_events(low_note, high_note))
+        return;
+
+    int range = high_note - low_note + 2;           /* 2-pixel border       */
+    seq.visit_notes
+    (
+        0, m_length, [&] (const sequence::note_info & ni)
+        {
+            span sp;
+            sp.s_x0 = ni.ni_start * width / len;
+            sp.s_x1 = ni.ni_finish * width / len;
+            if (ni.ni_type == DRAW_NOTE_ON || ni.ni_type == DRAW_NOTE_OFF)
+                sp.s_x1 = sp.s_x0 + 1;
+
+            if (sp.s_x1 <= sp.s_x0)
+                sp.s_x1 = sp.s_x0 + 1;
+
+            if (ni.ni_type == DRAW_TEMPO)
+            {
+                sp.s_y = height - height * (ni.ni_note + 1) /
+                    SEQ64_MAX_DATA_VALUE;
+
+                m_tempos.push_back(sp);
+            }
+            else
+            {
+                sp.s_y = height - height * (ni.ni_note + 1 - low_note) / range;
+                m_notes.push_back(sp);
+            }
+        }
+    );
+
+    std::sort(m_notes.begin(), m_notes.end(), span_before);
+    std::vector<span>::size_type count = 0;
+    for (std::vector<span>::size_type i = 0; i < m_notes.size(); ++i)
+    {
+        const span & sp = m_notes[i];
+        if (count > 0)
+        {
+            span & last = m_notes[count - 1];
+            if (last.s_y == sp.s_y && sp.s_x0 <= last.s_x1 + 1)
+            {
+                if (sp.s_x1 > last.s_x1)
+                    last.s_x1 = sp.s_x1;
+
+                continue;
+            }
+        }
+        m_notes[count++] = sp;
+    }
+    m_notes.resize(count);
+    if (m_notes.capacity() > 2 * count)
+        std::vector<span>(m_notes).swap(m_notes);   /* give back the rest   */
+}
+
+/**
+ *  Empties the thumbnail, so that it is current for no sequence.
+ */
+
+void
+thumbnail::clear ()
+{
+    m_seq = nullptr;
+    m_notes.clear();
+    m_tempos.clear();
+}
+
+}           // namespace seq64
+
+/*
+ * thumbnail.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -88,7 +88,6 @@ triggers::triggers (sequence & parent)
     m_undo_stack                (),
     m_redo_stack                (),
     m_iterator_play_trigger     (),
-    m_iterator_draw_trigger     (),
     m_trigger_copied            (false),
     m_paste_tick                (SEQ64_NO_PASTE_TRIGGER),   // stazed
     m_ppqn                      (0),
@@ -136,7 +135,6 @@ triggers::operator = (const triggers & rhs)
         m_undo_stack = rhs.m_undo_stack;
         m_redo_stack = rhs.m_redo_stack;
         m_iterator_play_trigger = rhs.m_iterator_play_trigger;
-        m_iterator_draw_trigger = rhs.m_iterator_draw_trigger;
         m_trigger_copied = rhs.m_trigger_copied;
         m_ppqn = rhs.m_ppqn;
         m_length = rhs.m_length;
@@ -1245,77 +1243,6 @@ triggers::paste (midipulse paste_tick)
     }
 }
 
-/**
- *  Get the next trigger in the trigger list, and set the parameters based
- *  on that trigger.
- *
- * \todo
- *      It would be a bit simpler to simply return a trigger object, wouldn't
- *      it?
- *
- * \param tick_on
- *      Return value for the retrieval of the starting tick for the trigger.
- *
- * \param tick_off
- *      Return value for the retrieval of the ending tick for the trigger.
- *
- * \param selected
- *      Return value for the retrieval of the is-selected flag for the trigger.
- *
- * \param offset
- *      Return value for the retrieval of the offset for the trigger.
- *
- * \return
- *      Returns true if a trigger was found.  If false, the caller cannot rely
- *      on the values returned through the return parameters.
- *
- * \sideeffect
- *      The value of the m_iterator_draw_trigger member will be altered by this
- *      call, unless pointing to the end of the triggerlist, or if there are
- *      no triggers.
- */
-
-bool
-triggers::next
-(
-    midipulse & tick_on,
-    midipulse & tick_off,
-    bool & selected,
-    midipulse & offset
-)
-{
-    while (m_iterator_draw_trigger != m_triggers.end())
-    {
-        tick_on  = m_iterator_draw_trigger->tick_start();
-        selected = m_iterator_draw_trigger->selected();
-        offset = m_iterator_draw_trigger->offset();
-        tick_off = m_iterator_draw_trigger->tick_end();
-        ++m_iterator_draw_trigger;
-        return true;
-    }
-    return false;
-}
-
-/**
- *  Get the next trigger in the trigger list.
- *
- * \return
- *      Returns the next trigger.  If there is none, a default trigger object
- *      is returned.
- */
-
-trigger
-triggers::next_trigger ()
-{
-    trigger result;
-    while (m_iterator_draw_trigger != m_triggers.end())
-    {
-        result = *m_iterator_draw_trigger;
-        ++m_iterator_draw_trigger;
-    }
-    return result;
-}
-
 /**
  *  Selects the given trigger and increments the count of selected triggers if
  *  appropriate.  Don't confuse this function with select(midipulse).
@@ -107,6 +107,15 @@ private:
     virtual void api_continue_from (midipulse tick);
     virtual void api_port_start (int client, int port);
 
+    /**
+     *  All of the ALSA busses write through the one m_alsa_seq handle.
+     */
+
+    virtual bool api_shared_handle () const
+    {
+        return true;
+    }
+
     /*
      * Not implemented:
      *
@@ -359,6 +359,9 @@ mastermidibus::api_init (int ppqn, midibpm bpm)
     (
         m_alsa_seq, m_poll_descriptors, m_num_poll_descriptors, POLLIN
     );
+    for (int i = 0; i < m_num_poll_descriptors; ++i)
+        (void) m_input_reactor.add_source(m_poll_descriptors[i].fd);
+
     snd_seq_set_output_buffer_size(m_alsa_seq, c_midibus_output_size);
     snd_seq_set_input_buffer_size(m_alsa_seq, c_midibus_input_size);
     m_bus_announce = new midibus
@@ -492,7 +495,8 @@ mastermidibus::api_flush ()
 }
 
 /**
- *  Initiate a poll() on the existing poll descriptors.
+ *  Initiate a poll() on the existing poll descriptors.  Used only if the
+ *  input reactor could not be set up; see mastermidibase::poll_for_midi().
  *
  *  No locking needed?
  *
@@ -598,15 +602,10 @@ mastermidibus::api_port_start (int bus, int port)
     }                                           /* end loop for clients */
 
     /*
-     * Get the number of MIDI input poll file descriptors.
+     * The poll descriptors belong to the sequencer handle, not to the ports,
+     * so they do not change here.  They used to be re-allocated (and leaked)
+     * on every port start.
      */
-
-    m_num_poll_descriptors = snd_seq_poll_descriptors_count(m_alsa_seq, POLLIN);
-    m_poll_descriptors = new pollfd[m_num_poll_descriptors]; /* allocate info */
-    snd_seq_poll_descriptors                        /* get input descriptors */
-    (
-        m_alsa_seq, m_poll_descriptors, m_num_poll_descriptors, POLLIN
-    );
 }
 
 /**
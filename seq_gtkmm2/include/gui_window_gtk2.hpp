@@ -28,7 +28,7 @@
  * \library       sequencer64 application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2015-09-22
- * \updates       2017-05-20
+ * \updates       2026-10-18
  * \license       GNU GPLv2 or above
  *
  *  This module declares/defines the base class for main window of the
@@ -44,6 +44,8 @@
 
 #define PIXBUF_IMAGE(x)     Gtk::Image(Gdk::Pixbuf::create_from_xpm_data(x))
 
+#include "frame_scheduler.hpp"          /* seq64::frame_scheduler           */
+
 /*
  *  Since these items are pointers, we were able to move (most) of the
  *  included header files to the cpp file.   Except for the items that
@@ -100,6 +102,26 @@ private:
 
     int m_redraw_period_ms;
 
+    /**
+     *  Picks the actual redraw period, starting from m_redraw_period_ms,
+     *  and measures the cost of each redraw.  See start_frames().
+     */
+
+    frame_scheduler m_frames;
+
+    /**
+     *  The redraw function of the derived class, called once per frame.
+     */
+
+    sigc::slot<bool> m_frame_slot;
+
+    /**
+     *  The connection of frame() to the Glib timeout, remade whenever the
+     *  period changes.
+     */
+
+    sigc::connection m_frame_connect;
+
     /**
      *  Indicates if on_realize() has been called.  In some cases, we don't
      *  want to draw in objects that haven't yet appeared, otherwise crashes
@@ -158,6 +180,16 @@ protected:
         return m_redraw_period_ms;
     }
 
+    /**
+     * \getter m_frames
+     *      Provides the frame period and the frame-cost statistics.
+     */
+
+    const frame_scheduler & frames () const
+    {
+        return m_frames;
+    }
+
     /**
      * \getter m_is_realized
      */
@@ -171,11 +203,17 @@ protected:
     void scroll_vadjust (Gtk::Adjustment & vadjust, double step);
     void scroll_hset (Gtk::Adjustment & hadjust, double value);
     void scroll_vset (Gtk::Adjustment & vadjust, double value);
+    void start_frames (const sigc::slot<bool> & frame);
+    void stop_frames ();
 
 protected:
 
     void on_realize ();
 
+private:
+
+    bool frame ();
+
 };              // class gui_window_gtk2
 
 }               // namespace seq64
@@ -28,7 +28,7 @@
  * \library       sequencer64 application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2015-07-24
- * \updates       2017-08-13
+ * \updates       2026-10-18
  * \license       GNU GPLv2 or above
  *
  *  Wonder where the name "wid" came from....
@@ -37,6 +37,7 @@
 #include "globals.h"                    /* c_max_sequence, etc.     */
 #include "gui_drawingarea_gtk2.hpp"     /* one base class           */
 #include "seqmenu.hpp"                  /* the other base class     */
+#include "thumbnail.hpp"                /* seq64::thumbnail         */
 
 /*
  *  Do not document a namespace; it breaks Doxygen.
@@ -120,6 +121,23 @@ private:
 
     long m_last_tick_x[c_max_sequence];
 
+    /**
+     *  True for each sequence whose progress bar is on the window at
+     *  m_last_tick_x.  Copying the pixmap over a slot clears it, so that the
+     *  bar is drawn again even if it has not moved.
+     */
+
+    bool m_marker_drawn[c_max_sequence];
+
+    /**
+     *  Holds the rendered notes of each sequence, so that a slot is drawn
+     *  without walking the events unless the sequence has been edited.
+     *  Status changes (mute, queue, highlighting) only change the colors
+     *  the thumbnail is drawn with.
+     */
+
+    thumbnail m_thumbnails[c_max_sequence];
+
     /**
      *  These values are assigned to the values given by the constants of
      *  similar names in globals.h, and we will make them parameters or
@@ -473,10 +473,12 @@ private:
     bool m_is_running;
 
     /**
-     *  Provides a timeout handler.
+     *  The time, in seconds, of the last background backup of the song, or
+     *  of the start-up if there has been none.  See the [auto-song-save]
+     *  option.
      */
 
-    sigc::connection m_timeout_connect;
+    long m_last_autosave_s;
 
 #ifdef SEQ64_MAINWND_TAP_BUTTON
 
@@ -718,6 +720,7 @@ private:
 
     void update_window_title ();
     void update_recent_files_menu ();
+    void playlist_song_loaded ();
     void load_recent_file (int index);
     void toLower (std::string &);       // isn't this part of std::string?
 
@@ -747,7 +750,7 @@ private:
 
     void file_save ()
     {
-        save_file();
+        (void) save_file_async();
     }
 
     /**
@@ -777,6 +780,8 @@ private:
     void file_exit ();
     void new_file ();
     bool save_file ();
+    bool save_file_async ();
+    void poll_song_saver ();
     void choose_file ();
     bool is_save ();
     bool install_signal_handlers ();
@@ -28,13 +28,15 @@
  * \library       sequencer64 application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2015-07-24
- * \updates       2017-10-15
+ * \updates       2026-10-18
  * \license       GNU GPLv2 or above
  *
  *  This class represents the central piano-roll user-interface area of the
  *  performance/song editor.
  */
 
+#include <vector>                       /* std::vector<>                    */
+
 #include "globals.h"                    /* seq64::c_max_sequence            */
 #include "gui_drawingarea_gtk2.hpp"     /* seq64::gui_drawingarea_gtk2      */
 #include "rect.hpp"                     /* seq64::rect class                */
@@ -56,6 +58,7 @@ namespace seq64
 {
     class perform;
     class perfedit;
+    class sequence;
 
 /**
  *  This class implements the performance roll user interface.
@@ -184,6 +187,14 @@ protected:
 
     midipulse m_old_progress_ticks;
 
+    /**
+     *  True if the progress bar is on the window at m_old_progress_ticks.
+     *  Copying the pixmap over the window clears it, so that the bar is
+     *  drawn again even if it has not moved.
+     */
+
+    bool m_progress_drawn;
+
 #ifdef SEQ64_FOLLOW_PROGRESS_BAR
 
     /**
@@ -361,6 +372,55 @@ protected:
 
     bool m_grow_direction;
 
+    /**
+     *  One repetition of a pattern as drawn in a trigger box:  its notes,
+     *  its tempo lines, and the length marker at its left edge, on the
+     *  background of an unselected or a selected box.  Each repetition of
+     *  the pattern in view is then a copy of this image.  The images are
+     *  made again when the edit version of the pattern, its length, the
+     *  zoom, or its transposability changes.
+     */
+
+    struct miniature
+    {
+        const sequence * m_seq;         /**< The pattern, to tell a new one. */
+        unsigned m_version;             /**< Its edit version.              */
+        midipulse m_length;             /**< Its length, in ticks.          */
+        int m_scale;                    /**< The m_perf_scale_x drawn at.   */
+        bool m_transposable;            /**< Red notes if false.            */
+
+        /**
+         *  The images on the unselected and selected box backgrounds, made
+         *  when first needed.
+         */
+
+        Glib::RefPtr<Gdk::Pixmap> m_images[2];
+    };
+
+    /**
+     *  The miniatures, indexed by pattern number, and grown as patterns are
+     *  drawn.
+     */
+
+    std::vector<miniature> m_miniatures;
+
+    /**
+     *  The graphics context used to draw the miniatures.  It is separate from
+     *  m_gc, which may be clipped to a part of m_pixmap when a miniature is
+     *  made.
+     */
+
+    Glib::RefPtr<Gdk::GC> m_miniature_gc;
+
+    /**
+     *  True if m_pixmap holds every visible row as it should now be drawn.
+     *  Then an expose event is only a copy to the window, and a horizontal
+     *  scroll is a shift of m_pixmap plus the drawing of the strip that
+     *  scrolled into view.  Any request for a full redraw clears it.
+     */
+
+    bool m_rows_current;
+
 public:
 
     perfroll
@@ -401,6 +461,17 @@ protected:
     void snap_x (int & x);
     void snap_y (int & y);
     void draw_sequence_on (int seqnum);         /* perform::SeqOperation    */
+    void draw_notes_on
+    (
+        Glib::RefPtr<Gdk::Pixmap> & pixmap, Glib::RefPtr<Gdk::GC> & gc,
+        const sequence & seq, int low_note, int high_note, int tickmarker_x,
+        int x, int y, int w, midipulse window_s, midipulse window_f
+    );
+    Glib::RefPtr<Gdk::Pixmap> pattern_image
+    (
+        int seqnum, const sequence & seq, bool selected
+    );
+    bool scroll_pixmap (midipulse old_offset);
     void draw_background_on (int seqnum);
     void draw_drawable_row (int y);
 
@@ -503,6 +574,17 @@ protected:
     void change_vert ();
     void split_trigger(int sequence, midipulse tick);
     void enqueue_draw ();
+
+    /**
+     *  Makes the next expose event draw every visible row again.  Called by
+     *  the parent perfedit when the song changes behind our back.
+     */
+
+    void invalidate_rows ()
+    {
+        m_rows_current = false;
+    }
+
     void set_zoom (int z);
 
     /**
@@ -29,7 +29,7 @@
  * \library       sequencer64 application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2015-07-24
- * \updates       2017-07-25
+ * \updates       2026-10-18
  * \license       GNU GPLv2 or above
  *
  *  The data pane is the drawing-area below the seqedit's event area, and
@@ -37,6 +37,7 @@
  *  The height of the vertical lines is editable via the mouse.
  */
 
+#include "data_summary.hpp"             /* seq64::data_summary  */
 #include "globals.h"
 #include "gui_drawingarea_gtk2.hpp"
 #include "midibyte.hpp"                 /* midibyte typedef */
@@ -153,6 +154,16 @@ private:
 
     GdkRectangle m_old;
 
+    /**
+     *  The min/max pyramid of the lane being shown, used to draw one column
+     *  per pixel when the events are denser than the pixels.  It is cleared
+     *  by update_pixmap(), which is called whenever the data may have
+     *  changed, and built again on the next draw.  Scrolling and zooming
+     *  keep it.
+     */
+
+    data_summary m_summary;
+
 #ifdef USE_STAZED_SEQDATA_EXTENSIONS
 
     bool m_drag_handle;
@@ -183,12 +194,14 @@ public:
     void reset ();
 
     /**
-     *  Calls change_horz() to update the pixmap and queue up a redraw
-     *  operation.
+     *  Drops the summary of the lane, since redraw() is called when the
+     *  data changed, and calls change_horz() to update the pixmap and queue
+     *  up a redraw operation.
      */
 
     void redraw ()
     {
+        m_summary.clear();
         change_horz();
     }
 
@@ -210,6 +223,10 @@ private:
     );
 
     void draw_events_on (Glib::RefPtr<Gdk::Drawable> drawable);
+    bool draw_summary_on
+    (
+        Glib::RefPtr<Gdk::Drawable> drawable, int starttick, int endtick
+    );
     void change_horz ();
 
     /**
@@ -28,7 +28,7 @@
  * \library       sequencer64 application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2015-07-24
- * \updates       2017-10-08
+ * \updates       2026-10-18
  * \license       GNU GPLv2 or above
  *
  *  We are currently moving toward making this class a base class.
@@ -37,6 +37,8 @@
  *  progress bar during playback.  See the seqroll::m_progress_follow member.
  */
 
+#include <vector>                       /* std::vector<>            */
+
 #include "globals.h"
 #include "gui_drawingarea_gtk2.hpp"
 #include "rect.hpp"                     /* seq64::rect class        */
@@ -269,6 +271,14 @@ protected:
 
     int m_progress_x;
 
+    /**
+     *  True if the progress bar is on the window at m_progress_x.  Copying
+     *  the pixmap over the window clears it, so that the bar is drawn again
+     *  even if it has not moved.
+     */
+
+    bool m_progress_drawn;
+
     /**
      *  The horizontal value of the scroll window in units of
      *  ticks/pulses/divisions.
@@ -358,6 +368,37 @@ protected:
 
     midibyte m_cc;
 
+    /**
+     *  The middle layer of the piano roll:  the grid (m_background) with
+     *  the background sequence drawn on it.  The notes of m_seq are drawn
+     *  on m_pixmap over a copy of this layer, and the selection box is drawn
+     *  on the window over m_pixmap.  A damaged part of m_pixmap is restored
+     *  from this layer before its notes are drawn again.
+     */
+
+    Glib::RefPtr<Gdk::Pixmap> m_underlay;
+
+    /**
+     *  The notes of m_seq drawn on m_pixmap, sorted (see note_less()).
+     *  redraw_events() compares the notes now in view against these, and
+     *  redraws only the boxes of the notes that changed.
+     */
+
+    std::vector<sequence::note_info> m_drawn_notes;
+
+    /**
+     *  The view that m_drawn_notes was drawn in.  If any of these differs
+     *  from the current view, redraw_events() draws everything.
+     */
+
+    bool m_drawn_valid;
+    int m_drawn_ticks;
+    int m_drawn_key;
+    int m_drawn_zoom;
+    midipulse m_drawn_length;
+    const sequence * m_drawn_bgseq;
+    unsigned m_drawn_bgversion;
+
 public:
 
     seqroll
@@ -618,7 +659,19 @@ protected:
     (
         midipulse & tick_s, int & note_h, midipulse & tick_f, int & note_l
     );
-    void draw_events_on (Glib::RefPtr<Gdk::Drawable> draw);
+    sequence * background_sequence ();
+    bool drawn_current ();
+    void get_notes_in_view (std::vector<sequence::note_info> & notes);
+    void note_box (const sequence::note_info & ni, rect & r);
+    void repair_pixmap
+    (
+        const rect & r, const std::vector<sequence::note_info> & notes
+    );
+    void draw_note_on
+    (
+        Glib::RefPtr<Gdk::Drawable> draw, int method,
+        const sequence::note_info & ni
+    );
     int idle_redraw ();
     int idle_progress ();
     void change_horz ();
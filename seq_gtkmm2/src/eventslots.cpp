@@ -25,7 +25,7 @@
  * \library       sequencer64 application
  * \author        Chris Ahlstrom
  * \date          2015-12-05
- * \updates       2017-08-05
+ * \updates       2026-10-18
  * \license       GNU GPLv2 or above
  *
  *  This module is user-interface code.  It is loosely based on the workings
@@ -621,22 +621,7 @@ eventslots::save_events ()
     if (result)
     {
         event_list newevents;
-        for
-        (
-            editable_events::iterator ei = m_event_container.begin();
-            ei != m_event_container.end(); ++ei
-        )
-        {
-            /*
-             * Have to add the seq64 namespace to distinguish it from
-             * Gtk::Widget::event.
-             */
-
-            seq64::event e = EEDREF(ei);        /* actually a conversion    */
-            result = newevents.add(e);
-            if (! result)
-                break;
-        }
+        result = m_event_container.get_events(newevents);
         if (result)
             result = newevents.count() == m_event_count;
 
@@ -714,7 +699,21 @@ eventslots::page_movement (int new_value)
 
             m_top_index += movement;
 
-            if (movement > 0)
+            if (absmovement > m_line_maximum)
+            {
+                /*
+                 * A long jump, as when dragging the scrollbar thumb, goes
+                 * straight to the new frame instead of stepping to it.
+                 */
+
+                int bottom = m_top_index + m_line_count - 1;
+                if (bottom >= m_event_count)
+                    bottom = m_event_count - 1;
+
+                m_top_iterator = m_event_container.at(m_top_index);
+                m_bottom_iterator = m_event_container.at(bottom);
+            }
+            else if (movement > 0)
             {
                 for (int i = 0; i < movement; ++i)
                 {
@@ -772,18 +771,10 @@ eventslots::page_topper (editable_events::iterator newcurrent)
 
     if (ok)
     {
-        editable_events::iterator ei = m_event_container.begin();
-        int botindex = 0;
-        while (ei != newcurrent)
-        {
-            ++botindex;
-            ++ei;
-            if (botindex == m_event_count)
-            {
-                ok = false;                     /* never found the event!   */
-                break;
-            }
-        }
+        int botindex = m_event_container.index_of(newcurrent);
+        if (botindex >= m_event_count)
+            ok = false;                         /* never found the event!   */
+
         if (m_event_count <= m_line_maximum)    /* fewer events than lines  */
         {
             if (ok)
@@ -808,7 +799,6 @@ eventslots::page_topper (editable_events::iterator newcurrent)
                  * Count carefully!
                  */
 
-                editable_events::iterator ei = m_event_container.begin();
                 int pageup = botindex - line_maximum();
                 if (pageup < 0)
                 {
@@ -816,14 +806,10 @@ eventslots::page_topper (editable_events::iterator newcurrent)
                 }
                 else
                 {
-                    int countdown = pageup;
-                    while (countdown-- > 0)
-                        ++ei;
-
                     m_top_index = m_pager_index = pageup + 1;   /* re map   */
                 }
 
-                m_top_iterator = ei;
+                m_top_iterator = m_event_container.at(pageup);
                 m_current_iterator = newcurrent;
                 m_current_index = botindex - m_top_index;       /* re frame */
             }
@@ -893,7 +879,7 @@ eventslots::draw_event (editable_events::iterator ei, int index)
         col = font::CYAN_ON_BLACK;      /* BLACK_ON_YELLOW, YELLOW_ON_BLACK */
     }
 
-    editable_event & evp = EEDREF(ei);
+    editable_event evp = EEDREF(ei);        /* formatted only when shown    */
     char tmp[16];
     snprintf(tmp, sizeof tmp, "%4d-", m_top_index + index);
     std::string temp = tmp;
@@ -25,13 +25,14 @@
  * \library       sequencer64 application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2015-09-22
- * \updates       2016-07-15
+ * \updates       2026-10-18
  * \license       GNU GPLv2 or above
  *
  *  This module uses Gtk::Window as the base class, and also holds the main
  *  perform object and some window parameters.
  */
 
+#include <cstdio>                       /* std::printf()                    */
 #include <gtkmm/adjustment.h>
 #include <gtkmm/window.h>
 #include <gtkmm/scrollbar.h>
@@ -78,6 +79,9 @@ gui_window_gtk2::gui_window_gtk2
     m_window_x          (window_x),
     m_window_y          (window_y),
     m_redraw_period_ms  (usr().window_redraw_rate()),       /* 40, 25 ms    */
+    m_frames            (m_redraw_period_ms),
+    m_frame_slot        (),
+    m_frame_connect     (),
     m_is_realized       (false)
 {
     add_events(Gdk::KEY_PRESS_MASK | Gdk::KEY_RELEASE_MASK | Gdk::SCROLL_MASK);
@@ -86,12 +90,22 @@ gui_window_gtk2::gui_window_gtk2
 }
 
 /**
- *  This rote constructor does nothing.
+ *  Stops the frames, and, in verbose mode, shows what they cost.
  */
 
 gui_window_gtk2::~gui_window_gtk2 ()
 {
-    /* Empty body */
+    stop_frames();
+    if (rc().verbose_option() && m_frames.frames() > 0)
+    {
+        std::string title = not_nullptr(gobj()) ? get_title() : "window" ;
+        std::printf
+        (
+            "%s: %ld frames, average %ld us, worst %ld us\n",
+            title.c_str(), m_frames.frames(),
+            m_frames.average_cost_us(), m_frames.max_cost_us()
+        );
+    }
 }
 
 /**
@@ -210,6 +224,76 @@ gui_window_gtk2::scroll_vset (Gtk::Adjustment & vadjust, double value)
     vadjust.set_value(value);
 }
 
+/**
+ *  Starts calling a redraw function on a timer, instead of connecting it to
+ *  a fixed Glib timeout.  The period starts at redraw_period_ms(), and is
+ *  adapted after every frame; see the frame_scheduler class.
+ *
+ * \param frame
+ *      The redraw function.  If it returns false, the frames stop.
+ */
+
+void
+gui_window_gtk2::start_frames (const sigc::slot<bool> & frame)
+{
+    m_frame_connect.disconnect();
+    m_frame_slot = frame;
+    m_frame_connect = Glib::signal_timeout().connect
+    (
+        mem_fun(*this, &gui_window_gtk2::frame), m_frames.period_ms()
+    );
+}
+
+/**
+ *  Stops the frames started by start_frames().
+ */
+
+void
+gui_window_gtk2::stop_frames ()
+{
+    m_frame_connect.disconnect();
+}
+
+/**
+ *  Runs one frame, timing it, then picks the period of the next ones from
+ *  the published transport state and the state of the window.  The window
+ *  counts as hidden if it is unmapped or iconified.
+ *
+ * \return
+ *      Returns false, ending this timeout, if the redraw function asked to
+ *      stop, or if the period changed and a new timeout was connected.
+ */
+
+bool
+gui_window_gtk2::frame ()
+{
+    m_frames.begin_frame();
+    bool keep = m_frame_slot();
+    m_frames.end_frame();
+    if (! keep)
+        return false;
+
+    bool visible = false;
+    Glib::RefPtr<Gdk::Window> w = get_window();
+    if (w && is_visible())
+    {
+        Gdk::WindowState ws = w->get_state();
+        visible = (ws & Gdk::WINDOW_STATE_ICONIFIED) == 0 &&
+            (ws & Gdk::WINDOW_STATE_WITHDRAWN) == 0;
+    }
+
+    bool running = perf().transport().ts_running;
+    if (m_frames.update(running, visible, is_active()))
+    {
+        m_frame_connect = Glib::signal_timeout().connect
+        (
+            mem_fun(*this, &gui_window_gtk2::frame), m_frames.period_ms()
+        );
+        return false;                           /* drop the old timeout     */
+    }
+    return true;
+}
+
 /**
  *  This callback function calls the base-class on_realize() function, and
  *  sets the m_is_realized flag.
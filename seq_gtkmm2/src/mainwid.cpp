@@ -25,7 +25,7 @@
  * \library       sequencer64 application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2015-07-24
- * \updates       2017-12-30
+ * \updates       2026-10-18
  * \license       GNU GPLv2 or above
  *
  *  Note that this representation is, in a sense, inside the mainwnd
@@ -165,6 +165,7 @@ mainwid::mainwid
     m_old_seq               (0),
     m_screenset             ((ss > 0 && ss < SEQ64_DEFAULT_SET_MAX) ? ss : 0),
     m_last_tick_x           (),                 // array of size c_max_sequence
+    m_marker_drawn          (),                 // array of size c_max_sequence
     m_mainwnd_rows          (usr().mainwnd_rows()),
     m_mainwnd_cols          (usr().mainwnd_cols()),
     m_seqarea_x             (c_seqarea_x),
@@ -476,94 +477,47 @@ mainwid::draw_sequence_on_pixmap (int seqnum)
 #endif
             draw_rectangle_on_pixmap(fg_color(), x, y, lx, ly, false);
 
-            int low_note;                                   // for side-effect
-            int high_note;                                  // ditto
-            bool have_notes = seq->get_minmax_note_events(low_note, high_note);
-            if (have_notes)
-            {
-                int height = high_note - low_note + 2;      // 2-pixel border
-                int len = seq->get_length();
-                midipulse tick_s;
-                midipulse tick_f;
-                int note;
-                bool selected;
-                int velocity;
-                draw_type_t dt;
-                Color drawcolor = fg_color();
-                Color eventcolor = fg_color();
+            /*
+             * The notes come from the thumbnail of the sequence, which is
+             * rendered again only if the sequence has been edited.
+             */
+
+            thumbnail & thumb = m_thumbnails[seqnum];
+            if (! thumb.current(*seq, m_seqarea_seq_x, m_seqarea_seq_y))
+                thumb.render(*seq, m_seqarea_seq_x, m_seqarea_seq_y);
 
+            Color eventcolor = fg_color();
 #ifdef SEQ64_STAZED_TRANSPOSE
-                if (! seq->get_transposable())
-                {
-                    eventcolor = red();
-                    drawcolor = red();
-                }
+            if (! seq->get_transposable())
+                eventcolor = red();
 #endif
 
-                seq->reset_draw_marker();       /* reset container iterator */
-                do
+            const std::vector<thumbnail::span> & notes = thumb.notes();
+            std::vector<thumbnail::span>::const_iterator si;
+            for (si = notes.begin(); si != notes.end(); ++si)
+            {
+                int sy = rectangle_y + si->s_y;
+                draw_line_on_pixmap
+                (
+                    eventcolor, rectangle_x + si->s_x0, sy,
+                    rectangle_x + si->s_x1, sy
+                );
+            }
+
+            const std::vector<thumbnail::span> & tempos = thumb.tempos();
+            if (! tempos.empty())
+            {
+                set_line(Gdk::LINE_SOLID, 2);
+                for (si = tempos.begin(); si != tempos.end(); ++si)
                 {
-                    dt = seq->get_next_note_event   /* side-effects */
+                    int sy = rectangle_y + si->s_y;
+                    draw_line_on_pixmap
                     (
-                        tick_s, tick_f, note, selected, velocity
+                        tempo_paint(), rectangle_x + si->s_x0, sy,
+                        rectangle_x + si->s_x1, sy
                     );
-                    if (dt == DRAW_FIN)
-                        break;
-
-                    int tick_s_x = tick_s * m_seqarea_seq_x / len;
-                    int tick_f_x = tick_f * m_seqarea_seq_x / len;
-                    int note_y;
-                    if (dt == DRAW_TEMPO)
-                    {
-                        /*
-                         * Do not to scale by the note range here.
-                         */
-
-                        note_y = m_seqarea_seq_y -
-                             m_seqarea_seq_y * (note + 1) / SEQ64_MAX_DATA_VALUE;
-                    }
-                    else
-                    {
-                        note_y = m_seqarea_seq_y -
-                             m_seqarea_seq_y * (note + 1 - low_note) / height;
-                    }
-                    if (dt == DRAW_NOTE_ON || dt == DRAW_NOTE_OFF)
-                        tick_f_x = tick_s_x + 1;
-
-                    if (tick_f_x <= tick_s_x)
-                        tick_f_x = tick_s_x + 1;
-
-                    if (dt == DRAW_TEMPO)
-                    {
-                        set_line(Gdk::LINE_SOLID, 2);
-                        drawcolor = tempo_paint();
-                        note_y = m_seqarea_seq_y -
-                             m_seqarea_seq_y * (note + 1) / SEQ64_MAX_DATA_VALUE;
-                    }
-
-                    int sx = rectangle_x + tick_s_x;            /* start x  */
-                    int fx = rectangle_x + tick_f_x;            /* finish x */
-                    int sy = rectangle_y + note_y;              /* start y  */
-                    int fy = sy;                                /* finish y */
-                    draw_line_on_pixmap(drawcolor, sx, sy, fx, fy);
-
-                    if (dt == DRAW_TEMPO)
-                    {
-                        /*
-                         * We would like to also draw a line from the end of
-                         * the current tempo to the start of the next one.
-                         * But we currently have only the x value of the next
-                         * tempo.
-                         *
-                         * sx = fx;
-                         * fy = next tempo value scaled to 127;
-                         */
-
-                        set_line(Gdk::LINE_SOLID, 1);
-                        drawcolor = eventcolor;
-                    }
-
-                } while (dt != DRAW_FIN);
+                }
+                set_line(Gdk::LINE_SOLID, 1);
             }
         }
         else                                            /* sequence inactive */
@@ -670,6 +624,7 @@ mainwid::draw_sequence_pixmap_on_window (int seqnum)
         int x, y;
         calculate_base_sizes(seqnum, x, y);                 /* side-effects */
         draw_drawable(x, y, x, y, m_seqarea_x, m_seqarea_y + 1);
+        m_marker_drawn[seqnum] = false;
     }
 }
 
@@ -781,6 +736,9 @@ mainwid::draw_marker_on_sequence (int seqnum, int tick)
         tick %= len;
 
         long tick_x = tick * m_seqarea_seq_x / len;
+        if (m_marker_drawn[seqnum] && tick_x == m_last_tick_x[seqnum])
+            return;                         /* nothing visible changed      */
+
         int bar_x = rect_x + int(m_last_tick_x[seqnum]);
         int thickness = 1;
         if (usr().progress_bar_thick())
@@ -833,6 +791,8 @@ mainwid::draw_marker_on_sequence (int seqnum, int tick)
         );
         if (usr().progress_bar_thick())
             set_line(Gdk::LINE_SOLID, 1);
+
+        m_marker_drawn[seqnum] = true;
     }
 }
 
@@ -983,6 +943,9 @@ mainwid::on_expose_event (GdkEventExpose * ev)
         ev->area.x, ev->area.y, ev->area.x, ev->area.y,
         ev->area.width, ev->area.height
     );
+    for (int s = 0; s < c_max_sequence; ++s)
+        m_marker_drawn[s] = false;
+
     return true;
 }
 
@@ -82,6 +82,7 @@
 #include <cerrno>
 #include <cstring>
 #include <stdio.h>                      /* snprintf()                   */
+#include <time.h>                       /* clock_gettime()              */
 #include <gtk/gtkversion.h>
 #include <gtkmm/aboutdialog.h>
 #include <gtkmm/adjustment.h>
@@ -202,6 +203,15 @@
 #define SEQ64_TAP_BUTTON_TIMEOUT    5000L
 #endif
 
+/**
+ *  The names of the song backups written by the [auto-song-save] option.  The
+ *  suffix is appended to the song's file name; the name is used in the
+ *  configuration directory for a song that has no name yet.
+ */
+
+#define SEQ64_AUTOSAVE_FILE_SUFFIX  ".autosave.midi"
+#define SEQ64_AUTOSAVE_FILE_NAME    "autosave.midi"
+
 /*
  * Access some menu elements more easily.
  */
@@ -222,6 +232,22 @@ namespace seq64
 
 int mainwnd::sm_sigpipe[2];
 
+/**
+ *  Gets a clock for timing the song backups, unaffected by changes to the
+ *  system time.
+ *
+ * \return
+ *      Returns the monotonic time, in seconds.
+ */
+
+static long
+monotonic_seconds ()
+{
+    struct timespec spec;
+    clock_gettime(CLOCK_MONOTONIC, &spec);
+    return long(spec.tv_sec);
+}
+
 /**
  *  The constructor the main window of the application.
  *  This constructor is way too large; it would be nicer to provide a
@@ -379,7 +405,7 @@ mainwnd::mainwnd
     m_spinbutton_load_offset(nullptr),  /* created in file_import_dialog()  */
     m_entry_notes           (manage(new Gtk::Entry())),
     m_is_running            (false),
-    m_timeout_connect       (),                     /* handler              */
+    m_last_autosave_s       (monotonic_seconds()),
 #ifdef SEQ64_MAINWND_TAP_BUTTON
     m_current_beats         (0),
     m_base_time_ms          (0),
@@ -1164,10 +1190,7 @@ mainwnd::mainwnd
     add_events(Gdk::KEY_PRESS_MASK | Gdk::KEY_RELEASE_MASK);
 #endif
 
-    m_timeout_connect = Glib::signal_timeout().connect
-    (
-        mem_fun(*this, &mainwnd::timer_callback), redraw_period_ms()
-    );
+    start_frames(mem_fun(*this, &mainwnd::timer_callback));
     show_all();                             /* works here as well           */
 
 #if defined SEQ64_JE_PATTERN_PANEL_SCROLLBARS
@@ -1353,7 +1376,11 @@ mainwnd::toggle_menu_mode ()
 bool
 mainwnd::timer_callback ()
 {
-    midipulse tick = perf().get_tick();         /* use no get_start_tick()! */
+    if (perf().get_playlist().poll())           /* swapped in a new song?   */
+        playlist_song_loaded();
+
+    transport_snapshot::state ts = perf().transport();  /* no waiting    */
+    midipulse tick = ts.ts_tick;                /* use no get_start_tick()! */
     midibpm bpm = perf().get_beats_per_minute();
     update_markers(tick);
     if (m_button_queue->get_active() != perf().is_keep_queue())
@@ -1363,7 +1390,7 @@ mainwnd::timer_callback ()
      * Calculate the current time, and display it.
      */
 
-    if (perf().is_pattern_playing())
+    if (ts.ts_playing)
     {
         midibpm bpm = perf().get_beats_per_minute();
         int ppqn = perf().ppqn();
@@ -1481,6 +1508,8 @@ mainwnd::timer_callback ()
     if (m_perf_edit->get_toggle_jack() != perf().get_toggle_jack())
         m_perf_edit->toggle_jack();
 
+    poll_song_saver();                          /* background save results  */
+
     if (perf().is_running() != m_is_running)
     {
         m_is_running = perf().is_running();
@@ -1794,10 +1823,7 @@ mainwnd::on_realize ()
      *  grab_focus();
      *  set_focus(*this);
      *  present();
-     *  m_timeout_connect = Glib::signal_timeout().connect
-     *  (
-     *      mem_fun(*this, &mainwnd::timer_callback), redraw_period_ms()
-     *  );
+     *  start_frames(mem_fun(*this, &mainwnd::timer_callback));
      *
      * set_screenset(0);           // causes a segfault
      */
@@ -2019,7 +2045,7 @@ mainwnd::file_save_as (bool do_export)
             {
                 rc().filename(fname);
                 update_window_title();
-                save_file();
+                (void) save_file_async();
             }
             break;
         }
@@ -2075,6 +2101,24 @@ mainwnd::open_file (const std::string & fn)
     m_adjust_bpm->set_value(perf().get_beats_per_minute());
 }
 
+/**
+ *  Updates the window after the playlist has swapped in a song, as
+ *  open_file() does after a load.  The song is not added to the recent
+ *  files, since the playlist already lists it.
+ */
+
+void
+mainwnd::playlist_song_loaded ()
+{
+    const std::string & fn = perf().get_playlist().current_name();
+    ppqn(perf().get_playlist().current_ppqn());
+    rc().last_used_dir(fn.substr(0, fn.rfind("/") + 1));
+    rc().filename(fn);
+    update_window_title();
+    m_entry_notes->set_text(perf().current_screen_set_notepad());
+    m_adjust_bpm->set_value(perf().get_beats_per_minute());
+}
+
 /**
  *  Creates a file-chooser dialog.
  *
@@ -2114,6 +2158,10 @@ mainwnd::choose_file ()
  *  of m_ppqn, which was set when reading the MIDI file.  We also let midifile
  *  tell the perform that saving worked, so that the "is modified" flag can be
  *  cleared.  The midifile class is already a friend of perform.
+ *
+ *  This is the synchronous save, used when the caller must know the outcome
+ *  before going on, as when quitting or opening another file.  Any
+ *  background save is allowed to finish first.
  */
 
 bool
@@ -2126,6 +2174,7 @@ mainwnd::save_file ()
         return true;
     }
 
+    (void) perf().saver().wait();
     midifile f
     (
         rc().filename(), ppqn(),
@@ -2149,6 +2198,117 @@ mainwnd::save_file ()
     return result;
 }
 
+/**
+ *  Starts saving the current state in a MIDI file, on a background thread,
+ *  so that a large song does not stall the user-interface.  The song is
+ *  copied here; the rest is done by the perform object's song_saver, and
+ *  poll_song_saver() reports the outcome.  An autosave in progress is
+ *  finished first.
+ *
+ * \return
+ *      Returns true if the save was started, or if the file-save dialog was
+ *      shown because the song has no name yet.
+ */
+
+bool
+mainwnd::save_file_async ()
+{
+    if (rc().filename().empty())
+    {
+        file_save_as();
+        return true;
+    }
+
+    song_saver & saver = perf().saver();
+    if (saver.busy())
+    {
+        if (! saver.autosave())
+            return true;                /* this save is already underway    */
+
+        poll_song_saver();              /* reports it if already done       */
+        (void) saver.wait();
+    }
+
+    bool result = saver.start
+    (
+        perf(), rc().filename(), ppqn(),
+        rc().legacy_format(), usr().global_seq_feature()
+    );
+    if (! result)
+        result = save_file();           /* nothing to save, report it       */
+
+    return result;
+}
+
+/**
+ *  Called by the timer to report the outcome of a background save, and to
+ *  start an autosave if the [auto-song-save] interval has elapsed and the
+ *  song has changed.  The backup goes next to the song file, or into the
+ *  configuration directory if the song has no name yet; it never replaces
+ *  the song file, and does not clear the "modified" flag.
+ */
+
+void
+mainwnd::poll_song_saver ()
+{
+    song_saver & saver = perf().saver();
+    bool autosave = saver.autosave();
+    bool ok;
+    std::string filename;
+    std::string errmsg;
+    if (saver.finished(ok, filename, errmsg))
+    {
+        if (autosave)
+        {
+            if (! ok)
+                errprintf("autosave failed: %s\n", errmsg.c_str());
+        }
+        else if (ok)
+        {
+            rc().add_recent_file(filename);
+            update_recent_files_menu();
+        }
+        else
+        {
+            Gtk::MessageDialog errdialog
+            (
+                *this, errmsg, false, Gtk::MESSAGE_ERROR, Gtk::BUTTONS_OK, true
+            );
+            errdialog.run();
+        }
+    }
+
+    int interval = rc().auto_song_save();
+    if (interval > 0)
+    {
+        long now = monotonic_seconds();
+        if (! perf().is_modified())
+            m_last_autosave_s = now;            /* count from the first edit */
+        else if (! saver.busy() && now - m_last_autosave_s >= interval)
+        {
+            std::string backup;
+            if (rc().filename().empty())
+            {
+                std::string dir = rc().home_config_directory();
+                if (! dir.empty())
+                    backup = dir + SEQ64_AUTOSAVE_FILE_NAME;
+            }
+            else
+                backup = rc().filename() + SEQ64_AUTOSAVE_FILE_SUFFIX;
+
+            m_last_autosave_s = now;
+            if (! backup.empty())
+            {
+                (void) saver.start
+                (
+                    perf(), backup, ppqn(), rc().legacy_format(),
+                    usr().global_seq_feature(), true
+                );
+            }
+        }
+    }
+}
+
 /**
  *  Queries the user to save the changes made while the application was
  *  running.
@@ -2994,6 +3154,14 @@ mainwnd::on_key_press_event (GdkEventKey * ev)
                 m_adjust_ss->set_value(newss);
                 m_entry_notes->set_text(perf().current_screen_set_notepad());
             }
+            else if (k.key() == PREFKEY(playlist_prev))
+            {
+                perf().get_playlist().previous();   /* swapped in by timer  */
+            }
+            else if (k.key() == PREFKEY(playlist_next))
+            {
+                perf().get_playlist().next();
+            }
 #ifdef SEQ64_MAINWND_TAP_BUTTON
             else if (k.key() == PREFKEY(tap_bpm))
             {
@@ -3491,7 +3659,7 @@ mainwnd::signal_action (Glib::IOCondition condition)
             switch (message)
             {
             case SIGUSR1:
-                save_file();
+                (void) save_file_async();
                 break;
 
             case SIGINT:
@@ -843,6 +843,22 @@ options::add_extended_keys_page ()
     controltable->attach(*label, 4, 5, 3, 4);
     controltable->attach(*entry, 5, 6, 3, 4);
 #endif
+
+    label = manage(new Gtk::Label("Previous song", Gtk::ALIGN_RIGHT));
+    entry = manage
+    (
+        new keybindentry(keybindentry::location, PREFKEY_ADDR(playlist_prev))
+    );
+    controltable->attach(*label, 6, 7, 0, 1);
+    controltable->attach(*entry, 7, 8, 0, 1);
+
+    label = manage(new Gtk::Label("Next song", Gtk::ALIGN_RIGHT));
+    entry = manage
+    (
+        new keybindentry(keybindentry::location, PREFKEY_ADDR(playlist_next))
+    );
+    controltable->attach(*label, 6, 7, 1, 2);
+    controltable->attach(*entry, 7, 8, 1, 2);
 }
 
 #undef AddKey
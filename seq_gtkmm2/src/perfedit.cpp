@@ -497,6 +497,7 @@ perfedit::perfedit
 void
 perfedit::enqueue_draw (bool forward)
 {
+    m_perfroll->invalidate_rows();          /* the song may have changed    */
     m_perfroll->queue_draw();
     m_perfnames->queue_draw();
     m_perftime->queue_draw();
@@ -960,18 +961,15 @@ perfedit::set_transpose (int transpose)
 
 /**
  *  This callback function calls the base-class on_realize() function, and
- *  then connects the perfedit::timeout() function to the Glib
- *  signal-timeout, with a redraw timeout of redraw_period_ms().
+ *  then starts the perfedit::timeout() frames, which begin at a period of
+ *  redraw_period_ms().
  */
 
 void
 perfedit::on_realize ()
 {
     gui_window_gtk2::on_realize();
-    Glib::signal_timeout().connect
-    (
-        mem_fun(*this, &perfedit::timeout), redraw_period_ms()
-    );
+    start_frames(mem_fun(*this, &perfedit::timeout));
 }
 
 /**
@@ -489,6 +489,9 @@ perfnames::on_size_allocate (Gtk::Allocation & a)
 void
 perfnames::redraw_dirty_sequences ()
 {
+    if (! perf().any_dirty_names())         /* lock-free, usually nothing   */
+        return;
+
     int y_f = m_window_y / m_names_y;
     for (int y = 0; y <= y_f; ++y)
     {
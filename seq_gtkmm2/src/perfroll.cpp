@@ -25,7 +25,7 @@
  * \library       sequencer64 application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2015-07-24
- * \updates       2017-12-15
+ * \updates       2026-10-18
  * \license       GNU GPLv2 or above
  *
  *  The performance window allows automatic control of when each
@@ -65,6 +65,13 @@
 namespace seq64
 {
 
+/**
+ *  The widest miniature of a pattern kept by the song editor, in pixels.  A
+ *  pattern wider than this at the current zoom is drawn note by note.
+ */
+
+static const int c_max_miniature_w = 4096;
+
 /**
  *  Static (private) convenience values.  We need to be able to adjust
  *  sm_perfroll_background_x per the selected PPQN value.  This adjustment is
@@ -142,6 +149,7 @@ perfroll::perfroll
     m_measure_length        (0),
     m_beat_length           (0),
     m_old_progress_ticks    (0),
+    m_progress_drawn        (false),
 #ifdef SEQ64_FOLLOW_PROGRESS_BAR
     m_scroll_page           (0),
 #endif
@@ -170,7 +178,10 @@ perfroll::perfroll
 #endif
     m_moving                (false),
     m_growing               (false),
-    m_grow_direction        (false)
+    m_grow_direction        (false),
+    m_miniatures            (),
+    m_miniature_gc          (),
+    m_rows_current          (false)
 {
     set_ppqn(ppqn);                                         // choose_ppqn(ppqn)
     for (int i = 0; i < m_sequence_max; ++i)
@@ -233,11 +244,81 @@ perfroll::change_horz ()
 #ifdef SEQ64_SONG_BOX_SELECT
         m_scroll_offset_x = int(m_hadjust.get_value()) / m_zoom;
 #endif
+        midipulse old_offset = m_4bar_offset;
         m_4bar_offset = current_offset;
+
+        bool shifted = m_rows_current && scroll_pixmap(old_offset);
         enqueue_draw();
+        m_rows_current = shifted;       /* the expose is then only a copy   */
     }
 }
 
+/**
+ *  Scrolls the rows drawn in m_pixmap horizontally, after a change of
+ *  m_4bar_offset, by copying what stays in view to its new place.  Only the
+ *  strip that scrolled into view is drawn, with m_gc clipped to it.
+ *
+ *  The copy is exact only if both offsets fall on pixel boundaries, which
+ *  they do at the usual PPQN and zoom values.  If not, or if the scroll is
+ *  a page or more, the caller draws everything.
+ *
+ * \param old_offset
+ *      The offset that m_pixmap was drawn for.
+ *
+ * \return
+ *      Returns true if m_pixmap now holds every visible row at the new
+ *      offset.
+ */
+
+bool
+perfroll::scroll_pixmap (midipulse old_offset)
+{
+    midipulse delta = m_4bar_offset - old_offset;
+    if (! m_pixmap || (delta % m_perf_scale_x) != 0)
+        return false;
+
+    if ((m_4bar_offset % m_perf_scale_x) != 0)
+        return false;
+
+    int dx = int(delta / m_perf_scale_x);       /* > 0 if scrolled right    */
+    if (dx >= m_window_x || -dx >= m_window_x)
+        return false;
+
+    int strip_x;
+    int strip_w;
+    if (dx > 0)
+    {
+        strip_w = dx;
+        strip_x = m_window_x - strip_w;
+        m_pixmap->draw_drawable
+        (
+            m_gc, m_pixmap, dx, 0, 0, 0, m_window_x - strip_w, m_window_y
+        );
+    }
+    else
+    {
+        strip_w = -dx;
+        strip_x = 0;
+        m_pixmap->draw_drawable
+        (
+            m_gc, m_pixmap, 0, 0, strip_w, 0, m_window_x - strip_w, m_window_y
+        );
+    }
+
+    Gdk::Rectangle strip(strip_x, 0, strip_w, m_window_y);
+    m_gc->set_clip_rectangle(strip);
+
+    int yf = m_window_y / m_names_y;
+    for (int y = 0; y <= yf; ++y)
+    {
+        int seq = y + m_sequence_offset;
+        if (seq < m_sequence_max)           /* see on_expose_event()        */
+            draw_sequence(seq);
+    }
+    m_gc->set_clip_mask(Glib::RefPtr<Gdk::Bitmap>());  /* unclip           */
+    return true;
+}
+
 /**
  *  Changes the vertical offset member and queues up a draw operation.
  *
@@ -328,7 +409,7 @@ perfroll::update_sizes ()
     if (is_realized())
         m_pixmap = Gdk::Pixmap::create(m_window, m_window_x, m_window_y, -1);
 
-    enqueue_draw();
+    enqueue_draw();                             /* a new, blank m_pixmap    */
 }
 
 /**
@@ -436,12 +517,14 @@ perfroll::set_guides (int snap, int measure, int beat)
  *
  *  The parent perfedit will call perfroll::queue_draw() on behalf of this
  *  object, and it will pass a perfroll::enqueue_draw() to the peer perfedit's
- *  perfroll, if the peer exists.
+ *  perfroll, if the peer exists.  Since the caller expects everything to be
+ *  drawn again, the rows in m_pixmap are no longer current.
  */
 
 void
 perfroll::enqueue_draw ()
 {
+    m_rows_current = false;
 #ifdef SEQ64_SONG_BOX_SELECT
     if (m_box_select)
         draw_selection_on_window();
@@ -471,10 +554,15 @@ perfroll::enqueue_draw ()
 void
 perfroll::draw_progress ()
 {
-    midipulse tick = perf().get_tick();
+    midipulse tick = perf().transport().ts_tick;
     midipulse tick_offset = m_4bar_offset;
     int progress_x = (tick - tick_offset) / m_perf_scale_x;
     int old_progress_x = (m_old_progress_ticks - tick_offset) / m_perf_scale_x;
+    if (m_progress_drawn && progress_x == old_progress_x)
+    {
+        m_old_progress_ticks = tick;
+        return;                                 /* nothing visible changed  */
+    }
     if (usr().progress_bar_thick())
     {
         draw_drawable(old_progress_x-1, 0, old_progress_x-1, 0, 3, m_window_y);
@@ -501,6 +589,7 @@ perfroll::draw_progress ()
      */
 
     m_old_progress_ticks = tick;
+    m_progress_drawn = true;
 
 #ifdef USE_STAZED_PERF_AUTO_SCROLL  // no longer needed, left here just in case
     auto_scroll_horz();             // but sequencer64 now does this anyway
@@ -618,6 +707,17 @@ perfroll::auto_scroll_horz ()
 /**
  *  Draws the given pattern/sequence on the given drawable area.
  *  Statement nesting from hell!
+ *
+ *  Only the triggers in view are drawn, and, within each repetition of the
+ *  pattern in a trigger, only the notes in view are visited (see
+ *  sequence::visit_notes()).  Nothing here uses the iterators shared with
+ *  other views, so the song editor and a pattern editor can no longer spoil
+ *  each other's drawing.
+ *
+ *  Each repetition in view is a copy of the miniature of the pattern (see
+ *  pattern_image()), so the events of the pattern are not visited at all
+ *  unless it was edited or the zoom changed.  A pattern too long to keep as
+ *  an image is drawn note by note, as before.
  */
 
 void
@@ -628,25 +728,37 @@ perfroll::draw_sequence_on (int seqnum)
     {
         midipulse tick_offset = m_4bar_offset;      //  * m_ticks_per_bar;
         midipulse x_offset = tick_offset / m_perf_scale_x;
+        midipulse last_tick = tick_offset + m_window_x * m_perf_scale_x;
+        int row = seqnum - m_sequence_offset;
         m_sequence_active[seqnum] = true;
-        seq->reset_draw_trigger_marker();
-        seqnum -= m_sequence_offset;
+
+        std::vector<trigger> trigs;             /* copied, then drawn       */
+        seq->visit_triggers
+        (
+            tick_offset, last_tick,
+            [&trigs] (const trigger & t) { trigs.push_back(t); }
+        );
 
         midipulse sequence_length = seq->get_length();
         int length_w = sequence_length / m_perf_scale_x;
-        midipulse tick_on;
-        midipulse tick_off;
-        midipulse offset;
-        bool selected;
-        while (seq->get_next_trigger(tick_on, tick_off, selected, offset))
+        bool have_minmax = false;               /* only if drawing notes    */
+        bool have_notes = false;
+        int low_note = 0;
+        int high_note = 0;
+        std::vector<trigger>::const_iterator ti;
+        for (ti = trigs.begin(); ti != trigs.end(); ++ti)
         {
+            midipulse tick_on = ti->tick_start();
+            midipulse tick_off = ti->tick_end();
+            midipulse offset = ti->offset();
+            bool selected = ti->selected();
             if (tick_off > 0)
             {
                 midipulse x_on  = tick_on  / m_perf_scale_x;
                 midipulse x_off = tick_off / m_perf_scale_x;
                 int w = x_off - x_on + 1;
                 int x = x_on;
-                int y = m_names_y * seqnum + 1;         // + 2
+                int y = m_names_y * row + 1;            // + 2
                 int h = m_names_y - 2;                  // - 4
                 x -= x_offset;                  /* adjust to screen coords  */
 
@@ -654,44 +766,78 @@ perfroll::draw_sequence_on (int seqnum)
                  * Items drawn on the Song editor piano roll:
                  *
                  *  -# Main trigger box (also called a "segment") background.
+                 *  -# The repetitions of the pattern, each with its length
+                 *     marker.
                  *  -# Trigger outline (the rectangle around a "segment").
                  *  -# The left hand side little sequence grab handle,
                  *     or segment handle.
                  *  -# The right-side segment handle.
-                 *
-                 *  printf
-                 *  (
-                 *      "seq %d trigger: %s\n",
-                 *      seqnum, selected ? "selected" : "unselected"
-                 *  );
                  */
 
                 draw_rectangle_on_pixmap        /* fill segment background  */
                 (
                     selected ? grey() : white_paint(), x, y, w, h
                 );
-                draw_rectangle_on_pixmap(black_paint(), x, y, w, h, false);
-                draw_rectangle_on_pixmap        /* draw the segment handle  */
-                (
-                    dark_cyan(),                /* instead of black()       */
-                    x, y, m_size_box_w, m_size_box_w, false
-                );
-                draw_rectangle_on_pixmap        /* color set previous call  */
-                (
-                    x + w - m_size_box_w, y + h - m_size_box_w,
-                    m_size_box_w, m_size_box_w, false
-                );
+
+                /*
+                 * The inside of the trigger box that is in view.  The
+                 * repetitions are clipped to it.
+                 */
+
+                int clip_x0 = x + 1 > 0 ? x + 1 : 0 ;
+                int clip_x1 = x + w - 1 < m_window_x ?
+                    x + w - 1 : m_window_x - 1 ;
 
                 midipulse tickmarker =          /* length marker first tick */
                 (
                     tick_on - (tick_on % sequence_length) +
                     (offset % sequence_length) - sequence_length
                 );
+                if (tickmarker + sequence_length < tick_offset)
+                {
+                    midipulse gap = tick_offset - sequence_length - tickmarker;
+                    tickmarker += gap - (gap % sequence_length);
+                }
+
+                Glib::RefPtr<Gdk::Pixmap> image =
+                    pattern_image(seqnum, *seq, selected);
+
                 while (tickmarker < tick_off)
                 {
                     midipulse tickmarker_x =
                         (tickmarker / m_perf_scale_x) - x_offset;
 
+                    if (tickmarker_x > clip_x1)
+                        break;                          /* past the view    */
+
+                    if (image)
+                    {
+                        /*
+                         * The image is one pixel wider than a repetition,
+                         * for the notes that end with it; the next
+                         * repetition is copied over that column.
+                         */
+
+                        int src_x0 = clip_x0 - tickmarker_x;
+                        int src_x1 = clip_x1 - tickmarker_x;
+                        if (src_x0 < 0)
+                            src_x0 = 0;
+
+                        if (src_x1 > length_w)
+                            src_x1 = length_w;
+
+                        if (src_x0 <= src_x1)
+                        {
+                            m_pixmap->draw_drawable
+                            (
+                                m_gc, image, src_x0, 1,
+                                tickmarker_x + src_x0, y + 1,
+                                src_x1 - src_x0 + 1, h - 1
+                            );
+                        }
+                        tickmarker += sequence_length;
+                        continue;
+                    }
                     if (tickmarker > tick_on)
                     {
                         draw_rectangle
@@ -699,123 +845,249 @@ perfroll::draw_sequence_on (int seqnum)
                             m_pixmap, light_grey(), tickmarker_x, y + 4, 1, h - 8
                         );
                     }
-
-                    int low_note, high_note;            // for side-effects
-                    bool have_notes = seq->get_minmax_note_events
-                    (
-                        low_note, high_note             // side-effects
-                    );
-                    if (have_notes)
+                    if (! have_minmax)
+                    {
+                        have_notes = seq->get_minmax_note_events
+                        (
+                            low_note, high_note         // side-effects
+                        );
+                        have_minmax = true;
+                    }
+                    if (have_notes && length_w > 0 && clip_x0 <= clip_x1)
                     {
-                        int height = high_note - low_note + 2;
-                        int length = seq->get_length();
-                        midipulse tick_s;
-                        midipulse tick_f;
-                        int note;
-                        bool selected;
-                        int velocity;
-                        draw_type_t dt;
-
-#ifdef SEQ64_STAZED_TRANSPOSE
-
                         /*
-                         * If a pattern is not transposable, draw it in red
-                         * instead of black.
+                         * The pattern ticks that land in view in this
+                         * repetition, widened by a pixel to allow for the
+                         * rounding of the pixel math below.
                          */
 
-                        bool transposable = seq->get_transposable();
-                        if (transposable)
-                            m_gc->set_foreground(black_paint());
-                        else
-                            m_gc->set_foreground(red());
-#else
-                        bool transposable = false;
-                        m_gc->set_foreground(black_paint());
-#endif
+                        midipulse window_s =
+                            (clip_x0 - tickmarker_x - 1) * sequence_length /
+                            length_w;
+
+                        midipulse window_f =
+                            (clip_x1 - tickmarker_x + 1) * sequence_length /
+                            length_w;
 
-                        seq->reset_draw_marker();       /* container iterator */
-                        do
+                        if (window_f >= 0 && window_s <= sequence_length)
                         {
-                            dt = seq->get_next_note_event   /* side-effects */
+                            draw_notes_on
                             (
-                                tick_s, tick_f, note, selected, velocity
+                                m_pixmap, m_gc, *seq, low_note, high_note,
+                                tickmarker_x, x, y, w, window_s, window_f
                             );
-                            if (dt == DRAW_FIN)
-                                break;
-
-                            int mny = m_names_y - 6;
-                            int note_y;
-                            if (dt == DRAW_TEMPO)
-                            {
-                                /*
-                                 * Do not to scale by the note range here.
-                                 */
-
-                                note_y =
-                                (
-                                    mny - (mny * note) / SEQ64_MAX_DATA_VALUE
-                                ) + 1;
-                            }
-                            else
-                            {
-                                note_y =
-                                (
-                                    mny - (mny * (note - low_note)) / height
-                                ) + 1;
-                            }
-                            int tick_s_x =
-                                ((tick_s * length_w) / length) + tickmarker_x;
-
-                            int tick_f_x =
-                                ((tick_f * length_w) / length) + tickmarker_x;
-
-                            if (dt == DRAW_NOTE_ON || dt == DRAW_NOTE_OFF)
-                                tick_f_x = tick_s_x + 1;
-
-                            if (tick_f_x <= tick_s_x)
-                                tick_f_x = tick_s_x + 1;
-
-                            if (tick_s_x < x)
-                                tick_s_x = x;
-
-                            if (tick_f_x > x + w)
-                                tick_f_x = x + w;
-
-                            if (tick_f_x >= x && tick_s_x <= x + w)
-                            {
-                                int ny = y + note_y;
-                                Color paint = transposable ? black_paint() : red();
-                                if (dt == DRAW_TEMPO)
-                                {
-                                    set_line(Gdk::LINE_SOLID, 2);
-                                    paint = tempo_paint();
-                                }
-                                draw_line_on_pixmap
-                                (
-                                    paint, tick_s_x, ny, tick_f_x, ny
-                                );
-                                if (dt == DRAW_TEMPO)
-                                {
-                                    /*
-                                     * We would like to also draw a line from
-                                     * the end of the current tempo to the
-                                     * start of the next one.  But we
-                                     * currently have only the x value of the
-                                     * next tempo.
-                                     */
-
-                                    set_line(Gdk::LINE_SOLID, 1);
-                                }
-                            }
-                        } while (dt != DRAW_FIN);
+                        }
                     }
                     tickmarker += sequence_length;
                 }
+                draw_rectangle_on_pixmap(black_paint(), x, y, w, h, false);
+                draw_rectangle_on_pixmap        /* draw the segment handle  */
+                (
+                    dark_cyan(),                /* instead of black()       */
+                    x, y, m_size_box_w, m_size_box_w, false
+                );
+                draw_rectangle_on_pixmap        /* color set previous call  */
+                (
+                    x + w - m_size_box_w, y + h - m_size_box_w,
+                    m_size_box_w, m_size_box_w, false
+                );
             }
         }
     }
 }
 
+/**
+ *  Provides the miniature of a pattern at the current zoom, making it if the
+ *  pattern changed since it was last made.  It is drawn as one repetition in
+ *  a trigger box starting at x = 0 would be, including the length marker,
+ *  which the first repetition of a box never shows, since the box outline
+ *  covers it.
+ *
+ * \param seqnum
+ *      The number of the pattern.
+ *
+ * \param seq
+ *      The pattern.
+ *
+ * \param selected
+ *      True for the image on the background of a selected trigger.
+ *
+ * \return
+ *      Returns the image, which is one pixel wider than a repetition and as
+ *      high as a trigger box.  It is empty (false) if the pattern is too
+ *      long to keep as an image at this zoom.
+ */
+
+Glib::RefPtr<Gdk::Pixmap>
+perfroll::pattern_image (int seqnum, const sequence & seq, bool selected)
+{
+    midipulse length = seq.get_length();
+    int length_w = length / m_perf_scale_x;
+    if (length_w <= 0 || length_w > c_max_miniature_w || ! m_miniature_gc)
+        return Glib::RefPtr<Gdk::Pixmap>();
+
+#ifdef SEQ64_STAZED_TRANSPOSE
+    bool transposable = seq.get_transposable();
+#else
+    bool transposable = true;
+#endif
+
+    if (seqnum >= int(m_miniatures.size()))
+        m_miniatures.resize(seqnum + 1);
+
+    miniature & m = m_miniatures[seqnum];
+    if
+    (
+        m.m_seq != &seq || m.m_version != seq.edit_version() ||
+        m.m_length != length || m.m_scale != m_perf_scale_x ||
+        m.m_transposable != transposable
+    )
+    {
+        m.m_seq = &seq;
+        m.m_version = seq.edit_version();   /* before reading the events    */
+        m.m_length = length;
+        m.m_scale = m_perf_scale_x;
+        m.m_transposable = transposable;
+        m.m_images[0] = m.m_images[1] = Glib::RefPtr<Gdk::Pixmap>();
+    }
+
+    Glib::RefPtr<Gdk::Pixmap> & image = m.m_images[selected ? 1 : 0];
+    if (! image)
+    {
+        int w = length_w + 1;
+        int h = m_names_y - 2;
+        image = Gdk::Pixmap::create(m_window, w, h, -1);
+        m_miniature_gc->set_foreground(selected ? grey() : white_paint());
+        image->draw_rectangle(m_miniature_gc, true, 0, 0, w, h);
+        m_miniature_gc->set_foreground(light_grey());
+        image->draw_rectangle(m_miniature_gc, true, 0, 4, 1, h - 8);
+
+        int low_note, high_note;
+        if (seq.get_minmax_note_events(low_note, high_note))
+        {
+            draw_notes_on
+            (
+                image, m_miniature_gc, seq, low_note, high_note,
+                0, 0, 0, length_w, 0, length
+            );
+        }
+    }
+    return image;
+}
+
+/**
+ *  Draws the notes of one repetition of a pattern in a trigger box.
+ *
+ * \param pixmap
+ *      The pixmap to draw on:  m_pixmap, or the miniature of the pattern.
+ *
+ * \param gc
+ *      The graphics context to draw with.
+ *
+ * \param seq
+ *      The pattern.
+ *
+ * \param low_note
+ *      The lowest note in the pattern, for scaling.
+ *
+ * \param high_note
+ *      The highest note in the pattern, for scaling.
+ *
+ * \param tickmarker_x
+ *      The x coordinate of the start of the repetition.
+ *
+ * \param x
+ *      The x coordinate of the trigger box.
+ *
+ * \param y
+ *      The y coordinate of the trigger box.
+ *
+ * \param w
+ *      The width of the trigger box.
+ *
+ * \param window_s
+ *      The first pattern tick to visit.
+ *
+ * \param window_f
+ *      The last pattern tick to visit.
+ */
+
+void
+perfroll::draw_notes_on
+(
+    Glib::RefPtr<Gdk::Pixmap> & pixmap, Glib::RefPtr<Gdk::GC> & gc,
+    const sequence & seq, int low_note, int high_note, int tickmarker_x,
+    int x, int y, int w, midipulse window_s, midipulse window_f
+)
+{
+    int height = high_note - low_note + 2;
+    int length = seq.get_length();
+    int length_w = length / m_perf_scale_x;
+    int mny = m_names_y - 6;
+
+#ifdef SEQ64_STAZED_TRANSPOSE
+
+    /*
+     * If a pattern is not transposable, draw it in red instead of black.
+     */
+
+    bool transposable = seq.get_transposable();
+#else
+    bool transposable = true;
+#endif
+
+    seq.visit_notes
+    (
+        window_s, window_f, [&] (const sequence::note_info & ni)
+        {
+            draw_type_t dt = ni.ni_type;
+            int note_y;
+            if (dt == DRAW_TEMPO)                   /* do not scale by range */
+                note_y = (mny - (mny * ni.ni_note) / SEQ64_MAX_DATA_VALUE) + 1;
+            else
+                note_y = (mny - (mny * (ni.ni_note - low_note)) / height) + 1;
+
+            int tick_s_x = ((ni.ni_start * length_w) / length) + tickmarker_x;
+            int tick_f_x = ((ni.ni_finish * length_w) / length) + tickmarker_x;
+            if (dt == DRAW_NOTE_ON || dt == DRAW_NOTE_OFF)
+                tick_f_x = tick_s_x + 1;
+
+            if (tick_f_x <= tick_s_x)
+                tick_f_x = tick_s_x + 1;
+
+            if (tick_s_x < x)
+                tick_s_x = x;
+
+            if (tick_f_x > x + w)
+                tick_f_x = x + w;
+
+            if (tick_f_x >= x && tick_s_x <= x + w)
+            {
+                int ny = y + note_y;
+                if (dt == DRAW_TEMPO)
+                {
+                    gc->set_line_attributes
+                    (
+                        2, Gdk::LINE_SOLID, Gdk::CAP_NOT_LAST, Gdk::JOIN_MITER
+                    );
+                    gc->set_foreground(tempo_paint());
+                }
+                else
+                    gc->set_foreground(transposable ? black_paint() : red());
+
+                pixmap->draw_line(gc, tick_s_x, ny, tick_f_x, ny);
+                if (dt == DRAW_TEMPO)
+                {
+                    gc->set_line_attributes
+                    (
+                        1, Gdk::LINE_SOLID, Gdk::CAP_NOT_LAST, Gdk::JOIN_MITER
+                    );
+                }
+            }
+        }
+    );
+}
+
 /**
  *  Draws the given pattern/sequence background on the given drawable area.
  */
@@ -853,6 +1125,9 @@ void perfroll::draw_background_on (int seqnum)
 void
 perfroll::redraw_dirty_sequences ()
 {
+    if (! perf().any_dirty_perf())          /* lock-free, usually nothing   */
+        return;
+
     bool draw = false;
     int yf = m_window_y / m_names_y;
     for (int y = 0; y <= yf; ++y)
@@ -865,7 +1140,10 @@ perfroll::redraw_dirty_sequences ()
         }
     }
     if (draw)
+    {
         draw_drawable(0, 0, 0, 0, m_window_x, m_window_y);
+        m_progress_drawn = false;
+    }
 }
 
 /**
@@ -885,6 +1163,7 @@ perfroll::draw_drawable_row (int y)
     {
         int s = y / m_names_y;
         draw_drawable(0, s * m_names_y, 0, s * m_names_y, m_window_x, m_names_y);
+        m_progress_drawn = false;
     }
 }
 
@@ -916,6 +1195,7 @@ perfroll::draw_selection_on_window ()
     {
         m_old.get(x, y, w, h);                      /* get rectangle        */
         draw_drawable(x, y, x, y, w + 1, h + 1);    /* erase old rectangle  */
+        m_progress_drawn = false;
         m_selected.get(x, y, w, h);
     }
 
@@ -1124,6 +1404,7 @@ perfroll::on_realize ()
         m_window, m_background_x, m_names_y, -1
     );
     fill_background_pixmap(); /* fill the background (dotted lines n' such) */
+    m_miniature_gc = Gdk::GC::create(m_window);
 }
 
 /**
@@ -1137,6 +1418,10 @@ perfroll::on_realize ()
  *  prevents debug messages about an illegal sequence, and can show a black
  *  bottom row that is a clear sign we're at the end of the legal sequences.
  *
+ *  If m_pixmap already holds the rows as they should be drawn (for example,
+ *  after a horizontal scroll, or when the window is merely uncovered), it is
+ *  only copied to the window.
+ *
  * \param ev
  *      Provides the expose event.
  *
@@ -1147,19 +1432,25 @@ perfroll::on_realize ()
 bool
 perfroll::on_expose_event (GdkEventExpose * ev)
 {
-    int ys = ev->area.y / m_names_y;
-    int yf = (ev->area.y + ev->area.height) / m_names_y;
-    for (int y = ys; y <= yf; ++y)
+    if (! m_rows_current)
     {
-        int seq = y + m_sequence_offset;
-        if (seq < m_sequence_max)           /* see note in banner */
-            (void) draw_sequence(seq);
+        int ys = ev->area.y / m_names_y;
+        int yf = (ev->area.y + ev->area.height) / m_names_y;
+        for (int y = ys; y <= yf; ++y)
+        {
+            int seq = y + m_sequence_offset;
+            if (seq < m_sequence_max)           /* see note in banner */
+                (void) draw_sequence(seq);
+        }
+        if (ev->area.y <= 0 && ev->area.y + ev->area.height >= m_window_y)
+            m_rows_current = true;              /* all of them were drawn   */
     }
     m_window->draw_drawable
     (
         m_gc, m_pixmap, ev->area.x, ev->area.y,
         ev->area.x, ev->area.y, ev->area.width, ev->area.height
     );
+    m_progress_drawn = false;
     return true;
 }
 
@@ -26,7 +26,7 @@
  * \library       sequencer64 application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2015-07-24
- * \updates       2017-08-03
+ * \updates       2026-10-18
  * \license       GNU GPLv2 or above
  *
  *  The data area consists of vertical lines, with the height of each line
@@ -143,7 +143,7 @@ seqdata::reset ()
      * redraw();
      */
 
-    update_pixmap();
+    draw_events_on_pixmap();                /* the data did not change      */
     force_draw();
 }
 
@@ -189,12 +189,15 @@ seqdata::set_data_type (midibyte status, midibyte control)
 }
 
 /**
- *  Simply calls draw_events_on_pixmap().
+ *  Drops the summary of the lane and calls draw_events_on_pixmap().  Call
+ *  this function after changing the data, and draw_events_on_pixmap() after
+ *  only changing the view.
  */
 
 void
 seqdata::update_pixmap ()
 {
+    m_summary.clear();
     draw_events_on_pixmap();
 }
 
@@ -242,6 +245,8 @@ seqdata::draw_events_on (Glib::RefPtr<Gdk::Drawable> drawable)
     draw_rectangle(drawable, black_paint(), 0, 0, m_window_x, m_window_y);
     draw_rectangle(drawable, white_paint(), 1, 1, m_window_x-2, m_window_y-1);
     m_gc->set_foreground(black_paint());
+    if (draw_summary_on(drawable, starttick, endtick))
+        return;                             /* too dense to draw exactly    */
 
 #ifdef USE_STAZED_SEQDATA_EXTENSIONS
     int numselected = EVENTS_ALL;
@@ -257,10 +262,13 @@ seqdata::draw_events_on (Glib::RefPtr<Gdk::Drawable> drawable)
 #endif
 
         event_list::const_iterator ev;
-        m_seq.reset_ex_iterator(ev);
+        m_seq.reset_ex_iterator(ev, starttick);    /* skip what is off left */
         while (m_seq.get_next_event_ex(m_status, m_cc, ev))
         {
             midipulse tick = ev->get_timestamp();
+            if (tick > endtick)
+                break;                      /* the rest is off right    */
+
             bool selected = ev->is_selected();
             if (tick >= starttick && tick <= endtick)
             {
@@ -348,6 +356,119 @@ seqdata::draw_events_on (Glib::RefPtr<Gdk::Drawable> drawable)
 #endif
 }
 
+/**
+ *  Draws the lane from its summary, one column per pixel, if the events in
+ *  view are denser than the pixels.  Each column is drawn as the lines of
+ *  its events would overlap:  solid up to the lowest value, which all of
+ *  them reach, and lighter from there to the highest value.  A column with
+ *  one value looks just like the line of a single event.  The value labels
+ *  are left out, as they would only overwrite each other.  Tempo events are
+ *  few, and are drawn exactly, as in draw_events_on().
+ *
+ * \param drawable
+ *      The given drawable object.
+ *
+ * \param starttick
+ *      The tick at the left edge of the view.
+ *
+ * \param endtick
+ *      The tick at the right edge of the view.
+ *
+ * \return
+ *      Returns false, having drawn nothing, if no pixel of the view has
+ *      more than one event, in which case the caller draws the events
+ *      exactly.
+ */
+
+bool
+seqdata::draw_summary_on
+(
+    Glib::RefPtr<Gdk::Drawable> drawable, int starttick, int endtick
+)
+{
+    if (! m_summary.current(m_status, m_cc))
+        m_summary.build(m_seq, m_status, m_cc);
+
+    int level = data_summary::level_for(m_zoom);
+    const std::vector<data_summary::column> & spans = m_summary.level(level);
+    std::vector<data_summary::column> columns;      /* c_tick is the pixel  */
+    bool dense = false;
+    for
+    (
+        std::size_t i = m_summary.first(level, starttick);
+        i < spans.size() && spans[i].c_tick <= endtick; ++i
+    )
+    {
+        const data_summary::column & sp = spans[i];
+        midipulse x = sp.c_tick / m_zoom;
+        if (! columns.empty() && columns.back().c_tick == x)
+        {
+            data_summary::column & c = columns.back();
+            if (sp.c_min < c.c_min)
+                c.c_min = sp.c_min;
+
+            if (sp.c_max > c.c_max)
+                c.c_max = sp.c_max;
+
+            c.c_count += sp.c_count;
+            c.c_selected = c.c_selected || sp.c_selected;
+        }
+        else
+        {
+            columns.push_back(sp);
+            columns.back().c_tick = x;
+        }
+        if (columns.back().c_count > 1)
+            dense = true;
+    }
+    if (! dense)
+        return false;
+
+    set_line(Gdk::LINE_SOLID, 2);                   /* vertical event lines */
+    for (std::size_t i = 0; i < columns.size(); ++i)
+    {
+        const data_summary::column & c = columns[i];
+        int x = int(c.c_tick) - m_scroll_offset_x + 1;
+        draw_line
+        (
+            drawable, c.c_selected ? dark_orange() : black_paint(),
+            x, c_dataarea_y - c.c_min, x, c_dataarea_y
+        );
+        if (c.c_max > c.c_min)
+        {
+            draw_line
+            (
+                drawable, c.c_selected ? orange() : dark_grey(),
+                x, c_dataarea_y - c.c_max, x, c_dataarea_y - c.c_min
+            );
+        }
+    }
+
+    const std::vector<data_summary::tempo_mark> & tempos = m_summary.tempos();
+    for (std::size_t i = 0; i < tempos.size(); ++i)
+    {
+        const data_summary::tempo_mark & tm = tempos[i];
+        if (tm.tm_tick < starttick || tm.tm_tick > endtick)
+            continue;
+
+        int event_x = tm.tm_tick / m_zoom;
+        int x = event_x - m_scroll_offset_x + 1;
+        Color paint = tm.tm_selected ? dark_orange() : tempo_paint();
+        set_line(Gdk::LINE_SOLID, 2);
+        draw_line
+        (
+            drawable, paint, x, c_dataarea_y - tm.tm_value, x, c_dataarea_y
+        );
+        draw_rectangle                              /* draw handle          */
+        (
+            drawable, paint, event_x - m_scroll_offset_x - 3,
+            c_dataarea_y - tm.tm_value, c_data_handle_x, c_data_handle_y
+        );
+        render_digits(drawable, int(tm.tm_bpm), x);
+    }
+    return true;
+}
+
 /**
  *  Draws events on this object's built-in window and pixmap.
  *  This drawing is done only if there is no dragging in progress, to
@@ -403,7 +524,7 @@ seqdata::change_horz ()
 {
     m_scroll_offset_ticks = int(m_hadjust.get_value());
     m_scroll_offset_x = m_scroll_offset_ticks / m_zoom;
-    update_pixmap();
+    draw_events_on_pixmap();                /* the data did not change      */
     force_draw();
 }
 
@@ -25,7 +25,7 @@
  * \library       sequencer64 application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2015-07-24
- * \updates       2017-12-21
+ * \updates       2026-10-18
  * \license       GNU GPLv2 or above
  *
  *  Compare this class to eventedit, which has to do some similar things,
@@ -64,6 +64,8 @@
  *      -   m_menu_zoom.
  */
 
+#include <limits>                       /* std::numeric_limits<>        */
+
 #include <gtkmm/adjustment.h>
 #include <gtkmm/image.h>
 #include <gtkmm/menu.h>
@@ -1831,42 +1833,47 @@ seqedit::repopulate_event_menu (int buss, int channel)
     bool program_change = false;
     bool channel_pressure = false;
     bool pitch_wheel = false;
-    midibyte status, cc;
     memset(ccs, false, sizeof(bool) * SEQ64_MIDI_COUNT_MAX);
-    m_seq.reset_draw_marker();
-    while (m_seq.get_next_event(status, cc))            /* used only here!  */
-    {
-        switch (status)
+    m_seq.visit_events                                  /* used only here!  */
+    (
+        0, std::numeric_limits<midipulse>::max(), EVENT_ANY, 0,
+        [&] (const event & e)
         {
-        case EVENT_NOTE_OFF:
-            note_off = true;
-            break;
+            midibyte status = e.get_status();
+            midibyte cc, j;
+            e.get_data(cc, j);
+            switch (status)
+            {
+            case EVENT_NOTE_OFF:
+                note_off = true;
+                break;
 
-        case EVENT_NOTE_ON:
-            note_on = true;
-            break;
+            case EVENT_NOTE_ON:
+                note_on = true;
+                break;
 
-        case EVENT_AFTERTOUCH:
-            aftertouch = true;
-            break;
+            case EVENT_AFTERTOUCH:
+                aftertouch = true;
+                break;
 
-        case EVENT_CONTROL_CHANGE:
-            ccs[cc] = true;
-            break;
+            case EVENT_CONTROL_CHANGE:
+                ccs[cc] = true;
+                break;
 
-        case EVENT_PITCH_WHEEL:
-            pitch_wheel = true;
-            break;
+            case EVENT_PITCH_WHEEL:
+                pitch_wheel = true;
+                break;
 
-        case EVENT_PROGRAM_CHANGE:
-            program_change = true;
-            break;
+            case EVENT_PROGRAM_CHANGE:
+                program_change = true;
+                break;
 
-        case EVENT_CHANNEL_PRESSURE:
-            channel_pressure = true;
-            break;
+            case EVENT_CHANNEL_PRESSURE:
+                channel_pressure = true;
+                break;
+            }
         }
-    }
+    );
 
 #define SET_DATA_TYPE(x)    mem_fun(*this, &seqedit::set_data_type), x, 0
 
@@ -2841,18 +2848,15 @@ seqedit::stop_playing()
 #endif
 
 /**
- *  On realization, calls the base-class version, and connects the redraw
- *  timeout signal, timed at redraw_period_ms().
+ *  On realization, calls the base-class version, and starts the redraw
+ *  frames, which begin at a period of redraw_period_ms().
  */
 
 void
 seqedit::on_realize ()
 {
     gui_window_gtk2::on_realize();
-    Glib::signal_timeout().connect
-    (
-        mem_fun(*this, &seqedit::timeout), redraw_period_ms()
-    );
+    start_frames(mem_fun(*this, &seqedit::timeout));
 }
 
 /**
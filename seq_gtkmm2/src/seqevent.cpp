@@ -379,11 +379,14 @@ seqevent::draw_events_on (Glib::RefPtr<Gdk::Drawable> drawable)
     int starttick = m_scroll_offset_ticks;
     int endtick = (m_window_x * m_zoom) + m_scroll_offset_ticks;
     event_list::const_iterator ev;
-    m_seq.reset_ex_iterator(ev);
+    m_seq.reset_ex_iterator(ev, starttick);    /* skip what is off left */
     m_gc->set_foreground(black_paint());
     while (m_seq.get_next_event_ex(m_status, m_cc, ev))
     {
         midipulse tick = ev->get_timestamp();
+        if (tick > endtick)
+            break;                      /* the rest is off right    */
+
         bool selected = ev->is_selected();
         if (tick >= starttick && tick <= endtick)
         {
@@ -25,7 +25,7 @@
  * \library       sequencer64 application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2015-07-24
- * \updates       2017-10-08
+ * \updates       2026-10-18
  * \license       GNU GPLv2 or above
  *
  *  There are a large number of existing items to discuss.  But for now let's
@@ -70,6 +70,9 @@
  *  progress bar during playback.
  */
 
+#include <algorithm>                    /* std::sort()                  */
+#include <functional>                   /* std::bind()                  */
+
 #include <gdkmm/cursor.h>
 #include <gtkmm/accelkey.h>
 #include <gtkmm/adjustment.h>
@@ -102,6 +105,40 @@ namespace seq64
 
 static const long s_handlesize = 16;
 
+/**
+ *  The most damaged boxes that redraw_events() repairs one by one.  Beyond
+ *  this, they are merged into one box, which is cheaper than many.
+ */
+
+static const int c_max_damage = 16;
+
+/**
+ *  Orders the notes in view by time, then by every other field, so that two
+ *  sorted lists of notes can be compared in one pass.  Two notes are the
+ *  same if neither is less than the other.
+ */
+
+static bool
+note_less (const sequence::note_info & a, const sequence::note_info & b)
+{
+    if (a.ni_start != b.ni_start)
+        return a.ni_start < b.ni_start;
+
+    if (a.ni_note != b.ni_note)
+        return a.ni_note < b.ni_note;
+
+    if (a.ni_finish != b.ni_finish)
+        return a.ni_finish < b.ni_finish;
+
+    if (a.ni_type != b.ni_type)
+        return a.ni_type < b.ni_type;
+
+    if (a.ni_selected != b.ni_selected)
+        return b.ni_selected;
+
+    return a.ni_velocity < b.ni_velocity;
+}
+
 /**
  *  Principal constructor.
  *
@@ -184,6 +221,7 @@ seqroll::seqroll
     m_move_delta_y          (0),
     m_move_snap_offset_x    (0),        /* used in fruityseqroll            */
     m_progress_x            (0),
+    m_progress_drawn        (false),
     m_scroll_offset_ticks   (0),
     m_scroll_offset_key     (0),
     m_scroll_offset_x       (0),
@@ -198,7 +236,16 @@ seqroll::seqroll
     m_drawing_background_seq(false),
     m_expanded_recording    (false),
     m_status                (0),
-    m_cc                    (0)
+    m_cc                    (0),
+    m_underlay              (),
+    m_drawn_notes           (),
+    m_drawn_valid           (false),
+    m_drawn_ticks           (0),
+    m_drawn_key             (0),
+    m_drawn_zoom            (0),
+    m_drawn_length          (0),
+    m_drawn_bgseq           (nullptr),
+    m_drawn_bgversion       (0)
 {
     m_ppqn = choose_ppqn(ppqn);
     m_old.clear();
@@ -297,6 +344,8 @@ seqroll::update_sizes ()
     {
         m_pixmap = Gdk::Pixmap::create(m_window, m_window_x, m_window_y, -1);
         m_background = Gdk::Pixmap::create(m_window, m_window_x, m_window_y, -1);
+        m_underlay = Gdk::Pixmap::create(m_window, m_window_x, m_window_y, -1);
+        m_drawn_valid = false;
         change_vert();
     }
 }
@@ -396,28 +445,125 @@ seqroll::update_and_draw (int force)
 }
 
 /**
- *  Redraws events unless m_ignore_redraw is true.  Actually, that member is
- *  not needed and no longer exists.
+ *  Redraws the notes that changed since they were last drawn.  This is
+ *  called whenever the sequence is marked dirty, which happens on every
+ *  edit, selection change, and recorded note, so it must not cost more
+ *  than the change does.
+ *
+ *  The notes now in view are compared with the notes drawn on the pixmap
+ *  (both are sorted), and the box of each note found in only one of the
+ *  lists is damaged.  Each damaged box is restored from the underlay, and
+ *  the notes that cross it are drawn again, clipped to it.  Only the
+ *  damaged boxes are then copied to the window.  Too many boxes are merged
+ *  into one.  If the view or the background sequence changed since the
+ *  notes were drawn, everything is drawn, as before.
  */
 
 void
 seqroll::redraw_events ()
 {
-    update_pixmap();
-    force_draw();
+    if (! drawn_current())
+    {
+        update_pixmap();
+        force_draw();
+        return;
+    }
+
+    std::vector<sequence::note_info> notes;
+    get_notes_in_view(notes);
+
+    std::vector<rect> damage;
+    std::vector<sequence::note_info>::const_iterator o = m_drawn_notes.begin();
+    std::vector<sequence::note_info>::const_iterator n = notes.begin();
+    while (o != m_drawn_notes.end() || n != notes.end())
+    {
+        rect r;
+        bool oldonly = n == notes.end() ||
+            (o != m_drawn_notes.end() && note_less(*o, *n));
+
+        if (oldonly)
+            note_box(*o++, r);                          /* erased, changed  */
+        else if (o == m_drawn_notes.end() || note_less(*n, *o))
+            note_box(*n++, r);                          /* added, changed   */
+        else
+        {
+            ++o;                                        /* unchanged        */
+            ++n;
+            continue;
+        }
+        if (r.x() < m_window_x && r.x() + r.width() > 0 &&
+            r.y() < m_window_y && r.y() + r.height() > 0)
+        {
+            damage.push_back(r);
+        }
+    }
+    m_drawn_notes.swap(notes);
+    if (damage.empty())
+        return;
+
+    if (int(damage.size()) > c_max_damage)
+    {
+        int x0 = damage[0].x();
+        int y0 = damage[0].y();
+        int x1 = x0 + damage[0].width();
+        int y1 = y0 + damage[0].height();
+        for (std::size_t d = 1; d < damage.size(); ++d)
+        {
+            const rect & r = damage[d];
+            x0 = std::min(x0, r.x());
+            y0 = std::min(y0, r.y());
+            x1 = std::max(x1, r.x() + r.width());
+            y1 = std::max(y1, r.y() + r.height());
+        }
+        damage.resize(1);
+        damage[0].set(x0, y0, x1 - x0, y1 - y0);
+    }
+    for (std::size_t d = 0; d < damage.size(); ++d)
+        repair_pixmap(damage[d], m_drawn_notes);
+
+    for (std::size_t d = 0; d < damage.size(); ++d)
+    {
+        int x, y, w, h;
+        damage[d].get(x, y, w, h);
+        draw_drawable(x, y, x, y, w, h);
+    }
+    m_progress_drawn = false;
+    draw_selection_on_window();
 }
 
 /**
- *  Draws the main pixmap.
+ *  Draws the background layers on the main pixmap:  the grid, then the
+ *  background sequence, if any, by way of the underlay.
  */
 
 void
 seqroll::draw_background_on_pixmap ()
 {
-    m_pixmap->draw_drawable
+    m_underlay->draw_drawable
     (
         m_gc, m_background, 0, 0, 0, 0, m_window_x, m_window_y
     );
+
+    sequence * bgseq = background_sequence();
+    if (not_nullptr(bgseq))
+    {
+        midipulse starttick = m_scroll_offset_ticks;
+        midipulse endtick = (m_window_x * m_zoom) + m_scroll_offset_ticks;
+        bgseq->visit_notes
+        (
+            starttick, endtick, std::bind
+            (
+                &seqroll::draw_note_on, std::ref(*this),
+                m_underlay, 0, std::placeholders::_1
+            )
+        );
+    }
+    m_drawn_bgseq = bgseq;
+    m_drawn_bgversion = not_nullptr(bgseq) ? bgseq->edit_version() : 0 ;
+    m_pixmap->draw_drawable
+    (
+        m_gc, m_underlay, 0, 0, 0, 0, m_window_x, m_window_y
+    );
 }
 
 /**
@@ -662,8 +808,12 @@ seqroll::draw_progress_on_window ()
     static int s_last_scroll = 0;
 #endif
 
-    if (perf().is_running())
+    if (perf().transport().ts_running)
     {
+        int progress_x = (m_seq.get_last_tick() / m_zoom) - m_scroll_offset_x;
+        if (m_progress_drawn && progress_x == m_progress_x)
+            return;                             /* nothing visible changed  */
+
         if (usr().progress_bar_thick())
         {
             draw_drawable(m_progress_x-1, 0, m_progress_x-1, 0, 2, m_window_y);
@@ -681,7 +831,7 @@ seqroll::draw_progress_on_window ()
         }
 #endif
 
-        m_progress_x = (m_seq.get_last_tick() / m_zoom) - m_scroll_offset_x;
+        m_progress_x = progress_x;
 
 #ifdef SEQ64_STAZED_EXPAND_RECORD
         if (m_progress_x < last_progress)
@@ -705,6 +855,7 @@ seqroll::draw_progress_on_window ()
             if (usr().progress_bar_thick())
                 set_line(Gdk::LINE_SOLID, 1);
         }
+        m_progress_drawn = true;
     }
 }
 
@@ -766,176 +917,301 @@ seqroll::follow_progress ()
 #endif      // SEQ64_FOLLOW_PROGRESS_BAR
 
 /**
- *  Draws events on the given drawable area.  "Method 0" draws the background
- *  sequence, if active.  "Method 1" draws the sequence itself.
+ *  Provides the background sequence, if it is to be drawn.
  *
- * \param draw
- *      The "drawable" area to draw on.
+ * \return
+ *      Returns a pointer to the background sequence, or a null pointer if
+ *      there is none, or it is not to be drawn.
+ */
+
+sequence *
+seqroll::background_sequence ()
+{
+    if (m_drawing_background_seq && perf().is_active(m_background_sequence))
+        return perf().get_sequence(m_background_sequence);
+
+    return nullptr;
+}
+
+/**
+ *  Tells if the notes on the pixmap were drawn in the current view, so that
+ *  only the notes that changed need to be drawn again.
+ */
+
+bool
+seqroll::drawn_current ()
+{
+    if (! m_drawn_valid)
+        return false;
+
+    if
+    (
+        m_drawn_ticks != m_scroll_offset_ticks ||
+        m_drawn_key != m_scroll_offset_key ||
+        m_drawn_zoom != m_zoom || m_drawn_length != m_seq.get_length()
+    )
+    {
+        return false;
+    }
+
+    const sequence * bgseq = background_sequence();
+    if (bgseq != m_drawn_bgseq)
+        return false;
+
+    return is_nullptr(bgseq) || bgseq->edit_version() == m_drawn_bgversion;
+}
+
+/**
+ *  Copies the notes of the sequence that are in view, sorted.  Copying
+ *  them keeps the sequence locked only as long as the walk takes, not
+ *  while the notes are drawn.
+ *
+ * \param [out] notes
+ *      Receives the notes.
  */
 
 void
-seqroll::draw_events_on (Glib::RefPtr<Gdk::Drawable> draw)
+seqroll::get_notes_in_view (std::vector<sequence::note_info> & notes)
 {
-    midipulse tick_s;
-    midipulse tick_f;
-    int note;
-    bool selected;
-    int velocity;
-    draw_type_t dt;
-    int starttick = m_scroll_offset_ticks;
-    int endtick = (m_window_x * m_zoom) + m_scroll_offset_ticks;
-    sequence * seq = nullptr;
-    for (int method = 0; method < 2; ++method)  /* weird way to do it       */
+    midipulse starttick = m_scroll_offset_ticks;
+    midipulse endtick = (m_window_x * m_zoom) + m_scroll_offset_ticks;
+    notes.clear();
+    notes.reserve(m_drawn_notes.size());
+    m_seq.visit_notes
+    (
+        starttick, endtick, [&notes] (const sequence::note_info & ni)
+        {
+            notes.push_back(ni);
+        }
+    );
+    std::sort(notes.begin(), notes.end(), note_less);
+}
+
+/**
+ *  Provides the screen box that draw_note_on() can paint for a note, with a
+ *  pixel to spare on each side.  A note that wraps around can cover both
+ *  ends of its row, so its box is the whole row.
+ *
+ * \param ni
+ *      The note.
+ *
+ * \param [out] r
+ *      Receives the box.
+ */
+
+void
+seqroll::note_box (const sequence::note_info & ni, rect & r)
+{
+    int x = ni.ni_start / m_zoom - m_scroll_offset_x;
+    int y = c_rollarea_y - (ni.ni_note * c_key_y) - c_key_y + 1 -
+        m_scroll_offset_y;
+
+    int w = 16 / m_zoom + 2;                    /* unlinked Note On/Off     */
+    if (ni.ni_type == DRAW_NORMAL_LINKED)
     {
-        if (method == 0 && m_drawing_background_seq)
+        if (ni.ni_finish < ni.ni_start)
         {
-            if (perf().is_active(m_background_sequence))
-                seq = perf().get_sequence(m_background_sequence);
-            else
-                ++method;
+            x = 0;                              /* wrapped, the whole row   */
+            w = m_window_x;
         }
-        else if (method == 0)                   /* done with background?    */
-            ++method;                           /* now draw the sequence    */
+        else
+            w = (ni.ni_finish - ni.ni_start) / m_zoom;
+    }
+    r.set(x - 2, y - 1, w + 4, c_key_y + 1);
+}
 
-        if (method == 1)
-            seq = &m_seq;
+/**
+ *  Restores a box of the pixmap from the underlay, then draws the notes
+ *  that cross it, clipped to it, so that notes next to the box are not
+ *  disturbed.
+ *
+ * \param r
+ *      The box to repair.
+ *
+ * \param notes
+ *      The notes now in view.
+ */
+
+void
+seqroll::repair_pixmap
+(
+    const rect & r, const std::vector<sequence::note_info> & notes
+)
+{
+    int x, y, w, h;
+    r.get(x, y, w, h);
+    m_pixmap->draw_drawable(m_gc, m_underlay, x, y, x, y, w, h);
 
-        m_gc->set_foreground(black_paint());    /* draw boxes from sequence */
-        seq->reset_draw_marker();
-        while
+    Gdk::Rectangle clip(x, y, w, h);
+    m_gc->set_clip_rectangle(clip);
+    for (std::size_t i = 0; i < notes.size(); ++i)
+    {
+        rect nr;
+        note_box(notes[i], nr);
+        if
         (
-            (
-                dt = seq->get_next_note_event(tick_s, tick_f,
-                   note, selected, velocity)
-            ) != DRAW_FIN
+            nr.x() < x + w && nr.x() + nr.width() > x &&
+            nr.y() < y + h && nr.y() + nr.height() > y
         )
         {
+            draw_note_on(m_pixmap, 1, notes[i]);
+        }
+    }
+    m_gc->set_clip_mask(Glib::RefPtr<Gdk::Bitmap>());  /* no clipping    */
+}
+
+/**
+ *  Draws one note (or tempo) handed over by sequence::visit_notes().
+ *
+ * \param draw
+ *      The "drawable" area to draw on.
+ *
+ * \param method
+ *      0 for the background sequence, 1 for the sequence itself.
+ *
+ * \param ni
+ *      The note to draw.
+ */
+
+void
+seqroll::draw_note_on
+(
+    Glib::RefPtr<Gdk::Drawable> draw, int method,
+    const sequence::note_info & ni
+)
+{
+    draw_type_t dt = ni.ni_type;
+    midipulse tick_s = ni.ni_start;
+    midipulse tick_f = ni.ni_finish;
+    int note = ni.ni_note;
+    bool selected = ni.ni_selected;
+    int starttick = m_scroll_offset_ticks;
+    int endtick = (m_window_x * m_zoom) + m_scroll_offset_ticks;
+
 #ifdef SEQ64_SEQROLL_DRAW_TEMPO
-            bool istempo = dt == DRAW_TEMPO;
-            bool do_draw = true;                    /* dt != DRAW_TEMPO;    */
+    bool istempo = dt == DRAW_TEMPO;
+    bool do_draw = true;                    /* dt != DRAW_TEMPO;    */
 #else
-            bool do_draw = dt != DRAW_TEMPO;
+    bool do_draw = dt != DRAW_TEMPO;
 #endif
-            if (do_draw)
+    if (do_draw)
+    {
+        do_draw = tick_s >= starttick && tick_s <= endtick;
+        if (! do_draw)
+            do_draw = (dt == DRAW_NORMAL_LINKED) &&
+                tick_f >= starttick && tick_f <= endtick;
+    }
+    if (do_draw)
+    {
+        int note_width;
+        int note_off_width = 0;             /* for wrapped Note Off    */
+        int note_x = tick_s / m_zoom;       /* turn into screen coords */
+        int note_y = c_rollarea_y - (note * c_key_y) - c_key_y + 1;
+        int note_height = c_key_y - 3;
+        int in_shift = 0;
+        int length_add = 0;
+        if (dt == DRAW_NORMAL_LINKED)
+        {
+            if (tick_f >= tick_s)
             {
-                do_draw = tick_s >= starttick && tick_s <= endtick;
-                if (! do_draw)
-                    do_draw = (dt == DRAW_NORMAL_LINKED) &&
-                        tick_f >= starttick && tick_f <= endtick;
+                note_width = (tick_f - tick_s) / m_zoom;
+                if (note_width < 1)
+                    note_width = 1;
             }
-            if (do_draw)
+            else
             {
-                int note_width;
-                int note_off_width = 0;             /* for wrapped Note Off    */
-                int note_x = tick_s / m_zoom;       /* turn into screen coords */
-                int note_y = c_rollarea_y - (note * c_key_y) - c_key_y + 1;
-                int note_height = c_key_y - 3;
-                int in_shift = 0;
-                int length_add = 0;
-                if (dt == DRAW_NORMAL_LINKED)
-                {
-                    if (tick_f >= tick_s)
-                    {
-                        note_width = (tick_f - tick_s) / m_zoom;
-                        if (note_width < 1)
-                            note_width = 1;
-                    }
-                    else
-                    {
-                        /*
-                         * For a wrap-around note, calculate the Note On width,
-                         * then the Note Off width.  From Stazed's seq32 fixes.
-                         */
+                /*
+                 * For a wrap-around note, calculate the Note On width,
+                 * then the Note Off width.  From Stazed's seq32 fixes.
+                 */
 
-                        note_width = (m_seq.get_length() - tick_s) / m_zoom;
-                        note_off_width = tick_f / m_zoom;
-                    }
-                }
-                else
-                    note_width = 16 / m_zoom;
+                note_width = (m_seq.get_length() - tick_s) / m_zoom;
+                note_off_width = tick_f / m_zoom;
+            }
+        }
+        else
+            note_width = 16 / m_zoom;
 
-                if (dt == DRAW_NOTE_ON)
-                {
-                    in_shift = 0;
-                    length_add = 2;
-                }
-                else if (dt == DRAW_NOTE_OFF)
-                {
-                    in_shift = -1;
-                    length_add = 1;
-                }
-                note_x -= m_scroll_offset_x;
-                note_y -= m_scroll_offset_y;
+        if (dt == DRAW_NOTE_ON)
+        {
+            in_shift = 0;
+            length_add = 2;
+        }
+        else if (dt == DRAW_NOTE_OFF)
+        {
+            in_shift = -1;
+            length_add = 1;
+        }
+        note_x -= m_scroll_offset_x;
+        note_y -= m_scroll_offset_y;
 
-                /*
-                 * Draw note boxes for main or background sequence.  Use a
-                 * color more distinguishable from the "scale" color for the
-                 * background sequence.
-                 */
+        /*
+         * Draw note boxes for main or background sequence.  Use a
+         * color more distinguishable from the "scale" color for the
+         * background sequence.
+         */
 
-                if (method == 0)
-                     m_gc->set_foreground(dark_cyan());     /* vs dark_grey() */
+        if (method == 0)
+             m_gc->set_foreground(dark_cyan());     /* vs dark_grey() */
 #ifdef SEQ64_SEQROLL_DRAW_TEMPO
-                else if (istempo)
-                     m_gc->set_foreground(dark_cyan());
+        else if (istempo)
+             m_gc->set_foreground(dark_cyan());
 #endif
-                else
-                    m_gc->set_foreground(black_paint());
+        else
+            m_gc->set_foreground(black_paint());
 
-                draw_rectangle(draw, note_x, note_y, note_width, note_height);
-                if (tick_f < tick_s)                        /* note wraps?    */
-                    draw_rectangle(draw, 0, note_y, tick_f / m_zoom, note_height);
+        draw_rectangle(draw, note_x, note_y, note_width, note_height);
+        if (tick_f < tick_s)                        /* note wraps?    */
+            draw_rectangle(draw, 0, note_y, tick_f / m_zoom, note_height);
 
-                /*
-                 *  Draw inside box if there is room.  The check for note_width
-                 *  is based on the Note ON width. If the Note On is less than
-                 *  3 and there is a wrapped Note Off of width > 3 then the
-                 *  Note Off portion would not draw the inside rectangle. Thus
-                 *  the need for the additional (seq32) note_off_width check.
-                 */
+        /*
+         *  Draw inside box if there is room.  The check for note_width
+         *  is based on the Note ON width. If the Note On is less than
+         *  3 and there is a wrapped Note Off of width > 3 then the
+         *  Note Off portion would not draw the inside rectangle. Thus
+         *  the need for the additional (seq32) note_off_width check.
+         */
 
-                if (note_width > 3 || note_off_width > 3)
+        if (note_width > 3 || note_off_width > 3)
+        {
+            m_gc->set_foreground(selected ? orange() : white_paint());
+            if (method == 1)
+            {
+                int xinc = note_x + 1;
+                int yinc = note_y + 1;
+                int hdec = note_height - 3;
+                if (tick_f >= tick_s)
                 {
-                    m_gc->set_foreground(selected ? orange() : white_paint());
-                    if (method == 1)
-                    {
-                        int xinc = note_x + 1;
-                        int yinc = note_y + 1;
-                        int hdec = note_height - 3;
-                        if (tick_f >= tick_s)
-                        {
-                            draw_rectangle
-                            (
-                                draw, xinc + in_shift, yinc,
-                                note_width - 3 + length_add, hdec
-                            );
-                        }
-                        else
-                        {
-                            draw_rectangle          /* Note On */
-                            (
-                                draw, xinc + in_shift, yinc, note_width, hdec
-                            );
-
-                            int width = (tick_f / m_zoom) - 3 + length_add;
-                            if (width < 0)
-                                width = note_width;     // 0;
-
-                            draw_rectangle(draw, 0, yinc, width, hdec);
-
-                            /*
-                             *  Note Off wrapped (seq32). If off_width < 0,
-                             *  the draw would span the entire sequence
-                             *  (because the negative is treated like a large
-                             *  number). This occurs occasionally with a very
-                             *  small wrapped Note Off, due to rounding.
-                             */
-
-                            long off_width = tick_f / m_zoom - 3 + length_add;
-                            if (off_width >= 0)
-                                draw_rectangle(draw, 0, yinc, off_width, hdec);
-                        }
-                    }
+                    draw_rectangle
+                    (
+                        draw, xinc + in_shift, yinc,
+                        note_width - 3 + length_add, hdec
+                    );
+                }
+                else
+                {
+                    draw_rectangle          /* Note On */
+                    (
+                        draw, xinc + in_shift, yinc, note_width, hdec
+                    );
+
+                    int width = (tick_f / m_zoom) - 3 + length_add;
+                    if (width < 0)
+                        width = note_width;     // 0;
+
+                    draw_rectangle(draw, 0, yinc, width, hdec);
+
+                    /*
+                     *  Note Off wrapped (seq32). If off_width < 0,
+                     *  the draw would span the entire sequence
+                     *  (because the negative is treated like a large
+                     *  number). This occurs occasionally with a very
+                     *  small wrapped Note Off, due to rounding.
+                     */
+
+                    long off_width = tick_f / m_zoom - 3 + length_add;
+                    if (off_width >= 0)
+                        draw_rectangle(draw, 0, yinc, off_width, hdec);
                 }
             }
         }
@@ -943,24 +1219,35 @@ seqroll::draw_events_on (Glib::RefPtr<Gdk::Drawable> draw)
 }
 
 /**
- *  Fills the main pixmap with events.  Just calls draw_events_on().
+ *  Fills the main pixmap with the notes in view, and remembers them and the
+ *  view, for redraw_events().
  */
 
 void
 seqroll::draw_events_on_pixmap ()
 {
-    draw_events_on(m_pixmap);
+    get_notes_in_view(m_drawn_notes);
+    for (std::size_t i = 0; i < m_drawn_notes.size(); ++i)
+        draw_note_on(m_pixmap, 1, m_drawn_notes[i]);
+
+    m_drawn_valid = true;
+    m_drawn_ticks = m_scroll_offset_ticks;
+    m_drawn_key = m_scroll_offset_key;
+    m_drawn_zoom = m_zoom;
+    m_drawn_length = m_seq.get_length();
 }
 
 /**
- *  Draw the events on the main window and on the pixmap.
+ *  Brings the pixmap and the window up to date.  This used to draw all of
+ *  the notes twice, once on the window and once on the pixmap.  Now the
+ *  pixmap is repaired where the notes changed, and only those parts are
+ *  copied to the window.
  */
 
 int
 seqroll::idle_redraw ()
 {
-    draw_events_on(m_window);
-    draw_events_on(m_pixmap);
+    redraw_events();
     return true;
 }
 
@@ -987,6 +1274,7 @@ seqroll::draw_selection_on_window ()
     {
         m_old.get(x, y, w, h);                      /* get rectangle        */
         draw_drawable(x, y, x, y, w + 1, h + 1);    /* erase old rectangle  */
+        m_progress_drawn = false;
     }
     if (selecting())
     {
@@ -1932,6 +2220,7 @@ seqroll::on_expose_event (GdkEventExpose * ev)
 {
     GdkRectangle & area = ev->area;
     draw_drawable(area.x, area.y, area.x, area.y, area.width, area.height);
+    m_progress_drawn = false;
     draw_selection_on_window();
     return true;
 }
@@ -0,0 +1,152 @@
+#ifndef SEQ64_MASTERMIDIBUS_LM_HPP
+#define SEQ64_MASTERMIDIBUS_LM_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          mastermidibus_lm.hpp
+ *
+ *  This module declares/defines the loop-back version of the master MIDI
+ *  buss, which needs no ALSA sequencer and no JACK server.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  Every other backend needs a live ALSA sequencer or JACK server, which
+ *  continuous-integration machines and containers do not have.  This one
+ *  keeps its ports in memory:  SEQ64_LOOP_OUTPUT_PORTS output ports, whose
+ *  messages are captured, and SEQ64_LOOP_INPUT_PORTS input ports, into
+ *  which messages are injected.  All of them are stamped by one
+ *  virtual_clock, which follows the monotonic clock by default, and which
+ *  a test or an offline render can switch to the manual mode, in order to
+ *  drive perform::play() itself, faster than real time.
+ *
+ *  The input ports use the input reactor's notification descriptor, so
+ *  the input thread wakes up as soon as a message is injected.  A message
+ *  injected for a later time is read at the first poll after the virtual
+ *  clock reaches that time, within SEQ64_INPUT_POLL_MS.
+ */
+
+#include <vector>                       /* std::vector<>                    */
+
+#include "mastermidibase.hpp"           /* seq64::mastermidibase ABC        */
+#include "midibus_lm.hpp"               /* seq64::loop_message              */
+#include "virtual_clock.hpp"            /* seq64::virtual_clock             */
+
+/**
+ *  The number of output ports, the same as the number of virtual ports
+ *  made by the --manual-alsa-ports option.
+ */
+
+#define SEQ64_LOOP_OUTPUT_PORTS         SEQ64_ALSA_OUTPUT_BUSS_MAX
+
+/**
+ *  The number of input ports.
+ */
+
+#define SEQ64_LOOP_INPUT_PORTS          4
+
+/**
+ *  The capacity, in messages, of the ring buffer of each port.  A test
+ *  that lets the performance run must capture often enough to keep the
+ *  rings from filling; the messages that do not fit are counted by
+ *  dropped().
+ */
+
+#define SEQ64_LOOP_RING_SIZE            8192
+
+/*
+ * Do not document the namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  The class that "supervises" all of the loop-back midibus objects.
+ */
+
+class mastermidibus : public mastermidibase
+{
+
+private:
+
+    /**
+     *  The clock that stamps every message of every port.
+     */
+
+    virtual_clock m_virtual_clock;
+
+public:
+
+    mastermidibus
+    (
+        int ppqn    = SEQ64_USE_DEFAULT_PPQN,
+        midibpm bpm = SEQ64_DEFAULT_BPM        /* c_beats_per_minute */
+    );
+    virtual ~mastermidibus ();
+
+    /**
+     * \getter m_virtual_clock
+     */
+
+    virtual_clock & loop_clock ()
+    {
+        return m_virtual_clock;
+    }
+
+    bool inject
+    (
+        bussbyte bus, midibyte status, midibyte d0, midibyte d1,
+        long long time_us
+    );
+    bool capture (bussbyte bus, loop_message & msg);
+    int capture_all (std::vector<loop_message> & msgs);
+    long dropped ();
+
+protected:
+
+    virtual void api_init (int ppqn, midibpm /*bpm*/);
+    virtual int api_poll_for_midi ();
+    virtual bool api_is_more_input ();
+    virtual bool api_get_midi_event (event * in);
+
+    /**
+     *  Keeps the tick being played, for the stamps of the output.
+     */
+
+    virtual void api_play_position (midipulse tick)
+    {
+        m_virtual_clock.tick(tick);
+    }
+
+};          // class mastermidibus
+
+}           // namespace seq64
+
+#endif      // SEQ64_MASTERMIDIBUS_LM_HPP
+
+/*
+ * mastermidibus_lm.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -0,0 +1,168 @@
+#ifndef SEQ64_MIDIBUS_LM_HPP
+#define SEQ64_MIDIBUS_LM_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          midibus_lm.hpp
+ *
+ *  This module declares/defines the loop-back version of the midibus, whose
+ *  port is an in-process ring buffer.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  An output port puts each message it plays into its ring buffer, stamped
+ *  with the time of the master buss's virtual clock and the tick being
+ *  played.  The test or benchmark that owns the performance takes them out
+ *  with mastermidibus::capture().
+ *
+ *  An input port holds the messages given to mastermidibus::inject(), each
+ *  with the time at which it is due.  A message is not read before the
+ *  virtual clock reaches that time.  The messages of one port must be
+ *  injected in the order of their times; a message not yet due holds back
+ *  the ones behind it.
+ */
+
+#include <atomic>                       /* std::atomic<>                    */
+
+#include "midibase.hpp"                 /* seq64::midibase ABC              */
+#include "spsc_queue.hpp"               /* seq64::spsc_queue<>              */
+
+/*
+ * Do not document the namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+    class event;
+    class virtual_clock;
+
+/**
+ *  One message of a loop-back port, as injected or captured.  Only channel
+ *  and real-time messages of up to three bytes are carried.
+ */
+
+struct loop_message
+{
+    long long lm_time_us;           /**< The virtual time of it.            */
+    midipulse lm_tick;              /**< The tick played, if known.         */
+    bussbyte lm_bus;                /**< The port that carried it.          */
+    midibyte lm_status;             /**< The status, with channel.          */
+    midibyte lm_d0;                 /**< The first data byte.               */
+    midibyte lm_d1;                 /**< The second data byte.              */
+};
+
+/**
+ *  This class implements the loop-back version of the midibus object.
+ */
+
+class midibus : public midibase
+{
+    /**
+     *  The master MIDI bus sets up the buss, and injects and captures its
+     *  messages.
+     */
+
+    friend class mastermidibus;
+
+private:
+
+    /**
+     *  The clock of the master buss, which stamps the output.
+     */
+
+    const virtual_clock & m_clock;
+
+    /**
+     *  The ring buffer of the port.  The messages played by an output port,
+     *  or injected into an input port.
+     */
+
+    spsc_queue<loop_message> m_ring;
+
+    /**
+     *  The message taken from the ring of an input port before it was due.
+     *  Used only by the input thread.
+     */
+
+    loop_message m_pending;
+
+    /**
+     *  True if m_pending holds a message.
+     */
+
+    bool m_has_pending;
+
+    /**
+     *  The number of messages lost because the ring was full.
+     */
+
+    std::atomic<long> m_dropped;
+
+public:
+
+    midibus
+    (
+        const virtual_clock & clock, int index, int bus_id,
+        const std::string & client_name, unsigned ring_size
+    );
+
+    virtual ~midibus ();
+
+    /**
+     * \getter m_dropped
+     */
+
+    long dropped () const
+    {
+        return m_dropped.load();
+    }
+
+protected:
+
+    virtual int api_poll_for_midi ();
+    virtual bool api_init_in ();
+    virtual bool api_init_out ();
+    virtual void api_continue_from (midipulse tick, midipulse beats);
+    virtual void api_start ();
+    virtual void api_stop ();
+    virtual void api_clock (midipulse tick);
+    virtual void api_play (event * e24, midibyte channel);
+
+private:
+
+    bool put (const loop_message & msg);
+    void send (midibyte status, midibyte d0, midibyte d1, midipulse tick);
+    bool take_due (loop_message & msg, long long now_us);
+
+};          // class midibus (loopmidi)
+
+}           // namespace seq64
+
+#endif      // SEQ64_MIDIBUS_LM_HPP
+
+/*
+ * midibus_lm.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
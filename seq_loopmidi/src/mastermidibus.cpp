@@ -0,0 +1,332 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          mastermidibus.cpp
+ *
+ *  This module defines the loop-back version of the master MIDI buss.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  The inject() function is meant to be called from one thread, usually
+ *  the test's own, and capture() and capture_all() from one thread too,
+ *  since each port is a single-producer, single-consumer ring.
+ */
+
+#include <algorithm>                    /* std::stable_sort()               */
+#include <cstdio>                       /* std::snprintf()                  */
+
+#include "event.hpp"                    /* seq64::event                     */
+#include "mastermidibus_lm.hpp"         /* seq64::mastermidibus, loop-back  */
+#include "midibus_lm.hpp"               /* seq64::midibus, loop-back        */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Orders the captured messages by time, and then by buss.  Used with a
+ *  stable sort, so that the messages of one buss keep their order.
+ */
+
+static bool
+earlier (const loop_message & a, const loop_message & b)
+{
+    if (a.lm_time_us != b.lm_time_us)
+        return a.lm_time_us < b.lm_time_us;
+
+    return a.lm_bus < b.lm_bus;
+}
+
+/**
+ *  The base-class constructor fills the array for our busses.  The input
+ *  reactor's notification descriptor is enabled, so that an injection
+ *  wakes the input thread.
+ *
+ * \param ppqn
+ *      Provides the PPQN value for this object.  However, in most cases, the
+ *      default value, SEQ64_USE_DEFAULT_PPQN should be specified.
+ *
+ * \param bpm
+ *      Provides the beats per minute value, which defaults to
+ *      c_beats_per_minute.
+ */
+
+mastermidibus::mastermidibus (int ppqn, midibpm bpm)
+ :
+    mastermidibase      (ppqn, bpm),
+    m_virtual_clock     ()
+{
+    if (m_input_reactor.valid())
+        (void) m_input_reactor.enable_notify();
+}
+
+/**
+ *  The destructor has nothing to close; the base class deletes the busses.
+ */
+
+mastermidibus::~mastermidibus ()
+{
+    // Empty body
+}
+
+/**
+ *  Creates SEQ64_LOOP_OUTPUT_PORTS output ports and SEQ64_LOOP_INPUT_PORTS
+ *  input ports, which are always present.
+ *
+ * \param ppqn
+ *      The PPQN value to which to initialize the master MIDI buss.
+ *
+ * \param bpm
+ *      The BPM value to which to initialize the master MIDI buss.
+ */
+
+void
+mastermidibus::api_init (int ppqn, midibpm bpm)
+{
+    for (int i = 0; i < SEQ64_LOOP_OUTPUT_PORTS; ++i)
+    {
+        char name[32];
+        snprintf(name, sizeof name, "loop out %d", i);
+
+        midibus * m = new midibus
+        (
+            m_virtual_clock, i, i, name, SEQ64_LOOP_RING_SIZE
+        );
+        m->is_virtual_port(false);
+        m->is_input_port(false);
+        m_outbus_array.add(m, clock(i));
+    }
+    for (int i = 0; i < SEQ64_LOOP_INPUT_PORTS; ++i)
+    {
+        char name[32];
+        snprintf(name, sizeof name, "loop in %d", i);
+
+        midibus * m = new midibus
+        (
+            m_virtual_clock, SEQ64_LOOP_OUTPUT_PORTS + i, i, name,
+            SEQ64_LOOP_RING_SIZE
+        );
+        m->is_virtual_port(false);
+        m->is_input_port(true);
+        m_inbus_array.add(m, input(i));
+    }
+    set_beats_per_minute(bpm);
+    set_ppqn(ppqn);
+    set_sequence_input(false, nullptr);
+    m_outbus_array.set_all_clocks();
+    m_inbus_array.set_all_inputs();
+}
+
+/**
+ *  Used only if the input reactor could not be set up.  Returns at once if
+ *  an input message is due, and otherwise waits a millisecond.
+ *
+ * \return
+ *      Returns 1 if an input message is due, and 0 otherwise.
+ */
+
+int
+mastermidibus::api_poll_for_midi ()
+{
+    if (m_inbus_array.poll_for_midi())
+        return 1;
+
+    millisleep(1);
+    return 0;
+}
+
+/**
+ * \return
+ *      Returns true if an input message is due on any input port.
+ */
+
+bool
+mastermidibus::api_is_more_input ()
+{
+    return m_inbus_array.poll_for_midi();
+}
+
+/**
+ *  Takes the first due message from the input ports, in port order, and
+ *  converts it to an event.  A message on a port that is not inputting is
+ *  taken and discarded, as a real port would.
+ *
+ * \param in
+ *      The destination of the event.
+ *
+ * \return
+ *      Returns true if an event was obtained.
+ */
+
+bool
+mastermidibus::api_get_midi_event (event * in)
+{
+    long long now = m_virtual_clock.now_us();
+    int count = m_inbus_array.count();
+    for (int i = 0; i < count; ++i)
+    {
+        midibus * m = m_inbus_array.bus(bussbyte(i));
+        loop_message msg;
+        if (not_nullptr(m) && m->take_due(msg, now) && m->get_input())
+        {
+            in->set_status(msg.lm_status);
+            in->set_data(msg.lm_d0, msg.lm_d1);
+
+            /* some keyboards send Note On with velocity 0 for Note Off */
+
+            if (in->get_status() == EVENT_NOTE_ON && msg.lm_d1 == 0)
+                in->set_status(EVENT_NOTE_OFF, in->get_channel());
+
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ *  Queues a message on an input port, to be read once the virtual clock
+ *  reaches the given time, and wakes the input thread.
+ *
+ * \param bus
+ *      The input port, from 0 to SEQ64_LOOP_INPUT_PORTS - 1.
+ *
+ * \param status
+ *      The status byte, including the channel.
+ *
+ * \param d0
+ *      The first data byte, if any.
+ *
+ * \param d1
+ *      The second data byte, if any.
+ *
+ * \param time_us
+ *      The virtual time at which the message arrives.  It must not be
+ *      earlier than that of the last message injected on the port.
+ *
+ * \return
+ *      Returns false if there is no such port, or if its ring is full.
+ */
+
+bool
+mastermidibus::inject
+(
+    bussbyte bus, midibyte status, midibyte d0, midibyte d1, long long time_us
+)
+{
+    midibus * m = m_inbus_array.bus(bus);
+    bool result = not_nullptr(m);
+    if (result)
+    {
+        loop_message msg;
+        msg.lm_time_us = time_us;
+        msg.lm_tick = 0;
+        msg.lm_bus = bus;
+        msg.lm_status = status;
+        msg.lm_d0 = d0;
+        msg.lm_d1 = d1;
+        result = m->put(msg);
+        if (result)
+            m_input_reactor.notify();
+    }
+    return result;
+}
+
+/**
+ *  Takes the oldest message played on an output port.
+ *
+ * \param bus
+ *      The output port.
+ *
+ * \param [out] msg
+ *      The destination of the message.
+ *
+ * \return
+ *      Returns false if there is no such port, or nothing to take.
+ */
+
+bool
+mastermidibus::capture (bussbyte bus, loop_message & msg)
+{
+    midibus * m = m_outbus_array.bus(bus);
+    return not_nullptr(m) && m->m_ring.pop(msg);
+}
+
+/**
+ *  Takes every message played so far on every output port, and appends
+ *  them to a vector in the order of their time stamps.  Messages of the
+ *  same time stay in the order of their ports, and then in the order in
+ *  which they were played.
+ *
+ * \param [out] msgs
+ *      The vector to which the messages are appended.
+ *
+ * \return
+ *      Returns the number of messages appended.
+ */
+
+int
+mastermidibus::capture_all (std::vector<loop_message> & msgs)
+{
+    std::vector<loop_message>::size_type first = msgs.size();
+    int count = m_outbus_array.count();
+    for (int i = 0; i < count; ++i)
+    {
+        loop_message msg;
+        while (capture(bussbyte(i), msg))
+            msgs.push_back(msg);
+    }
+    std::stable_sort(msgs.begin() + first, msgs.end(), earlier);
+    return int(msgs.size() - first);
+}
+
+/**
+ * \return
+ *      Returns the number of messages lost, on all the ports, because
+ *      their rings were full.
+ */
+
+long
+mastermidibus::dropped ()
+{
+    long result = 0;
+    int count = m_outbus_array.count();
+    for (int i = 0; i < count; ++i)
+        result += m_outbus_array.bus(bussbyte(i))->dropped();
+
+    count = m_inbus_array.count();
+    for (int i = 0; i < count; ++i)
+        result += m_inbus_array.bus(bussbyte(i))->dropped();
+
+    return result;
+}
+
+}           // namespace seq64
+
+/*
+ * mastermidibus.cpp for the loop-back backend
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -0,0 +1,289 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          midibus.cpp
+ *
+ *  This module defines the loop-back version of the midibus, whose port is
+ *  an in-process ring buffer.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  This file differs from the other implementations in these particulars:
+ *
+ *      -   There is no device to open; the ports always initialize.
+ *      -   Every output message, including the MIDI clock, goes into the
+ *          ring buffer of the port, stamped with the virtual time and tick.
+ *          All the api_*() output functions are called with the buss's
+ *          I/O mutex held, so there is only one producer at a time.
+ *      -   An input port releases a message only when it is due.
+ */
+
+#include "event.hpp"                    /* seq64::event and macros          */
+#include "midibus_lm.hpp"               /* seq64::midibus for loop-back     */
+#include "settings.hpp"                 /* seq64::rc_settings               */
+#include "virtual_clock.hpp"            /* seq64::virtual_clock             */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Principal constructor.
+ *
+ * \param clock
+ *      The virtual clock of the master buss, which must outlive the buss.
+ *
+ * \param index
+ *      The ordinal of the port, used as its port ID too.
+ *
+ * \param bus_id
+ *      The buss number, among the inputs or among the outputs.
+ *
+ * \param clientname
+ *      The name shown for the port.
+ *
+ * \param ring_size
+ *      The capacity of the ring buffer, rounded up to a power of two.
+ */
+
+midibus::midibus
+(
+    const virtual_clock & clock, int index, int bus_id,
+    const std::string & clientname, unsigned ring_size
+) :
+    midibase
+    (
+        rc().application_name(), "loop", clientname, index,
+        bus_id, index, SEQ64_NO_QUEUE
+    ),
+    m_clock         (clock),
+    m_ring          (ring_size),
+    m_pending       (),
+    m_has_pending   (false),
+    m_dropped       (0)
+{
+    // Empty body
+}
+
+/**
+ *  The destructor has nothing to close.
+ */
+
+midibus::~midibus ()
+{
+    // Empty body
+}
+
+/**
+ *  Tells if an input message is due on the virtual clock.  Called by the
+ *  input thread only.
+ *
+ * \return
+ *      Returns 1 if a message can be read, and 0 otherwise.
+ */
+
+int
+midibus::api_poll_for_midi ()
+{
+    long long now = m_clock.now_us();
+    if (! m_has_pending)
+        m_has_pending = m_ring.pop(m_pending);
+
+    return (m_has_pending && m_pending.lm_time_us <= now) ? 1 : 0 ;
+}
+
+/**
+ *  There is nothing to open.
+ *
+ * \return
+ *      Always returns true.
+ */
+
+bool
+midibus::api_init_out ()
+{
+    return true;
+}
+
+/**
+ *  There is nothing to open.
+ *
+ * \return
+ *      Always returns true.
+ */
+
+bool
+midibus::api_init_in ()
+{
+    return true;
+}
+
+/**
+ *  Adds a message to the ring, counting it as dropped if the ring is full.
+ *
+ * \param msg
+ *      The message, already stamped.
+ *
+ * \return
+ *      Returns true if the message went into the ring.
+ */
+
+bool
+midibus::put (const loop_message & msg)
+{
+    bool result = m_ring.push(msg);
+    if (! result)
+        ++m_dropped;
+
+    return result;
+}
+
+/**
+ *  Stamps an output message with the virtual time and puts it in the ring.
+ *
+ * \param tick
+ *      The tick to record, which is the tick last played unless the caller
+ *      knows better.
+ */
+
+void
+midibus::send (midibyte status, midibyte d0, midibyte d1, midipulse tick)
+{
+    loop_message msg;
+    msg.lm_time_us = m_clock.now_us();
+    msg.lm_tick = tick;
+    msg.lm_bus = bussbyte(get_bus_id());
+    msg.lm_status = status;
+    msg.lm_d0 = d0;
+    msg.lm_d1 = d1;
+    (void) put(msg);
+}
+
+/**
+ *  Takes the next input message, if it is due.  Called by the input thread
+ *  only.
+ *
+ * \param [out] msg
+ *      The destination of the message.
+ *
+ * \param now_us
+ *      The time of the virtual clock.
+ *
+ * \return
+ *      Returns true if a message was taken.
+ */
+
+bool
+midibus::take_due (loop_message & msg, long long now_us)
+{
+    if (! m_has_pending)
+        m_has_pending = m_ring.pop(m_pending);
+
+    bool result = m_has_pending && m_pending.lm_time_us <= now_us;
+    if (result)
+    {
+        msg = m_pending;
+        m_has_pending = false;
+    }
+    return result;
+}
+
+/**
+ *  Puts the event, on the given channel, into the ring.
+ *
+ * \param e24
+ *      The MIDI event to play.
+ *
+ * \param channel
+ *      The channel on which to play the event.
+ */
+
+void
+midibus::api_play (event * e24, midibyte channel)
+{
+    midibyte d0, d1;
+    e24->get_data(d0, d1);
+    send(e24->get_status() + (channel & 0x0F), d0, d1, m_clock.tick());
+}
+
+/**
+ *  Puts a Continue and a Song Position into the ring.
+ *
+ * \param tick
+ *      The tick to continue from.
+ *
+ * \param beats
+ *      The calculated beats.  This calculation is made in the
+ *      midibase::continue_from() function.
+ */
+
+void
+midibus::api_continue_from (midipulse tick, midipulse beats)
+{
+    send(EVENT_MIDI_CONTINUE, 0, 0, tick);
+    send(EVENT_MIDI_SONG_POS, (beats & 0x3F80) >> 7, beats & 0x7F, tick);
+}
+
+/**
+ *  Puts a Start into the ring.
+ */
+
+void
+midibus::api_start ()
+{
+    send(EVENT_MIDI_START, 0, 0, m_clock.tick());
+}
+
+/**
+ *  Puts a Stop into the ring.
+ */
+
+void
+midibus::api_stop ()
+{
+    send(EVENT_MIDI_STOP, 0, 0, m_clock.tick());
+}
+
+/**
+ *  Puts a MIDI Clock into the ring.
+ *
+ * \param tick
+ *      The tick being clocked.
+ */
+
+void
+midibus::api_clock (midipulse tick)
+{
+    send(EVENT_MIDI_CLOCK, 0, 0, tick);
+}
+
+}           // namespace seq64
+
+/*
+ * midibus.cpp for the loop-back backend
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
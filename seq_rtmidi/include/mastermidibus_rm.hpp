@@ -121,6 +121,16 @@ protected:
         m_midi_master.api_port_start(masterbus, bus, port);
     }
 
+    /**
+     *  The ALSA API writes all of the busses through one sequencer handle.
+     *  Each JACK port has its own ring buffer.
+     */
+
+    virtual bool api_shared_handle () const
+    {
+        return rtmidi_info::selected_api() != RTMIDI_API_UNIX_JACK;
+    }
+
 private:
 
     void port_list (const std::string & tag);
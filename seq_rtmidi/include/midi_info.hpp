@@ -47,6 +47,7 @@
 namespace seq64
 {
     class event;
+    class input_reactor;
     class mastermidibus;
     class midibus;
 
@@ -287,6 +288,13 @@ private:
 
     midibpm m_bpm;
 
+    /**
+     *  The master buss's input reactor, if any.  The API adds its input
+     *  descriptors to it, or uses it to announce queued input.  Not owned.
+     */
+
+    input_reactor * m_input_reactor;
+
 protected:
 
     /**
@@ -554,6 +562,30 @@ protected:
         m_midi_handle = h;
     }
 
+public:
+
+    /**
+     * \getter m_input_reactor
+     */
+
+    input_reactor * reactor () const
+    {
+        return m_input_reactor;
+    }
+
+    /**
+     * \setter m_input_reactor
+     *      Overridden by the APIs that have input to announce to the
+     *      reactor.
+     */
+
+    virtual void reactor (input_reactor * r)
+    {
+        m_input_reactor = r;
+    }
+
+protected:
+
     /**
      * \getter m_bus_container
      */
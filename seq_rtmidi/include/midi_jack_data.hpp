@@ -24,6 +24,7 @@
 
 namespace seq64
 {
+    class input_reactor;
 
 /**
  *  Contains the JACK MIDI API data as a kind of scratchpad for this object.
@@ -80,6 +81,13 @@ struct midi_jack_data
 
     rtmidi_in_data * m_jack_rtmidiin;
 
+    /**
+     *  The input reactor to notify when input has been queued, or null to
+     *  leave the input thread to poll the queue.
+     */
+
+    input_reactor * m_jack_reactor;
+
     /**
      * \ctor midi_jack_data
      */
@@ -90,7 +98,8 @@ struct midi_jack_data
         m_jack_buffsize     (nullptr),
         m_jack_buffmessage  (nullptr),
         m_jack_lasttime     (0),
-        m_jack_rtmidiin     (nullptr)
+        m_jack_rtmidiin     (nullptr),
+        m_jack_reactor      (nullptr)
     {
         // Empty body
     }
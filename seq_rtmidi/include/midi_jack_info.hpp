@@ -123,6 +123,9 @@ public:
 
     virtual int api_poll_for_midi ();
 
+    using midi_info::reactor;
+    virtual void reactor (input_reactor * r);
+
     virtual void api_set_ppqn (int p);
     virtual void api_set_beats_per_minute (midibpm b);
     virtual void api_port_start (mastermidibus & masterbus, int bus, int port);
@@ -144,6 +144,15 @@ public:
         get_api_info()->add_bus(m);
     }
 
+    /**
+     *  Hands the master buss's input reactor to the selected API.
+     */
+
+    void reactor (input_reactor * r)
+    {
+        get_api_info()->reactor(r);
+    }
+
     /**
      *  Gets the buss/client ID for a MIDI interfaces.  This is the left-hand
      *  side of a X:Y pair (such as 128:0).
@@ -72,7 +72,8 @@ mastermidibus::mastermidibus (int ppqn, midibpm bpm)
     ),
     m_use_jack_polling  (rc().with_jack_midi())
 {
-    // Empty body
+    if (m_input_reactor.valid())
+        m_midi_master.reactor(&m_input_reactor);    /* before the ports */
 }
 
 /**
@@ -264,7 +265,8 @@ mastermidibus::activate ()
 
 /**
  *  Initiate a poll() on the existing poll descriptors.  This is a
- *  primitive poll, which exits when some data is obtained.
+ *  primitive poll, which exits when some data is obtained.  Used only if the
+ *  input reactor could not be set up; see mastermidibase::poll_for_midi().
  *
  *          m_midi_master.api_poll_for_midi();       // NON-FUNCTIONAL!
  */
@@ -56,6 +56,7 @@
 
 #include "calculations.hpp"             /* seq64::tempo_us_from_bpm()       */
 #include "event.hpp"                    /* seq64::event and other tokens    */
+#include "input_reactor.hpp"            /* seq64::input_reactor             */
 #include "midi_alsa_info.hpp"           /* seq64::midi_alsa_info            */
 #include "midibus_common.hpp"           /* from the libseq64 sub-project    */
 #include "settings.hpp"                 /* seq64::rc() configuration object */
@@ -355,6 +356,25 @@ midi_alsa_info::api_poll_for_midi ()
     return result;
 }
 
+/**
+ *  Stores the input reactor, and adds the ALSA input poll descriptors to
+ *  it, so that the input thread waits on them through the reactor.
+ *
+ * \param r
+ *      The master buss's input reactor.
+ */
+
+void
+midi_alsa_info::reactor (input_reactor * r)
+{
+    midi_info::reactor(r);
+    if (not_nullptr(r))
+    {
+        for (int i = 0; i < m_num_poll_descriptors; ++i)
+            (void) r->add_source(m_poll_descriptors[i].fd);
+    }
+}
+
 /*
  * Definitions copped from the seq_alsamidi/src/mastermidibus.cpp module.
  */
@@ -450,15 +470,10 @@ midi_alsa_info::api_port_start (mastermidibus & masterbus, int bus, int port)
     }                                           /* end loop for clients */
 
     /*
-     * Get the number of MIDI input poll file descriptors.
+     * The poll descriptors belong to the sequencer handle, not to the ports,
+     * so they do not change here.  They used to be re-allocated (and leaked)
+     * on every port start.
      */
-
-    m_num_poll_descriptors = snd_seq_poll_descriptors_count(m_alsa_seq, POLLIN);
-    m_poll_descriptors = new pollfd[m_num_poll_descriptors]; /* allocate info */
-    snd_seq_poll_descriptors                        /* get input descriptors */
-    (
-        m_alsa_seq, m_poll_descriptors, m_num_poll_descriptors, POLLIN
-    );
 }
 
 /**
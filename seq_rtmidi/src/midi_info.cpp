@@ -150,6 +150,7 @@ midi_info::midi_info
     m_app_name          (appname),
     m_ppqn              (ppqn),
     m_bpm               (bpm),
+    m_input_reactor     (nullptr),
     m_error_string      ()
 {
     //
@@ -141,6 +141,7 @@
 
 #include "calculations.hpp"             /* seq64::extract_port_name()       */
 #include "event.hpp"                    /* seq64::event from main library   */
+#include "input_reactor.hpp"            /* seq64::input_reactor             */
 #include "jack_assistant.hpp"           /* seq64::jack_status_pair_t        */
 #include "midibus_rm.hpp"               /* seq64::midibus for rtmidi        */
 #include "midi_jack.hpp"                /* seq64::midi_jack                 */
@@ -236,6 +237,7 @@ jack_process_rtmidi_input (jack_nframes_t nframes, void * arg)
     void * buff = jack_port_get_buffer(jackdata->m_jack_port, nframes);
     if (not_nullptr(buff))
     {
+        bool queued = false;
         jack_midi_event_t jmevent;
         jack_time_t jtime;
         int evcount = jack_midi_get_event_count(buff);
@@ -271,7 +273,8 @@ jack_process_rtmidi_input (jack_nframes_t nframes, void * arg)
                     }
                     else
                     {
-                        (void) rtindata->queue().add(message);
+                        if (rtindata->queue().add(message))
+                            queued = true;
                     }
                 }
             }
@@ -287,6 +290,8 @@ jack_process_rtmidi_input (jack_nframes_t nframes, void * arg)
                 }
             }
         }
+        if (queued && not_nullptr(jackdata->m_jack_reactor))
+            jackdata->m_jack_reactor->notify();     /* one wake per cycle   */
     }
     return 0;
 }
@@ -1455,6 +1460,7 @@ midi_in_jack::midi_in_jack (midibus & parentbus, midi_info & masterinfo)
      */
 
     m_jack_data.m_jack_rtmidiin = input_data();
+    m_jack_data.m_jack_reactor = masterinfo.reactor();
 }
 
 /**
@@ -1478,7 +1484,9 @@ midi_in_jack::api_poll_for_midi ()
     }
     else
     {
-        millisleep(1);
+        if (is_nullptr(m_jack_data.m_jack_reactor))
+            millisleep(1);                      /* no reactor, so throttle  */
+
         return rtindata->queue().count();
     }
 }
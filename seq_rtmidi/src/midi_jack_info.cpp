@@ -33,6 +33,7 @@
 
 #include "calculations.hpp"             /* extract_port_names()             */
 #include "event.hpp"                    /* seq64::event and other tokens    */
+#include "input_reactor.hpp"            /* seq64::input_reactor             */
 #include "jack_assistant.hpp"           /* seq64::create_jack_client()      */
 #include "midi_jack.hpp"                /* seq64::midi_jack_info            */
 #include "midi_jack_info.hpp"           /* seq64::midi_jack_info            */
@@ -582,6 +583,23 @@ midi_jack_info::api_port_start (mastermidibus & masterbus, int bus, int port)
     }
 }
 
+/**
+ *  Stores the input reactor, and enables its notification descriptor.  The
+ *  JACK input ports queue their input in the process callback, which then
+ *  calls input_reactor::notify().
+ *
+ * \param r
+ *      The master buss's input reactor.
+ */
+
+void
+midi_jack_info::reactor (input_reactor * r)
+{
+    midi_info::reactor(r);
+    if (not_nullptr(r))
+        (void) r->enable_notify();
+}
+
 /**
  *  MUCH TO DO!
  */
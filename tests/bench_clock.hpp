@@ -0,0 +1,60 @@
+#ifndef SEQ64_BENCH_CLOCK_HPP
+#define SEQ64_BENCH_CLOCK_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          bench_clock.hpp
+ *
+ *  This module provides the clock shared by the benchmarks in this
+ *  directory.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  The benchmarks are built by "make check" in the loop-back build
+ *  (--enable-loopmidi), but are not run by it; they are run by hand, and
+ *  print their times.
+ */
+
+#include <time.h>                       /* clock_gettime()                  */
+
+/**
+ * \return
+ *      Returns the monotonic time, in milliseconds.
+ */
+
+inline double
+msec_now ()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1.0e3 + ts.tv_nsec / 1.0e6;
+}
+
+#endif      // SEQ64_BENCH_CLOCK_HPP
+
+/*
+ * bench_clock.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
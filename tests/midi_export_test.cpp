@@ -0,0 +1,823 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          midi_export_test.cpp
+ *
+ *  This module defines a regression test for the song export,
+ *  midifile::write_song().
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  The exporter fills the tracks in parallel, from patterns that are
+ *  encoded once (see midi_container::song_fill_seq_event()).  The file it
+ *  writes must be the same, byte for byte, as the one written by the
+ *  earlier exporter, which filled one track at a time and encoded every
+ *  event again for every repetition of every trigger.  That exporter is
+ *  kept here, as the reference_export class.
+ *
+ *  The test loads a MIDI file, adds triggers to its patterns, song-mutes a
+ *  few of them, and exports the song both ways.  It is built by "make
+ *  check" in the loop-back build (--enable-loopmidi), which needs no ALSA
+ *  sequencer or JACK server.
+ *
+ *      midi_export_test [ file.midi [ triggers ] ]
+ *
+ *  It returns EXIT_SUCCESS if the exports match.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>                     /* EXIT_SUCCESS, srand(), rand()    */
+#include <fstream>                      /* std::ifstream                    */
+#include <iterator>                     /* std::istreambuf_iterator         */
+#include <list>                         /* std::list, of the triggers       */
+#include <string>
+#include <vector>
+
+#include "calculations.hpp"             /* log2_time_sig_value(), etc.      */
+#include "gui_assistant.hpp"            /* seq64::gui_assistant base class  */
+#include "keys_perform.hpp"             /* seq64::keys_perform              */
+#include "midi_container.hpp"           /* seq64::c_midibus, etc.           */
+#include "midifile.hpp"                 /* seq64::midifile                  */
+#include "perform.hpp"                  /* seq64::perform                   */
+#include "sequence.hpp"                 /* seq64::sequence                  */
+#include "settings.hpp"                 /* seq64::rc() and seq64::usr()     */
+
+#ifndef SEQ64_MTRK_TAG
+#define SEQ64_MTRK_TAG          0x4D54726B          /* magic number 'MTrk'  */
+#endif
+
+#ifndef SEQ64_TEST_MIDI_FILE
+#define SEQ64_TEST_MIDI_FILE    "contrib/midi/b4uacuse-seq24.midi"
+#endif
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  The song exporter as it was before the tracks were filled in parallel.
+ *  The functions are those of midi_container and midifile of that time,
+ *  writing into one byte vector.
+ */
+
+class reference_export
+{
+
+private:
+
+    /**
+     *  The bytes of the whole file.
+     */
+
+    std::vector<midibyte> m_bytes;
+
+    /**
+     *  The bytes of the track being filled.
+     */
+
+    std::vector<midibyte> m_track;
+
+    /**
+     *  The sequence whose track is being filled.
+     */
+
+    const sequence * m_sequence;
+
+public:
+
+    reference_export () :
+        m_bytes     (),
+        m_track     (),
+        m_sequence  (nullptr)
+    {
+        // Empty body
+    }
+
+    /**
+     * \getter m_bytes
+     */
+
+    const std::vector<midibyte> & bytes () const
+    {
+        return m_bytes;
+    }
+
+    bool write_song (perform & p, int ppqn);
+
+private:
+
+    void put (midibyte b)
+    {
+        m_track.push_back(b);
+    }
+
+    void write_long (midilong x);
+    void add_variable (midipulse v);
+    void add_long (midipulse x);
+    void add_short (midishort x);
+    void add_event (const event & e, midipulse deltatime);
+    void add_ex_event (const event & e, midipulse deltatime);
+    void fill_seq_number (int seq);
+    void fill_seq_name (const std::string & name);
+    void fill_meta_track_end (midipulse deltatime);
+    void fill_time_sig_and_tempo
+    (
+        const midi_timing & mt, bool has_time_sig, bool has_tempo
+    );
+    void fill_proprietary ();
+    midipulse song_fill_seq_event
+    (
+        const trigger & trig, midipulse prev_timestamp
+    );
+    void song_fill_seq_trigger
+    (
+        const trigger & trig, midipulse length, midipulse prev_timestamp
+    );
+
+};          // class reference_export
+
+/**
+ *  Writes a long value to the file, most significant byte first.
+ *
+ * \param x
+ *      The value to write.
+ */
+
+void
+reference_export::write_long (midilong x)
+{
+    m_bytes.push_back(midibyte((x & 0xFF000000) >> 24));
+    m_bytes.push_back(midibyte((x & 0x00FF0000) >> 16));
+    m_bytes.push_back(midibyte((x & 0x0000FF00) >> 8));
+    m_bytes.push_back(midibyte((x & 0x000000FF)));
+}
+
+/**
+ *  Adds a variable-length value to the track.
+ *
+ * \param v
+ *      The value to add.
+ */
+
+void
+reference_export::add_variable (midipulse v)
+{
+    midipulse buffer = v & 0x7F;                /* mask off a no-sign byte  */
+    while (v >>= 7)                             /* shift right 7 bits, test */
+    {
+        buffer <<= 8;                           /* move LSB bits to MSB     */
+        buffer |= ((v & 0x7F) | 0x80);          /* add LSB and set bit 7    */
+    }
+    for (;;)
+    {
+        put(midibyte(buffer) & 0xFF);           /* add the LSB              */
+        if (buffer & 0x80)                      /* if bit 7 set             */
+            buffer >>= 8;                       /* get next MSB             */
+        else
+            break;
+    }
+}
+
+/**
+ *  Adds a long value to the track, most significant byte first.
+ *
+ * \param x
+ *      The value to add.
+ */
+
+void
+reference_export::add_long (midipulse x)
+{
+    put((x & 0xFF000000) >> 24);
+    put((x & 0x00FF0000) >> 16);
+    put((x & 0x0000FF00) >> 8);
+    put((x & 0x000000FF));
+}
+
+/**
+ *  Adds a short value to the track, most significant byte first.
+ *
+ * \param x
+ *      The value to add.
+ */
+
+void
+reference_export::add_short (midishort x)
+{
+    put((x & 0x0000FF00) >> 8);
+    put((x & 0x000000FF));
+}
+
+/**
+ *  Adds an event and its delta time to the track, a byte at a time.
+ *
+ * \param e
+ *      The event to add.
+ *
+ * \param deltatime
+ *      The time since the previous event.
+ */
+
+void
+reference_export::add_event (const event & e, midipulse deltatime)
+{
+    if (e.is_ex_data())
+    {
+        add_ex_event(e, deltatime);
+    }
+    else
+    {
+        midibyte d0 = e.data(0);                    /* encode status & data */
+        midibyte d1 = e.data(1);
+        midibyte channel = m_sequence->get_midi_channel();
+        midibyte st = e.get_status();
+        add_variable(deltatime);                    /* encode delta_time    */
+        if (channel == EVENT_NULL_CHANNEL)
+            put(st | e.get_channel());              /* channel from event   */
+        else
+            put(st | channel);                      /* the sequence channel */
+
+        switch (st & EVENT_CLEAR_CHAN_MASK)                     /* 0xF0 */
+        {
+        case EVENT_NOTE_OFF:                                    /* 0x80 */
+        case EVENT_NOTE_ON:                                     /* 0x90 */
+        case EVENT_AFTERTOUCH:                                  /* 0xA0 */
+        case EVENT_CONTROL_CHANGE:                              /* 0xB0 */
+        case EVENT_PITCH_WHEEL:                                 /* 0xE0 */
+            put(d0);
+            put(d1);
+            break;
+
+        case EVENT_PROGRAM_CHANGE:                              /* 0xC0 */
+        case EVENT_CHANNEL_PRESSURE:                            /* 0xD0 */
+            put(d0);
+            break;
+
+        default:
+            break;
+        }
+    }
+}
+
+/**
+ *  Adds a SysEx or Meta event and its delta time to the track.
+ *
+ * \param e
+ *      The event to add.
+ *
+ * \param deltatime
+ *      The time since the previous event.
+ */
+
+void
+reference_export::add_ex_event (const event & e, midipulse deltatime)
+{
+    add_variable(deltatime);                    /* encode delta_time        */
+    put(e.get_status());                        /* indicates SysEx/Meta     */
+    if (e.is_meta())
+        put(e.get_channel());                   /* indicates meta type      */
+
+    int count = e.get_sysex_size();             /* applies for meta, too    */
+    put(count);
+    for (int i = 0; i < count; ++i)
+        put(e.get_sysex()[i]);
+}
+
+/**
+ *  Adds the sequence-number meta event.
+ *
+ * \param seq
+ *      The sequence number.
+ */
+
+void
+reference_export::fill_seq_number (int seq)
+{
+    add_variable(0);                                /* delta time N/A   */
+    put(0xFF);                                      /* meta marker      */
+    put(0x00);                                      /* seq-num marker   */
+    put(0x02);                                      /* length of event  */
+    add_short(midishort(seq));
+}
+
+/**
+ *  Adds the track-name meta event.
+ *
+ * \param name
+ *      The name of the sequence.
+ */
+
+void
+reference_export::fill_seq_name (const std::string & name)
+{
+    add_variable(0);                                /* delta time N/A   */
+    put(0xFF);                                      /* meta marker      */
+    put(0x03);                                      /* track name mark  */
+
+    int len = name.length();
+    if (len > SEQ64_MAX_DATA_VALUE)                 /* 0x7F, 127        */
+        len = SEQ64_MAX_DATA_VALUE;
+
+    put(midibyte(len));                             /* length of name   */
+    for (int i = 0; i < len; ++i)
+        put(midibyte(name[i]));
+}
+
+/**
+ *  Adds the end-of-track meta event.
+ *
+ * \param deltatime
+ *      The time since the previous event.
+ */
+
+void
+reference_export::fill_meta_track_end (midipulse deltatime)
+{
+    add_variable(deltatime);
+    put(0xFF);
+    put(0x2F);
+    put(0x00);
+}
+
+/**
+ *  Adds the tempo and time signature of the song to the first track, if
+ *  the sequence does not have them already.
+ *
+ * \param mt
+ *      The timing of the song.
+ *
+ * \param has_time_sig
+ *      True if the sequence has a time signature event.
+ *
+ * \param has_tempo
+ *      True if the sequence has a tempo event.
+ */
+
+void
+reference_export::fill_time_sig_and_tempo
+(
+    const midi_timing & mt, bool has_time_sig, bool has_tempo
+)
+{
+    if (! has_tempo)
+    {
+        midibyte t[4];                          /* hold tempo bytes */
+        tempo_us_to_bytes(t, mt.us_per_quarter_note());
+        add_variable(0);                        /* delta time       */
+        put(0xFF);                              /* meta event       */
+        put(0x51);                              /* tempo event      */
+        put(0x03);                              /* data length      */
+        put(t[0]);                              /* NOT 2, 1, 0!     */
+        put(t[1]);
+        put(t[2]);
+    }
+    if (! has_time_sig)
+    {
+        add_variable(0);                        /* delta time       */
+        put(0xFF);                              /* meta event       */
+        put(0x58);                              /* time sig event   */
+        put(0x04);                              /* data length      */
+        put(mt.beats_per_measure());
+        put(log2_time_sig_value(mt.beat_width()));
+        put(mt.clocks_per_metronome());
+        put(mt.thirtyseconds_per_quarter());
+    }
+}
+
+/**
+ *  Adds the SeqSpec events that describe the sequence.
+ */
+
+void
+reference_export::fill_proprietary ()
+{
+    add_variable(0);                                /* bus delta time   */
+    put(0xFF);                                      /* meta marker      */
+    put(0x7F);                                      /* SeqSpec marker   */
+    put(0x05);                                      /* event length     */
+    add_long(c_midibus);                            /* Seq24 SeqSpec ID */
+    put(m_sequence->get_midi_bus());                /* MIDI buss number */
+
+    add_variable(0);                                /* timesig delta t  */
+    put(0xFF);
+    put(0x7F);
+    put(0x06);
+    add_long(c_timesig);
+    put(m_sequence->get_beats_per_bar());
+    put(m_sequence->get_beat_width());
+
+    add_variable(0);                                /* channel delta t  */
+    put(0xFF);
+    put(0x7F);
+    put(0x05);
+    add_long(c_midich);
+    put(m_sequence->get_midi_channel());
+    if (! rc().legacy_format())
+    {
+        if (! usr().global_seq_feature())
+        {
+            if (m_sequence->musical_key() != SEQ64_KEY_OF_C)
+            {
+                add_variable(0);                        /* key selection dt */
+                put(0xFF);
+                put(0x7F);
+                put(0x05);                              /* long + midibyte  */
+                add_long(c_musickey);
+                put(m_sequence->musical_key());
+            }
+            if (m_sequence->musical_scale() != int(c_scale_off))
+            {
+                add_variable(0);                        /* scale selection  */
+                put(0xFF);
+                put(0x7F);
+                put(0x05);                              /* long + midibyte  */
+                add_long(c_musicscale);
+                put(m_sequence->musical_scale());
+            }
+            if (SEQ64_IS_VALID_SEQUENCE(m_sequence->background_sequence()))
+            {
+                add_variable(0);                        /* b'ground seq.    */
+                put(0xFF);
+                put(0x7F);
+                put(0x08);                              /* two long values  */
+                add_long(c_backsequence);
+                add_long(m_sequence->background_sequence());
+            }
+        }
+
+#ifdef SEQ64_STAZED_TRANSPOSE
+        add_variable(0);                                /* no delta time    */
+        put(0xFF);
+        put(0x7F);
+        put(0x05);                                      /* long + midibyte  */
+        add_long(c_transpose);
+        put(m_sequence->get_transposable());            /* a boolean byte   */
+#endif
+
+    }
+}
+
+/**
+ *  Adds the events of the sequence for one trigger, walking the whole
+ *  event list for each repetition of the pattern.
+ *
+ * \param trig
+ *      The trigger to be processed.
+ *
+ * \param prev_timestamp
+ *      The time-stamp of the previous event.
+ *
+ * \return
+ *      Returns the time-stamp of the last event added.
+ */
+
+midipulse
+reference_export::song_fill_seq_event
+(
+    const trigger & trig, midipulse prev_timestamp
+)
+{
+    midipulse len = m_sequence->get_length();
+    midipulse trig_offset = trig.offset() % len;
+    midipulse start_offset = trig.tick_start() % len;
+    midipulse timestamp_adjust = trig.tick_start() + trig_offset - start_offset;
+    int note_is_used[c_midi_notes];
+    for (int i = 0; i < c_midi_notes; ++i)
+        note_is_used[i] = 0;                        /* initialize to off */
+
+    int times_played = 1 + (trig.length() - 1) / len;
+    if (trig_offset > start_offset)                 /* offset len too far   */
+        timestamp_adjust -= len;
+
+    const event_list & evl = m_sequence->events();
+    for (int p = 0; p <= times_played; ++p)
+    {
+        midipulse delta_time = 0;
+        for (const event & e : evl)
+        {
+            midipulse timestamp = e.get_timestamp() + timestamp_adjust;
+            if (timestamp >= trig.tick_start())     /* at/after trigger     */
+            {
+                midibyte note = e.get_note();
+                if (e.is_note_on())
+                {
+                    if (timestamp <= trig.tick_end())
+                        note_is_used[note]++;       /* count the note       */
+                    else
+                        continue;                   /* skip                 */
+                }
+                else if (e.is_note_off())
+                {
+                    if (note_is_used[note] > 0)
+                    {
+                        note_is_used[note]--;       /* turn off the note    */
+                        if (timestamp > trig.tick_end())
+                            timestamp = trig.tick_end();
+                    }
+                    else
+                        continue;                   /* if no Note On, skip  */
+                }
+            }
+            else
+                continue;                           /* before trigger, skip */
+
+            if (timestamp >= trig.tick_end())       /* event past trigger   */
+            {
+                if (! e.is_note_on() && ! e.is_note_off())
+                    continue;                       /* drop the event       */
+            }
+
+            delta_time = timestamp - prev_timestamp;
+            prev_timestamp = timestamp;
+            add_event(e, delta_time);
+        }
+        timestamp_adjust += len;
+    }
+    return prev_timestamp;
+}
+
+/**
+ *  Adds the single trigger that covers the whole exported track, the
+ *  SeqSpec events, and the end of the track.
+ *
+ * \param trig
+ *      The last trigger of the sequence.
+ *
+ * \param length
+ *      The length of the exported track.
+ *
+ * \param prev_timestamp
+ *      The time-stamp of the last event added.
+ */
+
+void
+reference_export::song_fill_seq_trigger
+(
+    const trigger & trig, midipulse length, midipulse prev_timestamp
+)
+{
+    const int num_triggers = 1;                 /* only one trigger here    */
+    add_variable(0);                            /* no delta time            */
+    put(0xFF);                                  /* indicates a meta event   */
+    put(0x7F);                                  /* sequencer-specific       */
+    add_variable((num_triggers * 3 * 4) + 4);   /* 3 long values + tag      */
+    add_long(c_triggers_new);                   /* Seq24 tag for triggers   */
+    add_long(0);                                /* the start tick           */
+    add_long(trig.tick_end());
+    add_long(0);                                /* offset is done in event  */
+    fill_proprietary();
+    fill_meta_track_end(length - prev_timestamp);
+}
+
+/**
+ *  Builds the exported file, one track at a time.
+ *
+ * \param p
+ *      The performance to export.
+ *
+ * \param ppqn
+ *      The PPQN of the file.
+ *
+ * \return
+ *      Returns true if there was a track to export.
+ */
+
+bool
+reference_export::write_song (perform & p, int ppqn)
+{
+    int numtracks = 0;
+    for (int i = 0; i < c_max_sequence; ++i)
+    {
+        if (p.is_exportable(i))
+            ++numtracks;
+    }
+    m_bytes.clear();
+    write_long(0x4D546864);                     /* MThd                     */
+    write_long(6);
+    m_bytes.push_back(0);                       /* MIDI format 1            */
+    m_bytes.push_back(1);
+    m_bytes.push_back(midibyte((numtracks >> 8) & 0xFF));
+    m_bytes.push_back(midibyte(numtracks & 0xFF));
+    m_bytes.push_back(midibyte((ppqn >> 8) & 0xFF));
+    m_bytes.push_back(midibyte(ppqn & 0xFF));
+    for (int track = 0; track < c_max_sequence; ++track)
+    {
+        if (! p.is_exportable(track))
+            continue;
+
+        const sequence & seq = *p.get_sequence(track);
+        m_sequence = &seq;
+        m_track.clear();
+        fill_seq_number(track);
+        fill_seq_name(seq.name());
+        if (track == 0 && ! rc().legacy_format())
+        {
+            fill_time_sig_and_tempo
+            (
+                p.timing(), seq.events().has_time_signature(),
+                seq.events().has_tempo()
+            );
+        }
+
+        midipulse previous_ts = 0;
+        const std::list<trigger> trigs = seq.get_triggers();
+        for (const trigger & t : trigs)
+            previous_ts = song_fill_seq_event(t, previous_ts);
+
+        if (! trigs.empty())
+        {
+            const trigger & end_trigger = trigs.back();
+            midipulse seqend = end_trigger.tick_end();
+            midipulse measticks = seq.measures_to_ticks();
+            midipulse remainder = seqend % measticks;
+            if (remainder != measticks - 1)
+                seqend += measticks - remainder - 1;
+
+            song_fill_seq_trigger(end_trigger, seqend, previous_ts);
+        }
+        write_long(SEQ64_MTRK_TAG);
+        write_long(midilong(m_track.size()));
+        m_bytes.insert(m_bytes.end(), m_track.begin(), m_track.end());
+    }
+    return numtracks > 0;
+}
+
+}           // namespace seq64
+
+/**
+ *  Adds triggers to every pattern but every seventh, which then is not
+ *  exported, and song-mutes every eleventh.  The triggers have random
+ *  lengths and offsets, from a fixed seed, so that they start and end in
+ *  the middle of the pattern, overlap notes, and wrap around.
+ *
+ * \param p
+ *      The performance holding the patterns.
+ *
+ * \param count
+ *      The number of triggers per pattern.
+ *
+ * \return
+ *      Returns the number of patterns.
+ */
+
+static int
+add_triggers (seq64::perform & p, int count)
+{
+    int patterns = 0;
+    srand(11);
+    for (int s = 0; s < c_max_sequence; ++s)
+    {
+        seq64::sequence * seq = p.get_sequence(s);
+        if (seq == nullptr)
+            continue;
+
+        ++patterns;
+        seq64::midipulse len = seq->get_length();
+        if (s % 7 == 3 || len <= 0)
+            continue;
+
+        seq64::midipulse t = (s % 5) * 96;
+        for (int k = 0; k < count; ++k)
+        {
+            seq64::midipulse tlen = len / 2 + rand() % (len * 3);
+            seq64::midipulse offset = (rand() % 4) * len / 4;
+            seq->add_trigger(t, tlen, offset, false);
+            t += tlen + (rand() % 3) * 48;
+        }
+        if (s % 11 == 5)
+            seq->set_song_mute(true);
+    }
+    return patterns;
+}
+
+/**
+ *  Reads a whole file.
+ *
+ * \param filename
+ *      The file to read.
+ *
+ * \return
+ *      Returns the bytes of the file, empty if it could not be read.
+ */
+
+static std::vector<seq64::midibyte>
+read_file (const std::string & filename)
+{
+    std::ifstream f(filename.c_str(), std::ios::in | std::ios::binary);
+    return std::vector<seq64::midibyte>
+    (
+        (std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>()
+    );
+}
+
+/**
+ *  The standard C/C++ entry point to this test.
+ *
+ * \param argc
+ *      The number of command-line parameters.
+ *
+ * \param argv
+ *      Optionally the MIDI file to load, and the number of triggers to add
+ *      to each pattern.
+ *
+ * \return
+ *      Returns EXIT_SUCCESS if the exports are the same.
+ */
+
+int
+main (int argc, char * argv [])
+{
+    std::string fn = argc > 1 ? argv[1] : SEQ64_TEST_MIDI_FILE ;
+    int count = argc > 2 ? atoi(argv[2]) : 20 ;
+    seq64::rc().set_defaults();
+    seq64::usr().set_defaults();
+
+    seq64::keys_perform keys;
+    seq64::gui_assistant cli(keys);
+    seq64::perform p(cli);
+    p.launch(seq64::usr().midi_ppqn());
+
+    seq64::midifile f(fn);
+    if (! f.parse(p))
+    {
+        printf("? MIDI file not parsed: %s\n", fn.c_str());
+        return EXIT_FAILURE;
+    }
+
+    int patterns = add_triggers(p, count);
+    std::string outname = "midi_export_test.midi";
+    seq64::midifile out(outname, p.ppqn());
+    bool ok = out.write_song(p);
+    if (! ok)
+    {
+        printf("? Song not exported: %s\n", out.error_message().c_str());
+        p.finish();
+        return EXIT_FAILURE;
+    }
+
+    seq64::reference_export ref;
+    ok = ref.write_song(p, p.ppqn());
+    p.finish();
+
+    std::vector<seq64::midibyte> actual = read_file(outname);
+    const std::vector<seq64::midibyte> & expected = ref.bytes();
+    (void) std::remove(outname.c_str());
+    if (ok)
+    {
+        std::size_t n = actual.size() < expected.size() ?
+            actual.size() : expected.size() ;
+
+        std::size_t i = 0;
+        while (i < n && actual[i] == expected[i])
+            ++i;
+
+        ok = i == n && actual.size() == expected.size();
+        if (! ok)
+        {
+            printf
+            (
+                "? Exports differ at byte %lu (sizes %lu and %lu)\n",
+                (unsigned long) i, (unsigned long) actual.size(),
+                (unsigned long) expected.size()
+            );
+        }
+    }
+    if (ok)
+    {
+        printf
+        (
+            "%d patterns, %d triggers each: %lu bytes exported, the same\n",
+            patterns, count, (unsigned long) actual.size()
+        );
+    }
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE ;
+}
+
+/*
+ * midi_export_test.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -0,0 +1,284 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          midi_import_test.cpp
+ *
+ *  This module defines a regression test for the streaming import,
+ *  midifile_stream::import(), as used by "seq64smf -o".
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  seq64smf imports a file into a performance that is never launched, and
+ *  so has no master buss, and then saves it.  For a plain SMF file, with
+ *  none of the Sequencer64 SeqSpec data that the import skips, the file it
+ *  saves must be the same, byte for byte, as the one saved after
+ *  midifile::parse() loads the file into a launched performance.  In
+ *  particular, the tempo saved in the c_bpmtag SeqSpec must be the tempo of
+ *  the file, not 0.
+ *
+ *  The test does that for each file given, or else for Brand3.mid, which
+ *  must come out at 105 BPM.  It is built and run by "make check" in the
+ *  loop-back build (--enable-loopmidi).
+ *
+ *      midi_import_test [ file.midi ... ]
+ *
+ *  It returns EXIT_SUCCESS if the saved files match.
+ */
+
+#include <math.h>                       /* fabs()                           */
+#include <stdio.h>
+#include <stdlib.h>                     /* EXIT_SUCCESS                     */
+#include <fstream>                      /* std::ifstream                    */
+#include <iterator>                     /* std::istreambuf_iterator         */
+#include <string>
+#include <vector>
+
+#include "gui_assistant.hpp"            /* seq64::gui_assistant base class  */
+#include "keys_perform.hpp"             /* seq64::keys_perform              */
+#include "midifile.hpp"                 /* seq64::midifile                  */
+#include "midifile_stream.hpp"          /* seq64::midifile_stream           */
+#include "perform.hpp"                  /* seq64::perform                   */
+#include "settings.hpp"                 /* seq64::rc() and seq64::usr()     */
+
+#ifndef SEQ64_TEST_MIDI_DIR
+#define SEQ64_TEST_MIDI_DIR     "contrib/midi"
+#endif
+
+/**
+ *  The file tested by default, and its tempo, which is read from the
+ *  microseconds per quarter note, so it is compared to the nearest
+ *  hundredth.
+ */
+
+#define SEQ64_TEST_IMPORT_FILE  SEQ64_TEST_MIDI_DIR "/Brand3.mid"
+#define SEQ64_TEST_IMPORT_BPM   105.0
+#define SEQ64_TEST_BPM_EPSILON  0.01
+
+/**
+ *  Reads a whole file.
+ *
+ * \param filename
+ *      The file to read.
+ *
+ * \return
+ *      Returns the bytes of the file, empty if it could not be read.
+ */
+
+static std::vector<seq64::midibyte>
+read_file (const std::string & filename)
+{
+    std::ifstream f(filename.c_str(), std::ios::in | std::ios::binary);
+    return std::vector<seq64::midibyte>
+    (
+        (std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>()
+    );
+}
+
+/**
+ *  Imports a file the way seq64smf does, and saves it.
+ *
+ * \param filename
+ *      The file to import.
+ *
+ * \param outname
+ *      The file to save.
+ *
+ * \param [out] bpm
+ *      The tempo of the performance after the import.
+ *
+ * \return
+ *      Returns true if the file was imported and saved.
+ */
+
+static bool
+import_and_write
+(
+    const std::string & filename, const std::string & outname,
+    seq64::midibpm & bpm
+)
+{
+    seq64::midifile_stream ms(filename);
+    seq64::keys_perform keys;
+    seq64::gui_assistant cli(keys);
+    seq64::perform p(cli);                      /* never launched           */
+    bool result = ms.import(p);
+    if (result)
+    {
+        seq64::midifile f(outname, ms.ppqn());
+        bpm = p.get_beats_per_minute();
+        result = f.write(p);
+    }
+    return result;
+}
+
+/**
+ *  Parses a file into a launched performance, and saves it.
+ *
+ * \param filename
+ *      The file to parse.
+ *
+ * \param outname
+ *      The file to save.
+ *
+ * \param [out] bpm
+ *      The tempo of the performance after the parse.
+ *
+ * \return
+ *      Returns true if the file was parsed and saved.
+ */
+
+static bool
+parse_and_write
+(
+    const std::string & filename, const std::string & outname,
+    seq64::midibpm & bpm
+)
+{
+    seq64::keys_perform keys;
+    seq64::gui_assistant cli(keys);
+    seq64::perform p(cli);
+    p.launch(seq64::usr().midi_ppqn());
+
+    seq64::midifile f(filename);
+    bool result = f.parse(p);
+    if (result)
+    {
+        seq64::midifile out(outname, p.ppqn());
+        bpm = p.get_beats_per_minute();
+        result = out.write(p);
+    }
+    p.finish();
+    return result;
+}
+
+/**
+ *  Saves a file both ways and compares the results.
+ *
+ * \param filename
+ *      The file to test.
+ *
+ * \param [out] bpm
+ *      The tempo of the imported performance.
+ *
+ * \return
+ *      Returns true if both saved files are the same.
+ */
+
+static bool
+compare (const std::string & filename, seq64::midibpm & bpm)
+{
+    std::string importname = "midi_import_test_import.midi";
+    std::string parsename = "midi_import_test_parse.midi";
+    seq64::midibpm parsebpm = 0.0;
+    bool ok = import_and_write(filename, importname, bpm);
+    if (! ok)
+        printf("? MIDI file not imported: %s\n", filename.c_str());
+
+    if (ok)
+    {
+        ok = parse_and_write(filename, parsename, parsebpm);
+        if (! ok)
+            printf("? MIDI file not parsed: %s\n", filename.c_str());
+    }
+    if (ok)
+    {
+        std::vector<seq64::midibyte> imported = read_file(importname);
+        std::vector<seq64::midibyte> parsed = read_file(parsename);
+        std::size_t n = imported.size() < parsed.size() ?
+            imported.size() : parsed.size() ;
+
+        std::size_t i = 0;
+        while (i < n && imported[i] == parsed[i])
+            ++i;
+
+        ok = i == n && imported.size() == parsed.size();
+        if (! ok)
+        {
+            printf
+            (
+                "? %s: saved files differ at byte %lu (sizes %lu and %lu), "
+                "%g and %g BPM\n",
+                filename.c_str(), (unsigned long) i,
+                (unsigned long) imported.size(),
+                (unsigned long) parsed.size(), bpm, parsebpm
+            );
+        }
+    }
+    (void) std::remove(importname.c_str());
+    (void) std::remove(parsename.c_str());
+    return ok;
+}
+
+/**
+ *  The standard C/C++ entry point to this test.
+ *
+ * \param argc
+ *      The number of command-line parameters.
+ *
+ * \param argv
+ *      Optionally the MIDI files to test.
+ *
+ * \return
+ *      Returns EXIT_SUCCESS if the saved files are the same.
+ */
+
+int
+main (int argc, char * argv [])
+{
+    seq64::rc().set_defaults();
+    seq64::usr().set_defaults();
+
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i)
+        files.push_back(argv[i]);
+
+    bool checkbpm = files.empty();
+    if (checkbpm)
+        files.push_back(SEQ64_TEST_IMPORT_FILE);
+
+    bool ok = true;
+    std::vector<std::string>::const_iterator fi;
+    for (fi = files.begin(); fi != files.end(); ++fi)
+    {
+        seq64::midibpm bpm = 0.0;
+        if (compare(*fi, bpm))
+        {
+            printf("%s: %g BPM, saved the same\n", fi->c_str(), bpm);
+            double error = fabs(bpm - SEQ64_TEST_IMPORT_BPM);
+            if (checkbpm && error > SEQ64_TEST_BPM_EPSILON)
+            {
+                printf("? Expected %g BPM\n", SEQ64_TEST_IMPORT_BPM);
+                ok = false;
+            }
+        }
+        else
+            ok = false;
+    }
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE ;
+}
+
+/*
+ * midi_import_test.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
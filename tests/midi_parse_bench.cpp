@@ -0,0 +1,262 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          midi_parse_bench.cpp
+ *
+ *  This module defines a benchmark of loading MIDI files,
+ *  midifile::parse(), over a corpus of files.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  The corpus is the files named on the command line, or else the MIDI
+ *  files in contrib/midi.  Each file is parsed a few times into a cleared
+ *  performance, and the best time is kept.  The total of the best times is
+ *  reported, along with the time spent just getting the bytes: read into
+ *  a vector through an ifstream, as parse() used to do, and viewed with a
+ *  mapped_file, as it does now.
+ *
+ *  See bench_clock.hpp for how the benchmarks are built and run.
+ *
+ *      midi_parse_bench [ -r repeats ] [ file.midi ... ]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>                     /* EXIT_SUCCESS, atoi()             */
+#include <string.h>                     /* strcmp()                         */
+#include <dirent.h>                     /* opendir(), readdir()             */
+#include <algorithm>                    /* std::sort()                      */
+#include <fstream>                      /* std::ifstream                    */
+#include <string>
+#include <vector>
+
+#include "bench_clock.hpp"              /* msec_now()                       */
+#include "gui_assistant.hpp"            /* seq64::gui_assistant base class  */
+#include "keys_perform.hpp"             /* seq64::keys_perform              */
+#include "mapped_file.hpp"              /* seq64::mapped_file               */
+#include "midifile.hpp"                 /* seq64::midifile                  */
+#include "perform.hpp"                  /* seq64::perform                   */
+#include "settings.hpp"                 /* seq64::rc() and seq64::usr()     */
+
+#ifndef SEQ64_TEST_MIDI_DIR
+#define SEQ64_TEST_MIDI_DIR     "contrib/midi"
+#endif
+
+/**
+ *  Lists the MIDI files (".mid" and ".midi") of a directory, in order.
+ *
+ * \param dirname
+ *      The directory to list.
+ *
+ * \return
+ *      Returns the path names of the files.
+ */
+
+static std::vector<std::string>
+list_corpus (const std::string & dirname)
+{
+    std::vector<std::string> result;
+    DIR * dir = opendir(dirname.c_str());
+    if (dir != nullptr)
+    {
+        struct dirent * entry;
+        while ((entry = readdir(dir)) != nullptr)
+        {
+            std::string name = entry->d_name;
+            std::string::size_type dot = name.find_last_of('.');
+            if (dot == std::string::npos)
+                continue;
+
+            std::string ext = name.substr(dot);
+            if (ext == ".mid" || ext == ".midi")
+                result.push_back(dirname + "/" + name);
+        }
+        closedir(dir);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+/**
+ *  Gets the bytes of a file the way parse() used to, into a vector through
+ *  an ifstream, and adds them up, so that they are all touched.
+ *
+ * \param filename
+ *      The file to read.
+ *
+ * \return
+ *      Returns the sum of the bytes.
+ */
+
+static unsigned long
+load_stream (const std::string & filename)
+{
+    unsigned long result = 0;
+    std::ifstream file
+    (
+        filename.c_str(), std::ios::in | std::ios::binary | std::ios::ate
+    );
+    if (file.is_open())
+    {
+        std::size_t size = std::size_t(file.tellg());
+        std::vector<seq64::midibyte> data(size);
+        file.seekg(0, std::ios::beg);
+        if (size > 0)
+            file.read(reinterpret_cast<char *>(&data[0]), size);
+
+        for (std::size_t i = 0; i < size; ++i)
+            result += data[i];
+    }
+    return result;
+}
+
+/**
+ *  Gets the bytes of a file the way parse() does now, with a mapped_file,
+ *  and adds them up.
+ *
+ * \param filename
+ *      The file to view.
+ *
+ * \return
+ *      Returns the sum of the bytes.
+ */
+
+static unsigned long
+load_mapped (const std::string & filename)
+{
+    unsigned long result = 0;
+    seq64::mapped_file view;
+    if (view.open(filename))
+    {
+        const seq64::midibyte * data = view.data();
+        for (std::size_t i = 0; i < view.size(); ++i)
+            result += data[i];
+    }
+    return result;
+}
+
+/**
+ *  The standard C/C++ entry point to this benchmark.
+ *
+ * \param argc
+ *      The number of command-line parameters.
+ *
+ * \param argv
+ *      Optionally "-r" and the number of times to parse each file, then the
+ *      files of the corpus.
+ *
+ * \return
+ *      Returns EXIT_SUCCESS if the corpus was not empty.
+ */
+
+int
+main (int argc, char * argv [])
+{
+    int repeats = 5;
+    int index = 1;
+    if (argc > 2 && strcmp(argv[1], "-r") == 0)
+    {
+        repeats = atoi(argv[2]);
+        index = 3;
+    }
+    if (repeats < 1)
+        repeats = 1;
+
+    std::vector<std::string> corpus;
+    for ( ; index < argc; ++index)
+        corpus.push_back(argv[index]);
+
+    if (corpus.empty())
+        corpus = list_corpus(SEQ64_TEST_MIDI_DIR);
+
+    if (corpus.empty())
+    {
+        printf("? No MIDI files to parse\n");
+        return EXIT_FAILURE;
+    }
+    seq64::rc().set_defaults();
+    seq64::usr().set_defaults();
+
+    seq64::keys_perform keys;
+    seq64::gui_assistant cli(keys);
+    seq64::perform p(cli);
+    p.launch(seq64::usr().midi_ppqn());
+
+    double parsetotal = 0.0, streamtotal = 0.0, mappedtotal = 0.0;
+    int failures = 0;
+    std::vector<std::string>::const_iterator fi;
+    for (fi = corpus.begin(); fi != corpus.end(); ++fi)
+    {
+        double best = 0.0, streambest = 0.0, mappedbest = 0.0;
+        bool ok = true;
+        for (int r = 0; r < repeats; ++r)
+        {
+            (void) p.clear_all();
+
+            seq64::midifile f(*fi);
+            double start = msec_now();
+            ok = f.parse(p);
+            double elapsed = msec_now() - start;
+            if (r == 0 || elapsed < best)
+                best = elapsed;
+
+            start = msec_now();
+            unsigned long streamsum = load_stream(*fi);
+            elapsed = msec_now() - start;
+            if (r == 0 || elapsed < streambest)
+                streambest = elapsed;
+
+            start = msec_now();
+            unsigned long mappedsum = load_mapped(*fi);
+            elapsed = msec_now() - start;
+            if (r == 0 || elapsed < mappedbest)
+                mappedbest = elapsed;
+
+            if (streamsum != mappedsum)
+                printf("? Views differ: %s\n", fi->c_str());
+        }
+        if (! ok)
+            ++failures;
+
+        printf("%9.3f ms  %s%s\n", best, fi->c_str(), ok ? "" : " (failed)");
+        parsetotal += best;
+        streamtotal += streambest;
+        mappedtotal += mappedbest;
+    }
+    p.finish();
+    printf
+    (
+        "%d files, %d not parsed, best of %d:\n"
+        "    parse():     %.1f ms\n"
+        "    ifstream:    %.1f ms\n"
+        "    mapped_file: %.1f ms\n",
+        int(corpus.size()), failures, repeats,
+        parsetotal, streamtotal, mappedtotal
+    );
+    return EXIT_SUCCESS;
+}
+
+/*
+ * midi_parse_bench.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -0,0 +1,343 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          midi_split_bench.cpp
+ *
+ *  This module defines a benchmark of importing SMF 0 files, which
+ *  midi_splitter splits into one pattern per channel.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  The benchmark writes an SMF 0 file of the given number of events, from
+ *  a fixed seed: notes, up to four at a time per channel, control and
+ *  program changes, and tempo changes, on ten channels, many of them at the
+ *  same time.  It then parses the file and reports the time taken.
+ *
+ *  It also prints a hash of the split patterns: every event, in order,
+ *  with its data and the time of the event it is linked to.  The hash does
+ *  not depend on the speed of the split, so it can be compared between
+ *  builds, to check that a faster split gives the same patterns.
+ *
+ *  See bench_clock.hpp for how the benchmarks are built and run.
+ *
+ *      midi_split_bench [ events ... ]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>                     /* EXIT_SUCCESS, atoi()             */
+#include <deque>                        /* std::deque, the notes left on    */
+#include <fstream>                      /* std::ofstream                    */
+#include <random>                       /* std::mt19937                     */
+#include <string>
+#include <vector>
+
+#include "bench_clock.hpp"              /* msec_now()                       */
+#include "event_list.hpp"               /* seq64::event_list                */
+#include "gui_assistant.hpp"            /* seq64::gui_assistant base class  */
+#include "keys_perform.hpp"             /* seq64::keys_perform              */
+#include "midifile.hpp"                 /* seq64::midifile                  */
+#include "perform.hpp"                  /* seq64::perform                   */
+#include "sequence.hpp"                 /* seq64::sequence                  */
+#include "settings.hpp"                 /* seq64::rc() and seq64::usr()     */
+
+/**
+ *  The pseudo-random generator, seeded the same way for every file, so
+ *  that every run writes the same files.
+ */
+
+static std::mt19937 s_random;
+
+/**
+ * \return
+ *      Returns a pseudo-random number from 0 to \a n - 1.
+ */
+
+static int
+next_random (int n)
+{
+    return int(s_random() % (unsigned long)(n));
+}
+
+/**
+ *  Appends a variable-length value.
+ *
+ * \param track
+ *      The bytes to append to.
+ *
+ * \param v
+ *      The value.
+ */
+
+static void
+put_varinum (std::vector<seq64::midibyte> & track, unsigned long v)
+{
+    seq64::midibyte b[4];
+    int count = 0;
+    b[count++] = seq64::midibyte(v & 0x7F);
+    while ((v >>= 7) > 0 && count < 4)
+        b[count++] = seq64::midibyte(0x80 | (v & 0x7F));
+
+    while (count > 0)
+        track.push_back(b[--count]);
+}
+
+/**
+ *  Appends a delta time and up to three bytes.
+ */
+
+static void
+put_event
+(
+    std::vector<seq64::midibyte> & track, int delta,
+    int b0, int b1, int b2 = -1
+)
+{
+    put_varinum(track, (unsigned long)(delta));
+    track.push_back(seq64::midibyte(b0));
+    track.push_back(seq64::midibyte(b1));
+    if (b2 >= 0)
+        track.push_back(seq64::midibyte(b2));
+}
+
+/**
+ *  Writes an SMF 0 file.
+ *
+ * \param filename
+ *      The file to write.
+ *
+ * \param events
+ *      The number of channel events to generate.
+ *
+ * \return
+ *      Returns true if the file was written.
+ */
+
+static bool
+write_smf_0 (const std::string & filename, int events)
+{
+    static const int s_channels[] = { 0, 1, 2, 3, 5, 9, 9, 9, 10, 12, 15 };
+    static const int s_deltas[] = { 0, 0, 0, 1, 5, 12 };
+    static const int s_controls[] = { 1, 7, 10, 64 };
+    static const seq64::midibyte s_header[] =
+    {
+        0x00, 0xFF, 0x03, 0x04, 'S', 'o', 'n', 'g',
+        0x00, 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20,
+        0x00, 0xFF, 0x58, 0x04, 0x04, 0x02, 0x18, 0x08
+    };
+    std::vector<seq64::midibyte> track
+    (
+        s_header, s_header + sizeof s_header
+    );
+    std::deque<int> on[16];                     /* notes on, per channel    */
+    for (int i = 0; i < events; ++i)
+    {
+        int ch = s_channels[next_random(11)];
+        int delta = s_deltas[next_random(6)];
+        int r = next_random(100);
+        bool full = on[ch].size() >= 4;         /* four notes at most       */
+        if (r < 50 && ! full)
+        {
+            int note = 30 + next_random(61);
+            put_event(track, delta, 0x90 | ch, note, 1 + next_random(127));
+            on[ch].push_back(note);
+        }
+        else if ((r < 85 && ! on[ch].empty()) || (r < 50 && full))
+        {
+            put_event(track, delta, 0x80 | ch, on[ch].front(), 0);
+            on[ch].pop_front();
+        }
+        else if (r < 95)
+        {
+            int cc = s_controls[next_random(4)];
+            put_event(track, delta, 0xB0 | ch, cc, next_random(128));
+        }
+        else if (r < 98)
+        {
+            put_event(track, delta, 0xC0 | ch, next_random(128));
+        }
+        else
+        {
+            put_event(track, delta, 0xFF, 0x51, 0x03);
+            track.push_back(0x06);
+            track.push_back(0x1A);
+            track.push_back(0x80);
+        }
+    }
+    for (int ch = 0; ch < 16; ++ch)
+    {
+        for (size_t n = 0; n < on[ch].size(); ++n)
+            put_event(track, 1, 0x80 | ch, on[ch][n], 0);
+    }
+    put_event(track, 0, 0xFF, 0x2F, 0x00);
+
+    std::ofstream file
+    (
+        filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc
+    );
+    static const char s_mthd[] =
+    {
+        'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0, char(192)
+    };
+    file.write(s_mthd, sizeof s_mthd);
+
+    unsigned long len = (unsigned long)(track.size());
+    char mtrk[8] =
+    {
+        'M', 'T', 'r', 'k',
+        char((len >> 24) & 0xFF), char((len >> 16) & 0xFF),
+        char((len >> 8) & 0xFF), char(len & 0xFF)
+    };
+    file.write(mtrk, sizeof mtrk);
+    file.write(reinterpret_cast<const char *>(&track[0]), track.size());
+    return file.good();
+}
+
+/**
+ *  Hashes the patterns of the performance: their names, lengths, and
+ *  channels, and each event, in order, with its note link.
+ *
+ * \param p
+ *      The performance holding the patterns.
+ *
+ * \param [out] patterns
+ *      The number of patterns.
+ *
+ * \param [out] events
+ *      The number of events in all of them.
+ *
+ * \return
+ *      Returns the hash.
+ */
+
+static unsigned long
+hash_patterns (seq64::perform & p, int & patterns, int & events)
+{
+    unsigned long h = 1469598103UL;
+    patterns = events = 0;
+    for (int s = 0; s < c_max_sequence; ++s)
+    {
+        seq64::sequence * seq = p.get_sequence(s);
+        if (seq == nullptr)
+            continue;
+
+        ++patterns;
+        h = h * 131 + s;
+        const std::string & name = seq->name();
+        for (std::string::size_type c = 0; c < name.size(); ++c)
+            h = h * 131 + (unsigned char)(name[c]);
+
+        h = h * 131 + seq->get_length();
+        h = h * 131 + seq->get_midi_channel();
+        for (const seq64::event & e : seq->events())
+        {
+            seq64::midibyte d0, d1;
+            e.get_data(d0, d1);
+            h = h * 131 + e.get_timestamp();
+            h = h * 131 + e.get_status();
+            h = h * 131 + e.get_channel();
+            h = h * 131 + d0;
+            h = h * 131 + d1;
+            h = h * 131 +
+                (e.is_linked() ? e.get_linked()->get_timestamp() + 1 : 0);
+
+            h = h * 131 + e.get_sysex_size();
+            ++events;
+        }
+    }
+    return h;
+}
+
+/**
+ *  The standard C/C++ entry point to this benchmark.
+ *
+ * \param argc
+ *      The number of command-line parameters.
+ *
+ * \param argv
+ *      Optionally the sizes, in events, of the files to import.
+ *
+ * \return
+ *      Returns EXIT_SUCCESS if every file was imported.
+ */
+
+int
+main (int argc, char * argv [])
+{
+    std::vector<int> sizes;
+    for (int i = 1; i < argc; ++i)
+        sizes.push_back(atoi(argv[i]));
+
+    if (sizes.empty())
+    {
+        sizes.push_back(20000);
+        sizes.push_back(100000);
+    }
+    seq64::rc().set_defaults();
+    seq64::usr().set_defaults();
+
+    seq64::keys_perform keys;
+    seq64::gui_assistant cli(keys);
+    seq64::perform p(cli);
+    p.launch(seq64::usr().midi_ppqn());
+
+    bool ok = true;
+    std::string filename = "midi_split_bench.midi";
+    std::vector<int>::const_iterator si;
+    for (si = sizes.begin(); ok && si != sizes.end(); ++si)
+    {
+        s_random.seed(5);
+        ok = *si > 0 && write_smf_0(filename, *si);
+        if (! ok)
+        {
+            printf("? SMF 0 file not written: %s\n", filename.c_str());
+            break;
+        }
+        (void) p.clear_all();
+
+        seq64::midifile f(filename);
+        double start = msec_now();
+        ok = f.parse(p);
+        double elapsed = msec_now() - start;
+        if (ok)
+        {
+            int patterns, events;
+            unsigned long h = hash_patterns(p, patterns, events);
+            printf
+            (
+                "%7d events: %9.1f ms, %d patterns, %d events, hash %lx\n",
+                *si, elapsed, patterns, events, h
+            );
+        }
+        else
+            printf("? SMF 0 file not parsed: %s\n", filename.c_str());
+    }
+    p.finish();
+    (void) std::remove(filename.c_str());
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE ;
+}
+
+/*
+ * midi_split_bench.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -0,0 +1,244 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          midi_write_bench.cpp
+ *
+ *  This module defines a benchmark of saving a MIDI file,
+ *  midifile::write().
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-18
+ * \updates       2026-10-18
+ * \license       GNU GPLv2 or above
+ *
+ *  The benchmark fills every pattern slot, 1024 by default, with notes, and
+ *  saves the song a few times, reporting the best and the average time.
+ *
+ *  For comparison, it also times the way the file used to be written: the
+ *  same tracks, filled by midi_vector::fill(), copied a byte at a time into
+ *  an std::list<midibyte>, and written to the stream a byte per call.  Only
+ *  the tracks are written that way, not the header or the proprietary
+ *  track, which are small.
+ *
+ *  See bench_clock.hpp for how the benchmarks are built and run.
+ *
+ *      midi_write_bench [ patterns [ notes [ repeats ] ] ]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>                     /* EXIT_SUCCESS, atoi()             */
+#include <fstream>                      /* std::ofstream                    */
+#include <list>                         /* std::list, the old buffer        */
+#include <string>
+
+#include "bench_clock.hpp"              /* msec_now()                       */
+#include "gui_assistant.hpp"            /* seq64::gui_assistant base class  */
+#include "keys_perform.hpp"             /* seq64::keys_perform              */
+#include "midi_vector.hpp"              /* seq64::midi_vector               */
+#include "midifile.hpp"                 /* seq64::midifile                  */
+#include "perform.hpp"                  /* seq64::perform                   */
+#include "sequence.hpp"                 /* seq64::sequence                  */
+#include "settings.hpp"                 /* seq64::rc() and seq64::usr()     */
+
+/**
+ *  Fills the pattern slots with notes.  Each pattern is four measures
+ *  long, and its notes are spread evenly over it.
+ *
+ * \param p
+ *      The performance to fill.
+ *
+ * \param patterns
+ *      The number of patterns.
+ *
+ * \param notes
+ *      The number of notes per pattern.
+ */
+
+static void
+make_song (seq64::perform & p, int patterns, int notes)
+{
+    for (int s = 0; s < patterns && s < c_max_sequence; ++s)
+    {
+        p.new_sequence(s);
+        seq64::sequence * seq = p.get_sequence(s);
+        seq64::midipulse len = seq->measures_to_ticks(4);
+        seq->set_length(len);
+        seq64::midipulse step = len / notes > 0 ? len / notes : 1 ;
+        for (int n = 0; n < notes; ++n)
+        {
+            seq64::midipulse tick = (n * step) % len;
+            seq->add_note(tick, step, 36 + (n + s) % 48);
+        }
+    }
+}
+
+/**
+ *  Writes the tracks the way midifile::write() used to: through an
+ *  std::list holding a byte per node, then to the stream a byte at a time.
+ *
+ * \param p
+ *      The performance to write.
+ *
+ * \param filename
+ *      The file to write.
+ *
+ * \return
+ *      Returns the number of bytes written.
+ */
+
+static long
+write_old (seq64::perform & p, const std::string & filename)
+{
+    std::list<seq64::midibyte> buffer;
+    seq64::midi_timing mt = p.timing();
+    for (int s = 0; s < c_max_sequence; ++s)
+    {
+        seq64::sequence * seq = p.get_sequence(s);
+        if (seq == nullptr)
+            continue;
+
+        seq64::midi_vector lst(*seq);
+        lst.fill(s, mt);
+
+        long len = long(lst.size());
+        buffer.push_back('M');
+        buffer.push_back('T');
+        buffer.push_back('r');
+        buffer.push_back('k');
+        buffer.push_back(seq64::midibyte((len >> 24) & 0xFF));
+        buffer.push_back(seq64::midibyte((len >> 16) & 0xFF));
+        buffer.push_back(seq64::midibyte((len >> 8) & 0xFF));
+        buffer.push_back(seq64::midibyte(len & 0xFF));
+        while (! lst.done())
+            buffer.push_back(lst.get());
+    }
+
+    std::ofstream file
+    (
+        filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc
+    );
+    std::list<seq64::midibyte>::const_iterator i;
+    for (i = buffer.begin(); i != buffer.end(); ++i)
+    {
+        char c = char(*i);
+        file.write(&c, 1);
+    }
+    return long(buffer.size());
+}
+
+/**
+ * \return
+ *      Returns the size of a file, or -1 if it cannot be opened.
+ */
+
+static long
+file_size (const std::string & filename)
+{
+    std::ifstream f(filename.c_str(), std::ios::in | std::ios::binary);
+    if (! f.is_open())
+        return -1;
+
+    f.seekg(0, std::ios::end);
+    return long(f.tellg());
+}
+
+/**
+ *  The standard C/C++ entry point to this benchmark.
+ *
+ * \param argc
+ *      The number of command-line parameters.
+ *
+ * \param argv
+ *      Optionally the number of patterns, of notes per pattern, and of
+ *      saves to time.
+ *
+ * \return
+ *      Returns EXIT_SUCCESS if every save succeeded.
+ */
+
+int
+main (int argc, char * argv [])
+{
+    int patterns = argc > 1 ? atoi(argv[1]) : c_max_sequence ;
+    int notes = argc > 2 ? atoi(argv[2]) : 500 ;
+    int repeats = argc > 3 ? atoi(argv[3]) : 5 ;
+    if (patterns < 1 || notes < 1 || repeats < 1)
+    {
+        printf("Usage: midi_write_bench [ patterns [ notes [ repeats ] ] ]\n");
+        return EXIT_FAILURE;
+    }
+    seq64::rc().set_defaults();
+    seq64::usr().set_defaults();
+
+    seq64::keys_perform keys;
+    seq64::gui_assistant cli(keys);
+    seq64::perform p(cli);
+    p.launch(seq64::usr().midi_ppqn());
+    make_song(p, patterns, notes);
+
+    std::string filename = "midi_write_bench.midi";
+    std::string oldname = "midi_write_bench_old.midi";
+    bool ok = true;
+    double best = 0.0, total = 0.0;
+    double oldbest = 0.0, oldtotal = 0.0;
+    long oldsize = 0;
+    for (int r = 0; ok && r < repeats; ++r)
+    {
+        seq64::midifile f(filename, p.ppqn());
+        double start = msec_now();
+        ok = f.write(p);
+        double elapsed = msec_now() - start;
+        total += elapsed;
+        if (r == 0 || elapsed < best)
+            best = elapsed;
+
+        start = msec_now();
+        oldsize = write_old(p, oldname);
+        elapsed = msec_now() - start;
+        oldtotal += elapsed;
+        if (r == 0 || elapsed < oldbest)
+            oldbest = elapsed;
+    }
+    long size = file_size(filename);
+    p.finish();
+    (void) std::remove(filename.c_str());
+    (void) std::remove(oldname.c_str());
+    if (ok)
+    {
+        printf
+        (
+            "%d patterns, %d notes each, %ld bytes:\n"
+            "    write():  best %.1f ms, average %.1f ms\n"
+            "    old path: best %.1f ms, average %.1f ms (%ld bytes)\n",
+            patterns, notes, size, best, total / repeats,
+            oldbest, oldtotal / repeats, oldsize
+        );
+    }
+    else
+        printf("? MIDI file not written: %s\n", filename.c_str());
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE ;
+}
+
+/*
+ * midi_write_bench.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */